@@ -0,0 +1,335 @@
+///////////////////////////////////////////////////////////////////////////////
+// EntityStore.cpp
+// ============
+// Dense component arrays with swap-and-pop removal and generation
+// checked handles.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "EntityStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+#include <glm/gtx/transform.hpp>
+
+namespace
+{
+    // Entity counts RunBenchmark() uses when none are given, how far
+    // apart it spaces the entities, and how often each step is timed
+    const size_t BENCHMARK_COUNTS[] = { 100000, 1000000 };
+    const float BENCHMARK_SPACING = 2.0f;
+    const int BENCHMARK_RUNS = 3;
+
+    // Nanoseconds per entity for a step that took seconds
+    double PerEntity(double seconds, size_t count)
+    {
+        return seconds * 1.0e9 / std::max<size_t>(count, 1);
+    }
+}
+
+const EntityStore::ENTITY EntityStore::NO_ENTITY = { 0xFFFFFFFFu, 0xFFFFFFFFu };
+
+/***********************************************************
+ * EntityStore()
+ ***********************************************************/
+EntityStore::EntityStore()
+{
+}
+
+/***********************************************************
+ * Create()
+ * Components start out as an untextured white unit box at
+ * the origin with every cylinder part on.
+ ***********************************************************/
+EntityStore::ENTITY EntityStore::Create()
+{
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = (uint32_t)m_slots.size();
+        SLOT fresh = { 0, 0, false };
+        m_slots.push_back(fresh);
+    }
+
+    m_slots[slot].index = (uint32_t)m_entitySlots.size();
+    m_slots[slot].bUsed = true;
+
+    MESH_REF mesh = { 0, 0, -1, -1 };
+    SURFACE surface = { glm::vec4(1.0f), glm::vec2(1.0f) };
+    BOUNDS bounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+    m_transforms.push_back(glm::mat4(1.0f));
+    m_meshes.push_back(mesh);
+    m_materials.push_back(-1);
+    m_textures.push_back(-1);
+    m_surfaces.push_back(surface);
+    m_bounds.push_back(bounds);
+    m_flags.push_back(FLAG_DRAW_TOP | FLAG_DRAW_BOTTOM | FLAG_DRAW_SIDES);
+    m_entitySlots.push_back(slot);
+
+    ENTITY entity = { slot, m_slots[slot].generation };
+    return entity;
+}
+
+/***********************************************************
+ * Append()
+ * Each column grows by one block copy; only the handle
+ * slots are handed out one entity at a time.
+ ***********************************************************/
+size_t EntityStore::Append(size_t count, const glm::mat4* transforms, const MESH_REF* meshes, const int* materials,
+                           const int* textures, const SURFACE* surfaces, const BOUNDS* bounds, const uint8_t* flags)
+{
+    size_t first = m_entitySlots.size();
+    m_transforms.insert(m_transforms.end(), transforms, transforms + count);
+    m_meshes.insert(m_meshes.end(), meshes, meshes + count);
+    m_materials.insert(m_materials.end(), materials, materials + count);
+    m_textures.insert(m_textures.end(), textures, textures + count);
+    m_surfaces.insert(m_surfaces.end(), surfaces, surfaces + count);
+    m_bounds.insert(m_bounds.end(), bounds, bounds + count);
+    m_flags.insert(m_flags.end(), flags, flags + count);
+
+    m_entitySlots.resize(first + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t slot;
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            slot = (uint32_t)m_slots.size();
+            SLOT fresh = { 0, 0, false };
+            m_slots.push_back(fresh);
+        }
+        m_slots[slot].index = (uint32_t)(first + i);
+        m_slots[slot].bUsed = true;
+        m_entitySlots[first + i] = slot;
+    }
+    return first;
+}
+
+/***********************************************************
+ * Destroy()
+ * Swap-and-pop in every column keeps the arrays gap-free
+ * at a cost that doesn't depend on the entity count.
+ ***********************************************************/
+bool EntityStore::Destroy(ENTITY entity)
+{
+    if (!IsAlive(entity))
+        return false;
+
+    uint32_t index = m_slots[entity.slot].index;
+    uint32_t last = (uint32_t)m_entitySlots.size() - 1;
+    if (index != last)
+    {
+        m_transforms[index] = m_transforms[last];
+        m_meshes[index] = m_meshes[last];
+        m_materials[index] = m_materials[last];
+        m_textures[index] = m_textures[last];
+        m_surfaces[index] = m_surfaces[last];
+        m_bounds[index] = m_bounds[last];
+        m_flags[index] = m_flags[last];
+        m_entitySlots[index] = m_entitySlots[last];
+        m_slots[m_entitySlots[index]].index = index;
+    }
+
+    m_transforms.pop_back();
+    m_meshes.pop_back();
+    m_materials.pop_back();
+    m_textures.pop_back();
+    m_surfaces.pop_back();
+    m_bounds.pop_back();
+    m_flags.pop_back();
+    m_entitySlots.pop_back();
+
+    m_slots[entity.slot].bUsed = false;
+    m_slots[entity.slot].generation++;
+    m_freeSlots.push_back(entity.slot);
+    return true;
+}
+
+/***********************************************************
+ * Clear()
+ ***********************************************************/
+void EntityStore::Clear()
+{
+    for (uint32_t slot : m_entitySlots)
+    {
+        m_slots[slot].bUsed = false;
+        m_slots[slot].generation++;
+        m_freeSlots.push_back(slot);
+    }
+
+    m_transforms.clear();
+    m_meshes.clear();
+    m_materials.clear();
+    m_textures.clear();
+    m_surfaces.clear();
+    m_bounds.clear();
+    m_flags.clear();
+    m_entitySlots.clear();
+}
+
+/***********************************************************
+ * Reserve()
+ ***********************************************************/
+void EntityStore::Reserve(size_t count)
+{
+    m_transforms.reserve(count);
+    m_meshes.reserve(count);
+    m_materials.reserve(count);
+    m_textures.reserve(count);
+    m_surfaces.reserve(count);
+    m_bounds.reserve(count);
+    m_flags.reserve(count);
+    m_entitySlots.reserve(count);
+    m_slots.reserve(count);
+}
+
+/***********************************************************
+ * IsAlive()
+ ***********************************************************/
+bool EntityStore::IsAlive(ENTITY entity) const
+{
+    return entity.slot < m_slots.size() &&
+           m_slots[entity.slot].bUsed &&
+           m_slots[entity.slot].generation == entity.generation;
+}
+
+/***********************************************************
+ * GetIndex()
+ ***********************************************************/
+int EntityStore::GetIndex(ENTITY entity) const
+{
+    return IsAlive(entity) ? (int)m_slots[entity.slot].index : -1;
+}
+
+/***********************************************************
+ * GetEntity()
+ ***********************************************************/
+EntityStore::ENTITY EntityStore::GetEntity(size_t index) const
+{
+    uint32_t slot = m_entitySlots[index];
+    ENTITY entity = { slot, m_slots[slot].generation };
+    return entity;
+}
+
+/***********************************************************
+ * RunBenchmark()
+ * Each count gets a fresh store, timed at four steps:
+ *   create    Create() plus setting a transform, as a
+ *             scene load does, without reserving first
+ *   update    rewrite every transform and its world bounds,
+ *             the work a moving scene does each frame
+ *   cull      test every bounds and flag against a box,
+ *             the shape of SceneManager's culling pass
+ *   destroy   remove half the entities by handle in random
+ *             order, so every removal swaps
+ * The best of BENCHMARK_RUNS runs is logged for each.
+ ***********************************************************/
+void EntityStore::RunBenchmark(const std::vector<std::string>& args)
+{
+    std::vector<size_t> counts;
+    for (const std::string& arg : args)
+    {
+        size_t count = (size_t)std::strtoull(arg.c_str(), nullptr, 10);
+        if (count > 0)
+            counts.push_back(count);
+    }
+    if (counts.empty())
+        counts.assign(std::begin(BENCHMARK_COUNTS), std::end(BENCHMARK_COUNTS));
+
+    for (size_t count : counts)
+    {
+        size_t side = (size_t)std::ceil(std::sqrt((double)count));
+        double best[4] = { 0.0, 0.0, 0.0, 0.0 };
+        size_t visible = 0;
+        size_t remaining = 0;
+        for (int run = 0; run < BENCHMARK_RUNS; run++)
+        {
+            EntityStore store;
+            std::vector<ENTITY> entities(count);
+
+            auto startTime = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < count; i++)
+            {
+                entities[i] = store.Create();
+                glm::vec3 position((float)(i % side) * BENCHMARK_SPACING, 0.0f, (float)(i / side) * BENCHMARK_SPACING);
+                store.GetTransforms()[i] = glm::translate(position);
+            }
+            auto createTime = std::chrono::steady_clock::now();
+
+            // a small per-entity lift, then the unit box carried through it
+            glm::mat4* transforms = store.GetTransforms();
+            BOUNDS* bounds = store.GetBounds();
+            for (size_t i = 0; i < count; i++)
+            {
+                transforms[i][3].y += 0.01f;
+                glm::vec3 center = glm::vec3(transforms[i][3]);
+                glm::vec3 extent = (glm::abs(glm::vec3(transforms[i][0])) +
+                                    glm::abs(glm::vec3(transforms[i][1])) +
+                                    glm::abs(glm::vec3(transforms[i][2]))) * 0.5f;
+                bounds[i].boundsMin = center - extent;
+                bounds[i].boundsMax = center + extent;
+            }
+            auto updateTime = std::chrono::steady_clock::now();
+
+            // the near quarter of the grid in each direction is "on screen"
+            glm::vec3 viewMin(-1.0f);
+            glm::vec3 viewMax(side * BENCHMARK_SPACING * 0.5f);
+            const uint8_t* flags = store.GetFlags();
+            size_t inside = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                bool bInside = !(flags[i] & FLAG_HIDDEN) &&
+                               bounds[i].boundsMax.x >= viewMin.x && bounds[i].boundsMin.x <= viewMax.x &&
+                               bounds[i].boundsMax.y >= viewMin.y && bounds[i].boundsMin.y <= viewMax.y &&
+                               bounds[i].boundsMax.z >= viewMin.z && bounds[i].boundsMin.z <= viewMax.z;
+                inside += bInside ? 1 : 0;
+            }
+            auto cullTime = std::chrono::steady_clock::now();
+
+            // the shuffle is set up outside the timed step
+            std::shuffle(entities.begin(), entities.end(), std::mt19937(run + 1));
+            auto destroyStart = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < count / 2; i++)
+                store.Destroy(entities[i]);
+            auto destroyTime = std::chrono::steady_clock::now();
+
+            double seconds[4] = {
+                std::chrono::duration<double>(createTime - startTime).count(),
+                std::chrono::duration<double>(updateTime - createTime).count(),
+                std::chrono::duration<double>(cullTime - updateTime).count(),
+                std::chrono::duration<double>(destroyTime - destroyStart).count()
+            };
+            for (int step = 0; step < 4; step++)
+            {
+                if (run == 0 || seconds[step] < best[step])
+                    best[step] = seconds[step];
+            }
+            visible = inside;
+            remaining = store.GetCount();
+        }
+
+        std::cout << "INFO: " << count << " entities: create " << best[0] * 1000.0 << " ms ("
+                  << PerEntity(best[0], count) << " ns each), update " << best[1] * 1000.0 << " ms ("
+                  << PerEntity(best[1], count) << " ns), cull " << best[2] * 1000.0 << " ms ("
+                  << PerEntity(best[2], count) << " ns, " << visible << " inside), destroy half "
+                  << best[3] * 1000.0 << " ms (" << PerEntity(best[3], count / 2) << " ns, "
+                  << remaining << " left)" << std::endl;
+    }
+}
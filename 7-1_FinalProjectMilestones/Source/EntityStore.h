@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// EntityStore.h
+// ============
+// Scene objects as densely packed component arrays, addressed from the
+// outside by handles that stay valid while other entities come and go.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  EntityStore
+ *
+ *  Every component lives in its own array, and the arrays
+ *  are kept parallel and gap-free: position i in each one
+ *  belongs to the same entity, and positions run from 0 to
+ *  GetCount() - 1. Systems walk a column or two front to
+ *  back and never touch the components they don't need.
+ *
+ *  Destroy() moves the last entity into the hole, so
+ *  positions are only good until the next Destroy(). Hold
+ *  on to an ENTITY instead; GetIndex() turns it into the
+ *  entity's current position. A slot's generation goes up
+ *  each time it's freed, so a handle to a destroyed entity
+ *  is told apart from whatever reuses its slot.
+ *
+ *  CPU only — no GL — so it can be timed headless.
+ ***********************************************************/
+class EntityStore
+{
+public:
+    // stable handle to one entity
+    struct ENTITY
+    {
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+    // what to draw and how to cull its faces
+    struct MESH_REF
+    {
+        // a SceneManager::MESH_TYPE
+        uint8_t mesh;
+        // a SceneManager::CULL_MODE
+        uint8_t cullMode;
+        // MeshLibrary handle for imported meshes, -1 otherwise
+        int32_t importedMesh;
+        // SceneManager prefab for prefab placements, -1 otherwise
+        int32_t prefab;
+    };
+
+    // color and texture tiling, for draws that don't need a texture
+    // or a material to tell them apart
+    struct SURFACE
+    {
+        glm::vec4 color;
+        glm::vec2 uvScale;
+    };
+
+    // world-space box used for culling
+    struct BOUNDS
+    {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    // bits of the flags component
+    enum ENTITY_FLAG
+    {
+        // cylinder parts (ignored for other meshes)
+        FLAG_DRAW_TOP = 1 << 0,
+        FLAG_DRAW_BOTTOM = 1 << 1,
+        FLAG_DRAW_SIDES = 1 << 2,
+        // rasterized into the occlusion buffer as well as drawn
+        FLAG_OCCLUDER = 1 << 3,
+        // kept but not drawn, e.g. while a generated plant stands in
+        FLAG_HIDDEN = 1 << 4
+    };
+
+    // a handle no entity ever has
+    static const ENTITY NO_ENTITY;
+
+    // constructor
+    EntityStore();
+
+    // Add an entity with default components at position GetCount() - 1
+    ENTITY Create();
+    // Add count entities whose components are copied from the given
+    // columns, each count long. Returns the position of the first.
+    size_t Append(size_t count, const glm::mat4* transforms, const MESH_REF* meshes, const int* materials,
+                  const int* textures, const SURFACE* surfaces, const BOUNDS* bounds, const uint8_t* flags);
+    // Remove an entity; the last entity takes its position. Returns
+    // false if the handle was already stale.
+    bool Destroy(ENTITY entity);
+    // Remove every entity; handles given out so far all go stale
+    void Clear();
+    // Make room for count entities without reallocating
+    void Reserve(size_t count);
+
+    bool IsAlive(ENTITY entity) const;
+    // current position of a live entity, -1 for a stale handle
+    int GetIndex(ENTITY entity) const;
+    // handle of the entity at a position
+    ENTITY GetEntity(size_t index) const;
+    size_t GetCount() const { return m_entitySlots.size(); }
+
+    // Component columns, GetCount() long. Pointers are good until the
+    // next Create(), Append(), Destroy() or Clear().
+    glm::mat4* GetTransforms() { return m_transforms.data(); }
+    const glm::mat4* GetTransforms() const { return m_transforms.data(); }
+    MESH_REF* GetMeshes() { return m_meshes.data(); }
+    const MESH_REF* GetMeshes() const { return m_meshes.data(); }
+    // index into the scene's material list, -1 for none
+    int* GetMaterials() { return m_materials.data(); }
+    const int* GetMaterials() const { return m_materials.data(); }
+    // texture slot, -1 to use the surface color instead
+    int* GetTextures() { return m_textures.data(); }
+    const int* GetTextures() const { return m_textures.data(); }
+    SURFACE* GetSurfaces() { return m_surfaces.data(); }
+    const SURFACE* GetSurfaces() const { return m_surfaces.data(); }
+    BOUNDS* GetBounds() { return m_bounds.data(); }
+    const BOUNDS* GetBounds() const { return m_bounds.data(); }
+    // ENTITY_FLAG bits
+    uint8_t* GetFlags() { return m_flags.data(); }
+    const uint8_t* GetFlags() const { return m_flags.data(); }
+
+    // Time creation, iteration and destruction at each entity count in
+    // args (100k and 1M by default) and log them
+    static void RunBenchmark(const std::vector<std::string>& args);
+
+private:
+    // where a slot's entity is, if it has one
+    struct SLOT
+    {
+        uint32_t index;
+        uint32_t generation;
+        bool bUsed;
+    };
+
+    // components, all indexed by position
+    std::vector<glm::mat4> m_transforms;
+    std::vector<MESH_REF> m_meshes;
+    std::vector<int> m_materials;
+    std::vector<int> m_textures;
+    std::vector<SURFACE> m_surfaces;
+    std::vector<BOUNDS> m_bounds;
+    std::vector<uint8_t> m_flags;
+    // slot of the entity at each position
+    std::vector<uint32_t> m_entitySlots;
+
+    // indexed by ENTITY::slot
+    std::vector<SLOT> m_slots;
+    // slots Destroy() gave back, reused last in first out
+    std::vector<uint32_t> m_freeSlots;
+};
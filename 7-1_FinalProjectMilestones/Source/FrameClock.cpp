@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameClock.cpp
+// ============
+// Monotonic frame timing with a fixed simulation timestep, render-time
+// interpolation and running frame statistics.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameClock.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Longest frame banked in full — a quarter second
+    const int64_t MAX_FRAME_NANOSECONDS = 250000000;
+
+    const double NANOSECONDS_PER_SECOND = 1.0e9;
+    const double NANOSECONDS_PER_MILLISECOND = 1.0e6;
+}
+
+/***********************************************************
+ * FrameClock()
+ ***********************************************************/
+FrameClock::FrameClock(int stepsPerSecond)
+    : m_start(std::chrono::steady_clock::now())
+    , m_stepNanoseconds(1000000000 / std::max(stepsPerSecond, 1))
+    , m_frameStart(0)
+    , m_accumulator(0)
+    , m_stepCount(0)
+{
+    m_frameTimes.reserve(STATS_FRAMES);
+
+    m_stats.frames = 0;
+    m_stats.steps = 0;
+    m_stats.lastMilliseconds = 0.0;
+    m_stats.averageMilliseconds = 0.0;
+    m_stats.minMilliseconds = 0.0;
+    m_stats.maxMilliseconds = 0.0;
+    m_stats.framesPerSecond = 0.0;
+    m_stats.lastSteps = 0;
+    m_stats.droppedMilliseconds = 0.0;
+}
+
+/***********************************************************
+ * Now()
+ ***********************************************************/
+int64_t FrameClock::Now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start).count();
+}
+
+/***********************************************************
+ * BeginFrame()
+ * The first frame banks nothing, so time spent loading
+ * before the loop starts isn't simulated or counted.
+ ***********************************************************/
+void FrameClock::BeginFrame()
+{
+    int64_t now = Now();
+    int64_t elapsed = now - m_frameStart;
+    m_frameStart = now;
+    m_stats.lastSteps = 0;
+    if (m_stats.frames++ == 0)
+        return;
+
+    RecordFrame(elapsed);
+    if (elapsed > MAX_FRAME_NANOSECONDS)
+    {
+        m_stats.droppedMilliseconds += (elapsed - MAX_FRAME_NANOSECONDS) / NANOSECONDS_PER_MILLISECOND;
+        elapsed = MAX_FRAME_NANOSECONDS;
+    }
+    m_accumulator += elapsed;
+}
+
+/***********************************************************
+ * Step()
+ ***********************************************************/
+bool FrameClock::Step()
+{
+    if (m_accumulator < m_stepNanoseconds)
+        return false;
+
+    m_accumulator -= m_stepNanoseconds;
+    m_stepCount++;
+    m_stats.steps++;
+    m_stats.lastSteps++;
+    return true;
+}
+
+/***********************************************************
+ * GetStepSeconds()
+ ***********************************************************/
+double FrameClock::GetStepSeconds() const
+{
+    return m_stepNanoseconds / NANOSECONDS_PER_SECOND;
+}
+
+/***********************************************************
+ * GetTime()
+ ***********************************************************/
+double FrameClock::GetTime() const
+{
+    return m_frameStart / NANOSECONDS_PER_SECOND;
+}
+
+/***********************************************************
+ * GetSimulationTime()
+ * Counted in whole steps, so it never drifts from the sum
+ * of the steps taken.
+ ***********************************************************/
+double FrameClock::GetSimulationTime() const
+{
+    return (int64_t)m_stepCount * m_stepNanoseconds / NANOSECONDS_PER_SECOND;
+}
+
+/***********************************************************
+ * GetAlpha()
+ ***********************************************************/
+double FrameClock::GetAlpha() const
+{
+    return (double)m_accumulator / (double)m_stepNanoseconds;
+}
+
+/***********************************************************
+ * GetInterpolatedTime()
+ ***********************************************************/
+double FrameClock::GetInterpolatedTime() const
+{
+    return ((int64_t)m_stepCount * m_stepNanoseconds + m_accumulator) / NANOSECONDS_PER_SECOND;
+}
+
+/***********************************************************
+ * RecordFrame()
+ * The window is small enough to rescan every frame.
+ ***********************************************************/
+void FrameClock::RecordFrame(int64_t nanoseconds)
+{
+    if ((int)m_frameTimes.size() < STATS_FRAMES)
+        m_frameTimes.push_back(nanoseconds);
+    else
+        m_frameTimes[(m_stats.frames - 2) % STATS_FRAMES] = nanoseconds;
+
+    int64_t sum = 0;
+    int64_t shortest = m_frameTimes[0];
+    int64_t longest = m_frameTimes[0];
+    for (int64_t frameTime : m_frameTimes)
+    {
+        sum += frameTime;
+        shortest = std::min(shortest, frameTime);
+        longest = std::max(longest, frameTime);
+    }
+
+    double average = (double)sum / m_frameTimes.size();
+    m_stats.lastMilliseconds = nanoseconds / NANOSECONDS_PER_MILLISECOND;
+    m_stats.averageMilliseconds = average / NANOSECONDS_PER_MILLISECOND;
+    m_stats.minMilliseconds = shortest / NANOSECONDS_PER_MILLISECOND;
+    m_stats.maxMilliseconds = longest / NANOSECONDS_PER_MILLISECOND;
+    m_stats.framesPerSecond = (average > 0.0) ? NANOSECONDS_PER_SECOND / average : 0.0;
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameClock.h
+// ============
+// Monotonic frame timing with a fixed simulation timestep, render-time
+// interpolation and running frame statistics.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  FrameClock
+ *
+ *  Time is kept as whole nanoseconds since construction,
+ *  read from the steady clock, so deltas stay exact no
+ *  matter how long the program has been up; seconds are
+ *  only formed as doubles on the way out.
+ *
+ *  BeginFrame() banks the time since the last frame, and
+ *  Step() pays it out one fixed step at a time:
+ *
+ *      clock.BeginFrame();
+ *      while (clock.Step())
+ *          simulate(clock.GetStepSeconds());
+ *      render(clock.GetAlpha());
+ *
+ *  so the simulation advances the same way at any frame
+ *  rate. What's left in the bank, as a fraction of a step,
+ *  is how far to blend from the previous step's state to
+ *  the latest one when drawing. A frame longer than
+ *  MAX_FRAME_NANOSECONDS, e.g. after a stall or a window
+ *  drag, only banks that much and the rest is dropped,
+ *  rather than the simulation racing to catch up.
+ ***********************************************************/
+class FrameClock
+{
+public:
+    // frame timing, wall clock
+    struct FRAME_STATS
+    {
+        // frames since construction, and simulation steps run in them
+        uint64_t frames;
+        uint64_t steps;
+        // the last frame, and the mean, shortest and longest of up to
+        // the last STATS_FRAMES frames
+        double lastMilliseconds;
+        double averageMilliseconds;
+        double minMilliseconds;
+        double maxMilliseconds;
+        double framesPerSecond;
+        // steps the last frame ran
+        int lastSteps;
+        // time thrown away by frames over the limit
+        double droppedMilliseconds;
+    };
+
+    // stepsPerSecond sets the fixed simulation timestep
+    FrameClock(int stepsPerSecond);
+
+    // Start a frame: read the clock and bank the time since the last one
+    void BeginFrame();
+    // Take one step from the bank; false once less than a step is left
+    bool Step();
+
+    double GetStepSeconds() const;
+    // Seconds since construction, as of BeginFrame()
+    double GetTime() const;
+    // Seconds of simulation run so far, a whole number of steps
+    double GetSimulationTime() const;
+    // Fraction of a step banked past the latest step, 0 to 1
+    double GetAlpha() const;
+    // Simulation time the drawn frame stands for, between the latest
+    // step and the next
+    double GetInterpolatedTime() const;
+
+    const FRAME_STATS& GetStats() const { return m_stats; }
+
+private:
+    // frames the windowed stats cover
+    static const int STATS_FRAMES = 120;
+
+    // nanoseconds since construction
+    int64_t Now() const;
+    // fold one frame's length into m_stats
+    void RecordFrame(int64_t nanoseconds);
+
+    std::chrono::steady_clock::time_point m_start;
+    int64_t m_stepNanoseconds;
+    int64_t m_frameStart;
+    // banked time not yet stepped
+    int64_t m_accumulator;
+    uint64_t m_stepCount;
+
+    // recent frame lengths, a ring of STATS_FRAMES
+    std::vector<int64_t> m_frameTimes;
+    FRAME_STATS m_stats;
+};
@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////////////
+// GLStateCache.cpp
+// ============
+// Thin layer between the managers and OpenGL that shadows GL state and
+// shader uniforms, and drops calls that wouldn't change anything.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLStateCache.h"
+#include "ShaderManager.h"
+
+#include <cstring>
+
+/***********************************************************
+ * GLStateCache()
+ * Everything starts out unknown.
+ ***********************************************************/
+GLStateCache::GLStateCache()
+    : m_bFilterEnabled(true)
+{
+    m_frameStats.issued = m_frameStats.elided = m_frameStats.redundant = 0;
+    m_lastFrameStats = m_frameStats;
+    Invalidate();
+}
+
+/***********************************************************
+ * Invalidate()
+ * Drops every shadow value so the next call of each kind
+ * goes through to GL.
+ ***********************************************************/
+void GLStateCache::Invalidate()
+{
+    m_capabilities.clear();
+
+    m_bClearColorKnown = false;
+    m_clearColor = glm::vec4(0.0f);
+    m_bDepthFuncKnown = false;
+    m_depthFunc = GL_LESS;
+    m_bDepthMaskKnown = false;
+    m_bDepthMask = GL_TRUE;
+    m_bColorMaskKnown = false;
+    m_colorMask[0] = m_colorMask[1] = m_colorMask[2] = m_colorMask[3] = GL_TRUE;
+    m_bCullFaceKnown = false;
+    m_cullFace = GL_BACK;
+    m_bFrontFaceKnown = false;
+    m_frontFace = GL_CCW;
+    m_bBlendFuncKnown = false;
+    m_blendSource = GL_ONE;
+    m_blendDest = GL_ZERO;
+    m_bPolygonOffsetKnown = false;
+    m_polygonOffsetFactor = 0.0f;
+    m_polygonOffsetUnits = 0.0f;
+
+    m_activeTextureUnit = -1;
+    for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+    {
+        m_textureKnown[i] = false;
+        m_boundTextures[i] = 0;
+    }
+
+    m_pBoundShader = nullptr;
+    m_uniforms.clear();
+}
+
+/***********************************************************
+ * BeginFrame()
+ * Publishes the counts for the frame that just ended.
+ ***********************************************************/
+void GLStateCache::BeginFrame()
+{
+    m_lastFrameStats = m_frameStats;
+    m_frameStats.issued = 0;
+    m_frameStats.elided = 0;
+    m_frameStats.redundant = 0;
+}
+
+/***********************************************************
+ * ShouldIssue()
+ * Every call through the cache ends up here exactly once.
+ * A call is issued when it changes something, or always
+ * when filtering is switched off.
+ ***********************************************************/
+bool GLStateCache::ShouldIssue(bool bChanged)
+{
+    if (!bChanged)
+        m_frameStats.redundant++;
+
+    if (bChanged || !m_bFilterEnabled)
+    {
+        m_frameStats.issued++;
+        return true;
+    }
+    m_frameStats.elided++;
+    return false;
+}
+
+/***********************************************************
+ * Enable() / Disable() / SetCapability()
+ ***********************************************************/
+void GLStateCache::Enable(GLenum capability)
+{
+    SetCapability(capability, true);
+}
+
+void GLStateCache::Disable(GLenum capability)
+{
+    SetCapability(capability, false);
+}
+
+void GLStateCache::SetCapability(GLenum capability, bool bEnabled)
+{
+    auto found = m_capabilities.find(capability);
+    bool bChanged = (found == m_capabilities.end()) || (found->second != bEnabled);
+    m_capabilities[capability] = bEnabled;
+
+    if (ShouldIssue(bChanged))
+    {
+        if (bEnabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+}
+
+/***********************************************************
+ * IsCapabilityEnabled()
+ * Avoids a glIsEnabled() round trip once the value is known.
+ ***********************************************************/
+bool GLStateCache::IsCapabilityEnabled(GLenum capability)
+{
+    auto found = m_capabilities.find(capability);
+    if (found != m_capabilities.end())
+        return found->second;
+
+    bool bEnabled = glIsEnabled(capability) == GL_TRUE;
+    m_capabilities[capability] = bEnabled;
+    return bEnabled;
+}
+
+/***********************************************************
+ * ClearColor()
+ ***********************************************************/
+void GLStateCache::ClearColor(float red, float green, float blue, float alpha)
+{
+    glm::vec4 color(red, green, blue, alpha);
+    bool bChanged = !m_bClearColorKnown || m_clearColor != color;
+    m_bClearColorKnown = true;
+    m_clearColor = color;
+
+    if (ShouldIssue(bChanged))
+        glClearColor(red, green, blue, alpha);
+}
+
+/***********************************************************
+ * DepthFunc() / DepthMask() / ColorMask()
+ ***********************************************************/
+void GLStateCache::DepthFunc(GLenum func)
+{
+    bool bChanged = !m_bDepthFuncKnown || m_depthFunc != func;
+    m_bDepthFuncKnown = true;
+    m_depthFunc = func;
+
+    if (ShouldIssue(bChanged))
+        glDepthFunc(func);
+}
+
+void GLStateCache::DepthMask(GLboolean bWrite)
+{
+    bool bChanged = !m_bDepthMaskKnown || m_bDepthMask != bWrite;
+    m_bDepthMaskKnown = true;
+    m_bDepthMask = bWrite;
+
+    if (ShouldIssue(bChanged))
+        glDepthMask(bWrite);
+}
+
+void GLStateCache::ColorMask(GLboolean bRed, GLboolean bGreen, GLboolean bBlue, GLboolean bAlpha)
+{
+    bool bChanged = !m_bColorMaskKnown ||
+                    m_colorMask[0] != bRed || m_colorMask[1] != bGreen ||
+                    m_colorMask[2] != bBlue || m_colorMask[3] != bAlpha;
+    m_bColorMaskKnown = true;
+    m_colorMask[0] = bRed;
+    m_colorMask[1] = bGreen;
+    m_colorMask[2] = bBlue;
+    m_colorMask[3] = bAlpha;
+
+    if (ShouldIssue(bChanged))
+        glColorMask(bRed, bGreen, bBlue, bAlpha);
+}
+
+/***********************************************************
+ * CullFace() / FrontFace() / GetFrontFace()
+ ***********************************************************/
+void GLStateCache::CullFace(GLenum face)
+{
+    bool bChanged = !m_bCullFaceKnown || m_cullFace != face;
+    m_bCullFaceKnown = true;
+    m_cullFace = face;
+
+    if (ShouldIssue(bChanged))
+        glCullFace(face);
+}
+
+void GLStateCache::FrontFace(GLenum winding)
+{
+    bool bChanged = !m_bFrontFaceKnown || m_frontFace != winding;
+    m_bFrontFaceKnown = true;
+    m_frontFace = winding;
+
+    if (ShouldIssue(bChanged))
+        glFrontFace(winding);
+}
+
+GLenum GLStateCache::GetFrontFace()
+{
+    if (!m_bFrontFaceKnown)
+    {
+        GLint winding = GL_CCW;
+        glGetIntegerv(GL_FRONT_FACE, &winding);
+        m_bFrontFaceKnown = true;
+        m_frontFace = (GLenum)winding;
+    }
+    return m_frontFace;
+}
+
+/***********************************************************
+ * BlendFunc()
+ ***********************************************************/
+void GLStateCache::BlendFunc(GLenum sourceFactor, GLenum destFactor)
+{
+    bool bChanged = !m_bBlendFuncKnown || m_blendSource != sourceFactor || m_blendDest != destFactor;
+    m_bBlendFuncKnown = true;
+    m_blendSource = sourceFactor;
+    m_blendDest = destFactor;
+
+    if (ShouldIssue(bChanged))
+        glBlendFunc(sourceFactor, destFactor);
+}
+
+/***********************************************************
+ * PolygonOffset()
+ ***********************************************************/
+void GLStateCache::PolygonOffset(float factor, float units)
+{
+    bool bChanged = !m_bPolygonOffsetKnown || m_polygonOffsetFactor != factor || m_polygonOffsetUnits != units;
+    m_bPolygonOffsetKnown = true;
+    m_polygonOffsetFactor = factor;
+    m_polygonOffsetUnits = units;
+
+    if (ShouldIssue(bChanged))
+        glPolygonOffset(factor, units);
+}
+
+/***********************************************************
+ * BindTexture2D()
+ * Switches the active unit only when the binding actually
+ * has to change.
+ ***********************************************************/
+void GLStateCache::BindTexture2D(int unit, GLuint texture)
+{
+    if (unit < 0 || unit >= MAX_TEXTURE_UNITS)
+        return;
+
+    bool bChanged = !m_textureKnown[unit] || m_boundTextures[unit] != texture;
+    m_textureKnown[unit] = true;
+    m_boundTextures[unit] = texture;
+
+    if (!ShouldIssue(bChanged))
+        return;
+
+    if (m_activeTextureUnit != unit)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeTextureUnit = unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+GLuint GLStateCache::GetBoundTexture2D(int unit) const
+{
+    if (unit < 0 || unit >= MAX_TEXTURE_UNITS)
+        return 0;
+    return m_boundTextures[unit];
+}
+
+/***********************************************************
+ * UseProgram()
+ ***********************************************************/
+void GLStateCache::UseProgram(ShaderManager* pShader)
+{
+    if (pShader == nullptr)
+        return;
+
+    bool bChanged = (m_pBoundShader != pShader);
+    m_pBoundShader = pShader;
+
+    if (ShouldIssue(bChanged))
+        pShader->use();
+}
+
+/***********************************************************
+ * UniformChanged()
+ * Compares a uniform's new value with the last one sent to
+ * the same program, and stores the new value.
+ ***********************************************************/
+bool GLStateCache::UniformChanged(ShaderManager* pShader, const std::string& name, const float* data, int count)
+{
+    UNIFORM_VALUE& stored = m_uniforms[pShader][name];
+    bool bChanged = (stored.count != count) ||
+                    (std::memcmp(stored.data, data, count * sizeof(float)) != 0);
+    if (bChanged)
+    {
+        std::memcpy(stored.data, data, count * sizeof(float));
+        stored.count = count;
+    }
+    return bChanged;
+}
+
+/***********************************************************
+ * Uniform setters
+ * Same names and arguments as ShaderManager's, plus the
+ * shader they belong to.
+ ***********************************************************/
+void GLStateCache::SetBoolValue(ShaderManager* pShader, const std::string& name, bool value)
+{
+    float data = 0.0f;
+    int bits = value ? 1 : 0;
+    std::memcpy(&data, &bits, sizeof(float));
+    if (ShouldIssue(UniformChanged(pShader, name, &data, 1)))
+        pShader->setBoolValue(name, value);
+}
+
+void GLStateCache::SetIntValue(ShaderManager* pShader, const std::string& name, int value)
+{
+    float data = 0.0f;
+    std::memcpy(&data, &value, sizeof(float));
+    if (ShouldIssue(UniformChanged(pShader, name, &data, 1)))
+        pShader->setIntValue(name, value);
+}
+
+void GLStateCache::SetFloatValue(ShaderManager* pShader, const std::string& name, float value)
+{
+    if (ShouldIssue(UniformChanged(pShader, name, &value, 1)))
+        pShader->setFloatValue(name, value);
+}
+
+void GLStateCache::SetVec2Value(ShaderManager* pShader, const std::string& name, const glm::vec2& value)
+{
+    float data[2] = { value.x, value.y };
+    if (ShouldIssue(UniformChanged(pShader, name, data, 2)))
+        pShader->setVec2Value(name, value);
+}
+
+void GLStateCache::SetVec3Value(ShaderManager* pShader, const std::string& name, const glm::vec3& value)
+{
+    float data[3] = { value.x, value.y, value.z };
+    if (ShouldIssue(UniformChanged(pShader, name, data, 3)))
+        pShader->setVec3Value(name, value);
+}
+
+void GLStateCache::SetVec3Value(ShaderManager* pShader, const std::string& name, float x, float y, float z)
+{
+    SetVec3Value(pShader, name, glm::vec3(x, y, z));
+}
+
+void GLStateCache::SetVec4Value(ShaderManager* pShader, const std::string& name, const glm::vec4& value)
+{
+    float data[4] = { value.x, value.y, value.z, value.w };
+    if (ShouldIssue(UniformChanged(pShader, name, data, 4)))
+        pShader->setVec4Value(name, value);
+}
+
+void GLStateCache::SetMat4Value(ShaderManager* pShader, const std::string& name, const glm::mat4& value)
+{
+    float data[16];
+    for (int column = 0; column < 4; column++)
+        for (int row = 0; row < 4; row++)
+            data[column * 4 + row] = value[column][row];
+    if (ShouldIssue(UniformChanged(pShader, name, data, 16)))
+        pShader->setMat4Value(name, value);
+}
+
+void GLStateCache::SetSampler2DValue(ShaderManager* pShader, const std::string& name, int unit)
+{
+    float data = 0.0f;
+    std::memcpy(&data, &unit, sizeof(float));
+    if (ShouldIssue(UniformChanged(pShader, name, &data, 1)))
+        pShader->setSampler2DValue(name, unit);
+}
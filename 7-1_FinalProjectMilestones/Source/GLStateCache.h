@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// GLStateCache.h
+// ============
+// Thin layer between the managers and OpenGL that shadows GL state and
+// shader uniforms, and drops calls that wouldn't change anything.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+
+class ShaderManager;
+
+/***********************************************************
+ *  GLStateCache
+ *
+ *  Remembers the last value sent for the bound program,
+ *  texture bindings, enables, a handful of fixed-function
+ *  settings, and every uniform of every program set through
+ *  it. A call that matches the shadow copy is elided. State
+ *  starts out unknown, so the first call of each kind always
+ *  goes through.
+ *
+ *  Only state changed through the cache is tracked — code
+ *  that calls GL directly must call Invalidate() afterwards.
+ *  Uniform setters assume the program is already bound via
+ *  UseProgram(), same as ShaderManager's setters.
+ ***********************************************************/
+class GLStateCache
+{
+public:
+    // constructor
+    GLStateCache();
+
+    // calls sent to GL versus dropped; redundant counts calls that
+    // matched the shadow copy whether or not filtering dropped them
+    struct STATE_STATS
+    {
+        int issued;
+        int elided;
+        int redundant;
+    };
+
+    // With filtering off every call is issued, but the shadow copy is
+    // still kept so switching it back on is safe
+    void SetFilterEnabled(bool bEnabled) { m_bFilterEnabled = bEnabled; }
+    bool IsFilterEnabled() const { return m_bFilterEnabled; }
+    // Forget everything, e.g. after GL was changed behind our back
+    void Invalidate();
+    // Start counting a new frame; the finished one moves to GetLastFrameStats()
+    void BeginFrame();
+    const STATE_STATS& GetLastFrameStats() const { return m_lastFrameStats; }
+
+    // Capabilities (GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, ...)
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+    void SetCapability(GLenum capability, bool bEnabled);
+    // Shadow copy when known, otherwise asks GL once
+    bool IsCapabilityEnabled(GLenum capability);
+
+    // Fixed-function settings
+    void ClearColor(float red, float green, float blue, float alpha);
+    void DepthFunc(GLenum func);
+    void DepthMask(GLboolean bWrite);
+    void ColorMask(GLboolean bRed, GLboolean bGreen, GLboolean bBlue, GLboolean bAlpha);
+    void CullFace(GLenum face);
+    void FrontFace(GLenum winding);
+    GLenum GetFrontFace();
+    void BlendFunc(GLenum sourceFactor, GLenum destFactor);
+    // takes effect only while GL_POLYGON_OFFSET_FILL is enabled
+    void PolygonOffset(float factor, float units);
+
+    // Textures — unit is an index, not GL_TEXTURE0 + index
+    void BindTexture2D(int unit, GLuint texture);
+    GLuint GetBoundTexture2D(int unit) const;
+
+    // Programs and uniforms
+    void UseProgram(ShaderManager* pShader);
+    void SetBoolValue(ShaderManager* pShader, const std::string& name, bool value);
+    void SetIntValue(ShaderManager* pShader, const std::string& name, int value);
+    void SetFloatValue(ShaderManager* pShader, const std::string& name, float value);
+    void SetVec2Value(ShaderManager* pShader, const std::string& name, const glm::vec2& value);
+    void SetVec3Value(ShaderManager* pShader, const std::string& name, const glm::vec3& value);
+    void SetVec3Value(ShaderManager* pShader, const std::string& name, float x, float y, float z);
+    void SetVec4Value(ShaderManager* pShader, const std::string& name, const glm::vec4& value);
+    void SetMat4Value(ShaderManager* pShader, const std::string& name, const glm::mat4& value);
+    void SetSampler2DValue(ShaderManager* pShader, const std::string& name, int unit);
+
+private:
+    static const int MAX_TEXTURE_UNITS = 32;
+
+    // raw bits of one uniform's last value (ints are stored bit for bit)
+    struct UNIFORM_VALUE
+    {
+        float data[16];
+        int count;
+    };
+
+    // Count one call; returns true if it has to reach GL
+    bool ShouldIssue(bool bChanged);
+    // Compare against and update a uniform's shadow copy
+    bool UniformChanged(ShaderManager* pShader, const std::string& name, const float* data, int count);
+
+    bool m_bFilterEnabled;
+    STATE_STATS m_frameStats;
+    STATE_STATS m_lastFrameStats;
+
+    std::unordered_map<GLenum, bool> m_capabilities;
+
+    // fixed-function shadows, each with a "known" flag
+    bool m_bClearColorKnown;
+    glm::vec4 m_clearColor;
+    bool m_bDepthFuncKnown;
+    GLenum m_depthFunc;
+    bool m_bDepthMaskKnown;
+    GLboolean m_bDepthMask;
+    bool m_bColorMaskKnown;
+    GLboolean m_colorMask[4];
+    bool m_bCullFaceKnown;
+    GLenum m_cullFace;
+    bool m_bFrontFaceKnown;
+    GLenum m_frontFace;
+    bool m_bBlendFuncKnown;
+    GLenum m_blendSource;
+    GLenum m_blendDest;
+    bool m_bPolygonOffsetKnown;
+    float m_polygonOffsetFactor;
+    float m_polygonOffsetUnits;
+
+    // texture unit shadows; -1 active unit means unknown
+    int m_activeTextureUnit;
+    bool m_textureKnown[MAX_TEXTURE_UNITS];
+    GLuint m_boundTextures[MAX_TEXTURE_UNITS];
+
+    // bound program, nullptr when unknown
+    ShaderManager* m_pBoundShader;
+    std::unordered_map<const ShaderManager*, std::unordered_map<std::string, UNIFORM_VALUE>> m_uniforms;
+};
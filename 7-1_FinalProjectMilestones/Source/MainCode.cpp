@@ -9,6 +9,8 @@
 
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <string>
+#include <vector>
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -22,6 +24,16 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "RenderSettings.h"
+#include "GLStateCache.h"
+#include "EntityStore.h"
+#include "MeshImporter.h"
+#include "PlantGenerator.h"
+#include "SceneBVH.h"
+#include "ShapeRaycast.h"
+#include "StressTest.h"
+#include "ResolutionScaler.h"
+#include "FrameClock.h"
 
 // Namespace for declaring global variables
 namespace
@@ -29,6 +41,9 @@ namespace
 	// Macro for window title
 	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
 
+	// fixed simulation steps per second, whatever the frame rate
+	const int SIMULATION_STEPS_PER_SECOND = 120;
+
 	// Main GLFW window
 	GLFWwindow* g_Window = nullptr;
 
@@ -36,8 +51,20 @@ namespace
 	SceneManager* g_SceneManager = nullptr;
 	// shader manager object for dynamic interaction with the shader code
 	ShaderManager* g_ShaderManager = nullptr;
+	// position-only shader for the optional depth pre-pass
+	ShaderManager* g_DepthShaderManager = nullptr;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+	// set by --stress to step through tiled scenes and log each
+	StressTest* g_StressTest = nullptr;
+	// runtime render toggles shared by the view and scene managers
+	RENDER_SETTINGS g_RenderSettings;
+	// shadow of GL state so redundant calls can be dropped
+	GLStateCache g_StateCache;
+	// scales the render resolution to hold the frame time
+	ResolutionScaler* g_ResolutionScaler = nullptr;
+	// frame timing and the fixed-step simulation clock
+	FrameClock* g_FrameClock = nullptr;
 }
 
 // Function declarations - all functions that are called manually
@@ -54,6 +81,55 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// --bench-import [mesh files] times the mesh importer and exits
+	// without opening a window
+	if (argc > 1 && std::string(argv[1]) == "--bench-import")
+	{
+		MeshImporter::RunBenchmark(std::vector<std::string>(argv + 2, argv + argc));
+		return(EXIT_SUCCESS);
+	}
+
+	// --compile-scene [scene] [output] writes the compiled binary form of
+	// a text scene (scenes/kitchen.scene by default) and exits
+	if (argc > 1 && std::string(argv[1]) == "--compile-scene")
+	{
+		std::string scenePath = (argc > 2) ? argv[2] : "scenes/kitchen.scene";
+		std::string binaryPath = (argc > 3) ? argv[3] : scenePath + "b";
+		return SceneManager::CompileSceneFile(scenePath, binaryPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// --bench-plants [preset] times plant generation at increasing
+	// iterations and exits
+	if (argc > 1 && std::string(argv[1]) == "--bench-plants")
+	{
+		PlantGenerator::RunBenchmark(std::vector<std::string>(argv + 2, argv + argc));
+		return(EXIT_SUCCESS);
+	}
+
+	// --bench-entities [entity counts] times entity creation, iteration
+	// and destruction at each count and exits
+	if (argc > 1 && std::string(argv[1]) == "--bench-entities")
+	{
+		EntityStore::RunBenchmark(std::vector<std::string>(argv + 2, argv + argc));
+		return(EXIT_SUCCESS);
+	}
+
+	// --bench-bvh [box counts] times BVH builds, refits and queries at
+	// each count against a linear scan and exits
+	if (argc > 1 && std::string(argv[1]) == "--bench-bvh")
+	{
+		SceneBVH::RunBenchmark(std::vector<std::string>(argv + 2, argv + argc));
+		return(EXIT_SUCCESS);
+	}
+
+	// --bench-pick [shape counts] times exact picking through a BVH of
+	// that many shapes against picking by bounds alone and exits
+	if (argc > 1 && std::string(argv[1]) == "--bench-pick")
+	{
+		ShapeRaycast::RunBenchmark(std::vector<std::string>(argv + 2, argv + argc));
+		return(EXIT_SUCCESS);
+	}
+
 	// if GLFW fails initialization, then terminate the application
 	if (InitializeGLFW() == false)
 	{
@@ -65,6 +141,8 @@ int main(int argc, char* argv[])
 	// try to create a new view manager object
 	g_ViewManager = new ViewManager(
 		g_ShaderManager);
+	g_ViewManager->SetRenderSettings(&g_RenderSettings);
+	g_ViewManager->SetStateCache(&g_StateCache);
 
 	// try to create the main display window
 	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
@@ -79,30 +157,93 @@ int main(int argc, char* argv[])
 	g_ShaderManager->LoadShaders(
 		"../../Utilities/shaders/vertexShader.glsl",
 		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
+
+	// the depth pre-pass shader ships with the project
+	g_DepthShaderManager = new ShaderManager();
+	g_DepthShaderManager->LoadShaders(
+		"shaders/depthVertexShader.glsl",
+		"shaders/depthFragmentShader.glsl");
+	g_StateCache.UseProgram(g_ShaderManager);
 
 	// try to create a new scene manager object and prepare the 3D scene
 	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager->SetRenderSettings(&g_RenderSettings);
+	g_SceneManager->SetStateCache(&g_StateCache);
+	g_SceneManager->SetDepthShader(g_DepthShaderManager);
 	g_SceneManager->PrepareScene();
 	g_SceneManager->LoadSceneTextures();  // Load textures after preparing scene
 
+	// --bench-scene [object counts] times text against binary scene loads
+	// through to populated entities at each count, then exits; it needs
+	// the textures and materials the loads resolve tags against
+	if (argc > 1 && std::string(argv[1]) == "--bench-scene")
+	{
+		g_SceneManager->RunSceneBenchmark(std::vector<std::string>(argv + 2, argv + argc));
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+
+	// --stress [object counts] renders tiled copies of the scene at each
+	// count, logs frame time, draw calls and memory, and exits
+	if (argc > 1 && std::string(argv[1]) == "--stress")
+	{
+		g_StressTest = new StressTest(g_SceneManager, std::vector<std::string>(argv + 2, argv + argc));
+		// don't let vsync cap the frame times, or the resolution scaler
+		// hide them
+		glfwSwapInterval(0);
+		g_RenderSettings.bDynamicResolution = false;
+	}
+
+	g_ResolutionScaler = new ResolutionScaler();
+	g_FrameClock = new FrameClock(SIMULATION_STEPS_PER_SECOND);
+
 	// loop will keep running until the application is closed 
 	// or until an error has occurred
 	while (!glfwWindowShouldClose(g_Window))
 	{
+		// bank the time since the last frame and run the simulation
+		// steps it pays for, then draw between the last two
+		g_FrameClock->BeginFrame();
+		while (g_FrameClock->Step())
+			g_ViewManager->StepSimulation(g_FrameClock->GetStepSeconds());
+		g_SceneManager->SetSimulationTime(g_FrameClock->GetInterpolatedTime());
+
+		// Start a new frame of issued / elided state call counts
+		g_StateCache.BeginFrame();
+		if (g_StressTest)
+			g_StressTest->BeginFrame();
+
+		// point the frame at the scaled target, or the window
+		g_ResolutionScaler->BeginFrame(
+			g_ViewManager->GetFramebufferWidth(),
+			g_ViewManager->GetFramebufferHeight(),
+			g_RenderSettings.bDynamicResolution);
+
 		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
+		g_StateCache.Enable(GL_DEPTH_TEST);
 
 		// Clear the frame and z buffers
-		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		g_StateCache.ClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
+		g_ViewManager->PrepareSceneView(g_FrameClock->GetAlpha());
+		// hand the same camera to the scene for CPU-side culling
+		g_SceneManager->SetViewMatrices(
+			g_ViewManager->GetViewMatrix(),
+			g_ViewManager->GetProjectionMatrix());
+		// a click selects whatever is under the cursor
+		glm::vec2 pickPoint;
+		if (g_ViewManager->TakePickRequest(pickPoint))
+			g_SceneManager->SelectEntityAt(pickPoint);
 
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
+		// upscale to the window
+		g_ResolutionScaler->EndFrame();
 
+		// stop once the stress test has logged every count
+		if (g_StressTest && !g_StressTest->EndFrame())
+			break;
 
 		// Flips the the back buffer with the front buffer every frame.
 		glfwSwapBuffers(g_Window);
@@ -111,7 +252,30 @@ int main(int argc, char* argv[])
 		glfwPollEvents();
 	}
 
+	// frame timing over the run
+	const FrameClock::FRAME_STATS& frameStats = g_FrameClock->GetStats();
+	std::cout << "INFO: " << frameStats.frames << " frames, " << frameStats.steps
+		<< " simulation steps; recent frames " << frameStats.averageMilliseconds << " ms average ("
+		<< frameStats.framesPerSecond << " fps), " << frameStats.minMilliseconds << " to "
+		<< frameStats.maxMilliseconds << " ms; " << frameStats.droppedMilliseconds
+		<< " ms dropped from overlong frames" << std::endl;
+
 	// clear the allocated manager objects from memory
+	if (NULL != g_StressTest)
+	{
+		delete g_StressTest;
+		g_StressTest = NULL;
+	}
+	if (NULL != g_FrameClock)
+	{
+		delete g_FrameClock;
+		g_FrameClock = NULL;
+	}
+	if (NULL != g_ResolutionScaler)
+	{
+		delete g_ResolutionScaler;
+		g_ResolutionScaler = NULL;
+	}
 	if (NULL != g_SceneManager)
 	{
 		delete g_SceneManager;
@@ -127,6 +291,11 @@ int main(int argc, char* argv[])
 		delete g_ShaderManager;
 		g_ShaderManager = NULL;
 	}
+	if (NULL != g_DepthShaderManager)
+	{
+		delete g_DepthShaderManager;
+		g_DepthShaderManager = NULL;
+	}
 
 	// Terminates the program successfully
 	exit(EXIT_SUCCESS); 
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile.cpp
+// ============
+// Read-only memory-mapped file, using mmap() on macOS/Linux and a file
+// mapping object on Windows.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/***********************************************************
+ * MappedFile()
+ ***********************************************************/
+MappedFile::MappedFile()
+    : m_pData(nullptr)
+    , m_size(0)
+#ifdef _WIN32
+    , m_fileHandle(INVALID_HANDLE_VALUE)
+    , m_mappingHandle(nullptr)
+#endif
+{
+}
+
+/***********************************************************
+ * ~MappedFile()
+ ***********************************************************/
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+/***********************************************************
+ * Open()
+ * Windows: file handle -> mapping object -> view of the
+ * whole file. All three stay open until Close().
+ ***********************************************************/
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (pView == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_pData = (const unsigned char*)pView;
+    m_size = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+/***********************************************************
+ * Close()
+ ***********************************************************/
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+        UnmapViewOfFile(m_pData);
+    if (m_mappingHandle != nullptr)
+        CloseHandle((HANDLE)m_mappingHandle);
+    if (m_fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle((HANDLE)m_fileHandle);
+
+    m_pData = nullptr;
+    m_size = 0;
+    m_mappingHandle = nullptr;
+    m_fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+/***********************************************************
+ * Open()
+ * POSIX: the descriptor can be closed right after mmap(),
+ * the mapping keeps the file alive on its own.
+ ***********************************************************/
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size <= 0)
+    {
+        close(descriptor);
+        return false;
+    }
+
+    void* pView = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (pView == MAP_FAILED)
+        return false;
+
+    m_pData = (const unsigned char*)pView;
+    m_size = (size_t)info.st_size;
+    return true;
+}
+
+/***********************************************************
+ * Close()
+ ***********************************************************/
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+        munmap((void*)m_pData, m_size);
+
+    m_pData = nullptr;
+    m_size = 0;
+}
+
+#endif
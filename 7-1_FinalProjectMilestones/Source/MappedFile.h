@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile.h
+// ============
+// Read-only memory-mapped file, using mmap() on macOS/Linux and a file
+// mapping object on Windows.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/***********************************************************
+ *  MappedFile
+ *
+ *  Maps a whole file into memory so its contents can be
+ *  handed straight to GL without a copy through our own
+ *  buffers. The mapping lives until Close() or destruction.
+ *  Not copyable.
+ ***********************************************************/
+class MappedFile
+{
+public:
+    // constructor
+    MappedFile();
+    // destructor
+    ~MappedFile();
+
+    // Map the file at path; returns false (and stays closed) if it
+    // can't be opened or is empty
+    bool Open(const std::string& path);
+    // Unmap and close the file; safe to call when nothing is open
+    void Close();
+
+    bool IsOpen() const { return m_pData != nullptr; }
+    const unsigned char* GetData() const { return m_pData; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* m_pData;
+    size_t m_size;
+
+#ifdef _WIN32
+    // HANDLEs, kept as void* so this header doesn't pull in windows.h
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+};
@@ -0,0 +1,201 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshCache.cpp
+// ============
+// Binary on-disk format for generated meshes, so they can be mapped and
+// uploaded directly on later starts instead of being rebuilt.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshCache.h"
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    // "MESH" read as a little-endian uint32; reads back scrambled on a
+    // machine with the other byte order, which Read() treats as stale
+    const uint32_t MESH_FILE_MAGIC = 0x4853454D;
+    const int MAX_ATTRIBUTES = 4;
+
+    // where one vertex attribute sits inside a vertex
+    struct ATTRIBUTE_LAYOUT
+    {
+        uint32_t location;
+        uint32_t components;
+        uint32_t glType;
+        uint32_t offset;
+    };
+
+    // Everything in the header is 32-bit so there's no padding to
+    // worry about between compilers
+    struct MESH_FILE_HEADER
+    {
+        uint32_t magic;
+        uint32_t formatVersion;
+        uint32_t generatorVersion;
+        uint32_t vertexStride;
+        uint32_t attributeCount;
+        ATTRIBUTE_LAYOUT attributes[MAX_ATTRIBUTES];
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexType;
+        MeshLibrary::INDEX_RANGE sides;
+        MeshLibrary::INDEX_RANGE topCap;
+        MeshLibrary::INDEX_RANGE bottomCap;
+        // byte offsets from the start of the file
+        uint32_t vertexOffset;
+        uint32_t indexOffset;
+        uint32_t fileSize;
+    };
+
+    // blobs start on 16-byte boundaries so the mapped pointers are
+    // suitably aligned for any attribute type
+    const uint32_t BLOB_ALIGNMENT = 16;
+
+    uint32_t AlignUp(uint32_t value)
+    {
+        return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    }
+
+    // Header fields that depend on the vertex layout this build uses
+    void FillLayout(MESH_FILE_HEADER& header)
+    {
+        header.vertexStride = sizeof(MeshLibrary::MESH_VERTEX);
+        header.attributeCount = 3;
+
+        ATTRIBUTE_LAYOUT position = { 0, 3, GL_FLOAT, (uint32_t)offsetof(MeshLibrary::MESH_VERTEX, position) };
+        ATTRIBUTE_LAYOUT normal   = { 1, 3, GL_FLOAT, (uint32_t)offsetof(MeshLibrary::MESH_VERTEX, normal) };
+        ATTRIBUTE_LAYOUT uv       = { 2, 2, GL_FLOAT, (uint32_t)offsetof(MeshLibrary::MESH_VERTEX, uv) };
+        header.attributes[0] = position;
+        header.attributes[1] = normal;
+        header.attributes[2] = uv;
+        header.indexType = GL_UNSIGNED_INT;
+    }
+
+    bool RangeFits(const MeshLibrary::INDEX_RANGE& range, uint32_t indexCount)
+    {
+        return range.first <= indexCount && range.count <= indexCount - range.first;
+    }
+}
+
+/***********************************************************
+ * EnsureDirectory()
+ * Only creates the last path component — the cache lives
+ * one level under the working directory.
+ ***********************************************************/
+bool MeshCache::EnsureDirectory(const std::string& directory)
+{
+#ifdef _WIN32
+    int result = _mkdir(directory.c_str());
+#else
+    int result = mkdir(directory.c_str(), 0755);
+#endif
+    return result == 0 || errno == EEXIST;
+}
+
+/***********************************************************
+ * Write()
+ * Header, then the vertex blob, then the index blob, each
+ * padded out to BLOB_ALIGNMENT.
+ ***********************************************************/
+bool MeshCache::Write(const std::string& path, const MeshLibrary::MESH_DATA& mesh, uint32_t generatorVersion)
+{
+    MESH_FILE_HEADER header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MESH_FILE_MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    header.generatorVersion = generatorVersion;
+    FillLayout(header);
+    header.vertexCount = (uint32_t)mesh.vertices.size();
+    header.indexCount = (uint32_t)mesh.indices.size();
+    header.sides = mesh.sides;
+    header.topCap = mesh.topCap;
+    header.bottomCap = mesh.bottomCap;
+
+    uint32_t vertexBytes = header.vertexCount * header.vertexStride;
+    uint32_t indexBytes = header.indexCount * (uint32_t)sizeof(uint32_t);
+    header.vertexOffset = AlignUp(sizeof(MESH_FILE_HEADER));
+    header.indexOffset = AlignUp(header.vertexOffset + vertexBytes);
+    header.fileSize = header.indexOffset + indexBytes;
+
+    std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!stream)
+        return false;
+
+    const char padding[BLOB_ALIGNMENT] = {};
+    stream.write((const char*)&header, sizeof(header));
+    stream.write(padding, header.vertexOffset - sizeof(header));
+    stream.write((const char*)mesh.vertices.data(), vertexBytes);
+    stream.write(padding, header.indexOffset - (header.vertexOffset + vertexBytes));
+    stream.write((const char*)mesh.indices.data(), indexBytes);
+    return (bool)stream;
+}
+
+/***********************************************************
+ * Read()
+ * Checks the header against this build before trusting any
+ * offsets, so a truncated or outdated file is just a miss.
+ ***********************************************************/
+bool MeshCache::Read(const std::string& path, uint32_t generatorVersion, MappedFile& file, MeshLibrary::MESH_VIEW& view)
+{
+    if (!file.Open(path))
+        return false;
+
+    if (file.GetSize() < sizeof(MESH_FILE_HEADER))
+    {
+        file.Close();
+        return false;
+    }
+
+    MESH_FILE_HEADER header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    MESH_FILE_HEADER expected;
+    std::memset(&expected, 0, sizeof(expected));
+    FillLayout(expected);
+
+    bool bValid =
+        header.magic == MESH_FILE_MAGIC &&
+        header.formatVersion == FORMAT_VERSION &&
+        header.generatorVersion == generatorVersion &&
+        header.vertexStride == expected.vertexStride &&
+        header.attributeCount == expected.attributeCount &&
+        std::memcmp(header.attributes, expected.attributes, sizeof(header.attributes)) == 0 &&
+        header.indexType == expected.indexType &&
+        header.fileSize == file.GetSize() &&
+        header.vertexOffset % BLOB_ALIGNMENT == 0 &&
+        header.indexOffset % BLOB_ALIGNMENT == 0 &&
+        header.vertexOffset >= sizeof(MESH_FILE_HEADER) &&
+        (uint64_t)header.vertexOffset + (uint64_t)header.vertexCount * header.vertexStride <= header.indexOffset &&
+        (uint64_t)header.indexOffset + (uint64_t)header.indexCount * sizeof(uint32_t) <= header.fileSize &&
+        RangeFits(header.sides, header.indexCount) &&
+        RangeFits(header.topCap, header.indexCount) &&
+        RangeFits(header.bottomCap, header.indexCount);
+
+    if (!bValid)
+    {
+        file.Close();
+        return false;
+    }
+
+    view.vertices = (const MeshLibrary::MESH_VERTEX*)(file.GetData() + header.vertexOffset);
+    view.vertexCount = header.vertexCount;
+    view.indices = (const uint32_t*)(file.GetData() + header.indexOffset);
+    view.indexCount = header.indexCount;
+    view.sides = header.sides;
+    view.topCap = header.topCap;
+    view.bottomCap = header.bottomCap;
+    return true;
+}
@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshCache.h
+// ============
+// Binary on-disk format for generated meshes, so they can be mapped and
+// uploaded directly on later starts instead of being rebuilt.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <cstdint>
+#include <string>
+
+class MappedFile;
+
+/***********************************************************
+ *  MeshCache
+ *
+ *  One file per mesh: a fixed-size header describing the
+ *  vertex layout, counts, index ranges and blob offsets,
+ *  followed by the vertex blob and the index blob exactly
+ *  as they go into the GL buffers. Files are written in the
+ *  machine's own byte order.
+ *
+ *  Read() rejects a file whose format version, generator
+ *  version or vertex layout doesn't match what this build
+ *  would write, so stale caches are regenerated rather than
+ *  misread.
+ ***********************************************************/
+class MeshCache
+{
+public:
+    // bump whenever the header or blob layout changes
+    static const uint32_t FORMAT_VERSION = 1;
+
+    // Create the cache directory if it isn't there yet
+    static bool EnsureDirectory(const std::string& directory);
+    // Serialize a generated mesh; returns false if the file couldn't be written
+    static bool Write(const std::string& path, const MeshLibrary::MESH_DATA& mesh, uint32_t generatorVersion);
+    // Map a cache file and point view into it. The view is only valid
+    // while file stays open. Returns false if the file is missing or stale.
+    static bool Read(const std::string& path, uint32_t generatorVersion, MappedFile& file, MeshLibrary::MESH_VIEW& view);
+};
@@ -0,0 +1,1389 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshImporter.cpp
+// ============
+// Wavefront OBJ and glTF 2.0 mesh import, parsed straight out of a
+// memory-mapped file into MeshLibrary's mesh layout.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshImporter.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace
+{
+    // Deepest JSON nesting accepted; glTF never goes past a handful
+    const int MAX_JSON_DEPTH = 64;
+    // Deepest node hierarchy walked, which also stops cycles
+    const int MAX_NODE_DEPTH = 64;
+
+    // glTF constants
+    const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+    const uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+    const uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+    const int GLTF_BYTE = 5120;
+    const int GLTF_UNSIGNED_BYTE = 5121;
+    const int GLTF_SHORT = 5122;
+    const int GLTF_UNSIGNED_SHORT = 5123;
+    const int GLTF_UNSIGNED_INT = 5125;
+    const int GLTF_FLOAT = 5126;
+    const int GLTF_TRIANGLES = 4;
+
+    // Benchmark input: a sphere big enough that the files run to tens
+    // of megabytes, and how many times each file is parsed
+    const char* BENCHMARK_DIRECTORY = "cache";
+    const int BENCHMARK_SECTORS = 768;
+    const int BENCHMARK_STACKS = 384;
+    const int BENCHMARK_RUNS = 5;
+
+    const double POWERS_OF_TEN[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Decimal number at p, advancing past it. strtod() would need a
+    // terminated copy of every token; this reads the mapping directly
+    // and is exact to well under a float ulp for mesh-sized values.
+    bool ParseNumber(const char*& p, const char* end, double& value)
+    {
+        const char* start = p;
+        bool bNegative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            bNegative = (*p == '-');
+            p++;
+        }
+
+        double mantissa = 0.0;
+        int exponent = 0;
+        bool bDigits = false;
+        while (p < end && IsDigit(*p))
+        {
+            mantissa = mantissa * 10.0 + (*p - '0');
+            bDigits = true;
+            p++;
+        }
+        if (p < end && *p == '.')
+        {
+            p++;
+            while (p < end && IsDigit(*p))
+            {
+                mantissa = mantissa * 10.0 + (*p - '0');
+                exponent--;
+                bDigits = true;
+                p++;
+            }
+        }
+        if (!bDigits)
+        {
+            p = start;
+            return false;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            const char* exponentStart = p;
+            p++;
+            bool bExponentNegative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                bExponentNegative = (*p == '-');
+                p++;
+            }
+            if (p < end && IsDigit(*p))
+            {
+                int written = 0;
+                while (p < end && IsDigit(*p))
+                {
+                    if (written < 10000)
+                        written = written * 10 + (*p - '0');
+                    p++;
+                }
+                exponent += bExponentNegative ? -written : written;
+            }
+            else
+            {
+                // "1e" is the number 1 followed by something else
+                p = exponentStart;
+            }
+        }
+
+        if (exponent >= 0 && exponent <= 22)
+            value = mantissa * POWERS_OF_TEN[exponent];
+        else if (exponent < 0 && exponent >= -22)
+            value = mantissa / POWERS_OF_TEN[-exponent];
+        else
+            value = mantissa * std::pow(10.0, exponent);
+
+        if (bNegative)
+            value = -value;
+        return true;
+    }
+
+    bool ParseInteger(const char*& p, const char* end, long long& value)
+    {
+        const char* start = p;
+        bool bNegative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            bNegative = (*p == '-');
+            p++;
+        }
+        if (p >= end || !IsDigit(*p))
+        {
+            p = start;
+            return false;
+        }
+
+        value = 0;
+        while (p < end && IsDigit(*p))
+        {
+            value = value * 10 + (*p - '0');
+            p++;
+        }
+        if (bNegative)
+            value = -value;
+        return true;
+    }
+
+    // ---- OBJ ----------------------------------------------------------
+
+    void SkipSpaces(const char*& p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+    }
+
+    // Moves past the next '\n', or to the end
+    void SkipLine(const char*& p, const char* end)
+    {
+        const void* newline = std::memchr(p, '\n', end - p);
+        p = (newline != nullptr) ? (const char*)newline + 1 : end;
+    }
+
+    bool IsLineEnd(const char* p, const char* end)
+    {
+        return p >= end || *p == '\n' || *p == '\r' || *p == '#';
+    }
+
+    // True if the line at p starts with keyword followed by a space
+    bool MatchKeyword(const char* p, const char* end, const char* keyword)
+    {
+        size_t length = std::strlen(keyword);
+        return (size_t)(end - p) > length &&
+               std::memcmp(p, keyword, length) == 0 &&
+               (p[length] == ' ' || p[length] == '\t');
+    }
+
+    bool ParseFloats(const char*& p, const char* end, int count, std::vector<float>& values)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            double value = 0.0;
+            SkipSpaces(p, end);
+            if (!ParseNumber(p, end, value))
+                return false;
+            values.push_back((float)value);
+        }
+        return true;
+    }
+
+    // 1-based or negative (relative) OBJ index to 0-based; -1 if invalid
+    long long ResolveIndex(long long index, size_t count)
+    {
+        long long resolved = (index > 0) ? index - 1 : (long long)count + index;
+        return (index != 0 && resolved >= 0 && resolved < (long long)count) ? resolved : -1;
+    }
+
+    // One v/vt/vn triple; -1 where the face left an attribute out
+    struct OBJ_CORNER
+    {
+        long long position;
+        long long uv;
+        long long normal;
+
+        bool operator==(const OBJ_CORNER& other) const
+        {
+            return position == other.position && uv == other.uv && normal == other.normal;
+        }
+    };
+
+    struct OBJ_CORNER_HASH
+    {
+        size_t operator()(const OBJ_CORNER& corner) const
+        {
+            uint64_t hash = (uint64_t)corner.position * 0x9E3779B97F4A7C15ull;
+            hash ^= (uint64_t)(corner.uv + 1) * 0xC2B2AE3D27D4EB4Full + (hash << 6) + (hash >> 2);
+            hash ^= (uint64_t)(corner.normal + 1) * 0x165667B19E3779F9ull + (hash << 6) + (hash >> 2);
+            return (size_t)hash;
+        }
+    };
+
+    // ---- JSON ---------------------------------------------------------
+
+    enum JSON_TYPE
+    {
+        JSON_NULL,
+        JSON_BOOL,
+        JSON_NUMBER,
+        JSON_STRING,
+        JSON_ARRAY,
+        JSON_OBJECT
+    };
+
+    // One parsed value. Strings and keys point into the file with their
+    // escapes left in; nothing glTF looks up by name contains any.
+    struct JSON_VALUE
+    {
+        JSON_TYPE type;
+        const char* text;
+        size_t length;
+        const char* key;
+        size_t keyLength;
+        double number;
+        int firstChild;
+        int nextSibling;
+        int childCount;
+    };
+
+    /***********************************************************
+     *  JsonDocument
+     *
+     *  Flat tree of JSON_VALUEs addressed by index; children of
+     *  an array or object are linked through nextSibling.
+     ***********************************************************/
+    class JsonDocument
+    {
+    public:
+        bool Parse(const char* text, size_t size)
+        {
+            m_values.clear();
+            const char* p = text;
+            const char* end = text + size;
+            if (ParseValue(p, end, 0) != 0)
+                return false;
+            SkipWhitespace(p, end);
+            return p == end;
+        }
+
+        const JSON_VALUE& Get(int index) const { return m_values[index]; }
+
+        // Index of the member named key, or -1
+        int GetMember(int object, const char* key) const
+        {
+            if (object < 0 || m_values[object].type != JSON_OBJECT)
+                return -1;
+
+            size_t keyLength = std::strlen(key);
+            for (int child = m_values[object].firstChild; child >= 0; child = m_values[child].nextSibling)
+            {
+                const JSON_VALUE& value = m_values[child];
+                if (value.keyLength == keyLength && std::memcmp(value.key, key, keyLength) == 0)
+                    return child;
+            }
+            return -1;
+        }
+
+        // Every element of an array, so later lookups by position are O(1)
+        void GetElements(int array, std::vector<int>& elements) const
+        {
+            elements.clear();
+            if (array < 0 || m_values[array].type != JSON_ARRAY)
+                return;
+            for (int child = m_values[array].firstChild; child >= 0; child = m_values[child].nextSibling)
+                elements.push_back(child);
+        }
+
+        double GetNumber(int object, const char* key, double fallback) const
+        {
+            int member = GetMember(object, key);
+            return (member >= 0 && m_values[member].type == JSON_NUMBER) ? m_values[member].number : fallback;
+        }
+
+        bool IsString(int value, const char* text) const
+        {
+            if (value < 0 || m_values[value].type != JSON_STRING)
+                return false;
+            size_t length = std::strlen(text);
+            return m_values[value].length == length && std::memcmp(m_values[value].text, text, length) == 0;
+        }
+
+    private:
+        static void SkipWhitespace(const char*& p, const char* end)
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+                p++;
+        }
+
+        // p is on the opening quote; leaves it past the closing one
+        static bool ParseString(const char*& p, const char* end, const char*& text, size_t& length)
+        {
+            if (p >= end || *p != '"')
+                return false;
+            p++;
+            text = p;
+            while (p < end && *p != '"')
+            {
+                if (*p == '\\')
+                    p++;
+                p++;
+            }
+            if (p >= end)
+                return false;
+            length = p - text;
+            p++;
+            return true;
+        }
+
+        static bool MatchLiteral(const char*& p, const char* end, const char* literal)
+        {
+            size_t length = std::strlen(literal);
+            if ((size_t)(end - p) < length || std::memcmp(p, literal, length) != 0)
+                return false;
+            p += length;
+            return true;
+        }
+
+        // Returns the new value's index, or -1 on a syntax error
+        int ParseValue(const char*& p, const char* end, int depth)
+        {
+            SkipWhitespace(p, end);
+            if (p >= end || depth > MAX_JSON_DEPTH)
+                return -1;
+
+            int index = (int)m_values.size();
+            JSON_VALUE value;
+            std::memset(&value, 0, sizeof(value));
+            value.firstChild = -1;
+            value.nextSibling = -1;
+            m_values.push_back(value);
+
+            char c = *p;
+            if (c == '{' || c == '[')
+            {
+                bool bObject = (c == '{');
+                char close = bObject ? '}' : ']';
+                m_values[index].type = bObject ? JSON_OBJECT : JSON_ARRAY;
+                p++;
+
+                SkipWhitespace(p, end);
+                if (p < end && *p == close)
+                {
+                    p++;
+                    return index;
+                }
+
+                int last = -1;
+                for (;;)
+                {
+                    const char* key = nullptr;
+                    size_t keyLength = 0;
+                    if (bObject)
+                    {
+                        SkipWhitespace(p, end);
+                        if (!ParseString(p, end, key, keyLength))
+                            return -1;
+                        SkipWhitespace(p, end);
+                        if (p >= end || *p != ':')
+                            return -1;
+                        p++;
+                    }
+
+                    int child = ParseValue(p, end, depth + 1);
+                    if (child < 0)
+                        return -1;
+                    m_values[child].key = key;
+                    m_values[child].keyLength = keyLength;
+                    if (last < 0)
+                        m_values[index].firstChild = child;
+                    else
+                        m_values[last].nextSibling = child;
+                    m_values[index].childCount++;
+                    last = child;
+
+                    SkipWhitespace(p, end);
+                    if (p >= end)
+                        return -1;
+                    if (*p == ',')
+                    {
+                        p++;
+                        continue;
+                    }
+                    if (*p != close)
+                        return -1;
+                    p++;
+                    return index;
+                }
+            }
+
+            if (c == '"')
+            {
+                m_values[index].type = JSON_STRING;
+                return ParseString(p, end, m_values[index].text, m_values[index].length) ? index : -1;
+            }
+            if (MatchLiteral(p, end, "true"))
+            {
+                m_values[index].type = JSON_BOOL;
+                m_values[index].number = 1.0;
+                return index;
+            }
+            if (MatchLiteral(p, end, "false"))
+            {
+                m_values[index].type = JSON_BOOL;
+                return index;
+            }
+            if (MatchLiteral(p, end, "null"))
+                return index;
+
+            m_values[index].type = JSON_NUMBER;
+            return ParseNumber(p, end, m_values[index].number) ? index : -1;
+        }
+
+        std::vector<JSON_VALUE> m_values;
+    };
+
+    // ---- glTF ---------------------------------------------------------
+
+    // One buffer's bytes, in the mapping (GLB) or in a decoded data: URI
+    struct GLTF_BUFFER
+    {
+        const unsigned char* data;
+        size_t size;
+    };
+
+    // Where an accessor's elements live and how to read them
+    struct GLTF_ACCESSOR
+    {
+        const unsigned char* data;
+        size_t count;
+        size_t stride;
+        int componentType;
+        int components;
+        bool bNormalized;
+    };
+
+    // Everything a glTF file's primitives are resolved against
+    struct GLTF_CONTEXT
+    {
+        JsonDocument document;
+        std::vector<int> accessors;
+        std::vector<int> bufferViews;
+        std::vector<int> meshes;
+        std::vector<int> nodes;
+        std::vector<GLTF_BUFFER> buffers;
+        // storage for base64 buffers, one slot per buffer
+        std::vector<std::vector<unsigned char>> decodedBuffers;
+        // primitives skipped because they aren't triangle lists
+        int skippedPrimitives;
+    };
+
+    int GetComponentSize(int componentType)
+    {
+        switch (componentType)
+        {
+        case GLTF_BYTE:
+        case GLTF_UNSIGNED_BYTE:
+            return 1;
+        case GLTF_SHORT:
+        case GLTF_UNSIGNED_SHORT:
+            return 2;
+        case GLTF_UNSIGNED_INT:
+        case GLTF_FLOAT:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    int GetComponentCount(const JsonDocument& document, int type)
+    {
+        if (document.IsString(type, "SCALAR")) return 1;
+        if (document.IsString(type, "VEC2"))   return 2;
+        if (document.IsString(type, "VEC3"))   return 3;
+        if (document.IsString(type, "VEC4"))   return 4;
+        return 0;
+    }
+
+    int GetBase64Value(char c)
+    {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    }
+
+    // Skips anything outside the alphabet, which covers JSON's "\/"
+    void DecodeBase64(const char* text, size_t length, std::vector<unsigned char>& bytes)
+    {
+        bytes.clear();
+        bytes.reserve(length / 4 * 3);
+
+        uint32_t bits = 0;
+        int bitCount = 0;
+        for (size_t i = 0; i < length && text[i] != '='; i++)
+        {
+            int value = GetBase64Value(text[i]);
+            if (value < 0)
+                continue;
+            bits = (bits << 6) | (uint32_t)value;
+            bitCount += 6;
+            if (bitCount >= 8)
+            {
+                bitCount -= 8;
+                bytes.push_back((unsigned char)(bits >> bitCount));
+            }
+        }
+    }
+
+    // Fill in context.buffers; glbChunk is the GLB binary chunk, if any
+    bool ResolveBuffers(GLTF_CONTEXT& context, int root, const unsigned char* glbChunk, size_t glbChunkSize)
+    {
+        const JsonDocument& document = context.document;
+        std::vector<int> buffers;
+        document.GetElements(document.GetMember(root, "buffers"), buffers);
+        context.buffers.resize(buffers.size());
+        context.decodedBuffers.resize(buffers.size());
+
+        for (size_t i = 0; i < buffers.size(); i++)
+        {
+            GLTF_BUFFER& buffer = context.buffers[i];
+            int uri = document.GetMember(buffers[i], "uri");
+            size_t byteLength = (size_t)document.GetNumber(buffers[i], "byteLength", 0.0);
+
+            if (uri < 0)
+            {
+                // only a GLB's first buffer may leave out its uri
+                if (i != 0 || glbChunk == nullptr)
+                {
+                    std::cout << "INFO: glTF buffer " << i << " has no data" << std::endl;
+                    return false;
+                }
+                buffer.data = glbChunk;
+                buffer.size = std::min(byteLength, glbChunkSize);
+                continue;
+            }
+
+            // data:[<media type>];base64,<data>
+            const JSON_VALUE& text = document.Get(uri);
+            const char* comma = nullptr;
+            if (text.type == JSON_STRING && text.length > 5 && std::memcmp(text.text, "data:", 5) == 0)
+                comma = (const char*)std::memchr(text.text, ',', text.length);
+            const size_t BASE64_LENGTH = 7;
+            if (comma == nullptr || comma - text.text < (ptrdiff_t)(5 + BASE64_LENGTH) ||
+                std::memcmp(comma - BASE64_LENGTH, ";base64", BASE64_LENGTH) != 0)
+            {
+                std::cout << "INFO: glTF buffer " << i << " is an external file; only embedded and GLB buffers are supported" << std::endl;
+                return false;
+            }
+
+            size_t dataLength = text.length - (comma + 1 - text.text);
+            DecodeBase64(comma + 1, dataLength, context.decodedBuffers[i]);
+            buffer.data = context.decodedBuffers[i].data();
+            buffer.size = std::min(byteLength, context.decodedBuffers[i].size());
+        }
+        return true;
+    }
+
+    // Resolve and bounds-check accessor index against its buffer view
+    bool GetAccessor(const GLTF_CONTEXT& context, int index, GLTF_ACCESSOR& accessor)
+    {
+        const JsonDocument& document = context.document;
+        if (index < 0 || index >= (int)context.accessors.size())
+            return false;
+
+        int object = context.accessors[index];
+        int viewIndex = (int)document.GetNumber(object, "bufferView", -1.0);
+        if (viewIndex < 0 || viewIndex >= (int)context.bufferViews.size() ||
+            document.GetMember(object, "sparse") >= 0)
+        {
+            return false;
+        }
+
+        accessor.componentType = (int)document.GetNumber(object, "componentType", 0.0);
+        accessor.components = GetComponentCount(document, document.GetMember(object, "type"));
+        accessor.count = (size_t)document.GetNumber(object, "count", 0.0);
+        int normalized = document.GetMember(object, "normalized");
+        accessor.bNormalized = (normalized >= 0 && document.Get(normalized).number != 0.0);
+
+        size_t elementSize = (size_t)GetComponentSize(accessor.componentType) * accessor.components;
+        if (elementSize == 0)
+            return false;
+
+        int view = context.bufferViews[viewIndex];
+        int bufferIndex = (int)document.GetNumber(view, "buffer", -1.0);
+        if (bufferIndex < 0 || bufferIndex >= (int)context.buffers.size())
+            return false;
+
+        const GLTF_BUFFER& buffer = context.buffers[bufferIndex];
+        size_t viewOffset = (size_t)document.GetNumber(view, "byteOffset", 0.0);
+        size_t viewLength = (size_t)document.GetNumber(view, "byteLength", 0.0);
+        size_t byteStride = (size_t)document.GetNumber(view, "byteStride", 0.0);
+        size_t accessorOffset = (size_t)document.GetNumber(object, "byteOffset", 0.0);
+
+        accessor.stride = (byteStride != 0) ? byteStride : elementSize;
+        if (viewOffset > buffer.size || viewLength > buffer.size - viewOffset || accessorOffset > viewLength)
+            return false;
+
+        // the last element has to end inside the view
+        size_t available = viewLength - accessorOffset;
+        if (accessor.count > 0 &&
+            (elementSize > available || (accessor.count - 1) > (available - elementSize) / accessor.stride))
+        {
+            return false;
+        }
+
+        accessor.data = buffer.data + viewOffset + accessorOffset;
+        return true;
+    }
+
+    float ReadComponent(const GLTF_ACCESSOR& accessor, size_t element, int component)
+    {
+        const unsigned char* p = accessor.data + element * accessor.stride +
+                                 (size_t)component * GetComponentSize(accessor.componentType);
+        switch (accessor.componentType)
+        {
+        case GLTF_FLOAT:
+        {
+            float value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+        case GLTF_UNSIGNED_BYTE:
+            return accessor.bNormalized ? *p / 255.0f : (float)*p;
+        case GLTF_BYTE:
+        {
+            float value = (float)(int8_t)*p;
+            return accessor.bNormalized ? std::max(value / 127.0f, -1.0f) : value;
+        }
+        case GLTF_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return accessor.bNormalized ? value / 65535.0f : (float)value;
+        }
+        case GLTF_SHORT:
+        {
+            int16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return accessor.bNormalized ? std::max(value / 32767.0f, -1.0f) : (float)value;
+        }
+        default:
+            return 0.0f;
+        }
+    }
+
+    uint32_t ReadIndex(const GLTF_ACCESSOR& accessor, size_t element)
+    {
+        const unsigned char* p = accessor.data + element * accessor.stride;
+        switch (accessor.componentType)
+        {
+        case GLTF_UNSIGNED_BYTE:
+            return *p;
+        case GLTF_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+        default:
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+        }
+    }
+
+    // Append one primitive with transform applied. Vertices that came
+    // without a normal are flagged in needsNormal.
+    bool AppendPrimitive(
+        GLTF_CONTEXT& context,
+        int primitive,
+        const glm::mat4& transform,
+        MeshLibrary::MESH_DATA& mesh,
+        std::vector<unsigned char>& needsNormal)
+    {
+        const JsonDocument& document = context.document;
+        if ((int)document.GetNumber(primitive, "mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+        {
+            context.skippedPrimitives++;
+            return true;
+        }
+
+        int attributes = document.GetMember(primitive, "attributes");
+        int positionIndex = (int)document.GetNumber(attributes, "POSITION", -1.0);
+        int normalIndex = (int)document.GetNumber(attributes, "NORMAL", -1.0);
+        int uvIndex = (int)document.GetNumber(attributes, "TEXCOORD_0", -1.0);
+        int indicesIndex = (int)document.GetNumber(primitive, "indices", -1.0);
+
+        GLTF_ACCESSOR positions;
+        GLTF_ACCESSOR normals;
+        GLTF_ACCESSOR uvs;
+        GLTF_ACCESSOR indices;
+        if (!GetAccessor(context, positionIndex, positions) || positions.components != 3)
+            return false;
+        bool bNormals = GetAccessor(context, normalIndex, normals) && normals.components == 3 &&
+                        normals.count >= positions.count;
+        bool bUVs = GetAccessor(context, uvIndex, uvs) && uvs.components == 2 &&
+                    uvs.count >= positions.count;
+        bool bIndexed = (indicesIndex >= 0);
+        if (bIndexed && (!GetAccessor(context, indicesIndex, indices) || indices.components != 1 ||
+                         (indices.componentType != GLTF_UNSIGNED_BYTE && indices.componentType != GLTF_UNSIGNED_SHORT &&
+                          indices.componentType != GLTF_UNSIGNED_INT)))
+        {
+            return false;
+        }
+
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+        bool bMirrored = glm::determinant(glm::mat3(transform)) < 0.0f;
+        uint32_t baseVertex = (uint32_t)mesh.vertices.size();
+
+        for (size_t i = 0; i < positions.count; i++)
+        {
+            MeshLibrary::MESH_VERTEX vertex;
+            glm::vec3 position(ReadComponent(positions, i, 0), ReadComponent(positions, i, 1), ReadComponent(positions, i, 2));
+            position = glm::vec3(transform * glm::vec4(position, 1.0f));
+
+            glm::vec3 normal(0.0f);
+            if (bNormals)
+            {
+                normal = glm::vec3(ReadComponent(normals, i, 0), ReadComponent(normals, i, 1), ReadComponent(normals, i, 2));
+                normal = normalMatrix * normal;
+                float length = glm::length(normal);
+                normal = (length > 0.0f) ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                vertex.position[axis] = position[axis];
+                vertex.normal[axis] = normal[axis];
+            }
+            // glTF puts the UV origin at the top left, GL at the bottom left
+            vertex.uv[0] = bUVs ? ReadComponent(uvs, i, 0) : 0.0f;
+            vertex.uv[1] = bUVs ? 1.0f - ReadComponent(uvs, i, 1) : 0.0f;
+
+            mesh.vertices.push_back(vertex);
+            needsNormal.push_back(bNormals ? 0 : 1);
+        }
+
+        size_t indexCount = bIndexed ? indices.count : positions.count;
+        indexCount -= indexCount % 3;
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            uint32_t corners[3];
+            for (int corner = 0; corner < 3; corner++)
+            {
+                corners[corner] = bIndexed ? ReadIndex(indices, i + corner) : (uint32_t)(i + corner);
+                if (corners[corner] >= positions.count)
+                    return false;
+            }
+            if (bMirrored)
+                std::swap(corners[1], corners[2]);
+            for (int corner = 0; corner < 3; corner++)
+                mesh.indices.push_back(baseVertex + corners[corner]);
+        }
+        return true;
+    }
+
+    glm::mat4 GetNodeTransform(const JsonDocument& document, int node)
+    {
+        std::vector<int> values;
+        document.GetElements(document.GetMember(node, "matrix"), values);
+        if (values.size() == 16)
+        {
+            float matrix[16];
+            for (int i = 0; i < 16; i++)
+                matrix[i] = (float)document.Get(values[i]).number;
+            // column-major, same as glm
+            return glm::make_mat4(matrix);
+        }
+
+        glm::mat4 transform(1.0f);
+        document.GetElements(document.GetMember(node, "translation"), values);
+        if (values.size() == 3)
+        {
+            glm::vec3 translation((float)document.Get(values[0]).number, (float)document.Get(values[1]).number,
+                                  (float)document.Get(values[2]).number);
+            transform = glm::translate(transform, translation);
+        }
+        document.GetElements(document.GetMember(node, "rotation"), values);
+        if (values.size() == 4)
+        {
+            // stored x, y, z, w
+            glm::quat rotation((float)document.Get(values[3]).number, (float)document.Get(values[0]).number,
+                               (float)document.Get(values[1]).number, (float)document.Get(values[2]).number);
+            transform = transform * glm::mat4_cast(rotation);
+        }
+        document.GetElements(document.GetMember(node, "scale"), values);
+        if (values.size() == 3)
+        {
+            glm::vec3 scale((float)document.Get(values[0]).number, (float)document.Get(values[1]).number,
+                            (float)document.Get(values[2]).number);
+            transform = glm::scale(transform, scale);
+        }
+        return transform;
+    }
+
+    bool AppendMesh(GLTF_CONTEXT& context, int meshIndex, const glm::mat4& transform,
+                    MeshLibrary::MESH_DATA& mesh, std::vector<unsigned char>& needsNormal)
+    {
+        if (meshIndex < 0 || meshIndex >= (int)context.meshes.size())
+            return false;
+
+        std::vector<int> primitives;
+        context.document.GetElements(context.document.GetMember(context.meshes[meshIndex], "primitives"), primitives);
+        for (int primitive : primitives)
+        {
+            if (!AppendPrimitive(context, primitive, transform, mesh, needsNormal))
+                return false;
+        }
+        return true;
+    }
+
+    bool AppendNode(GLTF_CONTEXT& context, int nodeIndex, const glm::mat4& parentTransform, int depth,
+                    MeshLibrary::MESH_DATA& mesh, std::vector<unsigned char>& needsNormal)
+    {
+        if (nodeIndex < 0 || nodeIndex >= (int)context.nodes.size() || depth > MAX_NODE_DEPTH)
+            return false;
+
+        const JsonDocument& document = context.document;
+        int node = context.nodes[nodeIndex];
+        glm::mat4 transform = parentTransform * GetNodeTransform(document, node);
+
+        int meshIndex = (int)document.GetNumber(node, "mesh", -1.0);
+        if (meshIndex >= 0 && !AppendMesh(context, meshIndex, transform, mesh, needsNormal))
+            return false;
+
+        std::vector<int> children;
+        document.GetElements(document.GetMember(node, "children"), children);
+        for (int child : children)
+        {
+            if (!AppendNode(context, (int)document.Get(child).number, transform, depth + 1, mesh, needsNormal))
+                return false;
+        }
+        return true;
+    }
+
+    // Parse the JSON part of a .gltf or .glb and append its triangles
+    bool ParseGLTFDocument(const char* json, size_t jsonSize, const unsigned char* glbChunk, size_t glbChunkSize,
+                           MeshLibrary::MESH_DATA& mesh, std::vector<unsigned char>& needsNormal)
+    {
+        GLTF_CONTEXT context;
+        context.skippedPrimitives = 0;
+        JsonDocument& document = context.document;
+        if (!document.Parse(json, jsonSize))
+        {
+            std::cout << "INFO: glTF JSON is malformed" << std::endl;
+            return false;
+        }
+
+        const int root = 0;
+        document.GetElements(document.GetMember(root, "accessors"), context.accessors);
+        document.GetElements(document.GetMember(root, "bufferViews"), context.bufferViews);
+        document.GetElements(document.GetMember(root, "meshes"), context.meshes);
+        document.GetElements(document.GetMember(root, "nodes"), context.nodes);
+        if (!ResolveBuffers(context, root, glbChunk, glbChunkSize))
+            return false;
+
+        bool bOK = true;
+        std::vector<int> scenes;
+        document.GetElements(document.GetMember(root, "scenes"), scenes);
+        if (scenes.empty())
+        {
+            // no scene to place them, so every mesh as-is
+            for (size_t i = 0; i < context.meshes.size() && bOK; i++)
+                bOK = AppendMesh(context, (int)i, glm::mat4(1.0f), mesh, needsNormal);
+        }
+        else
+        {
+            int sceneIndex = (int)document.GetNumber(root, "scene", 0.0);
+            if (sceneIndex < 0 || sceneIndex >= (int)scenes.size())
+                sceneIndex = 0;
+
+            std::vector<int> sceneNodes;
+            document.GetElements(document.GetMember(scenes[sceneIndex], "nodes"), sceneNodes);
+            for (size_t i = 0; i < sceneNodes.size() && bOK; i++)
+                bOK = AppendNode(context, (int)document.Get(sceneNodes[i]).number, glm::mat4(1.0f), 0, mesh, needsNormal);
+        }
+
+        if (!bOK)
+        {
+            std::cout << "INFO: glTF mesh data is out of range or in an unsupported layout" << std::endl;
+            return false;
+        }
+        if (context.skippedPrimitives > 0)
+        {
+            std::cout << "INFO: Skipped " << context.skippedPrimitives << " glTF primitives that aren't triangle lists" << std::endl;
+        }
+        return true;
+    }
+
+    // ---- shared -------------------------------------------------------
+
+    // Area-weighted face normals for the flagged vertices only
+    void RebuildNormals(MeshLibrary::MESH_DATA& mesh, const std::vector<unsigned char>& needsNormal)
+    {
+        if (std::find(needsNormal.begin(), needsNormal.end(), 1) == needsNormal.end())
+            return;
+
+        std::vector<glm::vec3> sums(mesh.vertices.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const float* a = mesh.vertices[mesh.indices[i]].position;
+            const float* b = mesh.vertices[mesh.indices[i + 1]].position;
+            const float* c = mesh.vertices[mesh.indices[i + 2]].position;
+            glm::vec3 faceNormal = glm::cross(glm::make_vec3(b) - glm::make_vec3(a), glm::make_vec3(c) - glm::make_vec3(a));
+            for (int corner = 0; corner < 3; corner++)
+                sums[mesh.indices[i + corner]] += faceNormal;
+        }
+
+        for (size_t v = 0; v < mesh.vertices.size(); v++)
+        {
+            if (!needsNormal[v])
+                continue;
+            float length = glm::length(sums[v]);
+            glm::vec3 normal = (length > 0.0f) ? sums[v] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            for (int axis = 0; axis < 3; axis++)
+                mesh.vertices[v].normal[axis] = normal[axis];
+        }
+    }
+
+    // Imported meshes are one sides range with empty caps after it
+    bool FinishMesh(MeshLibrary::MESH_DATA& mesh, const std::vector<unsigned char>& needsNormal)
+    {
+        if (mesh.indices.empty())
+        {
+            std::cout << "INFO: Mesh file has no triangles" << std::endl;
+            return false;
+        }
+
+        RebuildNormals(mesh, needsNormal);
+
+        uint32_t indexCount = (uint32_t)mesh.indices.size();
+        mesh.sides.first = 0;
+        mesh.sides.count = indexCount;
+        mesh.topCap.first = indexCount;
+        mesh.topCap.count = 0;
+        mesh.bottomCap.first = indexCount;
+        mesh.bottomCap.count = 0;
+        return true;
+    }
+
+    uint32_t ReadUint32(const unsigned char* p)
+    {
+        // GLB is little-endian, like every platform this builds for
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    bool HasExtension(const std::string& path, const char* extension)
+    {
+        size_t length = std::strlen(extension);
+        if (path.size() < length)
+            return false;
+        for (size_t i = 0; i < length; i++)
+        {
+            char c = path[path.size() - length + i];
+            if (c >= 'A' && c <= 'Z')
+                c = (char)(c - 'A' + 'a');
+            if (c != extension[i])
+                return false;
+        }
+        return true;
+    }
+
+    // ---- benchmark input ----------------------------------------------
+
+    bool WriteBenchmarkOBJ(const std::string& path, const MeshLibrary::MESH_DATA& mesh)
+    {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        for (const MeshLibrary::MESH_VERTEX& vertex : mesh.vertices)
+            std::fprintf(file, "v %.6f %.6f %.6f\n", vertex.position[0], vertex.position[1], vertex.position[2]);
+        for (const MeshLibrary::MESH_VERTEX& vertex : mesh.vertices)
+            std::fprintf(file, "vt %.6f %.6f\n", vertex.uv[0], vertex.uv[1]);
+        for (const MeshLibrary::MESH_VERTEX& vertex : mesh.vertices)
+            std::fprintf(file, "vn %.6f %.6f %.6f\n", vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            uint32_t a = mesh.indices[i] + 1;
+            uint32_t b = mesh.indices[i + 1] + 1;
+            uint32_t c = mesh.indices[i + 2] + 1;
+            std::fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+        }
+
+        bool bOK = (std::ferror(file) == 0);
+        return (std::fclose(file) == 0) && bOK;
+    }
+
+    bool WriteBenchmarkGLB(const std::string& path, const MeshLibrary::MESH_DATA& mesh)
+    {
+        size_t vertexCount = mesh.vertices.size();
+        size_t indexCount = mesh.indices.size();
+
+        // positions, normals, UVs and indices, each tightly packed
+        std::vector<unsigned char> binary;
+        binary.reserve(vertexCount * 32 + indexCount * 4);
+        for (const MeshLibrary::MESH_VERTEX& vertex : mesh.vertices)
+            binary.insert(binary.end(), (const unsigned char*)vertex.position, (const unsigned char*)(vertex.position + 3));
+        for (const MeshLibrary::MESH_VERTEX& vertex : mesh.vertices)
+            binary.insert(binary.end(), (const unsigned char*)vertex.normal, (const unsigned char*)(vertex.normal + 3));
+        for (const MeshLibrary::MESH_VERTEX& vertex : mesh.vertices)
+        {
+            float uv[2] = { vertex.uv[0], 1.0f - vertex.uv[1] };
+            binary.insert(binary.end(), (const unsigned char*)uv, (const unsigned char*)(uv + 2));
+        }
+        binary.insert(binary.end(), (const unsigned char*)mesh.indices.data(),
+                      (const unsigned char*)(mesh.indices.data() + indexCount));
+
+        size_t positionBytes = vertexCount * 12;
+        size_t uvOffset = vertexCount * 24;
+        size_t indexOffset = vertexCount * 32;
+
+        std::ostringstream json;
+        json << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+             << "\"nodes\":[{\"mesh\":0}],"
+             << "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+             << "\"buffers\":[{\"byteLength\":" << binary.size() << "}],"
+             << "\"bufferViews\":["
+             << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << positionBytes << "},"
+             << "{\"buffer\":0,\"byteOffset\":" << positionBytes << ",\"byteLength\":" << positionBytes << "},"
+             << "{\"buffer\":0,\"byteOffset\":" << uvOffset << ",\"byteLength\":" << vertexCount * 8 << "},"
+             << "{\"buffer\":0,\"byteOffset\":" << indexOffset << ",\"byteLength\":" << indexCount * 4 << "}],"
+             << "\"accessors\":["
+             << "{\"bufferView\":0,\"componentType\":5126,\"count\":" << vertexCount
+             << ",\"type\":\"VEC3\",\"min\":[-1,-1,-1],\"max\":[1,1,1]},"
+             << "{\"bufferView\":1,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\"},"
+             << "{\"bufferView\":2,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC2\"},"
+             << "{\"bufferView\":3,\"componentType\":5125,\"count\":" << indexCount << ",\"type\":\"SCALAR\"}]}";
+
+        // chunks are padded to 4 bytes: JSON with spaces, binary with zeros
+        std::string jsonText = json.str();
+        jsonText.append((4 - jsonText.size() % 4) % 4, ' ');
+        binary.resize((binary.size() + 3) / 4 * 4, 0);
+
+        uint32_t header[3] = { GLB_MAGIC, 2, (uint32_t)(12 + 8 + jsonText.size() + 8 + binary.size()) };
+        uint32_t jsonChunk[2] = { (uint32_t)jsonText.size(), GLB_CHUNK_JSON };
+        uint32_t binaryChunk[2] = { (uint32_t)binary.size(), GLB_CHUNK_BIN };
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        std::fwrite(header, sizeof(header), 1, file);
+        std::fwrite(jsonChunk, sizeof(jsonChunk), 1, file);
+        std::fwrite(jsonText.data(), 1, jsonText.size(), file);
+        std::fwrite(binaryChunk, sizeof(binaryChunk), 1, file);
+        std::fwrite(binary.data(), 1, binary.size(), file);
+
+        bool bOK = (std::ferror(file) == 0);
+        return (std::fclose(file) == 0) && bOK;
+    }
+}
+
+/***********************************************************
+ * ImportFile()
+ ***********************************************************/
+bool MeshImporter::ImportFile(const std::string& path, MeshLibrary::MESH_DATA& mesh)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cout << "INFO: Could not open mesh file " << path << std::endl;
+        return false;
+    }
+
+    bool bOK = false;
+    if (HasExtension(path, ".obj"))
+        bOK = ParseOBJ(file.GetData(), file.GetSize(), mesh);
+    else if (HasExtension(path, ".gltf"))
+        bOK = ParseGLTF(file.GetData(), file.GetSize(), mesh);
+    else if (HasExtension(path, ".glb"))
+        bOK = ParseGLB(file.GetData(), file.GetSize(), mesh);
+    else
+        std::cout << "INFO: Unknown mesh file type " << path << std::endl;
+
+    if (!bOK)
+    {
+        std::cout << "INFO: Could not import " << path << std::endl;
+        mesh = MeshLibrary::MESH_DATA();
+    }
+    return bOK;
+}
+
+/***********************************************************
+ * ParseOBJ()
+ * One pass over the lines. Each distinct v/vt/vn corner
+ * becomes one vertex, so shared corners stay shared.
+ ***********************************************************/
+bool MeshImporter::ParseOBJ(const unsigned char* data, size_t size, MeshLibrary::MESH_DATA& mesh)
+{
+    mesh = MeshLibrary::MESH_DATA();
+
+    const char* p = (const char*)data;
+    const char* end = p + size;
+
+    std::vector<float> positions;
+    std::vector<float> uvs;
+    std::vector<float> normals;
+    std::unordered_map<OBJ_CORNER, uint32_t, OBJ_CORNER_HASH> corners;
+    std::vector<uint32_t> polygon;
+    std::vector<unsigned char> needsNormal;
+
+    // rough guess from typical line lengths, to spare most rehashes
+    corners.reserve(size / 64);
+
+    int lineNumber = 1;
+    for (; p < end; lineNumber++)
+    {
+        SkipSpaces(p, end);
+
+        bool bOK = true;
+        if (MatchKeyword(p, end, "v"))
+        {
+            p += 1;
+            bOK = ParseFloats(p, end, 3, positions);
+        }
+        else if (MatchKeyword(p, end, "vt"))
+        {
+            p += 2;
+            bOK = ParseFloats(p, end, 2, uvs);
+        }
+        else if (MatchKeyword(p, end, "vn"))
+        {
+            p += 2;
+            bOK = ParseFloats(p, end, 3, normals);
+        }
+        else if (MatchKeyword(p, end, "f"))
+        {
+            p += 1;
+            polygon.clear();
+            for (;;)
+            {
+                SkipSpaces(p, end);
+                if (IsLineEnd(p, end))
+                    break;
+
+                long long position = 0;
+                long long uv = 0;
+                long long normal = 0;
+                if (!ParseInteger(p, end, position))
+                {
+                    bOK = false;
+                    break;
+                }
+                if (p < end && *p == '/')
+                {
+                    p++;
+                    if (p < end && *p != '/' && !ParseInteger(p, end, uv))
+                    {
+                        bOK = false;
+                        break;
+                    }
+                    if (p < end && *p == '/')
+                    {
+                        p++;
+                        if (!ParseInteger(p, end, normal))
+                        {
+                            bOK = false;
+                            break;
+                        }
+                    }
+                }
+
+                OBJ_CORNER corner;
+                corner.position = ResolveIndex(position, positions.size() / 3);
+                corner.uv = (uv != 0) ? ResolveIndex(uv, uvs.size() / 2) : -1;
+                corner.normal = (normal != 0) ? ResolveIndex(normal, normals.size() / 3) : -1;
+                if (corner.position < 0 || (uv != 0 && corner.uv < 0) || (normal != 0 && corner.normal < 0))
+                {
+                    bOK = false;
+                    break;
+                }
+
+                auto inserted = corners.emplace(corner, (uint32_t)mesh.vertices.size());
+                if (inserted.second)
+                {
+                    MeshLibrary::MESH_VERTEX vertex;
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        vertex.position[axis] = positions[corner.position * 3 + axis];
+                        vertex.normal[axis] = (corner.normal >= 0) ? normals[corner.normal * 3 + axis] : 0.0f;
+                    }
+                    vertex.uv[0] = (corner.uv >= 0) ? uvs[corner.uv * 2] : 0.0f;
+                    vertex.uv[1] = (corner.uv >= 0) ? uvs[corner.uv * 2 + 1] : 0.0f;
+                    mesh.vertices.push_back(vertex);
+                    needsNormal.push_back(corner.normal < 0 ? 1 : 0);
+                }
+                polygon.push_back(inserted.first->second);
+            }
+
+            // fan from the first corner; points and lines draw nothing
+            for (size_t i = 2; bOK && i < polygon.size(); i++)
+            {
+                mesh.indices.push_back(polygon[0]);
+                mesh.indices.push_back(polygon[i - 1]);
+                mesh.indices.push_back(polygon[i]);
+            }
+        }
+
+        if (!bOK)
+        {
+            std::cout << "INFO: OBJ parse error on line " << lineNumber << std::endl;
+            return false;
+        }
+        SkipLine(p, end);
+    }
+
+    return FinishMesh(mesh, needsNormal);
+}
+
+/***********************************************************
+ * ParseGLTF()
+ * A .gltf is the JSON alone, so every buffer has to be a
+ * base64 data: URI.
+ ***********************************************************/
+bool MeshImporter::ParseGLTF(const unsigned char* data, size_t size, MeshLibrary::MESH_DATA& mesh)
+{
+    mesh = MeshLibrary::MESH_DATA();
+
+    std::vector<unsigned char> needsNormal;
+    if (!ParseGLTFDocument((const char*)data, size, nullptr, 0, mesh, needsNormal))
+        return false;
+    return FinishMesh(mesh, needsNormal);
+}
+
+/***********************************************************
+ * ParseGLB()
+ * 12-byte header, then a JSON chunk and an optional binary
+ * chunk that buffer 0 refers to.
+ ***********************************************************/
+bool MeshImporter::ParseGLB(const unsigned char* data, size_t size, MeshLibrary::MESH_DATA& mesh)
+{
+    mesh = MeshLibrary::MESH_DATA();
+
+    if (size < 20 || ReadUint32(data) != GLB_MAGIC || ReadUint32(data + 4) != 2)
+    {
+        std::cout << "INFO: Not a glTF 2.0 binary file" << std::endl;
+        return false;
+    }
+    size = std::min(size, (size_t)ReadUint32(data + 8));
+
+    const unsigned char* json = nullptr;
+    size_t jsonSize = 0;
+    const unsigned char* binary = nullptr;
+    size_t binarySize = 0;
+    for (size_t offset = 12; offset + 8 <= size;)
+    {
+        size_t chunkSize = ReadUint32(data + offset);
+        uint32_t chunkType = ReadUint32(data + offset + 4);
+        if (chunkSize > size - offset - 8)
+            break;
+
+        if (chunkType == GLB_CHUNK_JSON && json == nullptr)
+        {
+            json = data + offset + 8;
+            jsonSize = chunkSize;
+        }
+        else if (chunkType == GLB_CHUNK_BIN && binary == nullptr)
+        {
+            binary = data + offset + 8;
+            binarySize = chunkSize;
+        }
+        offset += 8 + chunkSize;
+    }
+
+    if (json == nullptr)
+    {
+        std::cout << "INFO: glTF binary file has no JSON chunk" << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> needsNormal;
+    if (!ParseGLTFDocument((const char*)json, jsonSize, binary, binarySize, mesh, needsNormal))
+        return false;
+    return FinishMesh(mesh, needsNormal);
+}
+
+/***********************************************************
+ * RunBenchmark()
+ * Each file is mapped and parsed BENCHMARK_RUNS times and
+ * the best run is reported, so the first run's page faults
+ * don't skew the parse rate.
+ ***********************************************************/
+void MeshImporter::RunBenchmark(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> files = paths;
+    if (files.empty())
+    {
+        MeshLibrary::MESH_DATA sphere;
+        MeshLibrary::GenerateSphere(BENCHMARK_SECTORS, BENCHMARK_STACKS, sphere);
+
+        std::string objPath = std::string(BENCHMARK_DIRECTORY) + "/benchmark_sphere.obj";
+        std::string glbPath = std::string(BENCHMARK_DIRECTORY) + "/benchmark_sphere.glb";
+        if (!MeshCache::EnsureDirectory(BENCHMARK_DIRECTORY) ||
+            !WriteBenchmarkOBJ(objPath, sphere) ||
+            !WriteBenchmarkGLB(glbPath, sphere))
+        {
+            std::cout << "INFO: Could not write the benchmark meshes to " << BENCHMARK_DIRECTORY << std::endl;
+            return;
+        }
+        files.push_back(objPath);
+        files.push_back(glbPath);
+    }
+
+    for (const std::string& path : files)
+    {
+        MeshLibrary::MESH_DATA mesh;
+        double bestSeconds = 0.0;
+        size_t bytes = 0;
+        bool bOK = true;
+        for (int run = 0; run < BENCHMARK_RUNS && bOK; run++)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            bOK = ImportFile(path, mesh);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            if (run == 0 || seconds < bestSeconds)
+                bestSeconds = seconds;
+        }
+        if (!bOK)
+            continue;
+
+        MappedFile file;
+        if (file.Open(path))
+            bytes = file.GetSize();
+
+        double megabytes = bytes / 1.0e6;
+        std::cout << "INFO: Imported " << path << " (" << megabytes << " MB, "
+                  << mesh.vertices.size() << " vertices, " << mesh.indices.size() / 3 << " triangles) in "
+                  << bestSeconds * 1000.0 << " ms — " << megabytes / std::max(bestSeconds, 1.0e-9) << " MB/s"
+                  << std::endl;
+    }
+}
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshImporter.h
+// ============
+// Wavefront OBJ and glTF 2.0 mesh import, parsed straight out of a
+// memory-mapped file into MeshLibrary's mesh layout.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  MeshImporter
+ *
+ *  The parsers walk the mapped bytes once with a cursor:
+ *  numbers are converted where they lie and keywords and
+ *  JSON keys are compared in place, so no per-line or
+ *  per-token strings are built. The result is a MESH_DATA
+ *  with a single sides range, ready for MeshOptimizer and
+ *  MeshLibrary's upload.
+ *
+ *  OBJ: v / vt / vn / f lines (any polygon size, fan
+ *  triangulated, negative indices allowed); everything else
+ *  is skipped.
+ *  glTF: .gltf with data: URI buffers, or .glb with its
+ *  binary chunk. The triangle primitives of every mesh node
+ *  in the default scene are merged, node transforms applied.
+ *  External buffer files and sparse accessors aren't
+ *  supported.
+ *
+ *  Missing normals are rebuilt from the faces; missing UVs
+ *  are 0. Failures log why and return false.
+ ***********************************************************/
+class MeshImporter
+{
+public:
+    // Map path and parse it by its extension (.obj, .gltf or .glb)
+    static bool ImportFile(const std::string& path, MeshLibrary::MESH_DATA& mesh);
+
+    // Parse a file already in memory; data need not be null-terminated
+    static bool ParseOBJ(const unsigned char* data, size_t size, MeshLibrary::MESH_DATA& mesh);
+    static bool ParseGLTF(const unsigned char* data, size_t size, MeshLibrary::MESH_DATA& mesh);
+    static bool ParseGLB(const unsigned char* data, size_t size, MeshLibrary::MESH_DATA& mesh);
+
+    // Time ImportFile() on each file and log its throughput in MB/s.
+    // With no files, writes a large generated sphere to cache/ as both
+    // .obj and .glb and times those.
+    static void RunBenchmark(const std::vector<std::string>& paths);
+};
@@ -0,0 +1,863 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshLibrary.cpp
+// ============
+// In-project procedural meshes with several tessellation levels per
+// shape, used for distance-based level of detail alongside ShapeMeshes.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshLibrary.h"
+#include "MeshCache.h"
+#include "MeshImporter.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "MeshOptimizer.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+    const float PI = 3.14159265358979f;
+
+    // Tessellation per level, most detailed first. Level 0 is about
+    // what a close-up foliage core needs; level 3 is for things only
+    // a handful of pixels across (wire arch caps, feet, handles).
+    const int g_SphereSectors[MeshLibrary::LOD_LEVEL_COUNT]   = { 48, 24, 12, 8 };
+    const int g_SphereStacks[MeshLibrary::LOD_LEVEL_COUNT]    = { 24, 12, 8, 4 };
+    const int g_CylinderSectors[MeshLibrary::LOD_LEVEL_COUNT] = { 48, 24, 12, 6 };
+    const int g_TorusMain[MeshLibrary::LOD_LEVEL_COUNT]       = { 48, 24, 12, 8 };
+    const int g_TorusTube[MeshLibrary::LOD_LEVEL_COUNT]       = { 24, 12, 8, 4 };
+
+    // Relative to the working directory, like shaders/ and textures/
+    const char* MESH_CACHE_DIRECTORY = "cache";
+
+    MeshLibrary::MESH_VERTEX MakeVertex(
+        float px, float py, float pz,
+        float nx, float ny, float nz,
+        float u, float v)
+    {
+        MeshLibrary::MESH_VERTEX vertex;
+        vertex.position[0] = px;
+        vertex.position[1] = py;
+        vertex.position[2] = pz;
+        vertex.normal[0] = nx;
+        vertex.normal[1] = ny;
+        vertex.normal[2] = nz;
+        vertex.uv[0] = u;
+        vertex.uv[1] = v;
+        return vertex;
+    }
+
+    // Nearest half-float for the small, finite values UVs use. Values
+    // too small for a normal half become 0, too large become infinity.
+    uint16_t FloatToHalf(float value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000;
+        int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (exponent <= 0)
+            return (uint16_t)sign;
+        if (exponent >= 31)
+            return (uint16_t)(sign | 0x7C00);
+
+        uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+        // round to nearest; a carry out of the mantissa bumps the exponent
+        if (mantissa & 0x1000)
+            half++;
+        return (uint16_t)half;
+    }
+
+    // Unit vector to GL_INT_2_10_10_10_REV: x in bits 0-9, y in 10-19,
+    // z in 20-29, each a signed 10-bit fraction of 511; w left at 0
+    uint32_t PackNormal(const float normal[3])
+    {
+        uint32_t packed = 0;
+        for (int i = 0; i < 3; i++)
+        {
+            float component = std::max(-1.0f, std::min(1.0f, normal[i]));
+            int quantized = (int)std::lround(component * 511.0f);
+            packed |= ((uint32_t)quantized & 0x3FF) << (10 * i);
+        }
+        return packed;
+    }
+
+    // Start a new index range at the current end of the index list
+    MeshLibrary::INDEX_RANGE BeginRange(const MeshLibrary::MESH_DATA& mesh)
+    {
+        MeshLibrary::INDEX_RANGE range;
+        range.first = (uint32_t)mesh.indices.size();
+        range.count = 0;
+        return range;
+    }
+
+    void EndRange(const MeshLibrary::MESH_DATA& mesh, MeshLibrary::INDEX_RANGE& range)
+    {
+        range.count = (uint32_t)mesh.indices.size() - range.first;
+    }
+
+    // Flat disc at height y facing up (+Y) or down (-Y)
+    void AddCap(MeshLibrary::MESH_DATA& mesh, int sectors, float y, float radius, bool bFacingUp)
+    {
+        uint32_t center = (uint32_t)mesh.vertices.size();
+        float ny = bFacingUp ? 1.0f : -1.0f;
+        mesh.vertices.push_back(MakeVertex(0.0f, y, 0.0f, 0.0f, ny, 0.0f, 0.5f, 0.5f));
+
+        for (int j = 0; j <= sectors; j++)
+        {
+            float angle = 2.0f * PI * j / sectors;
+            float c = std::cos(angle);
+            float s = std::sin(angle);
+            mesh.vertices.push_back(MakeVertex(
+                radius * c, y, radius * s,
+                0.0f, ny, 0.0f,
+                0.5f + 0.5f * c, 0.5f + 0.5f * s));
+        }
+
+        for (int j = 0; j < sectors; j++)
+        {
+            uint32_t a = center + 1 + j;
+            uint32_t b = a + 1;
+            // counter-clockwise when seen from the side the cap faces
+            mesh.indices.push_back(center);
+            mesh.indices.push_back(bFacingUp ? b : a);
+            mesh.indices.push_back(bFacingUp ? a : b);
+        }
+    }
+}
+
+/***********************************************************
+ * MeshLibrary()
+ ***********************************************************/
+MeshLibrary::MeshLibrary()
+    : m_bLoaded(false)
+    , m_bPackedVertices(false)
+{
+    for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+    {
+        for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+        {
+            m_meshes[shape][level] = GPU_MESH();
+        }
+    }
+}
+
+/***********************************************************
+ * ~MeshLibrary()
+ * Frees the GL buffers for every uploaded mesh.
+ ***********************************************************/
+MeshLibrary::~MeshLibrary()
+{
+    for (IMPORTED_MESH& imported : m_importedMeshes)
+        DestroyMesh(imported.gpuMesh);
+
+    if (!m_bLoaded)
+        return;
+
+    for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+    {
+        for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+        {
+            DestroyMesh(m_meshes[shape][level]);
+        }
+    }
+}
+
+/***********************************************************
+ * DestroyMesh()
+ ***********************************************************/
+void MeshLibrary::DestroyMesh(GPU_MESH& gpuMesh)
+{
+    glDeleteVertexArrays(1, &gpuMesh.vao);
+    glDeleteVertexArrays(1, &gpuMesh.packedVao);
+    glDeleteBuffers(1, &gpuMesh.vbo);
+    glDeleteBuffers(1, &gpuMesh.packedVbo);
+    glDeleteBuffers(1, &gpuMesh.ebo);
+    gpuMesh = GPU_MESH();
+}
+
+/***********************************************************
+ * GenerateSphere()
+ * UV sphere of radius 1 centered on the origin. Poles sit
+ * on the Y axis; U wraps around, V runs bottom to top.
+ ***********************************************************/
+void MeshLibrary::GenerateSphere(int sectors, int stacks, MESH_DATA& mesh)
+{
+    mesh = MESH_DATA();
+
+    for (int i = 0; i <= stacks; i++)
+    {
+        float phi = PI / 2.0f - PI * i / stacks; // +90° (top) to -90° (bottom)
+        float ringRadius = std::cos(phi);
+        float y = std::sin(phi);
+
+        for (int j = 0; j <= sectors; j++)
+        {
+            float theta = 2.0f * PI * j / sectors;
+            float x = ringRadius * std::cos(theta);
+            float z = ringRadius * std::sin(theta);
+            mesh.vertices.push_back(MakeVertex(
+                x, y, z,
+                x, y, z,
+                (float)j / sectors, 1.0f - (float)i / stacks));
+        }
+    }
+
+    mesh.sides = BeginRange(mesh);
+    for (int i = 0; i < stacks; i++)
+    {
+        uint32_t k1 = i * (sectors + 1);
+        uint32_t k2 = k1 + sectors + 1;
+        for (int j = 0; j < sectors; j++, k1++, k2++)
+        {
+            // skip the zero-area triangles that meet at each pole
+            if (i != 0)
+            {
+                mesh.indices.push_back(k1);
+                mesh.indices.push_back(k1 + 1);
+                mesh.indices.push_back(k2);
+            }
+            if (i != stacks - 1)
+            {
+                mesh.indices.push_back(k1 + 1);
+                mesh.indices.push_back(k2 + 1);
+                mesh.indices.push_back(k2);
+            }
+        }
+    }
+    EndRange(mesh, mesh.sides);
+
+    mesh.topCap = BeginRange(mesh);
+    mesh.bottomCap = BeginRange(mesh);
+}
+
+/***********************************************************
+ * GenerateCylinder()
+ * Cylinder from y = 0 to y = 1 with a bottom radius of 1.
+ * A top radius below 1 gives the tapered cylinder. Sides,
+ * top cap and bottom cap each get their own index range,
+ * in the [bottom][sides][top][bottom] order.
+ ***********************************************************/
+void MeshLibrary::GenerateCylinder(int sectors, float topRadius, MESH_DATA& mesh)
+{
+    mesh = MESH_DATA();
+
+    // Side normals lean upward when the top is narrower than the base
+    float slope = 1.0f - topRadius;
+    float normalScale = 1.0f / std::sqrt(1.0f + slope * slope);
+
+    mesh.bottomCap = BeginRange(mesh);
+    AddCap(mesh, sectors, 0.0f, 1.0f, false);
+    EndRange(mesh, mesh.bottomCap);
+
+    uint32_t sideStart = (uint32_t)mesh.vertices.size();
+    for (int j = 0; j <= sectors; j++)
+    {
+        float angle = 2.0f * PI * j / sectors;
+        float c = std::cos(angle);
+        float s = std::sin(angle);
+        float u = (float)j / sectors;
+        float nx = c * normalScale;
+        float ny = slope * normalScale;
+        float nz = s * normalScale;
+
+        mesh.vertices.push_back(MakeVertex(c, 0.0f, s, nx, ny, nz, u, 0.0f));
+        mesh.vertices.push_back(MakeVertex(topRadius * c, 1.0f, topRadius * s, nx, ny, nz, u, 1.0f));
+    }
+
+    mesh.sides = BeginRange(mesh);
+    for (int j = 0; j < sectors; j++)
+    {
+        uint32_t bottom0 = sideStart + j * 2;
+        uint32_t top0 = bottom0 + 1;
+        uint32_t bottom1 = bottom0 + 2;
+        uint32_t top1 = bottom0 + 3;
+
+        mesh.indices.push_back(bottom0);
+        mesh.indices.push_back(top0);
+        mesh.indices.push_back(bottom1);
+
+        mesh.indices.push_back(bottom1);
+        mesh.indices.push_back(top0);
+        mesh.indices.push_back(top1);
+    }
+    EndRange(mesh, mesh.sides);
+
+    mesh.topCap = BeginRange(mesh);
+    AddCap(mesh, sectors, 1.0f, topRadius, true);
+    EndRange(mesh, mesh.topCap);
+
+    // second copy of the bottom cap, so top + bottom is contiguous too
+    mesh.indices.insert(mesh.indices.end(),
+                        mesh.indices.begin() + mesh.bottomCap.first,
+                        mesh.indices.begin() + mesh.bottomCap.first + mesh.bottomCap.count);
+}
+
+/***********************************************************
+ * GenerateTorus()
+ * Ring of radius 1 in the XY plane around the Z axis, with
+ * the given tube radius.
+ ***********************************************************/
+void MeshLibrary::GenerateTorus(int mainSegments, int tubeSegments, float tubeRadius, MESH_DATA& mesh)
+{
+    mesh = MESH_DATA();
+
+    for (int i = 0; i <= mainSegments; i++)
+    {
+        float u = 2.0f * PI * i / mainSegments;
+        float cu = std::cos(u);
+        float su = std::sin(u);
+
+        for (int j = 0; j <= tubeSegments; j++)
+        {
+            float v = 2.0f * PI * j / tubeSegments;
+            float cv = std::cos(v);
+            float sv = std::sin(v);
+            float ring = 1.0f + tubeRadius * cv;
+
+            mesh.vertices.push_back(MakeVertex(
+                ring * cu, ring * su, tubeRadius * sv,
+                cv * cu, cv * su, sv,
+                (float)i / mainSegments, (float)j / tubeSegments));
+        }
+    }
+
+    mesh.sides = BeginRange(mesh);
+    for (int i = 0; i < mainSegments; i++)
+    {
+        for (int j = 0; j < tubeSegments; j++)
+        {
+            uint32_t a = i * (tubeSegments + 1) + j;
+            uint32_t b = a + tubeSegments + 1;
+
+            mesh.indices.push_back(a);
+            mesh.indices.push_back(b);
+            mesh.indices.push_back(a + 1);
+
+            mesh.indices.push_back(a + 1);
+            mesh.indices.push_back(b);
+            mesh.indices.push_back(b + 1);
+        }
+    }
+    EndRange(mesh, mesh.sides);
+
+    mesh.topCap = BeginRange(mesh);
+    mesh.bottomCap = BeginRange(mesh);
+}
+
+/***********************************************************
+ * GetPartsRange()
+ * With the [bottom][sides][top][bottom] layout:
+ *   B, S, T       — their own ranges
+ *   B+S, S+T, all — runs starting at the first part
+ *   T+B           — top followed by the second bottom copy
+ * Meshes without caps only ever have the sides range.
+ ***********************************************************/
+MeshLibrary::INDEX_RANGE MeshLibrary::GetPartsRange(
+    const INDEX_RANGE& sides,
+    const INDEX_RANGE& topCap,
+    const INDEX_RANGE& bottomCap,
+    bool bDrawTop,
+    bool bDrawBottom,
+    bool bDrawSides)
+{
+    INDEX_RANGE range;
+    range.first = 0;
+    range.count = 0;
+
+    if (topCap.count == 0 && bottomCap.count == 0)
+    {
+        if (bDrawSides)
+            range = sides;
+        return range;
+    }
+
+    if (bDrawBottom && bDrawSides)
+    {
+        range.first = bottomCap.first;
+        range.count = bottomCap.count + sides.count + (bDrawTop ? topCap.count : 0);
+    }
+    else if (bDrawSides)
+    {
+        range.first = sides.first;
+        range.count = sides.count + (bDrawTop ? topCap.count : 0);
+    }
+    else if (bDrawTop)
+    {
+        range.first = topCap.first;
+        range.count = topCap.count + (bDrawBottom ? bottomCap.count : 0);
+    }
+    else if (bDrawBottom)
+    {
+        range = bottomCap;
+    }
+    return range;
+}
+
+/***********************************************************
+ * GetShapeParameters()
+ ***********************************************************/
+MeshLibrary::SHAPE_PARAMETERS MeshLibrary::GetShapeParameters(LOD_SHAPE shape, int level)
+{
+    SHAPE_PARAMETERS parameters;
+    parameters.rings = 0;
+    parameters.radius = 0.0f;
+
+    switch (shape)
+    {
+    case LOD_SPHERE:
+        parameters.segments = g_SphereSectors[level];
+        parameters.rings = g_SphereStacks[level];
+        break;
+    case LOD_CYLINDER:
+        parameters.segments = g_CylinderSectors[level];
+        parameters.radius = 1.0f;
+        break;
+    case LOD_TAPERED_CYLINDER:
+        parameters.segments = g_CylinderSectors[level];
+        parameters.radius = TAPERED_TOP_RADIUS;
+        break;
+    case LOD_TORUS:
+    default:
+        parameters.segments = g_TorusMain[level];
+        parameters.rings = g_TorusTube[level];
+        parameters.radius = TORUS_TUBE_RADIUS;
+        break;
+    }
+    return parameters;
+}
+
+/***********************************************************
+ * GenerateLODMesh()
+ * Runs the right generator with the parameters for level.
+ ***********************************************************/
+void MeshLibrary::GenerateLODMesh(LOD_SHAPE shape, int level, MESH_DATA& mesh)
+{
+    SHAPE_PARAMETERS parameters = GetShapeParameters(shape, level);
+    switch (shape)
+    {
+    case LOD_SPHERE:
+        GenerateSphere(parameters.segments, parameters.rings, mesh);
+        break;
+    case LOD_CYLINDER:
+    case LOD_TAPERED_CYLINDER:
+        GenerateCylinder(parameters.segments, parameters.radius, mesh);
+        break;
+    case LOD_TORUS:
+    default:
+        GenerateTorus(parameters.segments, parameters.rings, parameters.radius, mesh);
+        break;
+    }
+}
+
+/***********************************************************
+ * GetCachePath()
+ * e.g. cache/sphere_48x24.mesh, cache/torus_48x24_t0.10.mesh
+ ***********************************************************/
+std::string MeshLibrary::GetCachePath(LOD_SHAPE shape, int level)
+{
+    std::ostringstream path;
+    path.setf(std::ios::fixed);
+    path.precision(2);
+    path << MESH_CACHE_DIRECTORY << "/";
+
+    switch (shape)
+    {
+    case LOD_SPHERE:
+        path << "sphere_" << g_SphereSectors[level] << "x" << g_SphereStacks[level];
+        break;
+    case LOD_CYLINDER:
+        path << "cylinder_" << g_CylinderSectors[level];
+        break;
+    case LOD_TAPERED_CYLINDER:
+        path << "tapered_" << g_CylinderSectors[level] << "_r" << TAPERED_TOP_RADIUS;
+        break;
+    case LOD_TORUS:
+    default:
+        path << "torus_" << g_TorusMain[level] << "x" << g_TorusTube[level] << "_t" << TORUS_TUBE_RADIUS;
+        break;
+    }
+
+    path << ".mesh";
+    return path.str();
+}
+
+/***********************************************************
+ * MakeView()
+ ***********************************************************/
+MeshLibrary::MESH_VIEW MeshLibrary::MakeView(const MESH_DATA& mesh)
+{
+    MESH_VIEW view;
+    view.vertices = mesh.vertices.data();
+    view.vertexCount = (uint32_t)mesh.vertices.size();
+    view.indices = mesh.indices.data();
+    view.indexCount = (uint32_t)mesh.indices.size();
+    view.sides = mesh.sides;
+    view.topCap = mesh.topCap;
+    view.bottomCap = mesh.bottomCap;
+    return view;
+}
+
+/***********************************************************
+ * PackVertices()
+ * Positions are divided by the largest coordinate magnitude
+ * so they fill the snorm16 range; that magnitude comes back
+ * as the scale to undo it.
+ ***********************************************************/
+float MeshLibrary::PackVertices(const MESH_VIEW& mesh, std::vector<PACKED_VERTEX>& packed)
+{
+    float scale = 0.0f;
+    for (uint32_t i = 0; i < mesh.vertexCount; i++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+            scale = std::max(scale, std::fabs(mesh.vertices[i].position[axis]));
+    }
+    if (scale == 0.0f)
+        scale = 1.0f;
+
+    packed.resize(mesh.vertexCount);
+    for (uint32_t i = 0; i < mesh.vertexCount; i++)
+    {
+        const MESH_VERTEX& source = mesh.vertices[i];
+        PACKED_VERTEX& target = packed[i];
+        for (int axis = 0; axis < 3; axis++)
+            target.position[axis] = (int16_t)std::lround(source.position[axis] / scale * 32767.0f);
+        target.position[3] = 0;
+        target.normal = PackNormal(source.normal);
+        target.uv[0] = FloatToHalf(source.uv[0]);
+        target.uv[1] = FloatToHalf(source.uv[1]);
+    }
+    return scale;
+}
+
+/***********************************************************
+ * UploadMesh()
+ * Creates the index buffer and a VAO and vertex buffer per
+ * vertex layout for one mesh. Attribute locations match
+ * ShapeMeshes so the same shader program draws both; the
+ * packed attributes are normalized by the vertex fetch, so
+ * the shader sees the same vec3/vec3/vec2 inputs either way.
+ ***********************************************************/
+void MeshLibrary::UploadMesh(const MESH_VIEW& mesh, GPU_MESH& gpuMesh)
+{
+    gpuMesh.sides = mesh.sides;
+    gpuMesh.topCap = mesh.topCap;
+    gpuMesh.bottomCap = mesh.bottomCap;
+    gpuMesh.vertexCount = mesh.vertexCount;
+
+    glGenVertexArrays(1, &gpuMesh.vao);
+    glBindVertexArray(gpuMesh.vao);
+
+    glGenBuffers(1, &gpuMesh.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertexCount * sizeof(MESH_VERTEX), mesh.vertices, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &gpuMesh.ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpuMesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indexCount * sizeof(uint32_t), mesh.indices, GL_STATIC_DRAW);
+
+    GLsizei stride = sizeof(MESH_VERTEX);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MESH_VERTEX, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MESH_VERTEX, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MESH_VERTEX, uv));
+    glEnableVertexAttribArray(2);
+
+    std::vector<PACKED_VERTEX> packed;
+    gpuMesh.positionScale = PackVertices(mesh, packed);
+
+    glGenVertexArrays(1, &gpuMesh.packedVao);
+    glBindVertexArray(gpuMesh.packedVao);
+
+    glGenBuffers(1, &gpuMesh.packedVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.packedVbo);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PACKED_VERTEX), packed.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpuMesh.ebo);
+
+    stride = sizeof(PACKED_VERTEX);
+    glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PACKED_VERTEX, uv));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+}
+
+/***********************************************************
+ * LoadLODMeshes()
+ * Maps each shape/level from the cache when a current file
+ * exists, otherwise generates it, reorders it for the vertex
+ * cache and writes the file for next time. Mapped files are
+ * uploaded straight from the mapping and closed right
+ * after. Call once from PrepareScene() after the GL context
+ * exists.
+ ***********************************************************/
+void MeshLibrary::LoadLODMeshes()
+{
+    if (m_bLoaded)
+        return;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    bool bCacheWritable = MeshCache::EnsureDirectory(MESH_CACHE_DIRECTORY);
+    int cachedMeshes = 0;
+    int totalTriangles = 0;
+    MESH_DATA mesh;
+    MappedFile file;
+    for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+    {
+        for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+        {
+            std::string path = GetCachePath((LOD_SHAPE)shape, level);
+
+            MESH_VIEW view;
+            if (MeshCache::Read(path, GENERATOR_VERSION, file, view))
+            {
+                cachedMeshes++;
+            }
+            else
+            {
+                GenerateLODMesh((LOD_SHAPE)shape, level, mesh);
+
+                MeshOptimizer::CACHE_STATS before;
+                MeshOptimizer::CACHE_STATS after;
+                MeshOptimizer::OptimizeMesh(mesh, before, after);
+                std::cout << "INFO: Optimized " << path << " — ACMR " << before.acmr << " -> " << after.acmr
+                          << ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+
+                if (bCacheWritable && !MeshCache::Write(path, mesh, GENERATOR_VERSION))
+                {
+                    std::cout << "INFO: Could not write mesh cache file " << path << std::endl;
+                }
+                view = MakeView(mesh);
+            }
+
+            UploadMesh(view, m_meshes[shape][level]);
+            totalTriangles += (int)view.indexCount / 3;
+            file.Close();
+        }
+    }
+
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    m_bLoaded = true;
+    std::cout << "INFO: Loaded " << LOD_LEVEL_COUNT << " LOD levels for "
+              << LOD_SHAPE_COUNT << " shapes (" << totalTriangles << " triangles total, "
+              << cachedMeshes << " of " << LOD_LEVEL_COUNT * LOD_SHAPE_COUNT
+              << " from cache) in " << milliseconds << " ms" << std::endl;
+}
+
+/***********************************************************
+ * ImportMesh()
+ * Parses the file, runs the same optimizer passes the LOD
+ * meshes get, splits it into meshlets and uploads it. Call
+ * after the GL context exists.
+ ***********************************************************/
+int MeshLibrary::ImportMesh(const std::string& path)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    MESH_DATA mesh;
+    if (!MeshImporter::ImportFile(path, mesh))
+        return -1;
+
+    MeshOptimizer::CACHE_STATS before;
+    MeshOptimizer::CACHE_STATS after;
+    MeshOptimizer::OptimizeMesh(mesh, before, after);
+
+    // clustering reorders triangles, so renumber the vertices again
+    // after it and measure the order that actually gets drawn
+    IMPORTED_MESH imported;
+    imported.bClosed = MeshletBuilder::IsWatertight(mesh);
+    MeshletBuilder::BuildMeshlets(mesh, imported.meshlets);
+    MeshOptimizer::OptimizeVertexFetch(mesh);
+    after = MeshOptimizer::AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        imported.boundsMin[axis] = mesh.vertices[0].position[axis];
+        imported.boundsMax[axis] = mesh.vertices[0].position[axis];
+    }
+    for (const MESH_VERTEX& vertex : mesh.vertices)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            imported.boundsMin[axis] = std::min(imported.boundsMin[axis], vertex.position[axis]);
+            imported.boundsMax[axis] = std::max(imported.boundsMax[axis], vertex.position[axis]);
+        }
+    }
+
+    UploadMesh(MakeView(mesh), imported.gpuMesh);
+    m_importedMeshes.push_back(std::move(imported));
+
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "INFO: Imported " << path << " (" << mesh.vertices.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles, ACMR " << before.acmr << " -> " << after.acmr
+              << ", " << m_importedMeshes.back().meshlets.size() << " meshlets, "
+              << (m_importedMeshes.back().bClosed ? "closed" : "open")
+              << ") in " << milliseconds << " ms" << std::endl;
+    return (int)m_importedMeshes.size() - 1;
+}
+
+/***********************************************************
+ * DrawRange()
+ * Draws a run of triangles from the bound index buffer.
+ ***********************************************************/
+void MeshLibrary::DrawRange(const INDEX_RANGE& range)
+{
+    if (range.count == 0)
+        return;
+
+    glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_INT,
+                   (void*)(uintptr_t)(range.first * sizeof(uint32_t)));
+}
+
+/***********************************************************
+ * DrawLODMesh()
+ * Binds the requested level and draws the requested parts
+ * with a single draw call.
+ ***********************************************************/
+void MeshLibrary::DrawLODMesh(
+    LOD_SHAPE shape,
+    int level,
+    bool bDrawTop,
+    bool bDrawBottom,
+    bool bDrawSides)
+{
+    if (!m_bLoaded)
+        return;
+
+    const GPU_MESH& gpuMesh = m_meshes[shape][level];
+    glBindVertexArray(m_bPackedVertices ? gpuMesh.packedVao : gpuMesh.vao);
+    DrawRange(GetPartsRange(gpuMesh.sides, gpuMesh.topCap, gpuMesh.bottomCap, bDrawTop, bDrawBottom, bDrawSides));
+    glBindVertexArray(0);
+}
+
+/***********************************************************
+ * BindLODMeshBuffers()
+ * Same float layout UploadMesh() gives the mesh's own VAO.
+ ***********************************************************/
+void MeshLibrary::BindLODMeshBuffers(LOD_SHAPE shape, int level) const
+{
+    const GPU_MESH& gpuMesh = m_meshes[shape][level];
+    glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpuMesh.ebo);
+
+    GLsizei stride = sizeof(MESH_VERTEX);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MESH_VERTEX, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MESH_VERTEX, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MESH_VERTEX, uv));
+    glEnableVertexAttribArray(2);
+}
+
+/***********************************************************
+ * DrawLODMeshInstanced()
+ * Every part of the mesh, in one call for all instances.
+ ***********************************************************/
+void MeshLibrary::DrawLODMeshInstanced(LOD_SHAPE shape, int level, int instanceCount) const
+{
+    if (!m_bLoaded || instanceCount <= 0)
+        return;
+
+    const GPU_MESH& gpuMesh = m_meshes[shape][level];
+    INDEX_RANGE range = GetPartsRange(gpuMesh.sides, gpuMesh.topCap, gpuMesh.bottomCap, true, true, true);
+    glDrawElementsInstanced(GL_TRIANGLES, range.count, GL_UNSIGNED_INT,
+                            (void*)(uintptr_t)(range.first * sizeof(uint32_t)), instanceCount);
+}
+
+/***********************************************************
+ * DrawImportedMesh()
+ ***********************************************************/
+void MeshLibrary::DrawImportedMesh(int handle, const MeshletCuller* pCuller, int slot)
+{
+    if (handle < 0 || handle >= (int)m_importedMeshes.size())
+        return;
+
+    const GPU_MESH& gpuMesh = m_importedMeshes[handle].gpuMesh;
+    glBindVertexArray(m_bPackedVertices ? gpuMesh.packedVao : gpuMesh.vao);
+    if (pCuller != nullptr)
+        pCuller->DrawSlot(slot);
+    else
+        DrawRange(gpuMesh.sides);
+    glBindVertexArray(0);
+}
+
+/***********************************************************
+ * GetImportedPositionScale()
+ ***********************************************************/
+float MeshLibrary::GetImportedPositionScale(int handle) const
+{
+    if (!m_bPackedVertices || handle < 0 || handle >= (int)m_importedMeshes.size())
+        return 1.0f;
+    return m_importedMeshes[handle].gpuMesh.positionScale;
+}
+
+/***********************************************************
+ * GetImportedBounds()
+ ***********************************************************/
+void MeshLibrary::GetImportedBounds(int handle, float boundsMin[3], float boundsMax[3]) const
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        boundsMin[axis] = m_importedMeshes[handle].boundsMin[axis];
+        boundsMax[axis] = m_importedMeshes[handle].boundsMax[axis];
+    }
+}
+
+/***********************************************************
+ * GetPositionScale()
+ ***********************************************************/
+float MeshLibrary::GetPositionScale(LOD_SHAPE shape, int level) const
+{
+    if (!m_bPackedVertices || !m_bLoaded)
+        return 1.0f;
+    return m_meshes[shape][level].positionScale;
+}
+
+/***********************************************************
+ * GetVertexBufferBytes()
+ ***********************************************************/
+size_t MeshLibrary::GetVertexBufferBytes(bool bPacked) const
+{
+    size_t vertices = 0;
+    for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+    {
+        for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+            vertices += m_meshes[shape][level].vertexCount;
+    }
+    return vertices * (bPacked ? sizeof(PACKED_VERTEX) : sizeof(MESH_VERTEX));
+}
+
+/***********************************************************
+ * GetTriangleCount()
+ * Counts the triangles a DrawLODMesh() call would submit.
+ ***********************************************************/
+int MeshLibrary::GetTriangleCount(
+    LOD_SHAPE shape,
+    int level,
+    bool bDrawTop,
+    bool bDrawBottom,
+    bool bDrawSides) const
+{
+    const GPU_MESH& gpuMesh = m_meshes[shape][level];
+    return (int)GetPartsRange(gpuMesh.sides, gpuMesh.topCap, gpuMesh.bottomCap, bDrawTop, bDrawBottom, bDrawSides).count / 3;
+}
@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshLibrary.h
+// ============
+// In-project procedural meshes with several tessellation levels per
+// shape, used for distance-based level of detail alongside ShapeMeshes.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MeshletCuller;
+
+/***********************************************************
+ *  MeshLibrary
+ *
+ *  Generates the curved ShapeMeshes primitives (sphere,
+ *  cylinder, tapered cylinder, torus) at LOD_LEVEL_COUNT
+ *  tessellation levels with the same unit sizes, origin and
+ *  vertex layout, so a draw can swap between them without
+ *  changing its transform.
+ *
+ *  Generated meshes are saved to MeshCache files under
+ *  cache/ and mapped straight into the GL buffers on later
+ *  starts.
+ *
+ *  Meshes imported from OBJ / glTF files are optimized and
+ *  uploaded the same way and addressed by the handle
+ *  ImportMesh() returns; they aren't cached. Their
+ *  triangles are also grouped into meshlets (see
+ *  MeshletBuilder) so MeshletCuller can skip clusters the
+ *  camera can't see.
+ *
+ *  Every mesh is uploaded twice: once with full floats and
+ *  once as PACKED_VERTEX. Both stay resident so the packed
+ *  layout can be toggled at runtime. Packed positions are
+ *  divided by the mesh's position scale, so a packed draw's
+ *  model matrix has to be multiplied by GetPositionScale().
+ ***********************************************************/
+class MeshLibrary
+{
+public:
+    // constructor
+    MeshLibrary();
+    // destructor
+    ~MeshLibrary();
+
+    // shapes that have LOD levels
+    enum LOD_SHAPE
+    {
+        LOD_SPHERE,
+        LOD_CYLINDER,
+        LOD_TAPERED_CYLINDER,
+        LOD_TORUS,
+        LOD_SHAPE_COUNT
+    };
+
+    // level 0 is the most detailed
+    static const int LOD_LEVEL_COUNT = 4;
+    // bump whenever a generator's output changes, so cached
+    // meshes from older builds are regenerated
+    static const uint32_t GENERATOR_VERSION = 3;
+    // unit torus tube radius (its ring radius is 1) and tapered
+    // cylinder top radius; picking tests against the same surfaces
+    static constexpr float TORUS_TUBE_RADIUS = 0.1f;
+    static constexpr float TAPERED_TOP_RADIUS = 0.5f;
+
+    // same attribute layout as ShapeMeshes: position, normal, UV
+    struct MESH_VERTEX
+    {
+        float position[3];
+        float normal[3];
+        float uv[2];
+    };
+
+    // 16 bytes instead of 32, decoded by the vertex fetch itself:
+    // snorm16 position (w is padding) times the mesh's position
+    // scale, snorm 2_10_10_10 normal, half-float UV
+    struct PACKED_VERTEX
+    {
+        int16_t position[4];
+        uint32_t normal;
+        uint16_t uv[2];
+    };
+
+    // generator inputs for one shape at one level
+    struct SHAPE_PARAMETERS
+    {
+        // sphere sectors, cylinder sectors, torus main segments
+        int segments;
+        // sphere stacks, torus tube segments; unused for cylinders
+        int rings;
+        // cylinder top radius, torus tube radius; unused for spheres
+        float radius;
+    };
+
+    // a run of indices inside a mesh's index buffer
+    struct INDEX_RANGE
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // a cluster of an imported mesh's triangles (see MeshletBuilder)
+    struct MESHLET
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        // bounding sphere
+        float center[3];
+        float radius;
+        // every triangle faces within the cone around coneAxis;
+        // coneCutoff is the sine of its half angle, 1 when the cone
+        // is too wide to ever cull
+        float coneAxis[3];
+        float coneCutoff;
+    };
+
+    // CPU-side mesh. Cylinders split their indices into parts so
+    // caps and sides can be drawn separately like ShapeMeshes does;
+    // other shapes only use the sides range. Cylinder indices are laid
+    // out [bottom][sides][top][bottom again], so every combination of
+    // parts is one contiguous run (see GetPartsRange()); bottomCap is
+    // the first copy.
+    struct MESH_DATA
+    {
+        std::vector<MESH_VERTEX> vertices;
+        std::vector<uint32_t> indices;
+        INDEX_RANGE sides;
+        INDEX_RANGE topCap;
+        INDEX_RANGE bottomCap;
+    };
+
+    // Read-only view of a mesh's buffers, pointing either into a
+    // MESH_DATA or into a mapped cache file
+    struct MESH_VIEW
+    {
+        const MESH_VERTEX* vertices;
+        uint32_t vertexCount;
+        const uint32_t* indices;
+        uint32_t indexCount;
+        INDEX_RANGE sides;
+        INDEX_RANGE topCap;
+        INDEX_RANGE bottomCap;
+    };
+
+    // Load every shape at every level from the cache, generating,
+    // optimizing and caching any that are missing or stale, and upload them
+    void LoadLODMeshes();
+    // Draw one shape at one level; cap flags only matter for cylinders
+    void DrawLODMesh(
+        LOD_SHAPE shape,
+        int level,
+        bool bDrawTop = true,
+        bool bDrawBottom = true,
+        bool bDrawSides = true);
+    // Point attributes 0-2 and the index buffer of the bound VAO at one
+    // shape and level's float vertices, for callers that add their own
+    // per-instance attributes
+    void BindLODMeshBuffers(LOD_SHAPE shape, int level) const;
+    // Draw one shape at one level instanceCount times with the bound
+    // VAO, which BindLODMeshBuffers() must have set up
+    void DrawLODMeshInstanced(LOD_SHAPE shape, int level, int instanceCount) const;
+    // Import a mesh file (see MeshImporter), optimize and upload it;
+    // returns its handle, or -1 if it couldn't be read
+    int ImportMesh(const std::string& path);
+    // Draw an imported mesh: the clusters pCuller kept in slot, or
+    // the whole mesh without a culler
+    void DrawImportedMesh(int handle, const MeshletCuller* pCuller = nullptr, int slot = -1);
+    // Same as GetPositionScale(), for an imported mesh
+    float GetImportedPositionScale(int handle) const;
+    // Object-space bounding box of an imported mesh
+    void GetImportedBounds(int handle, float boundsMin[3], float boundsMax[3]) const;
+    // Clusters of an imported mesh, in index buffer order
+    const std::vector<MESHLET>& GetImportedMeshlets(int handle) const { return m_importedMeshes[handle].meshlets; }
+    // Whether an imported mesh is watertight, so it can be back-face culled
+    bool IsImportedMeshClosed(int handle) const { return m_importedMeshes[handle].bClosed; }
+    // Choose which uploaded vertex layout the draw calls use
+    void SetPackedVertices(bool bPacked) { m_bPackedVertices = bPacked; }
+    bool IsPackedVertices() const { return m_bPackedVertices; }
+    // Uniform scale a draw of this mesh must apply on top of its model
+    // matrix; always 1 with the float layout
+    float GetPositionScale(LOD_SHAPE shape, int level) const;
+    // Vertex buffer bytes for every shape and level in one layout
+    size_t GetVertexBufferBytes(bool bPacked) const;
+    // Triangles DrawLODMesh() would issue for the same arguments
+    int GetTriangleCount(
+        LOD_SHAPE shape,
+        int level,
+        bool bDrawTop = true,
+        bool bDrawBottom = true,
+        bool bDrawSides = true) const;
+
+    // The single run of indices that draws the requested parts of a
+    // mesh with the cylinder layout above; count is 0 if nothing is
+    // requested. Works in any unit, e.g. vertices for unindexed draws.
+    static INDEX_RANGE GetPartsRange(
+        const INDEX_RANGE& sides,
+        const INDEX_RANGE& topCap,
+        const INDEX_RANGE& bottomCap,
+        bool bDrawTop,
+        bool bDrawBottom,
+        bool bDrawSides);
+
+    // Tessellation and proportions every level of a shape is built with
+    static SHAPE_PARAMETERS GetShapeParameters(LOD_SHAPE shape, int level);
+
+    // Generators — radius 1, cylinders from y = 0 to y = 1
+    static void GenerateSphere(int sectors, int stacks, MESH_DATA& mesh);
+    static void GenerateCylinder(int sectors, float topRadius, MESH_DATA& mesh);
+    static void GenerateTorus(int mainSegments, int tubeSegments, float tubeRadius, MESH_DATA& mesh);
+    // Quantize a mesh to PACKED_VERTEX; returns the position scale
+    static float PackVertices(const MESH_VIEW& mesh, std::vector<PACKED_VERTEX>& packed);
+
+private:
+    // GL objects for one uploaded mesh; both VAOs share the index buffer
+    struct GPU_MESH
+    {
+        GLuint vao;
+        GLuint vbo;
+        GLuint packedVao;
+        GLuint packedVbo;
+        GLuint ebo;
+        uint32_t vertexCount;
+        float positionScale;
+        INDEX_RANGE sides;
+        INDEX_RANGE topCap;
+        INDEX_RANGE bottomCap;
+    };
+
+    // An uploaded file mesh and what scene culling needs
+    struct IMPORTED_MESH
+    {
+        GPU_MESH gpuMesh;
+        float boundsMin[3];
+        float boundsMax[3];
+        std::vector<MESHLET> meshlets;
+        bool bClosed;
+    };
+
+    // Generate one shape at one level
+    static void GenerateLODMesh(LOD_SHAPE shape, int level, MESH_DATA& mesh);
+    // Cache file for one shape at one level; the name carries the
+    // tessellation so retuning a level never picks up an old file
+    static std::string GetCachePath(LOD_SHAPE shape, int level);
+    // View over a generated mesh
+    static MESH_VIEW MakeView(const MESH_DATA& mesh);
+    // Copy a mesh into new GL buffers, in both vertex layouts
+    static void UploadMesh(const MESH_VIEW& mesh, GPU_MESH& gpuMesh);
+    // Free one mesh's GL objects
+    static void DestroyMesh(GPU_MESH& gpuMesh);
+    // Issue one indexed draw
+    static void DrawRange(const INDEX_RANGE& range);
+
+    GPU_MESH m_meshes[LOD_SHAPE_COUNT][LOD_LEVEL_COUNT];
+    std::vector<IMPORTED_MESH> m_importedMeshes;
+    bool m_bLoaded;
+    bool m_bPackedVertices;
+};
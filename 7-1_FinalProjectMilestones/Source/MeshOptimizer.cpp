@@ -0,0 +1,438 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshOptimizer.cpp
+// ============
+// Index and vertex reordering for generated meshes: post-transform
+// cache ordering, overdraw-aware cluster ordering and vertex fetch
+// ordering, plus the cache stats to compare before and after.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+    // Forsyth's tuning constants, as published
+    const int LRU_CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    // How much a vertex wants its remaining triangles drawn now
+    float VertexScore(int cachePosition, int remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            // the triangle just drawn is best kept together with its neighbours
+            if (cachePosition < 3)
+            {
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else
+            {
+                float scaler = 1.0f / (LRU_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        // finish off vertices with few triangles left so they leave the cache for good
+        score += VALENCE_BOOST_SCALE * std::pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    // Counts misses of a FIFO cache over a run of triangles; also
+    // reports which triangles missed on all three vertices
+    int CountFifoMisses(
+        const uint32_t* indices,
+        size_t indexCount,
+        std::vector<unsigned int>& timestamps,
+        std::vector<bool>* pHardBoundaries)
+    {
+        // a vertex is in the cache if it was loaded fewer than
+        // FIFO_CACHE_SIZE misses ago
+        std::fill(timestamps.begin(), timestamps.end(), 0u);
+        unsigned int time = MeshOptimizer::FIFO_CACHE_SIZE + 1;
+        int misses = 0;
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            int triangleMisses = 0;
+            for (int corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = indices[i + corner];
+                if (time - timestamps[vertex] > (unsigned int)MeshOptimizer::FIFO_CACHE_SIZE)
+                {
+                    timestamps[vertex] = time++;
+                    triangleMisses++;
+                }
+            }
+            misses += triangleMisses;
+            if (pHardBoundaries != nullptr)
+                (*pHardBoundaries)[i / 3] = (triangleMisses == 3);
+        }
+        return misses;
+    }
+
+    glm::vec3 GetPosition(const MeshLibrary::MESH_VERTEX& vertex)
+    {
+        return glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]);
+    }
+}
+
+/***********************************************************
+ * AnalyzeVertexCache()
+ ***********************************************************/
+MeshOptimizer::CACHE_STATS MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    CACHE_STATS stats;
+    stats.acmr = 0.0f;
+    stats.atvr = 0.0f;
+    if (indexCount < 3)
+        return stats;
+
+    std::vector<unsigned int> timestamps(vertexCount);
+    int misses = CountFifoMisses(indices, indexCount, timestamps, nullptr);
+
+    std::vector<bool> referenced(vertexCount, false);
+    size_t uniqueVertices = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (!referenced[indices[i]])
+        {
+            referenced[indices[i]] = true;
+            uniqueVertices++;
+        }
+    }
+
+    stats.acmr = (float)misses / (float)(indexCount / 3);
+    stats.atvr = (float)misses / (float)uniqueVertices;
+    return stats;
+}
+
+/***********************************************************
+ * OptimizeVertexCache()
+ * Tom Forsyth, "Linear-Speed Vertex Cache Optimisation".
+ * Each step emits the best-scoring triangle touching the
+ * simulated cache, falling back to a scan of the remaining
+ * triangles only when nothing in the cache has any left.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    // vertex -> triangles adjacency, packed into one array
+    std::vector<int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        remaining[indices[i]]++;
+
+    std::vector<size_t> adjacencyStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+
+    std::vector<size_t> adjacency(triangleCount * 3);
+    std::vector<size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        for (int corner = 0; corner < 3; corner++)
+            adjacency[fill[indices[t * 3 + corner]]++] = t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        triangleScore[t] = vertexScore[indices[t * 3]] +
+                           vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+    }
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    // cache holds LRU_CACHE_SIZE entries, plus room for a new triangle
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(LRU_CACHE_SIZE + 3);
+    nextCache.reserve(LRU_CACHE_SIZE + 3);
+
+    size_t scanCursor = 0;
+    long long bestTriangle = -1;
+
+    while (output.size() < triangleCount * 3)
+    {
+        if (bestTriangle < 0)
+        {
+            // nothing in the cache to continue from — take the best of the rest
+            while (scanCursor < triangleCount && emitted[scanCursor])
+                scanCursor++;
+            float bestScore = -1.0f;
+            for (size_t t = scanCursor; t < triangleCount; t++)
+            {
+                if (!emitted[t] && triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    bestTriangle = (long long)t;
+                }
+            }
+        }
+
+        size_t triangle = (size_t)bestTriangle;
+        emitted[triangle] = true;
+
+        // emit it and drop it from its vertices' adjacency lists
+        for (int corner = 0; corner < 3; corner++)
+        {
+            uint32_t vertex = indices[triangle * 3 + corner];
+            output.push_back(vertex);
+
+            size_t begin = adjacencyStart[vertex];
+            size_t end = begin + remaining[vertex];
+            for (size_t a = begin; a < end; a++)
+            {
+                if (adjacency[a] == triangle)
+                {
+                    adjacency[a] = adjacency[end - 1];
+                    break;
+                }
+            }
+            remaining[vertex]--;
+        }
+
+        // new LRU order: this triangle's vertices first, then the old cache
+        nextCache.clear();
+        for (int corner = 0; corner < 3; corner++)
+            nextCache.push_back(indices[triangle * 3 + corner]);
+        for (uint32_t vertex : cache)
+        {
+            if (vertex != nextCache[0] && vertex != nextCache[1] && vertex != nextCache[2])
+                nextCache.push_back(vertex);
+        }
+
+        // rescore everything that was or is in the cache
+        for (size_t i = 0; i < nextCache.size(); i++)
+        {
+            uint32_t vertex = nextCache[i];
+            cachePosition[vertex] = (i < (size_t)LRU_CACHE_SIZE) ? (int)i : -1;
+        }
+        for (size_t i = 0; i < nextCache.size(); i++)
+        {
+            uint32_t vertex = nextCache[i];
+            float newScore = VertexScore(cachePosition[vertex], remaining[vertex]);
+            float delta = newScore - vertexScore[vertex];
+            vertexScore[vertex] = newScore;
+
+            size_t begin = adjacencyStart[vertex];
+            size_t end = begin + remaining[vertex];
+            for (size_t a = begin; a < end; a++)
+                triangleScore[adjacency[a]] += delta;
+        }
+
+        // best candidate among triangles still touching the cache
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        size_t keep = std::min(nextCache.size(), (size_t)LRU_CACHE_SIZE);
+        for (size_t i = 0; i < keep; i++)
+        {
+            uint32_t vertex = nextCache[i];
+            size_t begin = adjacencyStart[vertex];
+            size_t end = begin + remaining[vertex];
+            for (size_t a = begin; a < end; a++)
+            {
+                size_t candidate = adjacency[a];
+                if (triangleScore[candidate] > bestScore)
+                {
+                    bestScore = triangleScore[candidate];
+                    bestTriangle = (long long)candidate;
+                }
+            }
+        }
+
+        nextCache.resize(keep);
+        cache.swap(nextCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+/***********************************************************
+ * OptimizeOverdraw()
+ * Cluster split and sort in the spirit of Sander et al.'s
+ * "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw". Each cluster is scored by how far it faces out
+ * from the mesh centre; outward clusters go first so they
+ * win the depth test against the ones behind them.
+ ***********************************************************/
+void MeshOptimizer::OptimizeOverdraw(
+    uint32_t* indices,
+    size_t indexCount,
+    const MeshLibrary::MESH_VERTEX* vertices,
+    size_t vertexCount,
+    float threshold)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2)
+        return;
+
+    std::vector<unsigned int> timestamps(vertexCount);
+    std::vector<bool> hardBoundaries(triangleCount);
+    int baseMisses = CountFifoMisses(indices, indexCount, timestamps, &hardBoundaries);
+
+    std::vector<size_t> clusterStarts;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        if (t == 0 || hardBoundaries[t])
+            clusterStarts.push_back(t);
+    }
+    if (clusterStarts.size() < 2)
+        return;
+    clusterStarts.push_back(triangleCount);
+
+    // area-weighted centroid of the range, then per cluster
+    struct CLUSTER
+    {
+        size_t first;
+        size_t count;
+        float sortKey;
+    };
+
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> clusterCentroids(clusterStarts.size() - 1, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterStarts.size() - 1, glm::vec3(0.0f));
+    std::vector<float> clusterAreas(clusterStarts.size() - 1, 0.0f);
+
+    for (size_t c = 0; c + 1 < clusterStarts.size(); c++)
+    {
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+        {
+            glm::vec3 a = GetPosition(vertices[indices[t * 3]]);
+            glm::vec3 b = GetPosition(vertices[indices[t * 3 + 1]]);
+            glm::vec3 d = GetPosition(vertices[indices[t * 3 + 2]]);
+            glm::vec3 normal = glm::cross(b - a, d - a);
+            float area = glm::length(normal);
+            glm::vec3 centroid = (a + b + d) / 3.0f;
+
+            clusterCentroids[c] += centroid * area;
+            clusterNormals[c] += normal;
+            clusterAreas[c] += area;
+            meshCentroid += centroid * area;
+            meshArea += area;
+        }
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    std::vector<CLUSTER> clusters(clusterStarts.size() - 1);
+    for (size_t c = 0; c < clusters.size(); c++)
+    {
+        clusters[c].first = clusterStarts[c];
+        clusters[c].count = clusterStarts[c + 1] - clusterStarts[c];
+
+        glm::vec3 centroid = (clusterAreas[c] > 0.0f) ? clusterCentroids[c] / clusterAreas[c] : meshCentroid;
+        float normalLength = glm::length(clusterNormals[c]);
+        glm::vec3 normal = (normalLength > 0.0f) ? clusterNormals[c] / normalLength : glm::vec3(0.0f);
+        clusters[c].sortKey = glm::dot(centroid - meshCentroid, normal);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+        [](const CLUSTER& a, const CLUSTER& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> reordered;
+    reordered.reserve(triangleCount * 3);
+    for (const CLUSTER& cluster : clusters)
+    {
+        reordered.insert(reordered.end(),
+                         indices + cluster.first * 3,
+                         indices + (cluster.first + cluster.count) * 3);
+    }
+
+    // only keep the new order if the vertex cache barely notices
+    int newMisses = CountFifoMisses(reordered.data(), reordered.size(), timestamps, nullptr);
+    if (newMisses <= baseMisses * threshold)
+        std::copy(reordered.begin(), reordered.end(), indices);
+}
+
+/***********************************************************
+ * OptimizeVertexFetch()
+ * Vertices the index buffer never uses keep their relative
+ * order at the end.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexFetch(MeshLibrary::MESH_DATA& mesh)
+{
+    const uint32_t UNASSIGNED = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(mesh.vertices.size(), UNASSIGNED);
+    std::vector<MeshLibrary::MESH_VERTEX> reordered;
+    reordered.reserve(mesh.vertices.size());
+
+    for (uint32_t& index : mesh.indices)
+    {
+        if (remap[index] == UNASSIGNED)
+        {
+            remap[index] = (uint32_t)reordered.size();
+            reordered.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    for (size_t v = 0; v < mesh.vertices.size(); v++)
+    {
+        if (remap[v] == UNASSIGNED)
+            reordered.push_back(mesh.vertices[v]);
+    }
+
+    mesh.vertices.swap(reordered);
+}
+
+/***********************************************************
+ * OptimizeMesh()
+ ***********************************************************/
+void MeshOptimizer::OptimizeMesh(MeshLibrary::MESH_DATA& mesh, CACHE_STATS& before, CACHE_STATS& after)
+{
+    const float OVERDRAW_THRESHOLD = 1.05f;
+
+    before = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+    const MeshLibrary::INDEX_RANGE* ranges[3] = { &mesh.sides, &mesh.topCap, &mesh.bottomCap };
+    for (const MeshLibrary::INDEX_RANGE* pRange : ranges)
+    {
+        if (pRange->count == 0)
+            continue;
+
+        uint32_t* indices = mesh.indices.data() + pRange->first;
+        OptimizeVertexCache(indices, pRange->count, mesh.vertices.size());
+        OptimizeOverdraw(indices, pRange->count, mesh.vertices.data(), mesh.vertices.size(), OVERDRAW_THRESHOLD);
+    }
+
+    // a cylinder's second bottom cap copy follows the top cap; keep it
+    // identical to the optimized first copy
+    if (mesh.bottomCap.count > 0)
+    {
+        size_t copyFirst = mesh.topCap.first + mesh.topCap.count;
+        std::copy(mesh.indices.begin() + mesh.bottomCap.first,
+                  mesh.indices.begin() + mesh.bottomCap.first + mesh.bottomCap.count,
+                  mesh.indices.begin() + copyFirst);
+    }
+
+    OptimizeVertexFetch(mesh);
+
+    after = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+}
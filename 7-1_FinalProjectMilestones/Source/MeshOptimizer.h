@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshOptimizer.h
+// ============
+// Index and vertex reordering for generated meshes: post-transform
+// cache ordering, overdraw-aware cluster ordering and vertex fetch
+// ordering, plus the cache stats to compare before and after.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  MeshOptimizer
+ *
+ *  Runs once per mesh before it is cached, so the cost is
+ *  only paid when a cache file is (re)built. Triangles are
+ *  only ever reordered inside their own INDEX_RANGE, so a
+ *  cylinder keeps the layout MeshLibrary::GetPartsRange()
+ *  relies on.
+ ***********************************************************/
+class MeshOptimizer
+{
+public:
+    // post-transform cache efficiency of an index buffer
+    struct CACHE_STATS
+    {
+        // average cache misses per triangle (0.5 is ideal for big grids, 3 is worst)
+        float acmr;
+        // average cache misses per referenced vertex (1 is ideal)
+        float atvr;
+    };
+
+    // Simulated FIFO cache used for stats and cluster splitting —
+    // small enough to be pessimistic for any GPU we run on
+    static const int FIFO_CACHE_SIZE = 16;
+
+    // Measure indices against a FIFO_CACHE_SIZE FIFO cache
+    static CACHE_STATS AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+    // Forsyth's linear-speed ordering: greedily emit the triangle whose
+    // vertices score best against a simulated LRU cache
+    static void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+    // Split cache-ordered triangles into clusters at hard cache misses
+    // and draw outward-facing clusters first, unless that would raise
+    // ACMR by more than threshold (e.g. 1.05 = 5%)
+    static void OptimizeOverdraw(
+        uint32_t* indices,
+        size_t indexCount,
+        const MeshLibrary::MESH_VERTEX* vertices,
+        size_t vertexCount,
+        float threshold);
+    // Renumber vertices in the order the index buffer first uses them
+    static void OptimizeVertexFetch(MeshLibrary::MESH_DATA& mesh);
+
+    // All three passes, each index range on its own; fills in the
+    // whole-mesh stats before and after
+    static void OptimizeMesh(MeshLibrary::MESH_DATA& mesh, CACHE_STATS& before, CACHE_STATS& after);
+};
@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshletBuilder.cpp
+// ============
+// Splits a mesh into small triangle clusters (meshlets) with bounding
+// spheres and normal cones, so whole clusters can be culled on the CPU.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+    // cones wider than this (minimum normal dot below it) can't cull
+    // anything useful, so they are switched off
+    const float MIN_CONE_DOT = 0.1f;
+
+    glm::vec3 GetPosition(const MeshLibrary::MESH_DATA& mesh, uint32_t index)
+    {
+        const float* position = mesh.vertices[index].position;
+        return glm::vec3(position[0], position[1], position[2]);
+    }
+
+    // Unit normal of the triangle starting at indices[base]; zero
+    // for degenerate triangles
+    glm::vec3 GetFaceNormal(const MeshLibrary::MESH_DATA& mesh, const uint32_t* indices, size_t base)
+    {
+        glm::vec3 a = GetPosition(mesh, indices[base]);
+        glm::vec3 b = GetPosition(mesh, indices[base + 1]);
+        glm::vec3 c = GetPosition(mesh, indices[base + 2]);
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float length = glm::length(normal);
+        return length > 0.0f ? normal / length : glm::vec3(0.0f);
+    }
+
+    // Sphere and cone over one finished cluster
+    void ComputeBounds(const MeshLibrary::MESH_DATA& mesh, MeshLibrary::MESHLET& meshlet)
+    {
+        const uint32_t* indices = mesh.indices.data() + meshlet.firstIndex;
+
+        glm::vec3 boundsMin = GetPosition(mesh, indices[0]);
+        glm::vec3 boundsMax = boundsMin;
+        glm::vec3 normalSum(0.0f);
+        for (uint32_t i = 0; i < meshlet.indexCount; i++)
+        {
+            glm::vec3 position = GetPosition(mesh, indices[i]);
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+            if (i % 3 == 0)
+                normalSum += GetFaceNormal(mesh, indices, i);
+        }
+
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (uint32_t i = 0; i < meshlet.indexCount; i++)
+        {
+            glm::vec3 offset = GetPosition(mesh, indices[i]) - center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        }
+
+        meshlet.center[0] = center.x;
+        meshlet.center[1] = center.y;
+        meshlet.center[2] = center.z;
+        meshlet.radius = std::sqrt(radiusSquared);
+
+        meshlet.coneAxis[0] = 0.0f;
+        meshlet.coneAxis[1] = 0.0f;
+        meshlet.coneAxis[2] = 0.0f;
+        meshlet.coneCutoff = 1.0f;
+
+        float sumLength = glm::length(normalSum);
+        if (sumLength < 1e-6f)
+            return;
+
+        glm::vec3 axis = normalSum / sumLength;
+        float minDot = 1.0f;
+        for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+        {
+            // degenerate triangles have no normal and can't be seen anyway
+            glm::vec3 normal = GetFaceNormal(mesh, indices, i);
+            if (normal != glm::vec3(0.0f))
+                minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+
+        meshlet.coneAxis[0] = axis.x;
+        meshlet.coneAxis[1] = axis.y;
+        meshlet.coneAxis[2] = axis.z;
+        if (minDot >= MIN_CONE_DOT)
+            meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+/***********************************************************
+ * BuildMeshlets()
+ * Seeds each cluster with the first unused triangle in the
+ * current (cache-optimized) order, then keeps adding the
+ * neighbor that brings in the fewest new vertices, ties
+ * going to the one best aligned with the cluster's average
+ * normal. A cluster closes when it is full or has no
+ * neighbors left that fit.
+ ***********************************************************/
+void MeshletBuilder::BuildMeshlets(MeshLibrary::MESH_DATA& mesh, std::vector<MeshLibrary::MESHLET>& meshlets)
+{
+    meshlets.clear();
+
+    const uint32_t firstIndex = mesh.sides.first;
+    const uint32_t triangleCount = mesh.sides.count / 3;
+    if (triangleCount == 0)
+        return;
+
+    const uint32_t* sourceIndices = mesh.indices.data() + firstIndex;
+    const size_t vertexCount = mesh.vertices.size();
+
+    // triangles touching each vertex, as offsets into one flat list
+    std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < triangleCount * 3; i++)
+        adjacencyStart[sourceIndices[i] + 1]++;
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+        adjacencyStart[vertex + 1] += adjacencyStart[vertex];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (uint32_t i = 0; i < triangleCount * 3; i++)
+            adjacency[fill[sourceIndices[i]]++] = i / 3;
+    }
+
+    // triangle numbers are relative to the sides range from here on
+    std::vector<glm::vec3> faceNormals(triangleCount);
+    for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+        faceNormals[triangle] = GetFaceNormal(mesh, sourceIndices, triangle * 3);
+
+    std::vector<bool> emitted(triangleCount, false);
+    // which cluster last took each vertex, so membership is one compare
+    std::vector<uint32_t> vertexCluster(vertexCount, UINT32_MAX);
+
+    std::vector<uint32_t> reordered;
+    reordered.reserve(triangleCount * 3);
+    std::vector<uint32_t> clusterTriangles;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> localVertices;
+    std::vector<uint32_t> localIndices;
+    uint32_t nextSeed = 0;
+
+    while (true)
+    {
+        while (nextSeed < triangleCount && emitted[nextSeed])
+            nextSeed++;
+        if (nextSeed == triangleCount)
+            break;
+
+        const uint32_t cluster = (uint32_t)meshlets.size();
+        int clusterVertices = 0;
+        glm::vec3 normalSum(0.0f);
+        clusterTriangles.clear();
+        candidates.clear();
+
+        uint32_t triangle = nextSeed;
+        while (true)
+        {
+            emitted[triangle] = true;
+            clusterTriangles.push_back(triangle);
+            normalSum += faceNormals[triangle];
+            for (int corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = sourceIndices[triangle * 3 + corner];
+                if (vertexCluster[vertex] == cluster)
+                    continue;
+                vertexCluster[vertex] = cluster;
+                clusterVertices++;
+                for (uint32_t i = adjacencyStart[vertex]; i < adjacencyStart[vertex + 1]; i++)
+                {
+                    if (!emitted[adjacency[i]])
+                        candidates.push_back(adjacency[i]);
+                }
+            }
+
+            if ((int)clusterTriangles.size() == MAX_MESHLET_TRIANGLES)
+                break;
+
+            // pick the best neighbor, dropping candidates already taken
+            int bestNewVertices = 4;
+            float bestAlignment = -2.0f;
+            uint32_t best = UINT32_MAX;
+            size_t kept = 0;
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                uint32_t candidate = candidates[i];
+                if (emitted[candidate])
+                    continue;
+                candidates[kept++] = candidate;
+
+                int newVertices = 0;
+                for (int corner = 0; corner < 3; corner++)
+                {
+                    if (vertexCluster[sourceIndices[candidate * 3 + corner]] != cluster)
+                        newVertices++;
+                }
+                if (clusterVertices + newVertices > MAX_MESHLET_VERTICES || newVertices > bestNewVertices)
+                    continue;
+
+                float alignment = glm::dot(faceNormals[candidate], normalSum);
+                if (newVertices < bestNewVertices || alignment > bestAlignment)
+                {
+                    bestNewVertices = newVertices;
+                    bestAlignment = alignment;
+                    best = candidate;
+                }
+            }
+            candidates.resize(kept);
+
+            if (best == UINT32_MAX)
+                break;
+            triangle = best;
+        }
+
+        // growth order isn't cache order, so re-run the cache pass on
+        // the cluster alone — in local numbering it's tiny
+        localVertices.clear();
+        localIndices.clear();
+        for (uint32_t clusterTriangle : clusterTriangles)
+        {
+            for (int corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = sourceIndices[clusterTriangle * 3 + corner];
+                uint32_t local = (uint32_t)(std::find(localVertices.begin(), localVertices.end(), vertex) - localVertices.begin());
+                if (local == localVertices.size())
+                    localVertices.push_back(vertex);
+                localIndices.push_back(local);
+            }
+        }
+        MeshOptimizer::OptimizeVertexCache(localIndices.data(), localIndices.size(), localVertices.size());
+
+        MeshLibrary::MESHLET meshlet;
+        meshlet.firstIndex = firstIndex + (uint32_t)reordered.size();
+        meshlet.indexCount = (uint32_t)localIndices.size();
+        for (uint32_t local : localIndices)
+            reordered.push_back(localVertices[local]);
+        meshlets.push_back(meshlet);
+    }
+
+    std::copy(reordered.begin(), reordered.end(), mesh.indices.begin() + firstIndex);
+
+    for (MeshLibrary::MESHLET& meshlet : meshlets)
+        ComputeBounds(mesh, meshlet);
+}
+
+/***********************************************************
+ * IsWatertight()
+ ***********************************************************/
+bool MeshletBuilder::IsWatertight(const MeshLibrary::MESH_DATA& mesh)
+{
+    const uint32_t firstIndex = mesh.sides.first;
+    const uint32_t indexCount = mesh.sides.count;
+    if (indexCount == 0)
+        return false;
+
+    // weld on exact position bits — seams split vertices by normal or
+    // UV but leave the positions identical
+    struct POSITION_KEY
+    {
+        float position[3];
+        bool operator==(const POSITION_KEY& other) const
+        {
+            return std::memcmp(position, other.position, sizeof(position)) == 0;
+        }
+    };
+    struct POSITION_HASH
+    {
+        size_t operator()(const POSITION_KEY& key) const
+        {
+            uint32_t bits[3];
+            std::memcpy(bits, key.position, sizeof(bits));
+            return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+        }
+    };
+
+    std::unordered_map<POSITION_KEY, uint32_t, POSITION_HASH> welded;
+    welded.reserve(mesh.vertices.size());
+    std::vector<uint32_t> remap(mesh.vertices.size());
+    for (size_t vertex = 0; vertex < mesh.vertices.size(); vertex++)
+    {
+        // -0 and +0 are the same point but not the same bits
+        POSITION_KEY key;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float value = mesh.vertices[vertex].position[axis];
+            key.position[axis] = (value == 0.0f) ? 0.0f : value;
+        }
+        remap[vertex] = welded.emplace(key, (uint32_t)welded.size()).first->second;
+    }
+
+    // each directed edge must appear once, and its reverse once;
+    // triangles that weld down to a line or point don't count
+    std::unordered_map<uint64_t, int> edges;
+    edges.reserve(indexCount);
+    for (uint32_t i = 0; i < indexCount; i += 3)
+    {
+        uint32_t corners[3];
+        for (int corner = 0; corner < 3; corner++)
+            corners[corner] = remap[mesh.indices[firstIndex + i + corner]];
+        if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0])
+            continue;
+
+        for (int corner = 0; corner < 3; corner++)
+        {
+            uint64_t edge = ((uint64_t)corners[corner] << 32) | corners[(corner + 1) % 3];
+            if (++edges[edge] > 1)
+                return false;
+        }
+    }
+    for (const auto& edge : edges)
+    {
+        uint64_t reverse = (edge.first << 32) | (edge.first >> 32);
+        if (edges.find(reverse) == edges.end())
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshletBuilder.h
+// ============
+// Splits a mesh into small triangle clusters (meshlets) with bounding
+// spheres and normal cones, so whole clusters can be culled on the CPU.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  MeshletBuilder
+ *
+ *  Runs once per mesh at import time. Each cluster grows
+ *  from a seed triangle through its neighbors, preferring
+ *  triangles that add no new vertices and that face the
+ *  same way as the cluster, so clusters stay compact and
+ *  their normal cones stay narrow. The index buffer is
+ *  reordered so every cluster is one contiguous run.
+ ***********************************************************/
+class MeshletBuilder
+{
+public:
+    // cluster limits — in the 64-128 triangle range, with few enough
+    // vertices that the cluster stays a compact patch
+    static const int MAX_MESHLET_VERTICES = 64;
+    static const int MAX_MESHLET_TRIANGLES = 124;
+
+    // Build clusters over the mesh's sides range, reordering its
+    // triangles so each cluster is contiguous. Caps are left alone.
+    static void BuildMeshlets(MeshLibrary::MESH_DATA& mesh, std::vector<MeshLibrary::MESHLET>& meshlets);
+
+    // True when every edge, after welding equal positions, is shared by
+    // exactly two triangles wound in opposite directions — only then
+    // can a cluster's back faces never be seen through a hole
+    static bool IsWatertight(const MeshLibrary::MESH_DATA& mesh);
+};
@@ -0,0 +1,274 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshletCuller.cpp
+// ============
+// Per-frame CPU culling of imported mesh clusters: frustum tests on the
+// cluster spheres and back-facing tests on their normal cones, with the
+// survivors written to an indirect draw buffer.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshletCuller.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+/***********************************************************
+ * MeshletCuller()
+ ***********************************************************/
+MeshletCuller::MeshletCuller(WorkerPool* pWorkerPool)
+    : m_pWorkerPool(pWorkerPool)
+    , m_eye(0.0f)
+    , m_meshletCount(0)
+    , m_bCheckedGL(false)
+    , m_bIndirect(false)
+    , m_indirectBuffer(0)
+    , m_indirectCapacity(0)
+{
+    for (int plane = 0; plane < 6; plane++)
+        m_planes[plane] = glm::vec4(0.0f);
+    m_stats = CULL_STATS();
+}
+
+/***********************************************************
+ * ~MeshletCuller()
+ ***********************************************************/
+MeshletCuller::~MeshletCuller()
+{
+    if (m_indirectBuffer != 0)
+        glDeleteBuffers(1, &m_indirectBuffer);
+    m_pWorkerPool = nullptr;
+}
+
+/***********************************************************
+ * BeginFrame()
+ * Pulls the six frustum planes out of the view-projection
+ * rows (Gribb/Hartmann) and normalizes them so sphere
+ * distances come out in world units.
+ ***********************************************************/
+void MeshletCuller::BeginFrame(const glm::mat4& viewProjection, const glm::vec3& eye)
+{
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; r++)
+        row[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+
+    m_planes[0] = row[3] + row[0];
+    m_planes[1] = row[3] - row[0];
+    m_planes[2] = row[3] + row[1];
+    m_planes[3] = row[3] - row[1];
+    m_planes[4] = row[3] + row[2];
+    m_planes[5] = row[3] - row[2];
+    for (int plane = 0; plane < 6; plane++)
+        m_planes[plane] /= glm::length(glm::vec3(m_planes[plane]));
+
+    m_eye = eye;
+    m_draws.clear();
+    m_meshletCount = 0;
+}
+
+/***********************************************************
+ * AddDraw()
+ ***********************************************************/
+int MeshletCuller::AddDraw(const std::vector<MeshLibrary::MESHLET>& meshlets, const glm::mat4& model, bool bConeCulling)
+{
+    CULL_DRAW draw;
+    draw.pMeshlets = meshlets.data();
+    draw.meshletCount = (int)meshlets.size();
+    draw.model = model;
+    draw.localEye = glm::vec3(glm::inverse(model) * glm::vec4(m_eye, 1.0f));
+    draw.maxScale = std::max(glm::length(glm::vec3(model[0])),
+                             std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    draw.bConeCulling = bConeCulling;
+    draw.firstMeshlet = m_meshletCount;
+    draw.firstCommand = 0;
+    draw.commandCount = 0;
+
+    m_draws.push_back(draw);
+    m_meshletCount += draw.meshletCount;
+    return (int)m_draws.size() - 1;
+}
+
+/***********************************************************
+ * CullJob()
+ * A cluster is back-facing when the camera sits inside the
+ * cone opposite its normal cone, pushed back by the sphere
+ * radius — every triangle then faces away whatever point of
+ * the cluster it is seen from.
+ ***********************************************************/
+void MeshletCuller::CullJob(CULL_JOB& job)
+{
+    const CULL_DRAW& draw = m_draws[job.draw];
+    job.offscreen = 0;
+    job.backFacing = 0;
+
+    for (int i = job.begin; i < job.end; i++)
+    {
+        const MeshLibrary::MESHLET& meshlet = draw.pMeshlets[i];
+        glm::vec3 center(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+        uint8_t bVisible = 1;
+
+        glm::vec3 worldCenter = glm::vec3(draw.model * glm::vec4(center, 1.0f));
+        float worldRadius = meshlet.radius * draw.maxScale;
+        for (int plane = 0; plane < 6; plane++)
+        {
+            if (glm::dot(glm::vec3(m_planes[plane]), worldCenter) + m_planes[plane].w < -worldRadius)
+            {
+                bVisible = 0;
+                job.offscreen++;
+                break;
+            }
+        }
+
+        if (bVisible && draw.bConeCulling && meshlet.coneCutoff < 1.0f)
+        {
+            glm::vec3 toCenter = center - draw.localEye;
+            glm::vec3 axis(meshlet.coneAxis[0], meshlet.coneAxis[1], meshlet.coneAxis[2]);
+            if (glm::dot(toCenter, axis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius)
+            {
+                bVisible = 0;
+                job.backFacing++;
+            }
+        }
+
+        m_visible[draw.firstMeshlet + i] = bVisible;
+    }
+}
+
+/***********************************************************
+ * Cull()
+ * No GL calls; the chunks run on whichever threads the pool
+ * has free.
+ ***********************************************************/
+void MeshletCuller::Cull()
+{
+    m_stats = CULL_STATS();
+    m_stats.draws = (int)m_draws.size();
+    m_stats.tested = m_meshletCount;
+    m_commands.clear();
+    if (m_draws.empty())
+        return;
+
+    m_jobs.clear();
+    for (int draw = 0; draw < (int)m_draws.size(); draw++)
+    {
+        for (int begin = 0; begin < m_draws[draw].meshletCount; begin += MESHLETS_PER_JOB)
+        {
+            CULL_JOB job;
+            job.draw = draw;
+            job.begin = begin;
+            job.end = begin + MESHLETS_PER_JOB;
+            if (job.end > m_draws[draw].meshletCount)
+                job.end = m_draws[draw].meshletCount;
+            job.offscreen = 0;
+            job.backFacing = 0;
+            m_jobs.push_back(job);
+        }
+    }
+
+    m_visible.resize(m_meshletCount);
+    m_pWorkerPool->ParallelFor((int)m_jobs.size(), [this](int job)
+    {
+        CullJob(m_jobs[job]);
+    });
+
+    for (const CULL_JOB& job : m_jobs)
+    {
+        m_stats.offscreen += job.offscreen;
+        m_stats.backFacing += job.backFacing;
+    }
+
+    // Compact each draw's survivors, merging runs that touch
+    for (CULL_DRAW& draw : m_draws)
+    {
+        draw.firstCommand = (int)m_commands.size();
+        for (int i = 0; i < draw.meshletCount; i++)
+        {
+            if (!m_visible[draw.firstMeshlet + i])
+                continue;
+
+            const MeshLibrary::MESHLET& meshlet = draw.pMeshlets[i];
+            if ((int)m_commands.size() > draw.firstCommand &&
+                m_commands.back().firstIndex + m_commands.back().count == meshlet.firstIndex)
+            {
+                m_commands.back().count += meshlet.indexCount;
+                continue;
+            }
+
+            DRAW_COMMAND command;
+            command.count = meshlet.indexCount;
+            command.instanceCount = 1;
+            command.firstIndex = meshlet.firstIndex;
+            command.baseVertex = 0;
+            command.baseInstance = 0;
+            m_commands.push_back(command);
+        }
+        draw.commandCount = (int)m_commands.size() - draw.firstCommand;
+    }
+    m_stats.commands = (int)m_commands.size();
+}
+
+/***********************************************************
+ * Upload()
+ ***********************************************************/
+void MeshletCuller::Upload()
+{
+    if (!m_bCheckedGL)
+    {
+        m_bCheckedGL = true;
+        m_bIndirect = GLEW_ARB_multi_draw_indirect != 0;
+        if (m_bIndirect)
+            glGenBuffers(1, &m_indirectBuffer);
+    }
+
+    if (m_bIndirect)
+    {
+        // orphan and refill, growing the store only when it's too small
+        size_t bytes = m_commands.size() * sizeof(DRAW_COMMAND);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+        if (bytes > m_indirectCapacity)
+            m_indirectCapacity = std::max(bytes, m_indirectCapacity * 2);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, m_indirectCapacity, nullptr, GL_STREAM_DRAW);
+        if (bytes > 0)
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, bytes, m_commands.data());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    else
+    {
+        m_counts.clear();
+        m_offsets.clear();
+        for (const DRAW_COMMAND& command : m_commands)
+        {
+            m_counts.push_back((GLsizei)command.count);
+            m_offsets.push_back((const void*)(uintptr_t)(command.firstIndex * sizeof(uint32_t)));
+        }
+    }
+}
+
+/***********************************************************
+ * DrawSlot()
+ ***********************************************************/
+void MeshletCuller::DrawSlot(int slot) const
+{
+    if (slot < 0 || slot >= (int)m_draws.size())
+        return;
+
+    const CULL_DRAW& draw = m_draws[slot];
+    if (draw.commandCount == 0)
+        return;
+
+    if (m_bIndirect)
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (const void*)(uintptr_t)(draw.firstCommand * sizeof(DRAW_COMMAND)),
+                                    draw.commandCount, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    else
+    {
+        glMultiDrawElements(GL_TRIANGLES, &m_counts[draw.firstCommand], GL_UNSIGNED_INT,
+                            &m_offsets[draw.firstCommand], draw.commandCount);
+    }
+}
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshletCuller.h
+// ============
+// Per-frame CPU culling of imported mesh clusters: frustum tests on the
+// cluster spheres and back-facing tests on their normal cones, with the
+// survivors written to an indirect draw buffer.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class WorkerPool;
+
+/***********************************************************
+ *  MeshletCuller
+ *
+ *  Each frame the scene adds the imported draws that
+ *  survived whole-object culling; Cull() then tests every
+ *  cluster of every draw in chunks on the worker pool and
+ *  packs the visible ones into one
+ *  glDrawElementsIndirect-style command list, and Upload()
+ *  hands that list to GL. Neighboring visible clusters
+ *  share a command, since their index runs are contiguous.
+ *  Everything up to Upload() is CPU-only, so AddDraw() can
+ *  be called from a worker building the next frame.
+ *
+ *  The cone test is only valid with back-face culling on,
+ *  so draws say whether it applies. It runs in the mesh's
+ *  object space, which keeps it exact under non-uniform and
+ *  mirrored transforms.
+ *
+ *  Without ARB_multi_draw_indirect (a 3.3 context on macOS)
+ *  the same commands go through glMultiDrawElements().
+ ***********************************************************/
+class MeshletCuller
+{
+public:
+    // constructor
+    MeshletCuller(WorkerPool* pWorkerPool);
+    // destructor
+    ~MeshletCuller();
+
+    // per-frame counters for logging
+    struct CULL_STATS
+    {
+        int draws;
+        int tested;
+        int offscreen;
+        int backFacing;
+        int commands;
+    };
+
+    // Forget last frame's draws and set this frame's camera
+    void BeginFrame(const glm::mat4& viewProjection, const glm::vec3& eye);
+    // Queue one draw of an imported mesh's clusters; returns the slot
+    // DrawSlot() takes. The meshlets must outlive the frame.
+    int AddDraw(const std::vector<MeshLibrary::MESHLET>& meshlets, const glm::mat4& model, bool bConeCulling);
+    // Test every queued cluster (runs on the worker pool) and build the
+    // visible ones' commands. Call once, after the last AddDraw().
+    void Cull();
+    // Upload the commands from Cull(); GL thread only, before DrawSlot()
+    void Upload();
+    // Draw a slot's visible clusters from the bound VAO's index buffer
+    void DrawSlot(int slot) const;
+
+    const CULL_STATS& GetStats() const { return m_stats; }
+
+    // clusters tested per worker job
+    static const int MESHLETS_PER_JOB = 256;
+
+private:
+    // same layout as GL's DrawElementsIndirectCommand
+    struct DRAW_COMMAND
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    // one queued draw
+    struct CULL_DRAW
+    {
+        const MeshLibrary::MESHLET* pMeshlets;
+        int meshletCount;
+        glm::mat4 model;
+        // camera position in the mesh's object space
+        glm::vec3 localEye;
+        // largest axis scale of the model, for the sphere radius
+        float maxScale;
+        bool bConeCulling;
+        // where this draw's flags and commands start
+        int firstMeshlet;
+        int firstCommand;
+        int commandCount;
+    };
+
+    // a run of one draw's clusters for one worker
+    struct CULL_JOB
+    {
+        int draw;
+        int begin;
+        int end;
+        int offscreen;
+        int backFacing;
+    };
+
+    // Test one job's clusters and set their visibility flags
+    void CullJob(CULL_JOB& job);
+
+    WorkerPool* m_pWorkerPool;
+
+    // world-space frustum planes, xyz normal and w distance
+    glm::vec4 m_planes[6];
+    glm::vec3 m_eye;
+
+    std::vector<CULL_DRAW> m_draws;
+    std::vector<CULL_JOB> m_jobs;
+    std::vector<uint8_t> m_visible;
+    std::vector<DRAW_COMMAND> m_commands;
+    int m_meshletCount;
+
+    // fallback path: per-command counts and byte offsets
+    std::vector<GLsizei> m_counts;
+    std::vector<const void*> m_offsets;
+
+    // indirect support is looked up on the first upload, once GL is live
+    bool m_bCheckedGL;
+    bool m_bIndirect;
+    GLuint m_indirectBuffer;
+    size_t m_indirectCapacity;
+
+    CULL_STATS m_stats;
+};
@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////
+// OcclusionCuller.cpp
+// ============
+// CPU-only software occlusion culling. Large box occluders (walls,
+// counter slab, fridge body) are rasterized into a small tiled depth
+// buffer, then object bounds are tested against it before any GL call.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionCuller.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // clip-space w below this counts as touching the near plane
+    const float NEAR_W_EPSILON = 1e-4f;
+    // tile rows handed to each rasterization job
+    const int TILE_ROWS_PER_JOB = 2;
+    // every bit of a tile coverage mask set
+    const uint64_t FULL_TILE_MASK = ~0ull;
+
+    // Unit box corners — bit 0 = +X, bit 1 = +Y, bit 2 = +Z
+    glm::vec4 BoxCorner(int index)
+    {
+        return glm::vec4(
+            (index & 1) ? 0.5f : -0.5f,
+            (index & 2) ? 0.5f : -0.5f,
+            (index & 4) ? 0.5f : -0.5f,
+            1.0f);
+    }
+
+    // Box faces wound counter-clockwise when seen from outside
+    const int g_BoxFaces[6][4] =
+    {
+        { 0, 4, 6, 2 },  // -X
+        { 1, 3, 7, 5 },  // +X
+        { 0, 1, 5, 4 },  // -Y
+        { 2, 6, 7, 3 },  // +Y
+        { 0, 2, 3, 1 },  // -Z
+        { 4, 5, 7, 6 }   // +Z
+    };
+}
+
+/***********************************************************
+ * OcclusionCuller()
+ * Allocates the tiled depth buffer. The worker pool is
+ * borrowed, not owned.
+ ***********************************************************/
+OcclusionCuller::OcclusionCuller(WorkerPool* pWorkerPool)
+    : m_pWorkerPool(pWorkerPool)
+    , m_viewProjection(1.0f)
+    , m_depth(TILES_X * TILES_Y * TILE_SIZE * TILE_SIZE, 1.0f)
+    , m_tileMask(TILES_X * TILES_Y, 0)
+    , m_tileMaxDepth(TILES_X * TILES_Y, 1.0f)
+    , m_stats()
+{
+}
+
+/***********************************************************
+ * ~OcclusionCuller()
+ ***********************************************************/
+OcclusionCuller::~OcclusionCuller()
+{
+    m_pWorkerPool = nullptr;
+}
+
+/***********************************************************
+ * BeginFrame()
+ * Resets the depth buffer to the far plane and drops last
+ * frame's occluders.
+ ***********************************************************/
+void OcclusionCuller::BeginFrame(const glm::mat4& viewProjection)
+{
+    m_viewProjection = viewProjection;
+    m_faces.clear();
+    m_stats = CULL_STATS();
+
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    std::fill(m_tileMask.begin(), m_tileMask.end(), 0ull);
+    std::fill(m_tileMaxDepth.begin(), m_tileMaxDepth.end(), 1.0f);
+}
+
+/***********************************************************
+ * AddOccluderBox()
+ * Projects the corners of a unit box and sets up each
+ * front-facing face for rasterization.
+ ***********************************************************/
+void OcclusionCuller::AddOccluderBox(const glm::mat4& model)
+{
+    glm::mat4 modelViewProjection = m_viewProjection * model;
+
+    glm::vec4 corners[8];
+    for (int i = 0; i < 8; i++)
+    {
+        corners[i] = modelViewProjection * BoxCorner(i);
+    }
+
+    for (int f = 0; f < 6; f++)
+    {
+        glm::vec4 quad[4];
+        for (int v = 0; v < 4; v++)
+        {
+            quad[v] = corners[g_BoxFaces[f][v]];
+        }
+        SetupFace(quad);
+    }
+}
+
+/***********************************************************
+ * SetupFace()
+ * Converts a clip-space quad into screen-space edge and
+ * depth equations. Faces that cross the near plane or face
+ * away from the camera are skipped — leaving them out can
+ * only make the buffer less aggressive, never wrong.
+ ***********************************************************/
+void OcclusionCuller::SetupFace(const glm::vec4 clip[4])
+{
+    float sx[4], sy[4], sz[4];
+    for (int v = 0; v < 4; v++)
+    {
+        if (clip[v].w < NEAR_W_EPSILON)
+            return;
+
+        float invW = 1.0f / clip[v].w;
+        sx[v] = (clip[v].x * invW * 0.5f + 0.5f) * BUFFER_WIDTH;
+        sy[v] = (clip[v].y * invW * 0.5f + 0.5f) * BUFFER_HEIGHT;
+        sz[v] = clip[v].z * invW * 0.5f + 0.5f;
+    }
+
+    // Shoelace area — positive means counter-clockwise, i.e. front-facing
+    float area = 0.0f;
+    for (int v = 0; v < 4; v++)
+    {
+        int n = (v + 1) & 3;
+        area += sx[v] * sy[n] - sx[n] * sy[v];
+    }
+    if (area <= 1e-6f)
+        return;
+
+    OCCLUDER_FACE face;
+
+    // Edge functions, pulled inward by half a pixel's extent so a
+    // positive value at the pixel center means the whole pixel is inside
+    for (int v = 0; v < 4; v++)
+    {
+        int n = (v + 1) & 3;
+        float a = -(sy[n] - sy[v]);
+        float b = sx[n] - sx[v];
+        face.edgeA[v] = a;
+        face.edgeB[v] = b;
+        face.edgeC[v] = -(a * sx[v] + b * sy[v]) - 0.5f * (std::fabs(a) + std::fabs(b));
+    }
+
+    // Depth plane through the first three corners (NDC depth is affine in
+    // screen space for a planar face). Pushed back by half a pixel's extent
+    // so each pixel stores the farthest depth the face reaches inside it.
+    float d1x = sx[1] - sx[0], d1y = sy[1] - sy[0], d1z = sz[1] - sz[0];
+    float d2x = sx[2] - sx[0], d2y = sy[2] - sy[0], d2z = sz[2] - sz[0];
+    float nx = d1y * d2z - d1z * d2y;
+    float ny = d1z * d2x - d1x * d2z;
+    float nz = d1x * d2y - d1y * d2x;
+    if (std::fabs(nz) < 1e-6f)
+        return;
+
+    face.depthA = -nx / nz;
+    face.depthB = -ny / nz;
+    face.depthC = sz[0] - face.depthA * sx[0] - face.depthB * sy[0]
+                + 0.5f * (std::fabs(face.depthA) + std::fabs(face.depthB));
+
+    float minX = std::min(std::min(sx[0], sx[1]), std::min(sx[2], sx[3]));
+    float maxX = std::max(std::max(sx[0], sx[1]), std::max(sx[2], sx[3]));
+    float minY = std::min(std::min(sy[0], sy[1]), std::min(sy[2], sy[3]));
+    float maxY = std::max(std::max(sy[0], sy[1]), std::max(sy[2], sy[3]));
+
+    face.minX = std::max(0, (int)std::floor(minX));
+    face.minY = std::max(0, (int)std::floor(minY));
+    face.maxX = std::min(BUFFER_WIDTH - 1, (int)std::floor(maxX));
+    face.maxY = std::min(BUFFER_HEIGHT - 1, (int)std::floor(maxY));
+    if (face.minX > face.maxX || face.minY > face.maxY)
+        return;
+
+    m_faces.push_back(face);
+}
+
+/***********************************************************
+ * RasterizeOccluders()
+ * Splits the buffer into bands of tile rows and rasterizes
+ * every face into each band on the worker pool. Bands never
+ * share pixels, so no locking is needed.
+ ***********************************************************/
+void OcclusionCuller::RasterizeOccluders()
+{
+    m_stats.occluderFaces = (int)m_faces.size();
+    if (m_faces.empty())
+        return;
+
+    int jobCount = (TILES_Y + TILE_ROWS_PER_JOB - 1) / TILE_ROWS_PER_JOB;
+    auto rasterizeJob = [this](int job)
+    {
+        int firstRow = job * TILE_ROWS_PER_JOB;
+        int lastRow = std::min(TILES_Y, firstRow + TILE_ROWS_PER_JOB);
+        RasterizeBand(firstRow, lastRow);
+    };
+
+    if (m_pWorkerPool != nullptr)
+    {
+        m_pWorkerPool->ParallelFor(jobCount, rasterizeJob);
+    }
+    else
+    {
+        for (int job = 0; job < jobCount; job++)
+            rasterizeJob(job);
+    }
+}
+
+/***********************************************************
+ * RasterizeBand()
+ * Rasterizes all faces into one horizontal band of tiles.
+ * Each tile row is processed 8 pixels at a time with plain
+ * fixed-length loops so the compiler can vectorize them.
+ ***********************************************************/
+void OcclusionCuller::RasterizeBand(int firstTileRow, int lastTileRow)
+{
+    const int bandMinY = firstTileRow * TILE_SIZE;
+    const int bandMaxY = lastTileRow * TILE_SIZE - 1;
+
+    for (const OCCLUDER_FACE& face : m_faces)
+    {
+        int minY = std::max(face.minY, bandMinY);
+        int maxY = std::min(face.maxY, bandMaxY);
+        if (minY > maxY)
+            continue;
+
+        for (int ty = minY / TILE_SIZE; ty <= maxY / TILE_SIZE; ty++)
+        {
+            for (int tx = face.minX / TILE_SIZE; tx <= face.maxX / TILE_SIZE; tx++)
+            {
+                int tileIndex = ty * TILES_X + tx;
+                float* tileDepth = &m_depth[tileIndex * TILE_SIZE * TILE_SIZE];
+                uint64_t mask = m_tileMask[tileIndex];
+
+                int rowBegin = std::max(minY - ty * TILE_SIZE, 0);
+                int rowEnd = std::min(maxY - ty * TILE_SIZE, TILE_SIZE - 1);
+                for (int row = rowBegin; row <= rowEnd; row++)
+                {
+                    float cy = (float)(ty * TILE_SIZE + row) + 0.5f;
+                    float* rowDepth = tileDepth + row * TILE_SIZE;
+
+                    float lane[TILE_SIZE];
+                    bool inside[TILE_SIZE];
+                    for (int lx = 0; lx < TILE_SIZE; lx++)
+                    {
+                        float cx = (float)(tx * TILE_SIZE + lx) + 0.5f;
+                        inside[lx] =
+                            face.edgeA[0] * cx + face.edgeB[0] * cy + face.edgeC[0] >= 0.0f &&
+                            face.edgeA[1] * cx + face.edgeB[1] * cy + face.edgeC[1] >= 0.0f &&
+                            face.edgeA[2] * cx + face.edgeB[2] * cy + face.edgeC[2] >= 0.0f &&
+                            face.edgeA[3] * cx + face.edgeB[3] * cy + face.edgeC[3] >= 0.0f;
+                        lane[lx] = face.depthA * cx + face.depthB * cy + face.depthC;
+                    }
+
+                    for (int lx = 0; lx < TILE_SIZE; lx++)
+                    {
+                        if (inside[lx] && lane[lx] < rowDepth[lx])
+                        {
+                            rowDepth[lx] = lane[lx];
+                            mask |= 1ull << (row * TILE_SIZE + lx);
+                        }
+                    }
+                }
+
+                m_tileMask[tileIndex] = mask;
+            }
+        }
+    }
+
+    // Rebuild the coarse level for this band. Uncovered pixels are still
+    // at 1.0, so a partially covered tile naturally reports the far plane.
+    for (int ty = firstTileRow; ty < lastTileRow; ty++)
+    {
+        for (int tx = 0; tx < TILES_X; tx++)
+        {
+            int tileIndex = ty * TILES_X + tx;
+            if (m_tileMask[tileIndex] != FULL_TILE_MASK)
+            {
+                m_tileMaxDepth[tileIndex] = 1.0f;
+                continue;
+            }
+
+            const float* tileDepth = &m_depth[tileIndex * TILE_SIZE * TILE_SIZE];
+            float maxDepth = 0.0f;
+            for (int p = 0; p < TILE_SIZE * TILE_SIZE; p++)
+                maxDepth = std::max(maxDepth, tileDepth[p]);
+            m_tileMaxDepth[tileIndex] = maxDepth;
+        }
+    }
+}
+
+/***********************************************************
+ * TestBounds()
+ * Projects a world-space AABB and checks whether every
+ * pixel it could touch already holds something nearer than
+ * the box's closest point. Whole tiles are rejected from
+ * the coarse level first; only tiles that can't be decided
+ * there are checked pixel by pixel.
+ ***********************************************************/
+OcclusionCuller::VISIBILITY OcclusionCuller::TestBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const
+{
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+    float minZ = 1e30f;
+    int outside[6] = { 0, 0, 0, 0, 0, 0 };
+
+    for (int i = 0; i < 8; i++)
+    {
+        glm::vec4 corner(
+            (i & 1) ? boundsMax.x : boundsMin.x,
+            (i & 2) ? boundsMax.y : boundsMin.y,
+            (i & 4) ? boundsMax.z : boundsMin.z,
+            1.0f);
+        glm::vec4 clip = m_viewProjection * corner;
+
+        // Count corners outside each frustum plane
+        outside[0] += clip.x < -clip.w;
+        outside[1] += clip.x >  clip.w;
+        outside[2] += clip.y < -clip.w;
+        outside[3] += clip.y >  clip.w;
+        outside[4] += clip.z < -clip.w;
+        outside[5] += clip.z >  clip.w;
+
+        if (clip.w < NEAR_W_EPSILON)
+        {
+            minZ = -1.0f; // straddles the camera — can't be occluded
+            continue;
+        }
+
+        float invW = 1.0f / clip.w;
+        minX = std::min(minX, clip.x * invW);
+        maxX = std::max(maxX, clip.x * invW);
+        minY = std::min(minY, clip.y * invW);
+        maxY = std::max(maxY, clip.y * invW);
+        minZ = std::min(minZ, clip.z * invW * 0.5f + 0.5f);
+    }
+
+    for (int p = 0; p < 6; p++)
+    {
+        if (outside[p] == 8)
+            return OFFSCREEN;
+    }
+
+    if (minZ <= 0.0f)
+        return VISIBLE;
+
+    int pixMinX = std::max(0, (int)std::floor((minX * 0.5f + 0.5f) * BUFFER_WIDTH));
+    int pixMaxX = std::min(BUFFER_WIDTH - 1, (int)std::floor((maxX * 0.5f + 0.5f) * BUFFER_WIDTH));
+    int pixMinY = std::max(0, (int)std::floor((minY * 0.5f + 0.5f) * BUFFER_HEIGHT));
+    int pixMaxY = std::min(BUFFER_HEIGHT - 1, (int)std::floor((maxY * 0.5f + 0.5f) * BUFFER_HEIGHT));
+    if (pixMinX > pixMaxX || pixMinY > pixMaxY)
+        return VISIBLE;
+
+    for (int ty = pixMinY / TILE_SIZE; ty <= pixMaxY / TILE_SIZE; ty++)
+    {
+        for (int tx = pixMinX / TILE_SIZE; tx <= pixMaxX / TILE_SIZE; tx++)
+        {
+            int tileIndex = ty * TILES_X + tx;
+
+            // Coarse level — the whole tile is nearer than the box
+            if (m_tileMaxDepth[tileIndex] < minZ)
+                continue;
+            // Nothing rasterized here at all
+            if (m_tileMask[tileIndex] == 0)
+                return VISIBLE;
+
+            const float* tileDepth = &m_depth[tileIndex * TILE_SIZE * TILE_SIZE];
+            int x0 = std::max(pixMinX - tx * TILE_SIZE, 0);
+            int x1 = std::min(pixMaxX - tx * TILE_SIZE, TILE_SIZE - 1);
+            int y0 = std::max(pixMinY - ty * TILE_SIZE, 0);
+            int y1 = std::min(pixMaxY - ty * TILE_SIZE, TILE_SIZE - 1);
+            for (int y = y0; y <= y1; y++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    if (tileDepth[y * TILE_SIZE + x] >= minZ)
+                        return VISIBLE;
+                }
+            }
+        }
+    }
+
+    return OCCLUDED;
+}
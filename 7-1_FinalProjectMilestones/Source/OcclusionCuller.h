@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// OcclusionCuller.h
+// ============
+// CPU-only software occlusion culling. Large box occluders (walls,
+// counter slab, fridge body) are rasterized into a small tiled depth
+// buffer, then object bounds are tested against it before any GL call.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class WorkerPool;
+
+/***********************************************************
+ *  OcclusionCuller
+ *
+ *  Low resolution masked depth buffer stored as 8x8 pixel
+ *  tiles. Each tile keeps a 64-bit coverage mask plus the
+ *  farthest covered depth, which acts as the coarse level
+ *  of the depth hierarchy. Rasterization is split into
+ *  bands of tile rows and run on the worker pool.
+ *
+ *  Only pixels an occluder covers completely are written,
+ *  and each one stores the farthest depth the face reaches
+ *  inside that pixel, so the buffer never claims more
+ *  coverage than the real geometry has.
+ ***********************************************************/
+class OcclusionCuller
+{
+public:
+    // constructor
+    OcclusionCuller(WorkerPool* pWorkerPool);
+    // destructor
+    ~OcclusionCuller();
+
+    // result of testing a set of bounds against the buffer
+    enum VISIBILITY
+    {
+        VISIBLE,
+        OFFSCREEN,
+        OCCLUDED
+    };
+
+    // per-frame counters for logging — callers count their own
+    // test results, since tests may run on several threads at once
+    struct CULL_STATS
+    {
+        int occluderFaces;
+    };
+
+    // Clear the buffer and set the camera for this frame
+    void BeginFrame(const glm::mat4& viewProjection);
+    // Queue a unit box ([-0.5, 0.5] on every axis) as an occluder
+    void AddOccluderBox(const glm::mat4& model);
+    // Rasterize every queued occluder (runs on the worker pool)
+    void RasterizeOccluders();
+    // Test a world-space bounding box against the rasterized occluders
+    // (read-only, safe to call from any number of workers at once)
+    VISIBILITY TestBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+    const CULL_STATS& GetStats() const { return m_stats; }
+
+    // buffer dimensions — 8x8 tiles, roughly the 5:4 window aspect
+    static const int BUFFER_WIDTH = 256;
+    static const int BUFFER_HEIGHT = 200;
+    static const int TILE_SIZE = 8;
+    static const int TILES_X = BUFFER_WIDTH / TILE_SIZE;
+    static const int TILES_Y = BUFFER_HEIGHT / TILE_SIZE;
+
+private:
+    // one projected occluder face ready for rasterization
+    struct OCCLUDER_FACE
+    {
+        // edge functions, inside when A*x + B*y + C >= 0
+        float edgeA[4];
+        float edgeB[4];
+        float edgeC[4];
+        // screen-space depth plane z = depthA*x + depthB*y + depthC
+        float depthA;
+        float depthB;
+        float depthC;
+        // pixel bounding rectangle (inclusive)
+        int minX, minY, maxX, maxY;
+    };
+
+    // Rasterize all faces into the tile rows [firstTileRow, lastTileRow)
+    void RasterizeBand(int firstTileRow, int lastTileRow);
+    // Project one quad (4 clip-space corners) into m_faces
+    void SetupFace(const glm::vec4 clip[4]);
+
+    WorkerPool* m_pWorkerPool;
+    glm::mat4 m_viewProjection;
+
+    // tile-major depth: tile (tx, ty) owns 64 consecutive floats
+    std::vector<float> m_depth;
+    // bit (y * 8 + x) set when that pixel of the tile is covered
+    std::vector<uint64_t> m_tileMask;
+    // farthest covered depth per tile — valid once the mask is full
+    std::vector<float> m_tileMaxDepth;
+
+    std::vector<OCCLUDER_FACE> m_faces;
+    CULL_STATS m_stats;
+};
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+// OverdrawVisualizer.cpp
+// ============
+// Debug render mode that counts how many fragments land on each pixel
+// and shows the counts as a heatmap, with average / max overdraw stats.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OverdrawVisualizer.h"
+#include "ShaderManager.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <iostream>
+
+/***********************************************************
+ * OverdrawVisualizer()
+ * GL objects are created lazily once we know the viewport
+ * size, so construction is cheap.
+ ***********************************************************/
+OverdrawVisualizer::OverdrawVisualizer()
+    : m_pStateCache(nullptr)
+    , m_pCountShader(nullptr)
+    , m_pInstancedCountShader(nullptr)
+    , m_pHeatmapShader(nullptr)
+    , m_framebuffer(0)
+    , m_countTexture(0)
+    , m_emptyVAO(0)
+    , m_width(0)
+    , m_height(0)
+    , m_savedFramebuffer(0)
+    , m_bSavedDepthTest(false)
+    , m_bSavedBlend(false)
+    , m_savedBlendSource(GL_ONE)
+    , m_savedBlendDest(GL_ZERO)
+    , m_savedTexture(0)
+{
+    m_stats.averageOverdraw = 0.0;
+    m_stats.averageCoveredOverdraw = 0.0;
+    m_stats.maxOverdraw = 0;
+    m_stats.coveredPixels = 0;
+    m_stats.totalPixels = 0;
+}
+
+/***********************************************************
+ * ~OverdrawVisualizer()
+ * Frees the shaders and any GL objects we made.
+ ***********************************************************/
+OverdrawVisualizer::~OverdrawVisualizer()
+{
+    delete m_pCountShader;
+    m_pCountShader = nullptr;
+    delete m_pInstancedCountShader;
+    m_pInstancedCountShader = nullptr;
+    delete m_pHeatmapShader;
+    m_pHeatmapShader = nullptr;
+
+    if (m_framebuffer != 0)
+        glDeleteFramebuffers(1, &m_framebuffer);
+    if (m_countTexture != 0)
+        glDeleteTextures(1, &m_countTexture);
+    if (m_emptyVAO != 0)
+        glDeleteVertexArrays(1, &m_emptyVAO);
+}
+
+/***********************************************************
+ * LoadShaders()
+ * The counting passes reuse the depth pre-pass and plant
+ * vertex shaders so they rasterize exactly the same pixels
+ * as the real scene. Returns false if any program failed
+ * to build.
+ ***********************************************************/
+bool OverdrawVisualizer::LoadShaders()
+{
+    m_pCountShader = new ShaderManager();
+    m_pCountShader->LoadShaders(
+        "shaders/depthVertexShader.glsl",
+        "shaders/overdrawCountFragmentShader.glsl");
+
+    m_pInstancedCountShader = new ShaderManager();
+    m_pInstancedCountShader->LoadShaders(
+        "shaders/instancedVertexShader.glsl",
+        "shaders/overdrawCountFragmentShader.glsl");
+
+    m_pHeatmapShader = new ShaderManager();
+    m_pHeatmapShader->LoadShaders(
+        "shaders/fullscreenVertexShader.glsl",
+        "shaders/overdrawHeatmapFragmentShader.glsl");
+
+    if (m_pCountShader->m_programID == 0 || m_pInstancedCountShader->m_programID == 0 ||
+        m_pHeatmapShader->m_programID == 0)
+    {
+        std::cout << "INFO: Overdraw view shaders failed to load" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * ResizeTarget()
+ * One 32-bit float channel per pixel — plenty of range for
+ * counts, and float targets blend additively everywhere we
+ * run (GL 3.3 and up).
+ ***********************************************************/
+void OverdrawVisualizer::ResizeTarget(int width, int height)
+{
+    if (m_framebuffer == 0)
+    {
+        glGenFramebuffers(1, &m_framebuffer);
+        glGenTextures(1, &m_countTexture);
+        glGenVertexArrays(1, &m_emptyVAO);
+    }
+
+    GLuint previousTexture = m_pStateCache->GetBoundTexture2D(0);
+    m_pStateCache->BindTexture2D(0, m_countTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_pStateCache->BindTexture2D(0, previousTexture);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_countTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "INFO: Overdraw count framebuffer is incomplete" << std::endl;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_readback.resize((size_t)width * height);
+}
+
+/***********************************************************
+ * BeginCounting()
+ * Clears the count target and sets up additive blending
+ * with depth testing off, so hidden layers are counted too.
+ * Face culling is left to the caller so culled back faces
+ * don't count as cost.
+ ***********************************************************/
+ShaderManager* OverdrawVisualizer::BeginCounting(int width, int height, const glm::mat4& view, const glm::mat4& projection)
+{
+    if (width != m_width || height != m_height)
+        ResizeTarget(width, height);
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_savedFramebuffer);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &m_savedBlendSource);
+    glGetIntegerv(GL_BLEND_DST_RGB, &m_savedBlendDest);
+    m_bSavedDepthTest = m_pStateCache->IsCapabilityEnabled(GL_DEPTH_TEST);
+    m_bSavedBlend = m_pStateCache->IsCapabilityEnabled(GL_BLEND);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    m_pStateCache->ClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    m_pStateCache->Disable(GL_DEPTH_TEST);
+    m_pStateCache->Enable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    m_pStateCache->BlendFunc(GL_ONE, GL_ONE);
+
+    m_pStateCache->UseProgram(m_pInstancedCountShader);
+    m_pStateCache->SetMat4Value(m_pInstancedCountShader, "view", view);
+    m_pStateCache->SetMat4Value(m_pInstancedCountShader, "projection", projection);
+
+    m_pStateCache->UseProgram(m_pCountShader);
+    m_pStateCache->SetMat4Value(m_pCountShader, "view", view);
+    m_pStateCache->SetMat4Value(m_pCountShader, "projection", projection);
+    return m_pCountShader;
+}
+
+/***********************************************************
+ * EndCounting()
+ * Optionally reads the counts back, then draws a full-screen
+ * triangle that maps each count to a heatmap color on the
+ * framebuffer that was bound before BeginCounting(). Puts
+ * back the blend, depth and texture unit 0 state the scene
+ * had before.
+ ***********************************************************/
+void OverdrawVisualizer::EndCounting(bool bReadStats)
+{
+    if (bReadStats)
+        ReadStats();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_savedFramebuffer);
+    m_pStateCache->Disable(GL_BLEND);
+
+    // borrow unit 0 from the scene textures and give it back afterwards
+    m_savedTexture = m_pStateCache->GetBoundTexture2D(0);
+    m_pStateCache->UseProgram(m_pHeatmapShader);
+    m_pStateCache->BindTexture2D(0, m_countTexture);
+    m_pStateCache->SetSampler2DValue(m_pHeatmapShader, "overdrawCounts", 0);
+
+    glBindVertexArray(m_emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    m_pStateCache->BindTexture2D(0, m_savedTexture);
+
+    m_pStateCache->SetCapability(GL_DEPTH_TEST, m_bSavedDepthTest);
+    m_pStateCache->SetCapability(GL_BLEND, m_bSavedBlend);
+    m_pStateCache->BlendFunc((GLenum)m_savedBlendSource, (GLenum)m_savedBlendDest);
+}
+
+/***********************************************************
+ * ReadStats()
+ * Stalls on the GPU to read the counts — fine for a debug
+ * view that only asks every couple of seconds.
+ ***********************************************************/
+void OverdrawVisualizer::ReadStats()
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, m_width, m_height, GL_RED, GL_FLOAT, m_readback.data());
+
+    double total = 0.0;
+    int covered = 0;
+    int maxCount = 0;
+    for (float value : m_readback)
+    {
+        int count = (int)(value + 0.5f);
+        total += count;
+        if (count > 0)
+            covered++;
+        maxCount = std::max(maxCount, count);
+    }
+
+    m_stats.totalPixels = m_width * m_height;
+    m_stats.coveredPixels = covered;
+    m_stats.maxOverdraw = maxCount;
+    m_stats.averageOverdraw = (m_stats.totalPixels > 0) ? total / m_stats.totalPixels : 0.0;
+    m_stats.averageCoveredOverdraw = (covered > 0) ? total / covered : 0.0;
+}
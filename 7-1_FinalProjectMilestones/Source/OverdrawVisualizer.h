@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+// OverdrawVisualizer.h
+// ============
+// Debug render mode that counts how many fragments land on each pixel
+// and shows the counts as a heatmap, with average / max overdraw stats.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+class ShaderManager;
+class GLStateCache;
+
+/***********************************************************
+ *  OverdrawVisualizer
+ *
+ *  Between BeginCounting() and EndCounting() the scene is
+ *  drawn into an offscreen float target with additive
+ *  blending and depth testing off, so every rasterized
+ *  fragment adds 1 to its pixel. EndCounting() maps the
+ *  counts to colors on the default framebuffer and can read
+ *  them back to compute overdraw stats.
+ ***********************************************************/
+class OverdrawVisualizer
+{
+public:
+    // constructor
+    OverdrawVisualizer();
+    // destructor
+    ~OverdrawVisualizer();
+
+    // overdraw numbers for one frame
+    struct OVERDRAW_STATS
+    {
+        // fragments per pixel over the whole view
+        double averageOverdraw;
+        // fragments per pixel over pixels hit at least once
+        double averageCoveredOverdraw;
+        // most fragments any one pixel received
+        int maxOverdraw;
+        // pixels hit at least once
+        int coveredPixels;
+        int totalPixels;
+    };
+
+    // Route state changes through the shared GL state filter
+    void SetStateCache(GLStateCache* pStateCache) { m_pStateCache = pStateCache; }
+    // Load the counting and heatmap shaders from the project's shaders folder
+    bool LoadShaders();
+    // Bind the count target for a viewport of the given size and set up
+    // blending; the returned shader needs each draw's model matrix
+    ShaderManager* BeginCounting(int width, int height, const glm::mat4& view, const glm::mat4& projection);
+    // Counting program for instanced draws such as plants, with the
+    // camera from BeginCounting() set; bind it before drawing
+    ShaderManager* GetInstancedCountShader() const { return m_pInstancedCountShader; }
+    // Draw the heatmap to the default framebuffer and restore GL state;
+    // reads the counts back first when bReadStats is set
+    void EndCounting(bool bReadStats);
+    // Stats from the last EndCounting(true)
+    const OVERDRAW_STATS& GetStats() const { return m_stats; }
+
+private:
+    // (Re)create the count texture and framebuffer at a new size
+    void ResizeTarget(int width, int height);
+    // Read the count texture and fill m_stats
+    void ReadStats();
+
+    GLStateCache* m_pStateCache;
+    ShaderManager* m_pCountShader;
+    ShaderManager* m_pInstancedCountShader;
+    ShaderManager* m_pHeatmapShader;
+
+    GLuint m_framebuffer;
+    GLuint m_countTexture;
+    // core profile needs a bound VAO even for attribute-less draws
+    GLuint m_emptyVAO;
+    int m_width;
+    int m_height;
+
+    // GL state saved by BeginCounting()
+    GLint m_savedFramebuffer;
+    bool m_bSavedDepthTest;
+    bool m_bSavedBlend;
+    GLint m_savedBlendSource;
+    GLint m_savedBlendDest;
+    GLuint m_savedTexture;
+
+    std::vector<float> m_readback;
+    OVERDRAW_STATS m_stats;
+};
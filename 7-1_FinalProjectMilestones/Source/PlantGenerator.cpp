@@ -0,0 +1,342 @@
+///////////////////////////////////////////////////////////////////////////////
+// PlantGenerator.cpp
+// ============
+// Procedural trees from an L-system: rewrite rules grow a symbol string,
+// and a 3D turtle turns it into bark segment and leaf instance transforms.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PlantGenerator.h"
+
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    const float PI = 3.14159265358979f;
+
+    // Symbol strings past this length stop growing; iteration counts
+    // that high would take minutes and gigabytes anyway
+    const size_t MAX_SYMBOLS = 64u * 1024u * 1024u;
+
+    // Iterations RunBenchmark() sweeps, and how often each is timed
+    const int BENCHMARK_FIRST_ITERATIONS = 3;
+    const int BENCHMARK_LAST_ITERATIONS = 8;
+    const int BENCHMARK_RUNS = 3;
+
+    // Where the turtle is and which way it faces
+    struct TURTLE
+    {
+        glm::vec3 position;
+        glm::vec3 heading;
+        glm::vec3 left;
+        glm::vec3 up;
+        float length;
+        float radius;
+    };
+
+    // Rodrigues' rotation of v around a unit axis
+    glm::vec3 RotateAround(const glm::vec3& v, const glm::vec3& axis, float radians)
+    {
+        float c = std::cos(radians);
+        float s = std::sin(radians);
+        return v * c + glm::cross(axis, v) * s + axis * (glm::dot(axis, v) * (1.0f - c));
+    }
+
+    void GrowBounds(const glm::vec3& center, float radius, glm::vec3& boundsMin, glm::vec3& boundsMax)
+    {
+        boundsMin = glm::min(boundsMin, center - glm::vec3(radius));
+        boundsMax = glm::max(boundsMax, center + glm::vec3(radius));
+    }
+
+    // Preset bonsai: a short trunk, then three branches per bud
+    // spiralling around each other, a leaf cluster at every joint
+    PlantGenerator::PLANT_PARAMETERS MakeBonsaiPreset()
+    {
+        PlantGenerator::PLANT_PARAMETERS parameters;
+        parameters.axiom = "FA";
+        parameters.rules.push_back(PlantGenerator::RULE('A', "F[&FLA]/////[&FLA]///////[&FLA]"));
+        parameters.iterations = 5;
+        parameters.angle = 26.0f;
+        parameters.angleJitter = 7.0f;
+        parameters.segmentLength = 0.55f;
+        parameters.baseRadius = 0.22f;
+        parameters.segmentTaper = 0.85f;
+        parameters.branchLengthScale = 0.78f;
+        parameters.branchRadiusScale = 0.68f;
+        parameters.leavesPerCluster = 12;
+        parameters.clusterRadius = 0.22f;
+        parameters.leafSize = glm::vec3(0.1f, 0.018f, 0.05f);
+        parameters.seed = 330;
+        // the hand-built bonsai's bark and foliage colors
+        parameters.barkColor = glm::vec4(0.2f, 0.17f, 0.14f, 1.0f);
+        parameters.leafColors[0] = glm::vec4(0.09f, 0.29f, 0.08f, 1.0f);
+        parameters.leafColors[1] = glm::vec4(0.14f, 0.41f, 0.11f, 1.0f);
+        parameters.leafColors[2] = glm::vec4(0.2f, 0.53f, 0.15f, 1.0f);
+        parameters.barkMaterial = "bark";
+        parameters.leafMaterial = "foliage";
+        return parameters;
+    }
+
+    // Preset shrub: bushy, no trunk to speak of, many small clusters
+    PlantGenerator::PLANT_PARAMETERS MakeShrubPreset()
+    {
+        PlantGenerator::PLANT_PARAMETERS parameters = MakeBonsaiPreset();
+        parameters.axiom = "A";
+        parameters.rules.clear();
+        parameters.rules.push_back(PlantGenerator::RULE('A', "[&FLA]////[&FLA]////[&FLA]////[&FLA]"));
+        parameters.iterations = 4;
+        parameters.angle = 32.0f;
+        parameters.segmentLength = 0.4f;
+        parameters.baseRadius = 0.08f;
+        parameters.branchLengthScale = 0.82f;
+        parameters.branchRadiusScale = 0.75f;
+        parameters.leavesPerCluster = 8;
+        parameters.clusterRadius = 0.16f;
+        return parameters;
+    }
+}
+
+/***********************************************************
+ * GetPreset()
+ ***********************************************************/
+bool PlantGenerator::GetPreset(const std::string& name, PLANT_PARAMETERS& parameters)
+{
+    if (name == "bonsai")
+        parameters = MakeBonsaiPreset();
+    else if (name == "shrub")
+        parameters = MakeShrubPreset();
+    else
+        return false;
+    return true;
+}
+
+/***********************************************************
+ * Expand()
+ * Rules are looked up through a table by symbol, so each
+ * pass is one walk over the string.
+ ***********************************************************/
+void PlantGenerator::Expand(const PLANT_PARAMETERS& parameters, std::string& symbols)
+{
+    const std::string* successors[256] = {};
+    for (const RULE& rule : parameters.rules)
+        successors[(unsigned char)rule.first] = &rule.second;
+
+    symbols = parameters.axiom;
+    std::string next;
+    for (int i = 0; i < parameters.iterations; i++)
+    {
+        next.clear();
+        for (char symbol : symbols)
+        {
+            const std::string* successor = successors[(unsigned char)symbol];
+            if (successor != nullptr)
+                next += *successor;
+            else
+                next += symbol;
+        }
+        if (next.size() > MAX_SYMBOLS)
+        {
+            std::cout << "INFO: Plant stopped growing after " << i << " of "
+                      << parameters.iterations << " iterations" << std::endl;
+            break;
+        }
+        symbols.swap(next);
+    }
+}
+
+/***********************************************************
+ * Generate()
+ * The turtle starts at the origin heading up +Y. A bark
+ * instance maps the unit cylinder's x / y / z onto the
+ * turtle's left / heading / left x heading, scaled by the
+ * segment's radius and length, so every segment's matrix
+ * keeps a positive determinant and back-face culling holds.
+ * Leaves are collected first and split into shade bands
+ * once the height range is known.
+ ***********************************************************/
+void PlantGenerator::Generate(const PLANT_PARAMETERS& parameters, PLANT_INSTANCES& instances)
+{
+    std::string symbols;
+    Expand(parameters, symbols);
+
+    instances.bark.clear();
+    for (int band = 0; band < LEAF_SHADE_COUNT; band++)
+        instances.leaves[band].clear();
+    instances.boundsMin = glm::vec3(0.0f);
+    instances.boundsMax = glm::vec3(0.0f);
+
+    std::mt19937 random(parameters.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> jitter(-parameters.angleJitter, parameters.angleJitter);
+    auto Turn = [&](float sign) { return glm::radians(sign * parameters.angle + jitter(random)); };
+
+    TURTLE turtle;
+    turtle.position = glm::vec3(0.0f);
+    turtle.heading = glm::vec3(0.0f, 1.0f, 0.0f);
+    turtle.left = glm::vec3(-1.0f, 0.0f, 0.0f);
+    turtle.up = glm::vec3(0.0f, 0.0f, 1.0f);
+    turtle.length = parameters.segmentLength;
+    turtle.radius = parameters.baseRadius;
+
+    std::vector<TURTLE> stack;
+    std::vector<PLANT_INSTANCE> leaves;
+    float leafMinY = 0.0f;
+    float leafMaxY = 0.0f;
+    float leafExtent = std::max(parameters.leafSize.x, std::max(parameters.leafSize.y, parameters.leafSize.z));
+    for (char symbol : symbols)
+    {
+        float radians;
+        switch (symbol)
+        {
+        case 'F':
+        {
+            glm::vec3 side = glm::cross(turtle.left, turtle.heading);
+            PLANT_INSTANCE segment;
+            segment.model = glm::mat4(
+                glm::vec4(turtle.left * turtle.radius, 0.0f),
+                glm::vec4(turtle.heading * turtle.length, 0.0f),
+                glm::vec4(side * turtle.radius, 0.0f),
+                glm::vec4(turtle.position, 1.0f));
+            segment.taper = parameters.segmentTaper;
+            instances.bark.push_back(segment);
+
+            GrowBounds(turtle.position, turtle.radius, instances.boundsMin, instances.boundsMax);
+            turtle.position += turtle.heading * turtle.length;
+            GrowBounds(turtle.position, turtle.radius, instances.boundsMin, instances.boundsMax);
+            turtle.radius *= parameters.segmentTaper;
+            break;
+        }
+        case 'f':
+            turtle.position += turtle.heading * turtle.length;
+            break;
+        case '+':
+        case '-':
+            radians = Turn(symbol == '+' ? 1.0f : -1.0f);
+            turtle.heading = RotateAround(turtle.heading, turtle.up, radians);
+            turtle.left = RotateAround(turtle.left, turtle.up, radians);
+            break;
+        case '&':
+        case '^':
+            radians = Turn(symbol == '&' ? 1.0f : -1.0f);
+            turtle.heading = RotateAround(turtle.heading, turtle.left, radians);
+            turtle.up = RotateAround(turtle.up, turtle.left, radians);
+            break;
+        case '/':
+        case '\\':
+            radians = Turn(symbol == '/' ? 1.0f : -1.0f);
+            turtle.left = RotateAround(turtle.left, turtle.heading, radians);
+            turtle.up = RotateAround(turtle.up, turtle.heading, radians);
+            break;
+        case '|':
+            turtle.heading = -turtle.heading;
+            turtle.left = -turtle.left;
+            break;
+        case '[':
+            stack.push_back(turtle);
+            turtle.length *= parameters.branchLengthScale;
+            turtle.radius *= parameters.branchRadiusScale;
+            break;
+        case ']':
+            if (!stack.empty())
+            {
+                turtle = stack.back();
+                stack.pop_back();
+            }
+            break;
+        case 'L':
+            for (int i = 0; i < parameters.leavesPerCluster; i++)
+            {
+                // uniform in the cluster's sphere, facing any which way
+                // but never far from level
+                float z = 2.0f * unit(random) - 1.0f;
+                float theta = 2.0f * PI * unit(random);
+                float r = parameters.clusterRadius * std::cbrt(unit(random));
+                float ring = std::sqrt(1.0f - z * z);
+                glm::vec3 offset(r * ring * std::cos(theta), r * z, r * ring * std::sin(theta));
+
+                PLANT_INSTANCE leaf;
+                leaf.model = glm::translate(turtle.position + offset)
+                           * glm::rotate(2.0f * PI * unit(random), glm::vec3(0.0f, 1.0f, 0.0f))
+                           * glm::rotate(glm::radians(80.0f * unit(random) - 40.0f), glm::vec3(0.0f, 0.0f, 1.0f))
+                           * glm::scale(parameters.leafSize);
+                leaf.taper = 1.0f;
+
+                float y = leaf.model[3][1];
+                leafMinY = leaves.empty() ? y : std::min(leafMinY, y);
+                leafMaxY = leaves.empty() ? y : std::max(leafMaxY, y);
+                leaves.push_back(leaf);
+                GrowBounds(glm::vec3(leaf.model[3]), leafExtent, instances.boundsMin, instances.boundsMax);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // lower leaves sit in the canopy's shade
+    float bandHeight = std::max(leafMaxY - leafMinY, 1.0e-6f) / LEAF_SHADE_COUNT;
+    for (const PLANT_INSTANCE& leaf : leaves)
+    {
+        int band = std::min((int)((leaf.model[3][1] - leafMinY) / bandHeight), LEAF_SHADE_COUNT - 1);
+        instances.leaves[band].push_back(leaf);
+    }
+}
+
+/***********************************************************
+ * GetLeafCount()
+ ***********************************************************/
+size_t PlantGenerator::GetLeafCount(const PLANT_INSTANCES& instances)
+{
+    size_t count = 0;
+    for (int band = 0; band < LEAF_SHADE_COUNT; band++)
+        count += instances.leaves[band].size();
+    return count;
+}
+
+/***********************************************************
+ * RunBenchmark()
+ * Times the whole of Generate() — rewriting, the turtle
+ * walk and banding — and reports the best of
+ * BENCHMARK_RUNS at each iteration count. No GL is
+ * involved, so no window is needed.
+ ***********************************************************/
+void PlantGenerator::RunBenchmark(const std::vector<std::string>& args)
+{
+    std::string preset = args.empty() ? "bonsai" : args[0];
+    PLANT_PARAMETERS parameters;
+    if (!GetPreset(preset, parameters))
+    {
+        std::cout << "INFO: Unknown plant preset '" << preset << "'" << std::endl;
+        return;
+    }
+
+    for (int iterations = BENCHMARK_FIRST_ITERATIONS; iterations <= BENCHMARK_LAST_ITERATIONS; iterations++)
+    {
+        parameters.iterations = iterations;
+        PLANT_INSTANCES instances;
+        double bestSeconds = 0.0;
+        for (int run = 0; run < BENCHMARK_RUNS; run++)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            Generate(parameters, instances);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            if (run == 0 || seconds < bestSeconds)
+                bestSeconds = seconds;
+        }
+
+        double milliseconds = bestSeconds * 1000.0;
+        size_t leaves = GetLeafCount(instances);
+        std::cout << "INFO: Plant '" << preset << "' at " << iterations << " iterations: "
+                  << instances.bark.size() << " bark segments, " << leaves << " leaves in "
+                  << milliseconds << " ms — " << leaves / std::max(milliseconds, 1.0e-6)
+                  << " leaves/ms" << std::endl;
+    }
+}
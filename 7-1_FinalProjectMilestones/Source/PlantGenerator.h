@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// PlantGenerator.h
+// ============
+// Procedural trees from an L-system: rewrite rules grow a symbol string,
+// and a 3D turtle turns it into bark segment and leaf instance transforms.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  PlantGenerator
+ *
+ *  CPU only — no GL. Expand() rewrites the axiom in
+ *  parallel for the given number of iterations; Generate()
+ *  walks the result with a turtle whose heading, left and
+ *  up vectors stay orthonormal:
+ *
+ *    F       bark segment along the heading, then move
+ *    f       move without drawing
+ *    + -     turn left / right around up
+ *    & ^     pitch down / up around left
+ *    / \     roll right / left around the heading
+ *    |       turn around
+ *    [ ]     push / pop the turtle; a branch starts
+ *            thinner and shorter than its parent
+ *    L       a cluster of leaves around the turtle
+ *
+ *  Other symbols only take part in rewriting. Every turn
+ *  gets a seeded random jitter, so one preset gives the
+ *  same plant on every run.
+ *
+ *  Each bark segment is one instance of the unit cylinder
+ *  (radius 1, y = 0 to 1), narrowed towards its top by the
+ *  instance's taper; leaves are instances of the unit
+ *  sphere, flattened, and sorted into LEAF_SHADE_COUNT
+ *  bands by height so each band can be one instanced draw
+ *  in its own color.
+ ***********************************************************/
+class PlantGenerator
+{
+public:
+    // leaf color bands, lowest first
+    static const int LEAF_SHADE_COUNT = 3;
+
+    // one rewrite rule: every predecessor becomes successor
+    typedef std::pair<char, std::string> RULE;
+
+    struct PLANT_PARAMETERS
+    {
+        std::string axiom;
+        std::vector<RULE> rules;
+        int iterations;
+        // degrees for every turn symbol, plus up to angleJitter either way
+        float angle;
+        float angleJitter;
+        // first segment's length and base radius
+        float segmentLength;
+        float baseRadius;
+        // each segment's top radius over its base radius
+        float segmentTaper;
+        // a branch's length and radius over its parent's
+        float branchLengthScale;
+        float branchRadiusScale;
+        // leaves per L, scattered within clusterRadius
+        int leavesPerCluster;
+        float clusterRadius;
+        // half-extents of a leaf (length, thickness, width)
+        glm::vec3 leafSize;
+        unsigned int seed;
+        // colors and material tags SceneManager draws the parts with
+        glm::vec4 barkColor;
+        glm::vec4 leafColors[LEAF_SHADE_COUNT];
+        std::string barkMaterial;
+        std::string leafMaterial;
+    };
+
+    // one instance of a part's mesh
+    struct PLANT_INSTANCE
+    {
+        glm::mat4 model;
+        // top radius over bottom radius; 1 for leaves
+        float taper;
+    };
+
+    // everything one plant draws, in plant space
+    struct PLANT_INSTANCES
+    {
+        std::vector<PLANT_INSTANCE> bark;
+        std::vector<PLANT_INSTANCE> leaves[LEAF_SHADE_COUNT];
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    // Parameters of a named preset; false if there's no such preset
+    static bool GetPreset(const std::string& name, PLANT_PARAMETERS& parameters);
+    // Apply the rules to the axiom parameters.iterations times
+    static void Expand(const PLANT_PARAMETERS& parameters, std::string& symbols);
+    // Expand() and walk the result with the turtle
+    static void Generate(const PLANT_PARAMETERS& parameters, PLANT_INSTANCES& instances);
+    // Leaves in every shade band
+    static size_t GetLeafCount(const PLANT_INSTANCES& instances);
+
+    // Time Generate() on the preset named in args ("bonsai" by default)
+    // at increasing iterations and log leaves generated per millisecond
+    static void RunBenchmark(const std::vector<std::string>& args);
+};
@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+// PlantRenderer.cpp
+// ============
+// GPU side of the procedural plants: one instance buffer per plant and
+// one instanced draw call per plant part, whatever the leaf count.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PlantRenderer.h"
+#include "ShaderManager.h"
+
+#include <cstddef>
+#include <iostream>
+
+namespace
+{
+    const char* INSTANCED_VERTEX_SHADER = "shaders/instancedVertexShader.glsl";
+    // same Phong fragment shader main() loads for the main program
+    const char* PHONG_FRAGMENT_SHADER = "../../Utilities/shaders/fragmentShader.glsl";
+    const char* DEPTH_FRAGMENT_SHADER = "shaders/depthFragmentShader.glsl";
+
+    // Attribute locations of the per-instance data in the shader
+    const GLuint INSTANCE_MODEL_LOCATION = 3;
+    const GLuint INSTANCE_TAPER_LOCATION = 7;
+
+    // Meshes the parts are drawn with. A segment or a leaf is only a
+    // few pixels across from the default camera, so both use coarse
+    // levels — thousands of leaves at level 0 would be over a million
+    // triangles.
+    const MeshLibrary::LOD_SHAPE BARK_SHAPE = MeshLibrary::LOD_CYLINDER;
+    const int BARK_LEVEL = 2;
+    const MeshLibrary::LOD_SHAPE LEAF_SHAPE = MeshLibrary::LOD_SPHERE;
+    const int LEAF_LEVEL = 3;
+
+    MeshLibrary::LOD_SHAPE GetPartShape(int part)
+    {
+        return (part == PlantRenderer::PART_BARK) ? BARK_SHAPE : LEAF_SHAPE;
+    }
+
+    int GetPartLevel(int part)
+    {
+        return (part == PlantRenderer::PART_BARK) ? BARK_LEVEL : LEAF_LEVEL;
+    }
+}
+
+/***********************************************************
+ * PlantRenderer()
+ ***********************************************************/
+PlantRenderer::PlantRenderer()
+    : m_pPhongShader(nullptr)
+    , m_pDepthShader(nullptr)
+{
+}
+
+/***********************************************************
+ * ~PlantRenderer()
+ ***********************************************************/
+PlantRenderer::~PlantRenderer()
+{
+    Clear();
+
+    delete m_pPhongShader;
+    m_pPhongShader = nullptr;
+    delete m_pDepthShader;
+    m_pDepthShader = nullptr;
+}
+
+/***********************************************************
+ * LoadShaders()
+ ***********************************************************/
+bool PlantRenderer::LoadShaders()
+{
+    m_pPhongShader = new ShaderManager();
+    m_pPhongShader->LoadShaders(INSTANCED_VERTEX_SHADER, PHONG_FRAGMENT_SHADER);
+
+    m_pDepthShader = new ShaderManager();
+    m_pDepthShader->LoadShaders(INSTANCED_VERTEX_SHADER, DEPTH_FRAGMENT_SHADER);
+
+    if (m_pPhongShader->m_programID == 0 || m_pDepthShader->m_programID == 0)
+    {
+        std::cout << "INFO: Instanced plant shaders failed to load" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * AddPlant()
+ * Parts are laid out back to back in one buffer; each
+ * part's VAO starts its instance attributes at the part's
+ * first instance, so every draw begins at instance 0.
+ ***********************************************************/
+int PlantRenderer::AddPlant(const MeshLibrary* pMeshLibrary, const PlantGenerator::PLANT_INSTANCES& instances)
+{
+    const std::vector<PlantGenerator::PLANT_INSTANCE>* parts[PART_COUNT];
+    parts[PART_BARK] = &instances.bark;
+    for (int band = 0; band < PlantGenerator::LEAF_SHADE_COUNT; band++)
+        parts[PART_LEAVES + band] = &instances.leaves[band];
+
+    size_t total = 0;
+    for (int part = 0; part < PART_COUNT; part++)
+        total += parts[part]->size();
+
+    GPU_PLANT plant;
+    plant.pMeshLibrary = pMeshLibrary;
+    glGenBuffers(1, &plant.instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, plant.instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, total * sizeof(PlantGenerator::PLANT_INSTANCE), nullptr, GL_STATIC_DRAW);
+
+    glGenVertexArrays(PART_COUNT, plant.vaos);
+    GLsizei stride = sizeof(PlantGenerator::PLANT_INSTANCE);
+    size_t first = 0;
+    for (int part = 0; part < PART_COUNT; part++)
+    {
+        size_t count = parts[part]->size();
+        size_t offset = first * sizeof(PlantGenerator::PLANT_INSTANCE);
+        plant.instanceCounts[part] = (int)count;
+        glBindBuffer(GL_ARRAY_BUFFER, plant.instanceBuffer);
+        if (count > 0)
+            glBufferSubData(GL_ARRAY_BUFFER, offset, count * sizeof(PlantGenerator::PLANT_INSTANCE), parts[part]->data());
+
+        glBindVertexArray(plant.vaos[part]);
+        pMeshLibrary->BindLODMeshBuffers(GetPartShape(part), GetPartLevel(part));
+
+        // BindLODMeshBuffers() moved GL_ARRAY_BUFFER to the mesh
+        glBindBuffer(GL_ARRAY_BUFFER, plant.instanceBuffer);
+        for (GLuint column = 0; column < 4; column++)
+        {
+            GLuint location = INSTANCE_MODEL_LOCATION + column;
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+                                  (void*)(offset + offsetof(PlantGenerator::PLANT_INSTANCE, model) + column * sizeof(glm::vec4)));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+        glVertexAttribPointer(INSTANCE_TAPER_LOCATION, 1, GL_FLOAT, GL_FALSE, stride,
+                              (void*)(offset + offsetof(PlantGenerator::PLANT_INSTANCE, taper)));
+        glEnableVertexAttribArray(INSTANCE_TAPER_LOCATION);
+        glVertexAttribDivisor(INSTANCE_TAPER_LOCATION, 1);
+
+        first += count;
+    }
+    glBindVertexArray(0);
+
+    m_plants.push_back(plant);
+    return (int)m_plants.size() - 1;
+}
+
+/***********************************************************
+ * Clear()
+ ***********************************************************/
+void PlantRenderer::Clear()
+{
+    for (GPU_PLANT& plant : m_plants)
+    {
+        glDeleteVertexArrays(PART_COUNT, plant.vaos);
+        glDeleteBuffers(1, &plant.instanceBuffer);
+    }
+    m_plants.clear();
+}
+
+/***********************************************************
+ * DrawPart()
+ ***********************************************************/
+void PlantRenderer::DrawPart(int plant, PLANT_PART part) const
+{
+    const GPU_PLANT& gpuPlant = m_plants[plant];
+    if (gpuPlant.instanceCounts[part] == 0)
+        return;
+
+    glBindVertexArray(gpuPlant.vaos[part]);
+    gpuPlant.pMeshLibrary->DrawLODMeshInstanced(GetPartShape(part), GetPartLevel(part), gpuPlant.instanceCounts[part]);
+    glBindVertexArray(0);
+}
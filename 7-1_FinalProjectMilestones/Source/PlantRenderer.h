@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// PlantRenderer.h
+// ============
+// GPU side of the procedural plants: one instance buffer per plant and
+// one instanced draw call per plant part, whatever the leaf count.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+#include "PlantGenerator.h"
+
+#include <GL/glew.h>
+#include <vector>
+
+class ShaderManager;
+
+/***********************************************************
+ *  PlantRenderer
+ *
+ *  Owns two programs built around the instanced vertex
+ *  shader, like ProceduralMeshes: one with the shared Phong
+ *  fragment shader and one with the depth pre-pass fragment
+ *  shader. The caller sets the camera, lights, color and
+ *  material on them like it does on the main program.
+ *
+ *  A plant's bark and leaf instances share one buffer; each
+ *  part has a VAO that pairs a MeshLibrary mesh with that
+ *  part's run of the buffer. The shared Phong shader takes
+ *  a single objectColor per draw, which is why leaves are
+ *  split into shade bands — one draw per band.
+ ***********************************************************/
+class PlantRenderer
+{
+public:
+    // what each of a plant's draws is made of
+    enum PLANT_PART
+    {
+        PART_BARK,
+        // PART_LEAVES + band, for each PlantGenerator shade band
+        PART_LEAVES,
+        PART_COUNT = PART_LEAVES + PlantGenerator::LEAF_SHADE_COUNT
+    };
+
+    // constructor
+    PlantRenderer();
+    // destructor
+    ~PlantRenderer();
+
+    // Build both programs; returns false if either failed, in which
+    // case plants should stay off
+    bool LoadShaders();
+    ShaderManager* GetPhongShader() const { return m_pPhongShader; }
+    ShaderManager* GetDepthShader() const { return m_pDepthShader; }
+
+    // Upload a generated plant; returns its handle. pMeshLibrary must
+    // have its LOD meshes loaded and outlive the plant.
+    int AddPlant(const MeshLibrary* pMeshLibrary, const PlantGenerator::PLANT_INSTANCES& instances);
+    // Free every plant; handles start from 0 again
+    void Clear();
+
+    // Draw one part of a plant with a program from this class bound
+    void DrawPart(int plant, PLANT_PART part) const;
+    int GetInstanceCount(int plant, PLANT_PART part) const { return m_plants[plant].instanceCounts[part]; }
+    int GetPlantCount() const { return (int)m_plants.size(); }
+
+private:
+    // GL objects for one uploaded plant
+    struct GPU_PLANT
+    {
+        const MeshLibrary* pMeshLibrary;
+        GLuint instanceBuffer;
+        GLuint vaos[PART_COUNT];
+        int instanceCounts[PART_COUNT];
+    };
+
+    ShaderManager* m_pPhongShader;
+    ShaderManager* m_pDepthShader;
+    std::vector<GPU_PLANT> m_plants;
+};
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// ProceduralMeshes.cpp
+// ============
+// Vertex-pulling mode for the curved primitives: the vertex shader
+// builds positions, normals and UVs from gl_VertexID and a few per-draw
+// uniforms, so these draws read no vertex or index buffers at all.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ProceduralMeshes.h"
+#include "ShaderManager.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+
+namespace
+{
+    const char* PROCEDURAL_VERTEX_SHADER = "shaders/proceduralVertexShader.glsl";
+    // same Phong fragment shader main() loads for the main program
+    const char* PHONG_FRAGMENT_SHADER = "../../Utilities/shaders/fragmentShader.glsl";
+    const char* DEPTH_FRAGMENT_SHADER = "shaders/depthFragmentShader.glsl";
+}
+
+/***********************************************************
+ * ProceduralMeshes()
+ ***********************************************************/
+ProceduralMeshes::ProceduralMeshes()
+    : m_pPhongShader(nullptr)
+    , m_pDepthShader(nullptr)
+    , m_emptyVAO(0)
+{
+}
+
+/***********************************************************
+ * ~ProceduralMeshes()
+ ***********************************************************/
+ProceduralMeshes::~ProceduralMeshes()
+{
+    delete m_pPhongShader;
+    m_pPhongShader = nullptr;
+    delete m_pDepthShader;
+    m_pDepthShader = nullptr;
+
+    if (m_emptyVAO != 0)
+        glDeleteVertexArrays(1, &m_emptyVAO);
+}
+
+/***********************************************************
+ * LoadShaders()
+ ***********************************************************/
+bool ProceduralMeshes::LoadShaders()
+{
+    m_pPhongShader = new ShaderManager();
+    m_pPhongShader->LoadShaders(PROCEDURAL_VERTEX_SHADER, PHONG_FRAGMENT_SHADER);
+
+    m_pDepthShader = new ShaderManager();
+    m_pDepthShader->LoadShaders(PROCEDURAL_VERTEX_SHADER, DEPTH_FRAGMENT_SHADER);
+
+    if (m_pPhongShader->m_programID == 0 || m_pDepthShader->m_programID == 0)
+    {
+        std::cout << "INFO: Procedural mesh shaders failed to load" << std::endl;
+        return false;
+    }
+
+    glGenVertexArrays(1, &m_emptyVAO);
+    return true;
+}
+
+/***********************************************************
+ * GetSideTriangles() / GetCapTriangles()
+ * Must agree with proceduralVertexShader.glsl and with the
+ * index counts MeshLibrary's generators produce.
+ ***********************************************************/
+int ProceduralMeshes::GetSideTriangles(MeshLibrary::LOD_SHAPE shape, const MeshLibrary::SHAPE_PARAMETERS& parameters)
+{
+    switch (shape)
+    {
+    case MeshLibrary::LOD_SPHERE:
+        // one triangle per sector in the two rows touching a pole
+        return 2 * parameters.segments * (parameters.rings - 1);
+    case MeshLibrary::LOD_CYLINDER:
+    case MeshLibrary::LOD_TAPERED_CYLINDER:
+        return 2 * parameters.segments;
+    case MeshLibrary::LOD_TORUS:
+    default:
+        return 2 * parameters.segments * parameters.rings;
+    }
+}
+
+int ProceduralMeshes::GetCapTriangles(MeshLibrary::LOD_SHAPE shape, const MeshLibrary::SHAPE_PARAMETERS& parameters)
+{
+    if (shape == MeshLibrary::LOD_CYLINDER || shape == MeshLibrary::LOD_TAPERED_CYLINDER)
+        return parameters.segments;
+    return 0;
+}
+
+/***********************************************************
+ * Draw()
+ * Parts follow MeshLibrary's [bottom][sides][top][bottom]
+ * cylinder layout in gl_VertexID space, so any combination
+ * is one glDrawArrays() range.
+ ***********************************************************/
+void ProceduralMeshes::Draw(
+    GLStateCache* pStateCache,
+    ShaderManager* pShader,
+    MeshLibrary::LOD_SHAPE shape,
+    int level,
+    bool bDrawTop,
+    bool bDrawBottom,
+    bool bDrawSides)
+{
+    MeshLibrary::SHAPE_PARAMETERS parameters = MeshLibrary::GetShapeParameters(shape, level);
+    pStateCache->SetIntValue(pShader, "proceduralShape", (int)shape);
+    pStateCache->SetIntValue(pShader, "proceduralSegments", parameters.segments);
+    pStateCache->SetIntValue(pShader, "proceduralRings", parameters.rings);
+    pStateCache->SetFloatValue(pShader, "proceduralRadius", parameters.radius);
+
+    uint32_t sideVertices = GetSideTriangles(shape, parameters) * 3;
+    uint32_t capVertices = GetCapTriangles(shape, parameters) * 3;
+
+    MeshLibrary::INDEX_RANGE bottomCap = { 0, capVertices };
+    MeshLibrary::INDEX_RANGE sides = { capVertices, sideVertices };
+    MeshLibrary::INDEX_RANGE topCap = { capVertices + sideVertices, capVertices };
+    MeshLibrary::INDEX_RANGE range = MeshLibrary::GetPartsRange(sides, topCap, bottomCap, bDrawTop, bDrawBottom, bDrawSides);
+    if (range.count == 0)
+        return;
+
+    glBindVertexArray(m_emptyVAO);
+    glDrawArrays(GL_TRIANGLES, (GLint)range.first, (GLsizei)range.count);
+    glBindVertexArray(0);
+}
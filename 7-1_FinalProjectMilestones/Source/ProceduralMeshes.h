@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// ProceduralMeshes.h
+// ============
+// Vertex-pulling mode for the curved primitives: the vertex shader
+// builds positions, normals and UVs from gl_VertexID and a few per-draw
+// uniforms, so these draws read no vertex or index buffers at all.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <GL/glew.h>
+
+class ShaderManager;
+class GLStateCache;
+
+/***********************************************************
+ *  ProceduralMeshes
+ *
+ *  Owns two programs built around the procedural vertex
+ *  shader: one with the shared Phong fragment shader for the
+ *  main pass and one with the depth pre-pass fragment
+ *  shader. Any MeshLibrary shape and level can be drawn; the
+ *  level only picks the tessellation uniforms, so LOD costs
+ *  nothing extra here.
+ *
+ *  The programs carry their own uniforms — the caller sets
+ *  the camera, lights and materials on them like it does on
+ *  the main program.
+ ***********************************************************/
+class ProceduralMeshes
+{
+public:
+    // constructor
+    ProceduralMeshes();
+    // destructor
+    ~ProceduralMeshes();
+
+    // Build both programs; returns false if either failed, in which
+    // case the mode should stay off
+    bool LoadShaders();
+    ShaderManager* GetPhongShader() const { return m_pPhongShader; }
+    ShaderManager* GetDepthShader() const { return m_pDepthShader; }
+
+    // Set the shape uniforms on pShader (already bound) and draw the
+    // requested parts; cap flags only matter for cylinders
+    void Draw(
+        GLStateCache* pStateCache,
+        ShaderManager* pShader,
+        MeshLibrary::LOD_SHAPE shape,
+        int level,
+        bool bDrawTop = true,
+        bool bDrawBottom = true,
+        bool bDrawSides = true);
+
+    // Triangles in the sides and in each cap
+    static int GetSideTriangles(MeshLibrary::LOD_SHAPE shape, const MeshLibrary::SHAPE_PARAMETERS& parameters);
+    static int GetCapTriangles(MeshLibrary::LOD_SHAPE shape, const MeshLibrary::SHAPE_PARAMETERS& parameters);
+
+private:
+    ShaderManager* m_pPhongShader;
+    ShaderManager* m_pDepthShader;
+    // core profile needs a bound VAO even for attribute-less draws
+    GLuint m_emptyVAO;
+};
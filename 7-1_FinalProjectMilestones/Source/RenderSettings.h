@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////
+// RenderSettings.h
+// ============
+// Runtime render toggles shared between the view manager (which maps
+// them to keys) and the scene manager (which acts on them).
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  RENDER_SETTINGS
+ *
+ *  Owned by main; the managers only hold a pointer to it.
+ ***********************************************************/
+struct RENDER_SETTINGS
+{
+    // test object bounds against the CPU occlusion buffer (key C)
+    bool bOcclusionCulling = true;
+    // swap curved shapes to coarser meshes by screen size (key L)
+    bool bLevelOfDetail = true;
+    // lay down depth first so the Phong pass shades each pixel once (key Z)
+    bool bDepthPrepass = false;
+    // show fragments per pixel as a heatmap instead of the scene (key V)
+    bool bOverdrawView = false;
+    // drop GL calls that don't change any state (key G)
+    bool bStateFilter = true;
+    // draw the LOD meshes from the 16-byte packed vertex layout (key K)
+    bool bPackedVertices = false;
+    // build curved shapes in the vertex shader from gl_VertexID (key M)
+    bool bProceduralMeshes = false;
+    // skip off-screen and back-facing clusters of imported meshes (key J)
+    bool bMeshletCulling = true;
+    // sway the bonsai's branches through the scene graph (key B)
+    bool bBonsaiWind = false;
+    // draw scene plant lines as generated, instanced trees (key T)
+    bool bProceduralPlants = false;
+    // shrink the render resolution to hold the GPU frame time (key R)
+    bool bDynamicResolution = true;
+};
@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+// ResolutionScaler.cpp
+// ============
+// Dynamic resolution: renders the scene into an offscreen target whose
+// size follows the GPU frame time, then upscales it to the window.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ResolutionScaler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // 60 frames a second
+    const double DEFAULT_TARGET_MILLISECONDS = 1000.0 / 60.0;
+
+    // The scale moves in steps of SCALE_STEP between MIN_SCALE_STEPS and
+    // MAX_SCALE_STEPS of them, i.e. from half to full resolution per axis
+    const float SCALE_STEP = 0.05f;
+    const int MIN_SCALE_STEPS = 10;
+    const int MAX_SCALE_STEPS = 20;
+
+    // Frames averaged per decision, and the fraction of the target a
+    // sample must come in under before the scale steps back up
+    const int SAMPLE_FRAMES = 15;
+    const double HEADROOM = 0.8;
+}
+
+/***********************************************************
+ * ResolutionScaler()
+ * GL objects are created lazily on the first frame, once
+ * the window size is known.
+ ***********************************************************/
+ResolutionScaler::ResolutionScaler()
+    : m_framebuffer(0)
+    , m_colorBuffer(0)
+    , m_depthBuffer(0)
+    , m_targetWidth(0)
+    , m_targetHeight(0)
+    , m_windowWidth(0)
+    , m_windowHeight(0)
+    , m_renderWidth(0)
+    , m_renderHeight(0)
+    , m_bEnabled(false)
+    , m_bUsingTarget(false)
+    , m_queryIndex(0)
+    , m_targetMilliseconds(DEFAULT_TARGET_MILLISECONDS)
+    , m_scaleSteps(MAX_SCALE_STEPS)
+    , m_scale(1.0f)
+    , m_sampleMilliseconds(0.0)
+    , m_sampleFrames(0)
+    , m_frameMilliseconds(0.0)
+{
+    for (int i = 0; i < QUERY_FRAMES; i++)
+    {
+        m_queries[i][0] = m_queries[i][1] = 0;
+        m_bQueryPending[i] = false;
+    }
+}
+
+/***********************************************************
+ * ~ResolutionScaler()
+ ***********************************************************/
+ResolutionScaler::~ResolutionScaler()
+{
+    if (m_framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        glDeleteRenderbuffers(1, &m_colorBuffer);
+        glDeleteRenderbuffers(1, &m_depthBuffer);
+    }
+    if (m_queries[0][0] != 0)
+        glDeleteQueries(QUERY_FRAMES * 2, &m_queries[0][0]);
+}
+
+/***********************************************************
+ * ResizeTarget()
+ * Renderbuffers rather than textures: the color is only
+ * ever blitted, never sampled.
+ ***********************************************************/
+void ResolutionScaler::ResizeTarget(int width, int height)
+{
+    if (m_framebuffer == 0)
+    {
+        glGenFramebuffers(1, &m_framebuffer);
+        glGenRenderbuffers(1, &m_colorBuffer);
+        glGenRenderbuffers(1, &m_depthBuffer);
+    }
+
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "INFO: Dynamic resolution framebuffer is incomplete" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    m_targetWidth = width;
+    m_targetHeight = height;
+}
+
+/***********************************************************
+ * BeginFrame()
+ * Called before the frame is cleared, so the clear lands
+ * on whichever framebuffer the scene is about to use.
+ ***********************************************************/
+void ResolutionScaler::BeginFrame(int windowWidth, int windowHeight, bool bEnabled)
+{
+    if (m_queries[0][0] == 0)
+        glGenQueries(QUERY_FRAMES * 2, &m_queries[0][0]);
+    ReadTimings();
+
+    if (bEnabled != m_bEnabled)
+    {
+        // start over at full resolution each time it comes on
+        m_bEnabled = bEnabled;
+        m_scaleSteps = MAX_SCALE_STEPS;
+        m_scale = 1.0f;
+        m_sampleMilliseconds = 0.0;
+        m_sampleFrames = 0;
+        std::cout << "INFO: Dynamic resolution " << (bEnabled ? "ON" : "OFF") << std::endl;
+    }
+
+    m_windowWidth = windowWidth;
+    m_windowHeight = windowHeight;
+    m_renderWidth = std::max(1, (int)(windowWidth * m_scale + 0.5f));
+    m_renderHeight = std::max(1, (int)(windowHeight * m_scale + 0.5f));
+
+    // the window's own framebuffer at full scale or while minimized
+    m_bUsingTarget = m_scaleSteps < MAX_SCALE_STEPS && windowWidth > 0 && windowHeight > 0;
+    if (m_bUsingTarget)
+    {
+        if (windowWidth != m_targetWidth || windowHeight != m_targetHeight)
+            ResizeTarget(windowWidth, windowHeight);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glViewport(0, 0, m_renderWidth, m_renderHeight);
+    }
+    else
+    {
+        m_renderWidth = windowWidth;
+        m_renderHeight = windowHeight;
+        glViewport(0, 0, windowWidth, windowHeight);
+    }
+
+    // overwriting a pair still in flight just drops that frame's time
+    glQueryCounter(m_queries[m_queryIndex][0], GL_TIMESTAMP);
+}
+
+/***********************************************************
+ * EndFrame()
+ * The blit is timed along with the scene, since it's part
+ * of what rendering below full resolution costs.
+ ***********************************************************/
+void ResolutionScaler::EndFrame()
+{
+    if (m_bUsingTarget)
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, m_renderWidth, m_renderHeight,
+                          0, 0, m_windowWidth, m_windowHeight,
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, m_windowWidth, m_windowHeight);
+    }
+
+    glQueryCounter(m_queries[m_queryIndex][1], GL_TIMESTAMP);
+    m_bQueryPending[m_queryIndex] = true;
+    m_queryIndex = (m_queryIndex + 1) % QUERY_FRAMES;
+}
+
+/***********************************************************
+ * ReadTimings()
+ * Oldest pair first; once one isn't ready, the newer ones
+ * won't be either. The timestamps span the GPU's work from
+ * the first command of the frame to the last, so a frame
+ * the CPU is slow to submit reads long too.
+ ***********************************************************/
+void ResolutionScaler::ReadTimings()
+{
+    for (int i = 0; i < QUERY_FRAMES; i++)
+    {
+        int q = (m_queryIndex + i) % QUERY_FRAMES;
+        if (!m_bQueryPending[q])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[q][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 beginTime = 0;
+        GLuint64 endTime = 0;
+        glGetQueryObjectui64v(m_queries[q][0], GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(m_queries[q][1], GL_QUERY_RESULT, &endTime);
+        m_bQueryPending[q] = false;
+
+        m_sampleMilliseconds += (double)(endTime - beginTime) / 1000000.0;
+        if (++m_sampleFrames < SAMPLE_FRAMES)
+            continue;
+
+        m_frameMilliseconds = m_sampleMilliseconds / m_sampleFrames;
+        m_sampleMilliseconds = 0.0;
+        m_sampleFrames = 0;
+        if (m_bEnabled)
+            UpdateScale(m_frameMilliseconds);
+    }
+}
+
+/***********************************************************
+ * UpdateScale()
+ * Fill cost goes with pixel count, the square of the scale,
+ * so an over-budget sample steps straight to the scale the
+ * square root of the overshoot predicts; recovery climbs
+ * one step per sample so it doesn't overshoot back.
+ ***********************************************************/
+void ResolutionScaler::UpdateScale(double milliseconds)
+{
+    int steps = m_scaleSteps;
+    if (milliseconds > m_targetMilliseconds)
+    {
+        double wanted = m_scaleSteps * std::sqrt(m_targetMilliseconds / milliseconds);
+        steps = std::min((int)std::floor(wanted), m_scaleSteps - 1);
+    }
+    else if (milliseconds < m_targetMilliseconds * HEADROOM)
+    {
+        steps = m_scaleSteps + 1;
+    }
+    steps = std::max(MIN_SCALE_STEPS, std::min(steps, MAX_SCALE_STEPS));
+    if (steps == m_scaleSteps)
+        return;
+
+    m_scaleSteps = steps;
+    m_scale = steps * SCALE_STEP;
+    std::cout << "INFO: Render scale " << (int)(m_scale * 100.0f + 0.5f) << "% ("
+              << (int)(m_windowWidth * m_scale + 0.5f) << "x" << (int)(m_windowHeight * m_scale + 0.5f)
+              << ") for " << milliseconds << " ms GPU frames against a "
+              << m_targetMilliseconds << " ms target" << std::endl;
+
+    // frames still in flight were drawn at the old scale
+    for (int i = 0; i < QUERY_FRAMES; i++)
+        m_bQueryPending[i] = false;
+    m_sampleMilliseconds = 0.0;
+    m_sampleFrames = 0;
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// ResolutionScaler.h
+// ============
+// Dynamic resolution: renders the scene into an offscreen target whose
+// size follows the GPU frame time, then upscales it to the window.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  ResolutionScaler
+ *
+ *  BeginFrame() points rendering at a viewport of the
+ *  window's framebuffer size times the current scale, and
+ *  EndFrame() stretches that region over the window with a
+ *  linear blit. The target is allocated at the full window
+ *  size and only the lower-left region is drawn, so a new
+ *  scale never reallocates anything; at full scale the
+ *  frame goes straight to the window instead.
+ *
+ *  GPU time is read from timestamp queries at both ends of
+ *  the frame, QUERY_FRAMES behind, so reading them never
+ *  stalls. The scale steps once per SAMPLE_FRAMES frames:
+ *  down when their average is over the target, up when it
+ *  is under HEADROOM of the target, and not at all in the
+ *  band between, so it doesn't hunt around the target.
+ ***********************************************************/
+class ResolutionScaler
+{
+public:
+    // constructor
+    ResolutionScaler();
+    // destructor
+    ~ResolutionScaler();
+
+    // GPU milliseconds per frame the scale is steered toward
+    void SetTargetFrameTime(double milliseconds) { m_targetMilliseconds = milliseconds; }
+
+    // Bind the target and viewport for a window framebuffer of the given
+    // size; with bEnabled off the frame renders to the window at full size
+    void BeginFrame(int windowWidth, int windowHeight, bool bEnabled);
+    // Upscale to the window, time the frame and step the scale
+    void EndFrame();
+
+    // Fraction of the window's width and height being rendered
+    float GetScale() const { return m_scale; }
+    int GetRenderWidth() const { return m_renderWidth; }
+    int GetRenderHeight() const { return m_renderHeight; }
+    // Average GPU milliseconds per frame over the last full sample
+    double GetFrameTime() const { return m_frameMilliseconds; }
+
+private:
+    // frames of timestamp pairs in flight
+    static const int QUERY_FRAMES = 3;
+
+    // (Re)create the color and depth storage at a new window size
+    void ResizeTarget(int width, int height);
+    // Collect any finished timestamp pairs
+    void ReadTimings();
+    // Step the scale from one sample's average frame time
+    void UpdateScale(double milliseconds);
+
+    GLuint m_framebuffer;
+    GLuint m_colorBuffer;
+    GLuint m_depthBuffer;
+    int m_targetWidth;
+    int m_targetHeight;
+
+    // this frame's sizes, set by BeginFrame()
+    int m_windowWidth;
+    int m_windowHeight;
+    int m_renderWidth;
+    int m_renderHeight;
+    bool m_bEnabled;
+    bool m_bUsingTarget;
+
+    // begin and end timestamps per frame in flight
+    GLuint m_queries[QUERY_FRAMES][2];
+    bool m_bQueryPending[QUERY_FRAMES];
+    int m_queryIndex;
+
+    double m_targetMilliseconds;
+    // the scale is kept in whole SCALE_STEPs so sizes repeat exactly
+    int m_scaleSteps;
+    float m_scale;
+    // frame times gathered toward the next step
+    double m_sampleMilliseconds;
+    int m_sampleFrames;
+    double m_frameMilliseconds;
+};
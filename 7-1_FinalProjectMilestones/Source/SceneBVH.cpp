@@ -0,0 +1,844 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneBVH.cpp
+// ============
+// Binned SAH build, incremental refit and stack-based traversal.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBVH.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+
+#include <glm/gtx/transform.hpp>
+
+namespace
+{
+    // Centroid bins per axis when looking for a split
+    const int BIN_COUNT = 16;
+    // Nodes this small always become leaves; nodes up to
+    // MAX_LEAF_ITEMS become leaves when SAH says splitting won't pay
+    const int MIN_LEAF_ITEMS = 2;
+    const int MAX_LEAF_ITEMS = 8;
+    // Cost of visiting a node, relative to testing one item
+    const float TRAVERSAL_COST = 1.0f;
+    // Below this depth splits fall back to the median, which bounds
+    // the depth of any tree at about MAX_SAH_DEPTH + log2(items)
+    const int MAX_SAH_DEPTH = 40;
+    // Deep enough for MAX_SAH_DEPTH plus the median levels of 2^32 items
+    const int STACK_SIZE = 96;
+    // Refit() rebuilds once the tree's cost passes its build cost by this
+    const float REBUILD_COST_RATIO = 1.5f;
+
+    // Builds this big use the worker pool, with about this many
+    // subtrees per thread so uneven subtrees still balance out
+    const size_t PARALLEL_BUILD_ITEMS = 16384;
+    const int TASKS_PER_THREAD = 4;
+
+    // Item counts RunBenchmark() uses when none are given, how much
+    // room each item gets, how many queries it averages and how many
+    // frames of drift it refits
+    const size_t BENCHMARK_COUNTS[] = { 10000, 100000, 1000000 };
+    const float BENCHMARK_SPACING = 4.0f;
+    const int BENCHMARK_QUERIES = 1000;
+    const int BENCHMARK_FRAMES = 100;
+    const float BENCHMARK_MOVED_SHARE = 0.01f;
+
+    // Half the surface area; zero for an empty box
+    float HalfArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        glm::vec3 size = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    void GrowBounds(const glm::vec3& itemMin, const glm::vec3& itemMax, glm::vec3& boundsMin, glm::vec3& boundsMax)
+    {
+        boundsMin = glm::min(boundsMin, itemMin);
+        boundsMax = glm::max(boundsMax, itemMax);
+    }
+
+    bool Overlaps(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax)
+    {
+        return aMax.x >= bMin.x && aMin.x <= bMax.x &&
+               aMax.y >= bMin.y && aMin.y <= bMax.y &&
+               aMax.z >= bMin.z && aMin.z <= bMax.z;
+    }
+
+    bool OverlapsSphere(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec3& center, float radiusSquared)
+    {
+        glm::vec3 closest = glm::clamp(center, boundsMin, boundsMax);
+        glm::vec3 offset = closest - center;
+        return glm::dot(offset, offset) <= radiusSquared;
+    }
+
+    // Distance along the ray to where it enters the box, or infinity
+    float EnterBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec3& origin,
+                   const glm::vec3& inverseDirection, float maxDistance)
+    {
+        glm::vec3 t0 = (boundsMin - origin) * inverseDirection;
+        glm::vec3 t1 = (boundsMax - origin) * inverseDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        return (enter <= exit) ? enter : std::numeric_limits<float>::infinity();
+    }
+
+    // Gribb/Hartmann planes, as MeshletCuller extracts them
+    void GetFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+    {
+        glm::vec4 row[4];
+        for (int r = 0; r < 4; r++)
+            row[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+
+        planes[0] = row[3] + row[0];
+        planes[1] = row[3] - row[0];
+        planes[2] = row[3] + row[1];
+        planes[3] = row[3] - row[1];
+        planes[4] = row[3] + row[2];
+        planes[5] = row[3] - row[2];
+    }
+
+    // -1 if the box is entirely outside one of the planes, 1 if it's
+    // entirely inside all of them, 0 if it straddles
+    int ClassifyBox(const glm::vec4 planes[6], const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+        int result = 1;
+        for (int plane = 0; plane < 6; plane++)
+        {
+            glm::vec3 normal(planes[plane]);
+            float distance = glm::dot(normal, center) + planes[plane].w;
+            float radius = glm::dot(glm::abs(normal), extent);
+            if (distance < -radius)
+                return -1;
+            if (distance < radius)
+                result = 0;
+        }
+        return result;
+    }
+
+    // doubled, which orders and bins items just as well
+    float GetCentroid2(const EntityStore::BOUNDS& bounds, int axis)
+    {
+        return bounds.boundsMin[axis] + bounds.boundsMax[axis];
+    }
+
+    // Milliseconds since startTime
+    double Elapsed(std::chrono::steady_clock::time_point startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+}
+
+/***********************************************************
+ * SceneBVH()
+ ***********************************************************/
+SceneBVH::SceneBVH(WorkerPool* pWorkerPool)
+    : m_pWorkerPool(pWorkerPool)
+    , m_costSum(0.0)
+    , m_buildCost(0.0f)
+{
+}
+
+/***********************************************************
+ * Build()
+ * With the pool, the top levels are split here until every
+ * open subtree is small enough to be one task. Each task
+ * then builds into its own node array, since the shared one
+ * can't grow from several threads, and the arrays are
+ * spliced on after the top levels, children still after
+ * their parents.
+ ***********************************************************/
+void SceneBVH::Build(const EntityStore::BOUNDS* bounds, size_t count)
+{
+    m_nodes.clear();
+    m_buildItems.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        m_buildItems[i].bounds = bounds[i];
+        m_buildItems[i].item = (int)i;
+    }
+    if (count == 0)
+    {
+        FinishBuild();
+        return;
+    }
+
+    NODE root;
+    root.first = 0;
+    root.count = (int32_t)count;
+    root.left = -1;
+    GetItemBounds(0, root.count, root.boundsMin, root.boundsMax);
+    m_nodes.reserve(count * 2);
+    m_nodes.push_back(root);
+
+    unsigned int threads = (m_pWorkerPool != nullptr) ? m_pWorkerPool->GetThreadCount() : 0;
+    if (threads == 0 || count < PARALLEL_BUILD_ITEMS)
+    {
+        Subdivide(m_nodes, 0, 0, 0, nullptr);
+    }
+    else
+    {
+        int stopCount = (int)(count / ((threads + 1) * TASKS_PER_THREAD));
+        std::vector<BUILD_TASK> tasks;
+        Subdivide(m_nodes, 0, 0, stopCount, &tasks);
+
+        std::vector<std::vector<NODE>> subtrees(tasks.size());
+        m_pWorkerPool->ParallelFor((int)tasks.size(), [this, &tasks, &subtrees](int task)
+        {
+            std::vector<NODE>& nodes = subtrees[task];
+            nodes.reserve(m_nodes[tasks[task].node].count * 2);
+            nodes.push_back(m_nodes[tasks[task].node]);
+            Subdivide(nodes, 0, tasks[task].depth, 0, nullptr);
+        });
+
+        // a subtree's node k lands at base + k - 1; its root replaces
+        // the placeholder the top levels left for it
+        for (size_t task = 0; task < tasks.size(); task++)
+        {
+            std::vector<NODE>& nodes = subtrees[task];
+            int base = (int)m_nodes.size();
+            for (NODE& node : nodes)
+            {
+                if (node.left >= 0)
+                    node.left += base - 1;
+            }
+            m_nodes[tasks[task].node] = nodes[0];
+            m_nodes.insert(m_nodes.end(), nodes.begin() + 1, nodes.end());
+        }
+    }
+
+    FinishBuild();
+    m_buildCost = GetCost();
+}
+
+/***********************************************************
+ * Subdivide()
+ ***********************************************************/
+void SceneBVH::Subdivide(std::vector<NODE>& nodes, int node, int depth, int stopCount, std::vector<BUILD_TASK>* pTasks)
+{
+    if (nodes[node].count <= MIN_LEAF_ITEMS)
+        return;
+    if (pTasks != nullptr && nodes[node].count <= stopCount)
+    {
+        BUILD_TASK task = { node, depth };
+        pTasks->push_back(task);
+        return;
+    }
+
+    int middle;
+    if (!SplitItems(nodes[node], depth, middle))
+        return;
+
+    NODE children[2];
+    children[0].first = nodes[node].first;
+    children[0].count = middle - nodes[node].first;
+    children[1].first = middle;
+    children[1].count = nodes[node].first + nodes[node].count - middle;
+    for (NODE& child : children)
+    {
+        child.left = -1;
+        GetItemBounds(child.first, child.count, child.boundsMin, child.boundsMax);
+    }
+
+    int left = (int)nodes.size();
+    nodes[node].left = left;
+    nodes.push_back(children[0]);
+    nodes.push_back(children[1]);
+    Subdivide(nodes, left, depth + 1, stopCount, pTasks);
+    Subdivide(nodes, left + 1, depth + 1, stopCount, pTasks);
+}
+
+/***********************************************************
+ * SplitItems()
+ * Bins the centroids along each axis and sweeps the bin
+ * boundaries for the lowest SAH cost. Too deep, or with
+ * every centroid in one spot, it splits at the median
+ * instead so the tree stays shallow.
+ ***********************************************************/
+bool SceneBVH::SplitItems(const NODE& node, int depth, int& middle)
+{
+    BUILD_ITEM* items = m_buildItems.data() + node.first;
+    int count = node.count;
+
+    glm::vec3 centroidMin(std::numeric_limits<float>::max());
+    glm::vec3 centroidMax(-std::numeric_limits<float>::max());
+    for (int i = 0; i < count; i++)
+    {
+        glm::vec3 centroid = items[i].bounds.boundsMin + items[i].bounds.boundsMax;
+        GrowBounds(centroid, centroid, centroidMin, centroidMax);
+    }
+
+    glm::vec3 extent = centroidMax - centroidMin;
+    int longest = (extent.x > extent.y) ? ((extent.x > extent.z) ? 0 : 2) : ((extent.y > extent.z) ? 1 : 2);
+    if (depth >= MAX_SAH_DEPTH || extent[longest] <= 0.0f)
+    {
+        middle = node.first + count / 2;
+        std::nth_element(items, items + count / 2, items + count, [longest](const BUILD_ITEM& a, const BUILD_ITEM& b)
+        {
+            return GetCentroid2(a.bounds, longest) < GetCentroid2(b.bounds, longest);
+        });
+        return true;
+    }
+
+    float parentArea = std::max(HalfArea(node.boundsMin, node.boundsMax), 1.0e-12f);
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    int bestBin = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (extent[axis] <= 0.0f)
+            continue;
+
+        int binCounts[BIN_COUNT] = {};
+        glm::vec3 binMin[BIN_COUNT];
+        glm::vec3 binMax[BIN_COUNT];
+        for (int bin = 0; bin < BIN_COUNT; bin++)
+        {
+            binMin[bin] = glm::vec3(std::numeric_limits<float>::max());
+            binMax[bin] = glm::vec3(-std::numeric_limits<float>::max());
+        }
+
+        float scale = BIN_COUNT / extent[axis];
+        for (int i = 0; i < count; i++)
+        {
+            const EntityStore::BOUNDS& bounds = items[i].bounds;
+            int bin = std::min(BIN_COUNT - 1, (int)((GetCentroid2(bounds, axis) - centroidMin[axis]) * scale));
+            binCounts[bin]++;
+            GrowBounds(bounds.boundsMin, bounds.boundsMax, binMin[bin], binMax[bin]);
+        }
+
+        // cost of splitting after each bin, left side swept forward
+        // and right side backward
+        float leftCost[BIN_COUNT - 1];
+        glm::vec3 sweepMin(std::numeric_limits<float>::max());
+        glm::vec3 sweepMax(-std::numeric_limits<float>::max());
+        int sweepCount = 0;
+        for (int bin = 0; bin < BIN_COUNT - 1; bin++)
+        {
+            sweepCount += binCounts[bin];
+            if (binCounts[bin] > 0)
+                GrowBounds(binMin[bin], binMax[bin], sweepMin, sweepMax);
+            leftCost[bin] = sweepCount * HalfArea(sweepMin, sweepMax);
+        }
+        sweepMin = glm::vec3(std::numeric_limits<float>::max());
+        sweepMax = glm::vec3(-std::numeric_limits<float>::max());
+        sweepCount = 0;
+        for (int bin = BIN_COUNT - 1; bin > 0; bin--)
+        {
+            sweepCount += binCounts[bin];
+            if (binCounts[bin] > 0)
+                GrowBounds(binMin[bin], binMax[bin], sweepMin, sweepMax);
+            float cost = TRAVERSAL_COST + (leftCost[bin - 1] + sweepCount * HalfArea(sweepMin, sweepMax)) / parentArea;
+            if (sweepCount < count && sweepCount > 0 && cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = bin - 1;
+            }
+        }
+    }
+
+    if (bestAxis < 0 || (bestCost >= (float)count && count <= MAX_LEAF_ITEMS))
+        return false;
+
+    float scale = BIN_COUNT / extent[bestAxis];
+    float axisMin = centroidMin[bestAxis];
+    BUILD_ITEM* split = std::partition(items, items + count, [bestAxis, bestBin, axisMin, scale](const BUILD_ITEM& item)
+    {
+        return std::min(BIN_COUNT - 1, (int)((GetCentroid2(item.bounds, bestAxis) - axisMin) * scale)) <= bestBin;
+    });
+    middle = node.first + (int)(split - items);
+    return true;
+}
+
+/***********************************************************
+ * GetItemBounds()
+ ***********************************************************/
+void SceneBVH::GetItemBounds(int first, int count, glm::vec3& boundsMin, glm::vec3& boundsMax) const
+{
+    boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+    for (int i = first; i < first + count; i++)
+        GrowBounds(m_buildItems[i].bounds.boundsMin, m_buildItems[i].bounds.boundsMax, boundsMin, boundsMax);
+}
+
+/***********************************************************
+ * FinishBuild()
+ ***********************************************************/
+void SceneBVH::FinishBuild()
+{
+    m_items.resize(m_buildItems.size());
+    m_itemBounds.resize(m_buildItems.size());
+    for (size_t i = 0; i < m_buildItems.size(); i++)
+    {
+        m_items[i] = m_buildItems[i].item;
+        m_itemBounds[i] = m_buildItems[i].bounds;
+    }
+
+    m_parents.assign(m_nodes.size(), -1);
+    m_itemPositions.resize(m_items.size());
+    m_itemLeaves.resize(m_items.size());
+    m_bDirty.assign(m_nodes.size(), 0);
+    m_costSum = 0.0;
+
+    for (size_t node = 0; node < m_nodes.size(); node++)
+    {
+        const NODE& current = m_nodes[node];
+        m_costSum += GetNodeCost(current);
+        if (current.left >= 0)
+        {
+            m_parents[current.left] = (int)node;
+            m_parents[current.left + 1] = (int)node;
+            continue;
+        }
+        for (int i = current.first; i < current.first + current.count; i++)
+        {
+            m_itemPositions[m_items[i]] = i;
+            m_itemLeaves[m_items[i]] = (int)node;
+        }
+    }
+}
+
+/***********************************************************
+ * Refit()
+ * Marks each moved item's leaf and its ancestors, stopping
+ * at the first one that's already marked, then recomputes
+ * them children first — children always come after their
+ * parent, so that's highest index first.
+ ***********************************************************/
+bool SceneBVH::Refit(const EntityStore::BOUNDS* bounds, const std::vector<int>& movedItems)
+{
+    if (m_nodes.empty() || movedItems.empty())
+        return false;
+
+    for (int item : movedItems)
+    {
+        m_itemBounds[m_itemPositions[item]] = bounds[item];
+        for (int node = m_itemLeaves[item]; node >= 0 && !m_bDirty[node]; node = m_parents[node])
+        {
+            m_bDirty[node] = 1;
+            m_dirtyNodes.push_back(node);
+        }
+    }
+    std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end(), std::greater<int>());
+
+    for (int node : m_dirtyNodes)
+    {
+        NODE& current = m_nodes[node];
+        m_costSum -= GetNodeCost(current);
+        if (current.left >= 0)
+        {
+            const NODE& left = m_nodes[current.left];
+            const NODE& right = m_nodes[current.left + 1];
+            current.boundsMin = glm::min(left.boundsMin, right.boundsMin);
+            current.boundsMax = glm::max(left.boundsMax, right.boundsMax);
+        }
+        else
+        {
+            current.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+            current.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+            for (int i = current.first; i < current.first + current.count; i++)
+                GrowBounds(m_itemBounds[i].boundsMin, m_itemBounds[i].boundsMax, current.boundsMin, current.boundsMax);
+        }
+        m_costSum += GetNodeCost(current);
+        m_bDirty[node] = 0;
+    }
+    m_dirtyNodes.clear();
+
+    if (GetCost() <= m_buildCost * REBUILD_COST_RATIO)
+        return false;
+
+    Build(bounds, m_items.size());
+    return true;
+}
+
+/***********************************************************
+ * Clear()
+ ***********************************************************/
+void SceneBVH::Clear()
+{
+    m_nodes.clear();
+    m_buildItems.clear();
+    FinishBuild();
+    m_buildCost = 0.0f;
+}
+
+/***********************************************************
+ * GetNodeCost()
+ ***********************************************************/
+float SceneBVH::GetNodeCost(const NODE& node) const
+{
+    float weight = (node.left >= 0) ? TRAVERSAL_COST : (float)node.count;
+    return weight * HalfArea(node.boundsMin, node.boundsMax);
+}
+
+/***********************************************************
+ * GetCost()
+ * The expected number of node visits and item tests for a
+ * random ray through the root box.
+ ***********************************************************/
+float SceneBVH::GetCost() const
+{
+    if (m_nodes.empty())
+        return 0.0f;
+    float rootArea = std::max(HalfArea(m_nodes[0].boundsMin, m_nodes[0].boundsMax), 1.0e-12f);
+    return (float)(m_costSum / rootArea);
+}
+
+/***********************************************************
+ * QueryFrustum()
+ * A node entirely inside every plane adds its whole item
+ * run without testing anything below it.
+ ***********************************************************/
+void SceneBVH::QueryFrustum(const glm::mat4& viewProjection, std::vector<int>& results) const
+{
+    results.clear();
+    if (m_nodes.empty())
+        return;
+
+    glm::vec4 planes[6];
+    GetFrustumPlanes(viewProjection, planes);
+
+    int stack[STACK_SIZE];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const NODE& node = m_nodes[stack[--depth]];
+        int side = ClassifyBox(planes, node.boundsMin, node.boundsMax);
+        if (side < 0)
+            continue;
+
+        if (side > 0)
+        {
+            results.insert(results.end(), m_items.begin() + node.first, m_items.begin() + node.first + node.count);
+        }
+        else if (node.left >= 0)
+        {
+            stack[depth++] = node.left + 1;
+            stack[depth++] = node.left;
+        }
+        else
+        {
+            for (int i = node.first; i < node.first + node.count; i++)
+            {
+                if (ClassifyBox(planes, m_itemBounds[i].boundsMin, m_itemBounds[i].boundsMax) >= 0)
+                    results.push_back(m_items[i]);
+            }
+        }
+    }
+}
+
+/***********************************************************
+ * QueryBox()
+ ***********************************************************/
+void SceneBVH::QueryBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<int>& results) const
+{
+    results.clear();
+    if (m_nodes.empty())
+        return;
+
+    int stack[STACK_SIZE];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const NODE& node = m_nodes[stack[--depth]];
+        if (!Overlaps(node.boundsMin, node.boundsMax, boundsMin, boundsMax))
+            continue;
+
+        if (node.left >= 0)
+        {
+            stack[depth++] = node.left + 1;
+            stack[depth++] = node.left;
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; i++)
+        {
+            if (Overlaps(m_itemBounds[i].boundsMin, m_itemBounds[i].boundsMax, boundsMin, boundsMax))
+                results.push_back(m_items[i]);
+        }
+    }
+}
+
+/***********************************************************
+ * QuerySphere()
+ ***********************************************************/
+void SceneBVH::QuerySphere(const glm::vec3& center, float radius, std::vector<int>& results) const
+{
+    results.clear();
+    if (m_nodes.empty())
+        return;
+
+    float radiusSquared = radius * radius;
+    int stack[STACK_SIZE];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const NODE& node = m_nodes[stack[--depth]];
+        if (!OverlapsSphere(node.boundsMin, node.boundsMax, center, radiusSquared))
+            continue;
+
+        if (node.left >= 0)
+        {
+            stack[depth++] = node.left + 1;
+            stack[depth++] = node.left;
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; i++)
+        {
+            if (OverlapsSphere(m_itemBounds[i].boundsMin, m_itemBounds[i].boundsMax, center, radiusSquared))
+                results.push_back(m_items[i]);
+        }
+    }
+}
+
+/***********************************************************
+ * CastRay()
+ * Nearer child first, and every node whose box starts past
+ * the closest hit so far is skipped, so most of the tree is
+ * never touched once something close has been hit.
+ ***********************************************************/
+int SceneBVH::CastRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                      const RAY_TEST& test, float& hitDistance) const
+{
+    hitDistance = maxDistance;
+    if (m_nodes.empty())
+        return -1;
+
+    // a huge finite value instead of infinity keeps 0 * inverse out of NaN
+    glm::vec3 inverseDirection;
+    for (int axis = 0; axis < 3; axis++)
+        inverseDirection[axis] = (direction[axis] != 0.0f) ? 1.0f / direction[axis] : std::copysign(1.0e30f, direction[axis]);
+
+    int hit = -1;
+    float best = maxDistance;
+
+    int stack[STACK_SIZE];
+    float stackEnter[STACK_SIZE];
+    int depth = 0;
+    float rootEnter = EnterBox(m_nodes[0].boundsMin, m_nodes[0].boundsMax, origin, inverseDirection, best);
+    if (rootEnter <= best)
+    {
+        stack[depth] = 0;
+        stackEnter[depth++] = rootEnter;
+    }
+
+    while (depth > 0)
+    {
+        depth--;
+        if (stackEnter[depth] > best)
+            continue;
+        const NODE& node = m_nodes[stack[depth]];
+
+        if (node.left >= 0)
+        {
+            const NODE& left = m_nodes[node.left];
+            const NODE& right = m_nodes[node.left + 1];
+            float leftEnter = EnterBox(left.boundsMin, left.boundsMax, origin, inverseDirection, best);
+            float rightEnter = EnterBox(right.boundsMin, right.boundsMax, origin, inverseDirection, best);
+
+            // push the farther one first so the nearer one pops next
+            int nearChild = node.left;
+            int farChild = node.left + 1;
+            if (rightEnter < leftEnter)
+            {
+                std::swap(nearChild, farChild);
+                std::swap(leftEnter, rightEnter);
+            }
+            if (rightEnter <= best)
+            {
+                stack[depth] = farChild;
+                stackEnter[depth++] = rightEnter;
+            }
+            if (leftEnter <= best)
+            {
+                stack[depth] = nearChild;
+                stackEnter[depth++] = leftEnter;
+            }
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++)
+        {
+            float enter = EnterBox(m_itemBounds[i].boundsMin, m_itemBounds[i].boundsMax, origin, inverseDirection, best);
+            if (enter > best)
+                continue;
+
+            if (!test)
+            {
+                best = enter;
+                hit = m_items[i];
+                continue;
+            }
+            float distance = best;
+            if (test(m_items[i], distance) && distance < best)
+            {
+                best = distance;
+                hit = m_items[i];
+            }
+        }
+    }
+
+    hitDistance = best;
+    return hit;
+}
+
+/***********************************************************
+ * RunBenchmark()
+ * Boxes of 0.2 to 2 units are scattered through a cube that
+ * grows with the count, so density stays the same. Logged
+ * for each count, best of three where it's a single call:
+ *   build     on one thread and on the worker pool
+ *   refit     BENCHMARK_FRAMES frames of a random walk by
+ *             BENCHMARK_MOVED_SHARE of the boxes, averaged,
+ *             with the cost drift and any rebuilds
+ *   queries   average over BENCHMARK_QUERIES random rays,
+ *             spheres and boxes, and one frustum from a
+ *             corner, each against a linear scan for scale
+ ***********************************************************/
+void SceneBVH::RunBenchmark(const std::vector<std::string>& args)
+{
+    std::vector<size_t> counts;
+    for (const std::string& arg : args)
+    {
+        size_t count = (size_t)std::strtoull(arg.c_str(), nullptr, 10);
+        if (count > 0)
+            counts.push_back(count);
+    }
+    if (counts.empty())
+        counts.assign(std::begin(BENCHMARK_COUNTS), std::end(BENCHMARK_COUNTS));
+
+    WorkerPool pool;
+    for (size_t count : counts)
+    {
+        float side = std::cbrt((float)count) * BENCHMARK_SPACING;
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(0.0f, side);
+        std::uniform_real_distribution<float> size(0.1f, 1.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        std::vector<EntityStore::BOUNDS> bounds(count);
+        for (EntityStore::BOUNDS& box : bounds)
+        {
+            glm::vec3 center(position(random), position(random), position(random));
+            glm::vec3 extent(size(random), size(random), size(random));
+            box.boundsMin = center - extent;
+            box.boundsMax = center + extent;
+        }
+
+        SceneBVH serial(nullptr);
+        SceneBVH bvh(&pool);
+        double serialBuild = 0.0;
+        double parallelBuild = 0.0;
+        for (int run = 0; run < 3; run++)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            serial.Build(bounds.data(), count);
+            double milliseconds = Elapsed(startTime);
+            serialBuild = (run == 0) ? milliseconds : std::min(serialBuild, milliseconds);
+
+            startTime = std::chrono::steady_clock::now();
+            bvh.Build(bounds.data(), count);
+            milliseconds = Elapsed(startTime);
+            parallelBuild = (run == 0) ? milliseconds : std::min(parallelBuild, milliseconds);
+        }
+        float buildCost = bvh.GetCost();
+
+        // queries first, against the tree as built
+        std::vector<int> results;
+        size_t rayHits = 0;
+        size_t sphereItems = 0;
+        size_t boxItems = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (int query = 0; query < BENCHMARK_QUERIES; query++)
+        {
+            glm::vec3 origin(position(random), position(random), position(random));
+            glm::vec3 direction(unit(random), unit(random), unit(random));
+            float distance;
+            rayHits += (bvh.CastRay(origin, direction, side, RAY_TEST(), distance) >= 0) ? 1 : 0;
+        }
+        double rayMicroseconds = Elapsed(startTime) * 1000.0 / BENCHMARK_QUERIES;
+
+        startTime = std::chrono::steady_clock::now();
+        for (int query = 0; query < BENCHMARK_QUERIES; query++)
+        {
+            bvh.QuerySphere(glm::vec3(position(random), position(random), position(random)), 5.0f, results);
+            sphereItems += results.size();
+        }
+        double sphereMicroseconds = Elapsed(startTime) * 1000.0 / BENCHMARK_QUERIES;
+
+        startTime = std::chrono::steady_clock::now();
+        for (int query = 0; query < BENCHMARK_QUERIES; query++)
+        {
+            glm::vec3 corner(position(random), position(random), position(random));
+            bvh.QueryBox(corner, corner + glm::vec3(8.0f), results);
+            boxItems += results.size();
+        }
+        double boxMicroseconds = Elapsed(startTime) * 1000.0 / BENCHMARK_QUERIES;
+
+        // a camera just outside one corner, looking at the far one
+        glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, side * 2.0f) *
+                                   glm::lookAt(glm::vec3(-1.0f), glm::vec3(side), glm::vec3(0.0f, 1.0f, 0.0f));
+        startTime = std::chrono::steady_clock::now();
+        bvh.QueryFrustum(viewProjection, results);
+        double frustumMilliseconds = Elapsed(startTime);
+        size_t frustumItems = results.size();
+
+        // one linear scan for scale
+        startTime = std::chrono::steady_clock::now();
+        glm::vec3 scanMin(side * 0.5f);
+        size_t scanned = 0;
+        for (const EntityStore::BOUNDS& box : bounds)
+            scanned += Overlaps(box.boundsMin, box.boundsMax, scanMin, scanMin + glm::vec3(8.0f)) ? 1 : 0;
+        double scanMicroseconds = Elapsed(startTime) * 1000.0;
+
+        // then a drifting scene
+        size_t movedCount = std::max<size_t>(1, (size_t)(count * BENCHMARK_MOVED_SHARE));
+        std::uniform_int_distribution<int> pick(0, (int)count - 1);
+        std::vector<int> moved(movedCount);
+        int rebuilds = 0;
+        double refitMilliseconds = 0.0;
+        float peakCost = buildCost;
+        for (int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+        {
+            for (size_t i = 0; i < movedCount; i++)
+            {
+                moved[i] = pick(random);
+                glm::vec3 step(unit(random), unit(random), unit(random));
+                bounds[moved[i]].boundsMin += step;
+                bounds[moved[i]].boundsMax += step;
+            }
+            startTime = std::chrono::steady_clock::now();
+            float cost = bvh.GetCost();
+            rebuilds += bvh.Refit(bounds.data(), moved) ? 1 : 0;
+            refitMilliseconds += Elapsed(startTime);
+            peakCost = std::max(peakCost, std::max(cost, bvh.GetCost()));
+        }
+        refitMilliseconds /= BENCHMARK_FRAMES;
+
+        std::cout << "INFO: BVH over " << count << " boxes (" << bvh.GetNodeCount() << " nodes, SAH cost "
+                  << buildCost << "): build " << serialBuild << " ms on one thread, " << parallelBuild
+                  << " ms on " << pool.GetThreadCount() + 1 << "; refit of " << movedCount << " moved "
+                  << refitMilliseconds << " ms a frame (cost peaked at " << peakCost << ", "
+                  << rebuilds << " rebuilds in " << BENCHMARK_FRAMES << " frames)" << std::endl;
+        std::cout << "INFO:   ray " << rayMicroseconds << " us (" << rayHits << "/" << BENCHMARK_QUERIES
+                  << " hit), sphere r5 " << sphereMicroseconds << " us (" << sphereItems / BENCHMARK_QUERIES
+                  << " found), box 8^3 " << boxMicroseconds << " us (" << boxItems / BENCHMARK_QUERIES
+                  << " found), frustum " << frustumMilliseconds << " ms (" << frustumItems
+                  << " found); linear box scan " << scanMicroseconds << " us (" << scanned << " found)" << std::endl;
+    }
+}
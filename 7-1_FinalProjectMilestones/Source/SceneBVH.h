@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneBVH.h
+// ============
+// Bounding volume hierarchy over scene object bounds for frustum, ray,
+// sphere and box queries, refit in place as objects move.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "EntityStore.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class WorkerPool;
+
+/***********************************************************
+ *  SceneBVH
+ *
+ *  Items are positions in an EntityStore's bounds column.
+ *  Build() splits them top-down with the surface area
+ *  heuristic, evaluated over BIN_COUNT centroid bins per
+ *  axis. Large builds split the top levels on the calling
+ *  thread, then finish the subtrees on the worker pool.
+ *
+ *  Every subtree covers one contiguous run of the item
+ *  order, and every child sits after its parent in the node
+ *  array, so a refit is a backward walk over just the
+ *  moved items' ancestors. Refit() tracks the tree's SAH
+ *  cost as boxes grow and rebuilds once it has drifted
+ *  REBUILD_COST_RATIO past the cost at build time.
+ *
+ *  Queries append matching items to a results vector; the
+ *  ray query visits nearer children first and hands each
+ *  candidate to the caller for an exact test. CPU only —
+ *  no GL.
+ ***********************************************************/
+class SceneBVH
+{
+public:
+    // Exact test for one item the ray's box test didn't rule out:
+    // return true and lower distance if the item is hit closer
+    typedef std::function<bool(int item, float& distance)> RAY_TEST;
+
+    // constructor — pWorkerPool may be null for single-threaded builds
+    SceneBVH(WorkerPool* pWorkerPool);
+
+    // Build over bounds[0] .. bounds[count - 1]
+    void Build(const EntityStore::BOUNDS* bounds, size_t count);
+    // Pick up the new bounds of the moved items, growing or shrinking
+    // only their ancestors; rebuilds if the tree has degraded too far.
+    // Returns true if it rebuilt.
+    bool Refit(const EntityStore::BOUNDS* bounds, const std::vector<int>& movedItems);
+    // Drop every item
+    void Clear();
+
+    // Items whose boxes are at least partly inside the frustum
+    void QueryFrustum(const glm::mat4& viewProjection, std::vector<int>& results) const;
+    // Items whose boxes overlap the box
+    void QueryBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<int>& results) const;
+    // Items whose boxes overlap the sphere
+    void QuerySphere(const glm::vec3& center, float radius, std::vector<int>& results) const;
+    // Closest item along the ray within maxDistance, or -1. Without a
+    // test, entering an item's box counts as hitting it. direction
+    // needn't be normalized; distances are in multiples of it.
+    int CastRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                const RAY_TEST& test, float& hitDistance) const;
+
+    size_t GetItemCount() const { return m_items.size(); }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    // SAH cost now and when last built, relative to the root box
+    float GetCost() const;
+    float GetBuildCost() const { return m_buildCost; }
+
+    // Time builds, refits and each query at every item count in args
+    // (10k, 100k and 1M by default) and log them
+    static void RunBenchmark(const std::vector<std::string>& args);
+
+private:
+    struct NODE
+    {
+        glm::vec3 boundsMin;
+        // this subtree's run of m_items
+        int32_t first;
+        glm::vec3 boundsMax;
+        int32_t count;
+        // first of the two children, which sit side by side; -1 for a leaf
+        int32_t left;
+    };
+
+    // an item and its box, partitioned together during a build so
+    // every pass over a node's items reads one contiguous run
+    struct BUILD_ITEM
+    {
+        EntityStore::BOUNDS bounds;
+        int item;
+    };
+
+    // a subtree left for the worker pool
+    struct BUILD_TASK
+    {
+        int node;
+        int depth;
+    };
+
+    // Split node until its leaves are small enough; subtrees of
+    // stopCount items or fewer go to pTasks instead, if given
+    void Subdivide(std::vector<NODE>& nodes, int node, int depth, int stopCount, std::vector<BUILD_TASK>* pTasks);
+    // Pick a split for a node's items and partition them around it;
+    // false if the node should stay a leaf
+    bool SplitItems(const NODE& node, int depth, int& middle);
+    // union of the boxes of a run of m_buildItems
+    void GetItemBounds(int first, int count, glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+    // parents, item positions, item leaves and the stored item boxes
+    void FinishBuild();
+    // unnormalized SAH cost of one node
+    float GetNodeCost(const NODE& node) const;
+
+    WorkerPool* m_pWorkerPool;
+
+    std::vector<NODE> m_nodes;
+    std::vector<int> m_parents;
+    // item order; leaves point into this
+    std::vector<int> m_items;
+    // item boxes in m_items order, so leaves read them contiguously
+    std::vector<EntityStore::BOUNDS> m_itemBounds;
+    // by item: position in m_items and the leaf holding it
+    std::vector<int> m_itemPositions;
+    std::vector<int> m_itemLeaves;
+
+    // item order while Build() is partitioning it
+    std::vector<BUILD_ITEM> m_buildItems;
+
+    // nodes Refit() is recomputing, once each
+    std::vector<int> m_dirtyNodes;
+    std::vector<uint8_t> m_bDirty;
+
+    // sum of every node's cost, kept up to date by Refit()
+    double m_costSum;
+    float m_buildCost;
+};
@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneBinary.cpp
+// ============
+// Compiled scene format: entity component columns and tag tables that are
+// mapped and copied in bulk, with no parsing on load.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBinary.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    // "SCNB" read as a little-endian uint32; reads back scrambled on a
+    // machine with the other byte order, which Read() treats as stale
+    const uint32_t SCENE_FILE_MAGIC = 0x424E4353;
+
+    // the blobs between the header and the tag tables, in file order
+    enum COLUMN
+    {
+        COLUMN_TRANSFORMS,
+        COLUMN_MESHES,
+        COLUMN_MATERIALS,
+        COLUMN_TEXTURES,
+        COLUMN_SURFACES,
+        COLUMN_BOUNDS,
+        COLUMN_FLAGS,
+        COLUMN_PROPS,
+        COLUMN_COUNT
+    };
+
+    // size of one element of each column in this build
+    const uint32_t COLUMN_ELEMENT_SIZES[COLUMN_COUNT] =
+    {
+        sizeof(glm::mat4),
+        sizeof(EntityStore::MESH_REF),
+        sizeof(int),
+        sizeof(int),
+        sizeof(EntityStore::SURFACE),
+        sizeof(EntityStore::BOUNDS),
+        sizeof(uint8_t),
+        sizeof(SceneBinary::PROP_RECORD)
+    };
+
+    // Everything in the header is 32-bit so there's no padding to
+    // worry about between compilers; the source stamp is split in two
+    struct SCENE_FILE_HEADER
+    {
+        uint32_t magic;
+        uint32_t formatVersion;
+        uint32_t elementSizes[COLUMN_COUNT];
+        uint32_t entityCount;
+        uint32_t propRecordCount;
+        uint32_t textureCount;
+        uint32_t materialCount;
+        uint32_t propCount;
+        uint32_t sourceTimeLow;
+        uint32_t sourceTimeHigh;
+        uint32_t sourceSizeLow;
+        uint32_t sourceSizeHigh;
+        // byte offsets from the start of the file
+        uint32_t columnOffsets[COLUMN_COUNT];
+        uint32_t stringOffsetsOffset;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+        uint32_t fileSize;
+    };
+
+    // same alignment as the mesh cache blobs
+    const uint32_t BLOB_ALIGNMENT = 16;
+
+    uint64_t AlignUp(uint64_t value)
+    {
+        return (value + BLOB_ALIGNMENT - 1) & ~(uint64_t)(BLOB_ALIGNMENT - 1);
+    }
+
+    void AppendTags(const std::vector<std::string>& tags, std::vector<uint32_t>& offsets, std::string& strings)
+    {
+        for (const std::string& tag : tags)
+        {
+            offsets.push_back((uint32_t)strings.size());
+            strings += tag;
+            strings += '\0';
+        }
+    }
+
+    long long JoinStamp(uint32_t low, uint32_t high)
+    {
+        return (long long)(((uint64_t)high << 32) | low);
+    }
+}
+
+/***********************************************************
+ * Write()
+ * Header, each column, string offsets, strings — each
+ * padded out to BLOB_ALIGNMENT. Offsets are 32-bit, so
+ * scenes past 4 GB are refused rather than written wrong.
+ ***********************************************************/
+bool SceneBinary::Write(const std::string& path, const SCENE_DATA& scene)
+{
+    size_t count = scene.transforms.size();
+    if (scene.meshes.size() != count || scene.materials.size() != count || scene.textures.size() != count ||
+        scene.surfaces.size() != count || scene.bounds.size() != count || scene.flags.size() != count ||
+        scene.props.size() > count)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> stringOffsets;
+    std::string strings;
+    AppendTags(scene.textureTags, stringOffsets, strings);
+    AppendTags(scene.materialTags, stringOffsets, strings);
+    AppendTags(scene.propTags, stringOffsets, strings);
+
+    const void* columns[COLUMN_COUNT] =
+    {
+        scene.transforms.data(), scene.meshes.data(), scene.materials.data(), scene.textures.data(),
+        scene.surfaces.data(), scene.bounds.data(), scene.flags.data(), scene.props.data()
+    };
+    uint64_t columnBytes[COLUMN_COUNT];
+    uint64_t columnOffsets[COLUMN_COUNT];
+    uint64_t offset = AlignUp(sizeof(SCENE_FILE_HEADER));
+    for (int column = 0; column < COLUMN_COUNT; column++)
+    {
+        size_t elements = (column == COLUMN_PROPS) ? scene.props.size() : count;
+        columnBytes[column] = (uint64_t)elements * COLUMN_ELEMENT_SIZES[column];
+        columnOffsets[column] = offset;
+        offset = AlignUp(offset + columnBytes[column]);
+    }
+    uint64_t offsetBytes = (uint64_t)stringOffsets.size() * sizeof(uint32_t);
+    uint64_t stringOffsetsOffset = offset;
+    uint64_t stringsOffset = AlignUp(stringOffsetsOffset + offsetBytes);
+    uint64_t fileSize = stringsOffset + strings.size();
+    if (fileSize > 0xFFFFFFFFull)
+        return false;
+
+    SCENE_FILE_HEADER header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SCENE_FILE_MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    for (int column = 0; column < COLUMN_COUNT; column++)
+    {
+        header.elementSizes[column] = COLUMN_ELEMENT_SIZES[column];
+        header.columnOffsets[column] = (uint32_t)columnOffsets[column];
+    }
+    header.entityCount = (uint32_t)count;
+    header.propRecordCount = (uint32_t)scene.props.size();
+    header.textureCount = (uint32_t)scene.textureTags.size();
+    header.materialCount = (uint32_t)scene.materialTags.size();
+    header.propCount = (uint32_t)scene.propTags.size();
+    header.sourceTimeLow = (uint32_t)((uint64_t)scene.sourceTime & 0xFFFFFFFF);
+    header.sourceTimeHigh = (uint32_t)((uint64_t)scene.sourceTime >> 32);
+    header.sourceSizeLow = (uint32_t)((uint64_t)scene.sourceSize & 0xFFFFFFFF);
+    header.sourceSizeHigh = (uint32_t)((uint64_t)scene.sourceSize >> 32);
+    header.stringOffsetsOffset = (uint32_t)stringOffsetsOffset;
+    header.stringsOffset = (uint32_t)stringsOffset;
+    header.stringsSize = (uint32_t)strings.size();
+    header.fileSize = (uint32_t)fileSize;
+
+    std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!stream)
+        return false;
+
+    const char padding[BLOB_ALIGNMENT] = {};
+    uint64_t written = sizeof(header);
+    stream.write((const char*)&header, sizeof(header));
+    for (int column = 0; column < COLUMN_COUNT; column++)
+    {
+        stream.write(padding, columnOffsets[column] - written);
+        stream.write((const char*)columns[column], columnBytes[column]);
+        written = columnOffsets[column] + columnBytes[column];
+    }
+    stream.write(padding, stringOffsetsOffset - written);
+    stream.write((const char*)stringOffsets.data(), offsetBytes);
+    stream.write(padding, stringsOffset - (stringOffsetsOffset + offsetBytes));
+    stream.write(strings.data(), strings.size());
+    return (bool)stream;
+}
+
+/***********************************************************
+ * Read()
+ * Checks the header against this build before trusting any
+ * offsets, then that every column fits in the file and
+ * every tag string starts inside the string blob, which
+ * ends in a terminator. That's a fixed number of columns
+ * and a handful of tags, however many entities there are.
+ ***********************************************************/
+bool SceneBinary::Read(const std::string& path, MappedFile& file, SCENE_VIEW& view)
+{
+    if (!file.Open(path))
+        return false;
+
+    if (file.GetSize() < sizeof(SCENE_FILE_HEADER))
+    {
+        file.Close();
+        return false;
+    }
+
+    SCENE_FILE_HEADER header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    uint64_t tagCount = (uint64_t)header.textureCount + header.materialCount + header.propCount;
+    bool bValid =
+        header.magic == SCENE_FILE_MAGIC &&
+        header.formatVersion == FORMAT_VERSION &&
+        header.fileSize == file.GetSize() &&
+        header.propRecordCount <= header.entityCount &&
+        header.stringOffsetsOffset % BLOB_ALIGNMENT == 0 &&
+        header.stringOffsetsOffset >= sizeof(SCENE_FILE_HEADER) &&
+        (uint64_t)header.stringOffsetsOffset + tagCount * sizeof(uint32_t) <= header.stringsOffset &&
+        (uint64_t)header.stringsOffset + header.stringsSize <= header.fileSize &&
+        (tagCount == 0 || (header.stringsSize > 0 && file.GetData()[header.stringsOffset + header.stringsSize - 1] == '\0'));
+
+    for (int column = 0; column < COLUMN_COUNT && bValid; column++)
+    {
+        uint64_t elements = (column == COLUMN_PROPS) ? header.propRecordCount : header.entityCount;
+        bValid = header.elementSizes[column] == COLUMN_ELEMENT_SIZES[column] &&
+                 header.columnOffsets[column] % BLOB_ALIGNMENT == 0 &&
+                 header.columnOffsets[column] >= sizeof(SCENE_FILE_HEADER) &&
+                 header.columnOffsets[column] + elements * COLUMN_ELEMENT_SIZES[column] <= header.stringOffsetsOffset;
+    }
+
+    const uint32_t* stringOffsets = (const uint32_t*)(file.GetData() + header.stringOffsetsOffset);
+    for (uint64_t i = 0; i < tagCount && bValid; i++)
+        bValid = stringOffsets[i] < header.stringsSize;
+
+    if (!bValid)
+    {
+        file.Close();
+        return false;
+    }
+
+    const unsigned char* data = file.GetData();
+    view.transforms = (const glm::mat4*)(data + header.columnOffsets[COLUMN_TRANSFORMS]);
+    view.meshes = (const EntityStore::MESH_REF*)(data + header.columnOffsets[COLUMN_MESHES]);
+    view.materials = (const int*)(data + header.columnOffsets[COLUMN_MATERIALS]);
+    view.textures = (const int*)(data + header.columnOffsets[COLUMN_TEXTURES]);
+    view.surfaces = (const EntityStore::SURFACE*)(data + header.columnOffsets[COLUMN_SURFACES]);
+    view.bounds = (const EntityStore::BOUNDS*)(data + header.columnOffsets[COLUMN_BOUNDS]);
+    view.flags = (const uint8_t*)(data + header.columnOffsets[COLUMN_FLAGS]);
+    view.entityCount = header.entityCount;
+    view.props = (const PROP_RECORD*)(data + header.columnOffsets[COLUMN_PROPS]);
+    view.propRecordCount = header.propRecordCount;
+    view.textureCount = header.textureCount;
+    view.materialCount = header.materialCount;
+    view.propCount = header.propCount;
+    view.sourceTime = JoinStamp(header.sourceTimeLow, header.sourceTimeHigh);
+    view.sourceSize = JoinStamp(header.sourceSizeLow, header.sourceSizeHigh);
+    view.stringOffsets = stringOffsets;
+    view.strings = (const char*)(data + header.stringsOffset);
+    return true;
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneBinary.h
+// ============
+// Compiled scene format: entity component columns and tag tables that are
+// mapped and copied in bulk, with no parsing on load.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "EntityStore.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+/***********************************************************
+ *  SceneBinary
+ *
+ *  A header, then one blob per EntityStore column laid out
+ *  exactly as the store keeps it in memory, a prop table
+ *  for the entities at the end of the columns, then the tag
+ *  tables: a string offset per texture, material and prop
+ *  tag, and the NUL-terminated strings. A load is a copy of
+ *  each column into the store; only the texture and
+ *  material columns, which hold tag table indices instead
+ *  of runtime slots, need a pass of their own. Only flat
+ *  scenes are compiled — no hierarchy, plants or prefabs —
+ *  since there are no columns for them.
+ *
+ *  Read() checks only the header, the column and table
+ *  ranges and the tag strings. Column contents are trusted:
+ *  the header carries the format version and the size of
+ *  every element type, so a file is only used by a build
+ *  that lays the columns out the way its compiler did.
+ *  Files are written in the machine's own byte order, and
+ *  carry the stamp of the text scene they were compiled
+ *  from so an edited source wins over a stale binary.
+ ***********************************************************/
+class SceneBinary
+{
+public:
+    // bump whenever the header, a column's layout or the meaning of
+    // a mesh or cull mode value changes
+    static const uint32_t FORMAT_VERSION = 2;
+
+    // what a prop table entry does with its entity at load
+    enum PROP_KIND
+    {
+        // draws the prop; bounds and cull mode come from the mesh
+        PROP_IMPORT = 1,
+        // only kept when the prop failed to import
+        PROP_FALLBACK = 2
+    };
+
+    // One entity that depends on whether a prop imported. The table
+    // covers the last entries of the columns, in the same order.
+    struct PROP_RECORD
+    {
+        // index into the prop tag table
+        uint32_t prop;
+        // a PROP_KIND
+        uint32_t kind;
+    };
+
+    // Everything a compiled scene holds, for Write()
+    struct SCENE_DATA
+    {
+        // EntityStore columns; imports have no bounds or cull mode yet
+        std::vector<glm::mat4> transforms;
+        std::vector<EntityStore::MESH_REF> meshes;
+        // tag table index, -1 for none
+        std::vector<int> materials;
+        std::vector<int> textures;
+        std::vector<EntityStore::SURFACE> surfaces;
+        std::vector<EntityStore::BOUNDS> bounds;
+        std::vector<uint8_t> flags;
+        std::vector<PROP_RECORD> props;
+
+        std::vector<std::string> textureTags;
+        std::vector<std::string> materialTags;
+        std::vector<std::string> propTags;
+        // SceneFile::GetFileStamp() of the text scene
+        long long sourceTime;
+        long long sourceSize;
+    };
+
+    // Pointers into a mapped file; only valid while it stays open
+    struct SCENE_VIEW
+    {
+        // entityCount long
+        const glm::mat4* transforms;
+        const EntityStore::MESH_REF* meshes;
+        const int* materials;
+        const int* textures;
+        const EntityStore::SURFACE* surfaces;
+        const EntityStore::BOUNDS* bounds;
+        const uint8_t* flags;
+        uint32_t entityCount;
+        // propRecordCount long, for the last entities
+        const PROP_RECORD* props;
+        uint32_t propRecordCount;
+
+        uint32_t textureCount;
+        uint32_t materialCount;
+        uint32_t propCount;
+        long long sourceTime;
+        long long sourceSize;
+
+        const char* GetTexture(uint32_t index) const { return strings + stringOffsets[index]; }
+        const char* GetMaterial(uint32_t index) const { return strings + stringOffsets[textureCount + index]; }
+        const char* GetProp(uint32_t index) const { return strings + stringOffsets[textureCount + materialCount + index]; }
+
+        // one offset per tag, textures then materials then props
+        const uint32_t* stringOffsets;
+        const char* strings;
+    };
+
+    // Serialize a compiled scene; returns false if the file couldn't be
+    // written or the columns aren't all the same length
+    static bool Write(const std::string& path, const SCENE_DATA& scene);
+    // Map a compiled scene and point view into it. Returns false if the
+    // file is missing, truncated or from another format version.
+    static bool Read(const std::string& path, MappedFile& file, SCENE_VIEW& view);
+};
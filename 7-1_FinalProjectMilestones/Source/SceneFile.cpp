@@ -0,0 +1,657 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneFile.cpp
+// ============
+// Text scene description: one line per object with its shape, transform,
+// color or texture, material and parent. See scenes/kitchen.scene for
+// the format.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "MappedFile.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace
+{
+    // Errors past this many are counted but not logged
+    const int MAX_REPORTED_ERRORS = 20;
+    // Longest number token accepted
+    const size_t MAX_NUMBER_LENGTH = 31;
+    // Replicate() jitters every run of copies the same way
+    const unsigned REPLICATE_SEED = 330;
+
+    struct SHAPE_NAME
+    {
+        const char* keyword;
+        SceneFile::OBJECT_SHAPE shape;
+    };
+
+    const SHAPE_NAME SHAPE_NAMES[] =
+    {
+        { "group",            SceneFile::SHAPE_GROUP },
+        { "plane",            SceneFile::SHAPE_PLANE },
+        { "box",              SceneFile::SHAPE_BOX },
+        { "cylinder",         SceneFile::SHAPE_CYLINDER },
+        { "tapered_cylinder", SceneFile::SHAPE_TAPERED_CYLINDER },
+        { "torus",            SceneFile::SHAPE_TORUS },
+        { "sphere",           SceneFile::SHAPE_SPHERE },
+        { "import",           SceneFile::SHAPE_IMPORT },
+        { "plant",            SceneFile::SHAPE_PLANT },
+        { "prefab",           SceneFile::SHAPE_PREFAB },
+        { "instance",         SceneFile::SHAPE_INSTANCE }
+    };
+
+    // A word on the current line, pointing into the mapping
+    struct TOKEN
+    {
+        const char* begin;
+        size_t length;
+    };
+
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // Next space-separated word before end or a '#' comment; empty
+    // once the line is used up
+    TOKEN NextToken(const char*& p, const char* end)
+    {
+        while (p < end && IsSpace(*p))
+            p++;
+
+        if (p < end && *p == '#')
+            p = end;
+
+        TOKEN token;
+        token.begin = p;
+        while (p < end && !IsSpace(*p) && *p != '#')
+            p++;
+        token.length = p - token.begin;
+        return token;
+    }
+
+    bool TokenIs(const TOKEN& token, const char* word)
+    {
+        return std::strlen(word) == token.length && std::memcmp(token.begin, word, token.length) == 0;
+    }
+
+    std::string ToString(const TOKEN& token)
+    {
+        return std::string(token.begin, token.length);
+    }
+
+    // Tokens are short, so one is copied out to terminate it for strtod()
+    bool ParseFloat(const TOKEN& token, float& value)
+    {
+        if (token.length == 0 || token.length > MAX_NUMBER_LENGTH)
+            return false;
+
+        char buffer[MAX_NUMBER_LENGTH + 1];
+        std::memcpy(buffer, token.begin, token.length);
+        buffer[token.length] = '\0';
+
+        char* parsedEnd = nullptr;
+        double parsed = std::strtod(buffer, &parsedEnd);
+        if (parsedEnd != buffer + token.length || !std::isfinite(parsed))
+            return false;
+        value = (float)parsed;
+        return true;
+    }
+
+    // Error reporting for one file
+    struct PARSE_CONTEXT
+    {
+        const std::string* pName;
+        int line;
+        int errors;
+
+        void Error(const std::string& message)
+        {
+            if (errors < MAX_REPORTED_ERRORS)
+                std::cout << "INFO: " << *pName << ":" << line << ": " << message << std::endl;
+            errors++;
+        }
+    };
+
+    bool ReadFloats(const char*& p, const char* end, const TOKEN& field, int count, float* values, PARSE_CONTEXT& context)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (!ParseFloat(NextToken(p, end), values[i]))
+            {
+                context.Error("'" + ToString(field) + "' needs " + std::to_string(count) + " numbers");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ReadWord(const char*& p, const char* end, const TOKEN& field, std::string& word, PARSE_CONTEXT& context)
+    {
+        TOKEN token = NextToken(p, end);
+        if (token.length == 0)
+        {
+            context.Error("'" + ToString(field) + "' needs a value");
+            return false;
+        }
+        word = ToString(token);
+        return true;
+    }
+
+    void WriteFloats(std::ofstream& stream, const char* field, const float* values, int count)
+    {
+        stream << ' ' << field;
+        for (int i = 0; i < count; i++)
+            stream << ' ' << values[i];
+    }
+
+    bool IsCylinder(SceneFile::OBJECT_SHAPE shape)
+    {
+        return shape == SceneFile::SHAPE_CYLINDER || shape == SceneFile::SHAPE_TAPERED_CYLINDER;
+    }
+
+    // Every field at the value a line gets when it leaves it out
+    void ResetObject(SceneFile::SCENE_OBJECT& object, int line)
+    {
+        object.shape = SceneFile::SHAPE_GROUP;
+        object.name.clear();
+        object.parent = -1;
+        object.scale = glm::vec3(1.0f);
+        object.rotation = glm::vec3(0.0f);
+        object.position = glm::vec3(0.0f);
+        object.color = glm::vec4(1.0f);
+        object.textureTag.clear();
+        object.uvScale = glm::vec2(1.0f);
+        object.materialTag.clear();
+        object.bDrawTop = true;
+        object.bDrawBottom = true;
+        object.bDrawSides = true;
+        object.bOccluder = false;
+        object.prop.clear();
+        object.fallbackProp.clear();
+        object.plant.clear();
+        object.replaces = -1;
+        object.prefab = -1;
+        object.definition = -1;
+        object.line = line;
+    }
+
+    // Parse one line into object; false if it's blank, a comment or
+    // bad. parsed holds the lines above it, names their indices.
+    bool ParseObject(const char* p, const char* end, SceneFile::SCENE_OBJECT& object,
+                     const std::vector<SceneFile::SCENE_OBJECT>& parsed,
+                     const std::unordered_map<std::string, int>& names, PARSE_CONTEXT& context)
+    {
+        TOKEN token = NextToken(p, end);
+        if (token.length == 0)
+            return false;
+
+        ResetObject(object, context.line);
+        std::string word;
+
+        bool bShape = false;
+        for (const SHAPE_NAME& shapeName : SHAPE_NAMES)
+        {
+            if (TokenIs(token, shapeName.keyword))
+            {
+                object.shape = shapeName.shape;
+                bShape = true;
+                break;
+            }
+        }
+        if (!bShape)
+        {
+            context.Error("unknown shape '" + ToString(token) + "'");
+            return false;
+        }
+        if (object.shape == SceneFile::SHAPE_IMPORT && !ReadWord(p, end, token, object.prop, context))
+            return false;
+        if (object.shape == SceneFile::SHAPE_PLANT && !ReadWord(p, end, token, object.plant, context))
+            return false;
+        if (object.shape == SceneFile::SHAPE_PREFAB)
+        {
+            // the prefab's id is its name, so instances and parts can refer to it
+            if (!ReadWord(p, end, token, object.name, context))
+                return false;
+            if (names.count(object.name) != 0)
+            {
+                context.Error("name '" + object.name + "' is already used");
+                return false;
+            }
+            object.definition = (int)parsed.size();
+            if (NextToken(p, end).length > 0)
+            {
+                context.Error("prefab lines take no fields; their parts are placed in prefab space");
+                return false;
+            }
+            return true;
+        }
+        if (object.shape == SceneFile::SHAPE_INSTANCE)
+        {
+            if (!ReadWord(p, end, token, word, context))
+                return false;
+            auto prefab = names.find(word);
+            if (prefab == names.end() || parsed[prefab->second].shape != SceneFile::SHAPE_PREFAB)
+            {
+                context.Error("'" + word + "' isn't a prefab defined above this line");
+                return false;
+            }
+            object.prefab = prefab->second;
+        }
+
+        bool bCylinderField = false;
+        while ((token = NextToken(p, end)).length > 0)
+        {
+            if (TokenIs(token, "name"))
+            {
+                if (!ReadWord(p, end, token, object.name, context))
+                    return false;
+                if (names.count(object.name) != 0)
+                {
+                    context.Error("name '" + object.name + "' is already used");
+                    return false;
+                }
+            }
+            else if (TokenIs(token, "parent"))
+            {
+                if (!ReadWord(p, end, token, word, context))
+                    return false;
+                auto parent = names.find(word);
+                if (parent == names.end())
+                {
+                    context.Error("parent '" + word + "' isn't named above this line");
+                    return false;
+                }
+                object.parent = parent->second;
+                object.definition = parsed[object.parent].definition;
+            }
+            else if (TokenIs(token, "scale"))
+            {
+                if (!ReadFloats(p, end, token, 3, &object.scale[0], context))
+                    return false;
+            }
+            else if (TokenIs(token, "rotate"))
+            {
+                if (!ReadFloats(p, end, token, 3, &object.rotation[0], context))
+                    return false;
+            }
+            else if (TokenIs(token, "position"))
+            {
+                if (!ReadFloats(p, end, token, 3, &object.position[0], context))
+                    return false;
+            }
+            else if (TokenIs(token, "color"))
+            {
+                if (!ReadFloats(p, end, token, 4, &object.color[0], context))
+                    return false;
+            }
+            else if (TokenIs(token, "uv"))
+            {
+                if (!ReadFloats(p, end, token, 2, &object.uvScale[0], context))
+                    return false;
+            }
+            else if (TokenIs(token, "texture"))
+            {
+                if (!ReadWord(p, end, token, object.textureTag, context))
+                    return false;
+            }
+            else if (TokenIs(token, "material"))
+            {
+                if (!ReadWord(p, end, token, object.materialTag, context))
+                    return false;
+            }
+            else if (TokenIs(token, "caps"))
+            {
+                if (!ReadWord(p, end, token, word, context))
+                    return false;
+                if (word == "both" || word == "top" || word == "bottom" || word == "none")
+                {
+                    object.bDrawTop = (word == "both" || word == "top");
+                    object.bDrawBottom = (word == "both" || word == "bottom");
+                }
+                else
+                {
+                    context.Error("caps must be both, top, bottom or none, not '" + word + "'");
+                    return false;
+                }
+                bCylinderField = true;
+            }
+            else if (TokenIs(token, "nosides"))
+            {
+                object.bDrawSides = false;
+                bCylinderField = true;
+            }
+            else if (TokenIs(token, "occluder"))
+            {
+                object.bOccluder = true;
+            }
+            else if (TokenIs(token, "fallback"))
+            {
+                if (!ReadWord(p, end, token, object.fallbackProp, context))
+                    return false;
+            }
+            else if (TokenIs(token, "replaces"))
+            {
+                if (!ReadWord(p, end, token, word, context))
+                    return false;
+                auto replaced = names.find(word);
+                if (replaced == names.end())
+                {
+                    context.Error("replaced object '" + word + "' isn't named above this line");
+                    return false;
+                }
+                object.replaces = replaced->second;
+                if (parsed[object.replaces].definition >= 0)
+                {
+                    context.Error("'" + word + "' is part of a prefab and can't be replaced");
+                    return false;
+                }
+            }
+            else
+            {
+                context.Error("unknown field '" + ToString(token) + "'");
+                return false;
+            }
+        }
+
+        if (bCylinderField && !IsCylinder(object.shape))
+        {
+            context.Error("caps and nosides only apply to cylinders");
+            return false;
+        }
+        if (IsCylinder(object.shape) && !object.bDrawTop && !object.bDrawBottom && !object.bDrawSides)
+        {
+            context.Error("cylinder with no caps and no sides draws nothing");
+            return false;
+        }
+        if (object.bOccluder && object.shape != SceneFile::SHAPE_BOX)
+        {
+            context.Error("only boxes can be occluders");
+            return false;
+        }
+        if (!object.fallbackProp.empty() &&
+            (object.shape == SceneFile::SHAPE_GROUP || object.shape == SceneFile::SHAPE_IMPORT ||
+             object.shape == SceneFile::SHAPE_PLANT || object.shape == SceneFile::SHAPE_INSTANCE))
+        {
+            context.Error("fallback only applies to primitive shapes");
+            return false;
+        }
+        if (object.replaces >= 0 && object.shape != SceneFile::SHAPE_PLANT)
+        {
+            context.Error("replaces only applies to plants");
+            return false;
+        }
+        if (object.shape == SceneFile::SHAPE_PLANT &&
+            (!object.textureTag.empty() || !object.materialTag.empty() || object.color != glm::vec4(1.0f)))
+        {
+            context.Error("plants take their colors and materials from the preset");
+            return false;
+        }
+        if (object.shape == SceneFile::SHAPE_INSTANCE &&
+            (!object.textureTag.empty() || !object.materialTag.empty() || object.color != glm::vec4(1.0f) ||
+             object.uvScale != glm::vec2(1.0f) || !object.fallbackProp.empty()))
+        {
+            context.Error("instances take everything they draw from the prefab");
+            return false;
+        }
+        if (object.definition >= 0 &&
+            (object.shape == SceneFile::SHAPE_PLANT || object.shape == SceneFile::SHAPE_INSTANCE || object.bOccluder))
+        {
+            context.Error("prefab parts can't be plants, instances or occluders");
+            return false;
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            // a zero scale can't be inverted for culling and draws nothing
+            if (object.scale[i] == 0.0f)
+            {
+                context.Error("scale can't be zero");
+                return false;
+            }
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            if (object.color[i] < 0.0f || object.color[i] > 1.0f)
+            {
+                context.Error("color values must be between 0 and 1");
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/***********************************************************
+ * Load()
+ ***********************************************************/
+bool SceneFile::Load(const std::string& path, std::vector<SCENE_OBJECT>& objects)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cout << "INFO: Could not open scene file " << path << std::endl;
+        return false;
+    }
+    return Parse(file.GetData(), file.GetSize(), path, objects);
+}
+
+/***********************************************************
+ * Parse()
+ * Works line by line without ever needing a terminator.
+ * Objects only replace the caller's list once the whole
+ * file has parsed cleanly.
+ ***********************************************************/
+bool SceneFile::Parse(const unsigned char* data, size_t size, const std::string& name,
+                      std::vector<SCENE_OBJECT>& objects)
+{
+    const char* p = (const char*)data;
+    const char* end = p + size;
+
+    PARSE_CONTEXT context;
+    context.pName = &name;
+    context.line = 0;
+    context.errors = 0;
+
+    std::vector<SCENE_OBJECT> parsed;
+    std::unordered_map<std::string, int> names;
+    SCENE_OBJECT object;
+    while (p < end)
+    {
+        context.line++;
+        const char* lineEnd = (const char*)std::memchr(p, '\n', end - p);
+        if (lineEnd == nullptr)
+            lineEnd = end;
+
+        if (ParseObject(p, lineEnd, object, parsed, names, context))
+        {
+            if (!object.name.empty())
+                names[object.name] = (int)parsed.size();
+            parsed.push_back(object);
+        }
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+
+    if (context.errors > 0)
+    {
+        std::cout << "INFO: " << name << " has " << context.errors << " error"
+                  << (context.errors == 1 ? "" : "s") << std::endl;
+        return false;
+    }
+
+    objects.swap(parsed);
+    return true;
+}
+
+/***********************************************************
+ * Write()
+ * Fields left at their defaults are skipped, so a written
+ * file reads like a hand-written one.
+ ***********************************************************/
+bool SceneFile::Write(const std::string& path, const std::vector<SCENE_OBJECT>& objects)
+{
+    std::ofstream stream(path.c_str(), std::ios::trunc);
+    if (!stream)
+        return false;
+
+    for (const SCENE_OBJECT& object : objects)
+    {
+        for (const SHAPE_NAME& shapeName : SHAPE_NAMES)
+        {
+            if (shapeName.shape == object.shape)
+                stream << shapeName.keyword;
+        }
+        if (object.shape == SHAPE_IMPORT)
+            stream << ' ' << object.prop;
+        if (object.shape == SHAPE_PLANT)
+            stream << ' ' << object.plant;
+        if (object.shape == SHAPE_PREFAB)
+        {
+            stream << ' ' << object.name << '\n';
+            continue;
+        }
+        if (object.shape == SHAPE_INSTANCE)
+            stream << ' ' << objects[object.prefab].name;
+        if (!object.name.empty())
+            stream << " name " << object.name;
+        if (object.parent >= 0)
+        {
+            if (objects[object.parent].name.empty())
+                return false;
+            stream << " parent " << objects[object.parent].name;
+        }
+        if (object.scale != glm::vec3(1.0f))
+            WriteFloats(stream, "scale", &object.scale[0], 3);
+        if (object.rotation != glm::vec3(0.0f))
+            WriteFloats(stream, "rotate", &object.rotation[0], 3);
+        if (object.position != glm::vec3(0.0f))
+            WriteFloats(stream, "position", &object.position[0], 3);
+        if (object.color != glm::vec4(1.0f))
+            WriteFloats(stream, "color", &object.color[0], 4);
+        if (!object.textureTag.empty())
+            stream << " texture " << object.textureTag;
+        if (object.uvScale != glm::vec2(1.0f))
+            WriteFloats(stream, "uv", &object.uvScale[0], 2);
+        if (!object.materialTag.empty())
+            stream << " material " << object.materialTag;
+        if (IsCylinder(object.shape) && !(object.bDrawTop && object.bDrawBottom))
+            stream << " caps " << (object.bDrawTop ? "top" : object.bDrawBottom ? "bottom" : "none");
+        if (!object.bDrawSides)
+            stream << " nosides";
+        if (object.bOccluder)
+            stream << " occluder";
+        if (!object.fallbackProp.empty())
+            stream << " fallback " << object.fallbackProp;
+        if (object.replaces >= 0)
+        {
+            if (objects[object.replaces].name.empty())
+                return false;
+            stream << " replaces " << objects[object.replaces].name;
+        }
+        stream << '\n';
+    }
+    return (bool)stream;
+}
+
+/***********************************************************
+ * Replicate()
+ * Each copy hangs under a group of its own named copy_<n>,
+ * which carries the copy's grid offset and jitter, so the
+ * copy moves and turns as one piece however its objects
+ * are rotated. Object names, parents, replaced objects and
+ * placed prefabs are renumbered through a table of where
+ * each object went: inside the copy, or to the one shared
+ * prefab definition.
+ ***********************************************************/
+void SceneFile::Replicate(const std::vector<SCENE_OBJECT>& objects, size_t count, float spacing,
+                          float positionJitter, float yawJitter, std::vector<SCENE_OBJECT>& replicated)
+{
+    replicated.clear();
+    std::vector<int> newIndices(objects.size(), -1);
+    size_t copiedPerCopy = 0;
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        if (objects[i].definition < 0)
+        {
+            copiedPerCopy++;
+            continue;
+        }
+        SCENE_OBJECT object = objects[i];
+        if (object.parent >= 0)
+            object.parent = newIndices[object.parent];
+        newIndices[i] = (int)replicated.size();
+        object.definition = (object.shape == SHAPE_PREFAB) ? newIndices[i] : newIndices[objects[i].definition];
+        replicated.push_back(object);
+    }
+    if (copiedPerCopy == 0 || count == 0)
+        return;
+
+    size_t copies = (count + copiedPerCopy - 1) / copiedPerCopy;
+    size_t columns = (size_t)std::ceil(std::sqrt((double)copies));
+    replicated.reserve(replicated.size() + count + copies);
+
+    std::mt19937 random(REPLICATE_SEED);
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    size_t copied = 0;
+    for (size_t copy = 0; copy < copies; copy++)
+    {
+        SCENE_OBJECT group;
+        ResetObject(group, 0);
+        group.name = "copy_" + std::to_string(copy);
+        group.position = glm::vec3((float)(copy % columns) * spacing + jitter(random) * positionJitter, 0.0f,
+                                   (float)(copy / columns) * -spacing + jitter(random) * positionJitter);
+        group.rotation.y = jitter(random) * yawJitter;
+        int groupIndex = (int)replicated.size();
+        replicated.push_back(group);
+
+        for (size_t i = 0; i < objects.size() && copied < count; i++)
+        {
+            if (objects[i].definition >= 0)
+                continue;
+            SCENE_OBJECT object = objects[i];
+            if (!object.name.empty())
+                object.name += "_" + std::to_string(copy);
+            object.parent = (object.parent >= 0) ? newIndices[object.parent] : groupIndex;
+            if (object.replaces >= 0)
+                object.replaces = newIndices[object.replaces];
+            if (object.prefab >= 0)
+                object.prefab = newIndices[object.prefab];
+            newIndices[i] = (int)replicated.size();
+            replicated.push_back(object);
+            copied++;
+        }
+    }
+}
+
+/***********************************************************
+ * GetFileStamp()
+ * Size is part of the stamp because modification times are
+ * only whole seconds on some file systems.
+ ***********************************************************/
+bool SceneFile::GetFileStamp(const std::string& path, long long& modifiedTime, long long& size)
+{
+#ifdef _WIN32
+    struct _stat64 info;
+    if (_stat64(path.c_str(), &info) != 0)
+        return false;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+#endif
+    modifiedTime = (long long)info.st_mtime;
+    size = (long long)info.st_size;
+    return true;
+}
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneFile.h
+// ============
+// Text scene description: one line per object with its shape, transform,
+// color or texture, material and parent. See scenes/kitchen.scene for
+// the format.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  Parses a mapped scene file in one pass with a cursor;
+ *  only names and tags are copied out. Everything the file
+ *  alone can check is validated here: unknown shapes and
+ *  fields, bad numbers, duplicate names, parents that
+ *  aren't defined earlier in the file (which also rules out
+ *  cycles), fields that don't apply to the shape, and
+ *  prefabs: everything under a prefab line is a part of it,
+ *  parts can't be plants, instances or occluders, and an
+ *  instance has to place a prefab defined above it.
+ *  Texture and material tags are checked by SceneManager,
+ *  which owns them.
+ *
+ *  Every error is logged with its line number and the
+ *  parse fails, so a half-saved file never replaces a
+ *  working scene.
+ ***********************************************************/
+class SceneFile
+{
+public:
+    enum OBJECT_SHAPE
+    {
+        SHAPE_GROUP,    // transform only, for children
+        SHAPE_PLANE,
+        SHAPE_BOX,
+        SHAPE_CYLINDER,
+        SHAPE_TAPERED_CYLINDER,
+        SHAPE_TORUS,
+        SHAPE_SPHERE,
+        SHAPE_IMPORT,   // meshes/<prop> via SceneManager::ImportPropMesh()
+        SHAPE_PLANT,    // a PlantGenerator preset, drawn instanced
+        SHAPE_PREFAB,   // defines a prefab from the objects under it; not drawn itself
+        SHAPE_INSTANCE  // places a prefab, which supplies everything it draws
+    };
+
+    // one object line, with the defaults filled in for fields it left out
+    struct SCENE_OBJECT
+    {
+        OBJECT_SHAPE shape;
+        // empty unless the line named it
+        std::string name;
+        // index of an earlier object, -1 for world space
+        int parent;
+        glm::vec3 scale;
+        // degrees, applied X then Y then Z
+        glm::vec3 rotation;
+        glm::vec3 position;
+        glm::vec4 color;
+        // empty for flat color
+        std::string textureTag;
+        glm::vec2 uvScale;
+        // empty leaves the material unset
+        std::string materialTag;
+        // cylinder parts (ignored for other shapes)
+        bool bDrawTop;
+        bool bDrawBottom;
+        bool bDrawSides;
+        bool bOccluder;
+        // SHAPE_IMPORT: the file name under meshes/
+        std::string prop;
+        // only drawn when this prop didn't import; empty to always draw
+        std::string fallbackProp;
+        // SHAPE_PLANT: the PlantGenerator preset
+        std::string plant;
+        // SHAPE_PLANT: index of an earlier object whose subtree the plant
+        // stands in for, -1 for none
+        int replaces;
+        // SHAPE_INSTANCE: index of the prefab line it places, -1 otherwise
+        int prefab;
+        // index of the prefab line this object is a part of (its own
+        // for a prefab line), -1 for objects placed in the scene
+        int definition;
+        // source line, for messages
+        int line;
+    };
+
+    // Map path and parse it; false (with the reasons logged) if it's
+    // missing or has any errors
+    static bool Load(const std::string& path, std::vector<SCENE_OBJECT>& objects);
+    // Parse a file already in memory; name is only used in messages
+    static bool Parse(const unsigned char* data, size_t size, const std::string& name,
+                      std::vector<SCENE_OBJECT>& objects);
+    // Write objects out in this format, for generated scenes; every
+    // parent must have a name. Returns false if the file couldn't be written.
+    static bool Write(const std::string& path, const std::vector<SCENE_OBJECT>& objects);
+    // Lay copies of objects out on a near-square grid, spacing apart
+    // along X and -Z, until count objects have been copied (the last
+    // copy may be cut short). Each copy is nudged up to positionJitter
+    // along X and Z and turned up to yawJitter degrees about Y. Prefab
+    // definitions go in once, ahead of the copies, and aren't counted.
+    static void Replicate(const std::vector<SCENE_OBJECT>& objects, size_t count, float spacing,
+                          float positionJitter, float yawJitter, std::vector<SCENE_OBJECT>& replicated);
+    // Modification time and size of path, so a reload can be triggered
+    // when either changes; false if the file isn't there
+    static bool GetFileStamp(const std::string& path, long long& modifiedTime, long long& size);
+};
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneGraph.cpp
+// ============
+// Parent/child transform hierarchy with world matrices that are only
+// recomputed for the subtrees whose local transforms changed.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneGraph.h"
+
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+
+/***********************************************************
+ * SceneGraph()
+ ***********************************************************/
+SceneGraph::SceneGraph()
+{
+}
+
+/***********************************************************
+ * Build()
+ * Parents come before their children, so subtree sizes add
+ * up in one backward pass, and each node's depth-first slot
+ * comes from one forward pass: a root takes the next free
+ * run, a child takes the next free run inside its parent's.
+ ***********************************************************/
+void SceneGraph::Build(const std::vector<int>& parents, const std::vector<NODE_TRANSFORM>& locals)
+{
+    int count = (int)parents.size();
+
+    std::vector<int> sizes(count, 1);
+    for (int i = count - 1; i >= 0; i--)
+    {
+        if (parents[i] >= 0)
+            sizes[parents[i]] += sizes[i];
+    }
+
+    m_sourceToNode.assign(count, 0);
+    m_nodeToSource.assign(count, 0);
+    // next free slot among each source node's children
+    std::vector<int> nextChild(count, 0);
+    int nextRoot = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int node;
+        if (parents[i] < 0)
+        {
+            node = nextRoot;
+            nextRoot += sizes[i];
+        }
+        else
+        {
+            node = nextChild[parents[i]];
+            nextChild[parents[i]] += sizes[i];
+        }
+        nextChild[i] = node + 1;
+        m_sourceToNode[i] = node;
+        m_nodeToSource[node] = i;
+    }
+
+    m_parents.resize(count);
+    m_subtreeEnds.resize(count);
+    m_locals.resize(count);
+    m_worlds.assign(count, glm::mat4(1.0f));
+    m_bDirty.assign(count, 0);
+    m_dirtyNodes.clear();
+    for (int i = 0; i < count; i++)
+    {
+        int node = m_sourceToNode[i];
+        m_parents[node] = (parents[i] >= 0) ? m_sourceToNode[parents[i]] : -1;
+        m_subtreeEnds[node] = node + sizes[i];
+        m_locals[node] = locals[i];
+        if (parents[i] < 0)
+        {
+            m_bDirty[node] = 1;
+            m_dirtyNodes.push_back(node);
+        }
+    }
+}
+
+/***********************************************************
+ * Update()
+ * Dirty nodes are visited in depth-first order, so an
+ * ancestor's run is redone before any dirty descendant is
+ * reached, and the descendant is skipped as covered.
+ ***********************************************************/
+int SceneGraph::Update(std::vector<std::pair<int, int>>& spans)
+{
+    spans.clear();
+    if (m_dirtyNodes.empty())
+        return 0;
+
+    std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+
+    int updated = 0;
+    int coveredEnd = 0;
+    for (int root : m_dirtyNodes)
+    {
+        m_bDirty[root] = 0;
+        if (root < coveredEnd)
+            continue;
+
+        int end = m_subtreeEnds[root];
+        for (int node = root; node < end; node++)
+        {
+            glm::mat4 local = ComposeLocal(m_locals[node]);
+            m_worlds[node] = (m_parents[node] >= 0) ? m_worlds[m_parents[node]] * local : local;
+        }
+        spans.push_back(std::make_pair(root, end));
+        updated += end - root;
+        coveredEnd = end;
+    }
+    m_dirtyNodes.clear();
+    return updated;
+}
+
+/***********************************************************
+ * SetLocal()
+ ***********************************************************/
+void SceneGraph::SetLocal(int node, const NODE_TRANSFORM& local)
+{
+    m_locals[node] = local;
+    if (!m_bDirty[node])
+    {
+        m_bDirty[node] = 1;
+        m_dirtyNodes.push_back(node);
+    }
+}
+
+/***********************************************************
+ * ComposeLocal()
+ ***********************************************************/
+glm::mat4 SceneGraph::ComposeLocal(const NODE_TRANSFORM& local)
+{
+    return glm::translate(local.position)
+         * glm::rotate(glm::radians(local.rotation.z), glm::vec3(0, 0, 1))
+         * glm::rotate(glm::radians(local.rotation.y), glm::vec3(0, 1, 0))
+         * glm::rotate(glm::radians(local.rotation.x), glm::vec3(1, 0, 0))
+         * glm::scale(local.scale);
+}
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneGraph.h
+// ============
+// Parent/child transform hierarchy with world matrices that are only
+// recomputed for the subtrees whose local transforms changed.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  SceneGraph
+ *
+ *  Nodes are stored depth-first in flat arrays, so every
+ *  subtree is one contiguous run [node, subtree end) with
+ *  each parent ahead of its children. Updating a subtree is
+ *  then a single forward pass over that run, reading
+ *  parents that are either outside it (and already clean)
+ *  or just written.
+ *
+ *  SetLocal() only records the node as dirty; Update()
+ *  recomputes each dirty subtree once, skipping dirty nodes
+ *  that sit inside a subtree already being redone. Nodes
+ *  outside every dirty subtree aren't touched.
+ ***********************************************************/
+class SceneGraph
+{
+public:
+    // local transform relative to the parent node
+    struct NODE_TRANSFORM
+    {
+        glm::vec3 scale;
+        // degrees, applied X then Y then Z
+        glm::vec3 rotation;
+        glm::vec3 position;
+    };
+
+    // constructor
+    SceneGraph();
+
+    // Replace the graph. parents[i] must be -1 or less than i. Nodes
+    // are reordered depth-first (children keep their given order);
+    // GetNode() maps a given index to its node. Every node starts dirty.
+    void Build(const std::vector<int>& parents, const std::vector<NODE_TRANSFORM>& locals);
+    // Recompute every dirty subtree; spans gets the [begin, end) node
+    // runs that changed. Returns how many nodes were recomputed.
+    int Update(std::vector<std::pair<int, int>>& spans);
+
+    // Change a node's local transform; takes effect at the next Update()
+    void SetLocal(int node, const NODE_TRANSFORM& local);
+    const NODE_TRANSFORM& GetLocal(int node) const { return m_locals[node]; }
+    const glm::mat4& GetWorld(int node) const { return m_worlds[node]; }
+
+    int GetNodeCount() const { return (int)m_parents.size(); }
+    // node for the index given to Build(), and back
+    int GetNode(int sourceIndex) const { return m_sourceToNode[sourceIndex]; }
+    int GetSource(int node) const { return m_nodeToSource[node]; }
+    // one past the last node of node's subtree
+    int GetSubtreeEnd(int node) const { return m_subtreeEnds[node]; }
+
+    // translate * rotateZ * rotateY * rotateX * scale
+    static glm::mat4 ComposeLocal(const NODE_TRANSFORM& local);
+
+private:
+    // depth-first arrays, all indexed by node
+    std::vector<int> m_parents;
+    std::vector<int> m_subtreeEnds;
+    std::vector<NODE_TRANSFORM> m_locals;
+    std::vector<glm::mat4> m_worlds;
+    std::vector<int> m_sourceToNode;
+    std::vector<int> m_nodeToSource;
+    // nodes given to SetLocal() since the last Update(), once each
+    std::vector<int> m_dirtyNodes;
+    std::vector<unsigned char> m_bDirty;
+};
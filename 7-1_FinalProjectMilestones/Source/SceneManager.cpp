@@ -9,6 +9,16 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SceneManager.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshletCuller.h"
+#include "OcclusionCuller.h"
+#include "OverdrawVisualizer.h"
+#include "PlantGenerator.h"
+#include "ProceduralMeshes.h"
+#include "SceneBVH.h"
+#include "ShapeRaycast.h"
+#include "WorkerPool.h"
 
 #ifndef STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -16,6 +26,11 @@
 #endif
 
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <cmath>
 
@@ -27,6 +42,340 @@ namespace {
     const char* g_TextureValueName = "objectTexture";
     const char* g_UseTextureName = "bUseTexture";
     const char* g_UseLightingName = "bUseLighting";
+
+    // Object-space bounds of each ShapeMeshes primitive. The torus is
+    // padded to a cube so its bounds hold no matter how it's oriented.
+    void GetMeshLocalBounds(SceneManager::MESH_TYPE mesh, glm::vec3& boundsMin, glm::vec3& boundsMax)
+    {
+        switch (mesh)
+        {
+        case SceneManager::MESH_PLANE:
+            boundsMin = glm::vec3(-1.0f, 0.0f, -1.0f);
+            boundsMax = glm::vec3(1.0f, 0.0f, 1.0f);
+            break;
+        case SceneManager::MESH_BOX:
+            boundsMin = glm::vec3(-0.5f);
+            boundsMax = glm::vec3(0.5f);
+            break;
+        case SceneManager::MESH_CYLINDER:
+        case SceneManager::MESH_TAPERED_CYLINDER:
+            boundsMin = glm::vec3(-1.0f, 0.0f, -1.0f);
+            boundsMax = glm::vec3(1.0f, 1.0f, 1.0f);
+            break;
+        case SceneManager::MESH_TORUS:
+            boundsMin = glm::vec3(-1.1f);
+            boundsMax = glm::vec3(1.1f);
+            break;
+        case SceneManager::MESH_SPHERE:
+        default:
+            boundsMin = glm::vec3(-1.0f);
+            boundsMax = glm::vec3(1.0f);
+            break;
+        }
+    }
+
+    // Pick log names, in MESH_TYPE order
+    const char* MESH_NAMES[] = { "plane", "box", "cylinder", "tapered cylinder", "torus", "sphere", "imported mesh", "prefab" };
+
+    // Projected diameter (pixels) at which each finer LOD level kicks in
+    const float g_LODThresholdPixels[MeshLibrary::LOD_LEVEL_COUNT - 1] = { 240.0f, 80.0f, 24.0f };
+    // How far past a threshold the size has to go before the level
+    // changes, so objects sitting right on a boundary don't pop
+    const float LOD_HYSTERESIS = 0.15f;
+
+    // The scene layout, and how often it's checked for edits
+    const char* SCENE_FILE_PATH = "scenes/kitchen.scene";
+    const int SCENE_FILE_CHECK_FRAMES = 30;
+    // Compiled from SCENE_FILE_PATH by --compile-scene; used instead of
+    // it while the text file is unchanged
+    const char* SCENE_BINARY_PATH = "scenes/kitchen.sceneb";
+
+    // Key B sways these scene nodes, and everything under them, about Z
+    const char* WIND_NODE_NAMES[] = { "leftBranch", "rightBranch", "seg4" };
+    const float WIND_SWAY_DEGREES = 4.0f;
+    const float WIND_SWAY_HZ = 0.35f;
+    // phase step between nodes, so they don't sway in lockstep
+    const float WIND_PHASE_STEP = 1.3f;
+    const double PI = 3.14159265358979;
+
+    // --bench-scene writes its generated scenes here, copies the
+    // kitchen's flat objects this far apart, and keeps the best of this
+    // many runs
+    const char* SCENE_BENCHMARK_DIRECTORY = "cache";
+    const float SCENE_BENCHMARK_SPACING = 40.0f;
+    const int SCENE_BENCHMARK_RUNS = 3;
+    // LoadStressScene() copies the kitchen this far apart, nudging and
+    // turning each copy by up to these
+    const float STRESS_SPACING = 30.0f;
+    const float STRESS_POSITION_JITTER = 4.0f;
+    const float STRESS_YAW_JITTER = 25.0f;
+
+    // Where ImportPropMesh() looks, and the formats it tries in order
+    const char* PROP_MESH_DIRECTORY = "meshes/";
+    const char* PROP_MESH_EXTENSIONS[] = { ".glb", ".gltf", ".obj" };
+
+    // Polygon offset the depth pre-pass gives buffer-mesh draws, pushing
+    // their depths just behind where the Phong pass will land
+    const float PREPASS_OFFSET_FACTOR = 1.0f;
+    const float PREPASS_OFFSET_UNITS = 1.0f;
+
+    // How often the overdraw view reads its counts back and logs them
+    const int OVERDRAW_REPORT_FRAMES = 120;
+    // How often meshlet culling logs its cluster counts while it's on
+    const int MESHLET_REPORT_FRAMES = 300;
+
+    // Maps a scene mesh to its MeshLibrary shape, if it has LOD levels
+    bool GetLODShape(SceneManager::MESH_TYPE mesh, MeshLibrary::LOD_SHAPE& shape)
+    {
+        switch (mesh)
+        {
+        case SceneManager::MESH_SPHERE:           shape = MeshLibrary::LOD_SPHERE;           return true;
+        case SceneManager::MESH_CYLINDER:         shape = MeshLibrary::LOD_CYLINDER;         return true;
+        case SceneManager::MESH_TAPERED_CYLINDER: shape = MeshLibrary::LOD_TAPERED_CYLINDER; return true;
+        case SceneManager::MESH_TORUS:            shape = MeshLibrary::LOD_TORUS;            return true;
+        default:                                  return false;
+        }
+    }
+
+    // Closed shapes can be back-face culled; open shells (uncapped
+    // cylinders, the single-sided plane) need both sides drawn. Mesh
+    // files don't say whether they're closed, so imports count as open
+    // here and SetEntityTransform() asks MeshLibrary instead.
+    bool IsClosedMesh(SceneManager::MESH_TYPE mesh, bool bDrawTop, bool bDrawBottom, bool bDrawSides)
+    {
+        switch (mesh)
+        {
+        case SceneManager::MESH_PLANE:
+        case SceneManager::MESH_IMPORTED:
+            return false;
+        case SceneManager::MESH_CYLINDER:
+        case SceneManager::MESH_TAPERED_CYLINDER:
+            return bDrawTop && bDrawBottom && bDrawSides;
+        default:
+            return true;
+        }
+    }
+
+    // World-space AABB of a transformed object-space AABB
+    void TransformBounds(const glm::mat4& model, glm::vec3& boundsMin, glm::vec3& boundsMax)
+    {
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+
+        glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+        glm::vec3 worldExtent(0.0f);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            worldExtent += glm::abs(glm::vec3(model[axis])) * extent[axis];
+        }
+
+        boundsMin = worldCenter - worldExtent;
+        boundsMax = worldCenter + worldExtent;
+    }
+
+    // A negative determinant mirrors the mesh and flips its winding
+    SceneManager::CULL_MODE SelectCullMode(bool bClosed, const glm::mat4& model)
+    {
+        if (!bClosed)
+            return SceneManager::CULL_NONE;
+        if (glm::dot(glm::cross(glm::vec3(model[0]), glm::vec3(model[1])), glm::vec3(model[2])) < 0.0f)
+            return SceneManager::CULL_BACK_MIRRORED;
+        return SceneManager::CULL_BACK;
+    }
+
+    SceneManager::MESH_TYPE GetShapeMesh(SceneFile::OBJECT_SHAPE shape)
+    {
+        switch (shape)
+        {
+        case SceneFile::SHAPE_PLANE:            return SceneManager::MESH_PLANE;
+        case SceneFile::SHAPE_CYLINDER:         return SceneManager::MESH_CYLINDER;
+        case SceneFile::SHAPE_TAPERED_CYLINDER: return SceneManager::MESH_TAPERED_CYLINDER;
+        case SceneFile::SHAPE_TORUS:            return SceneManager::MESH_TORUS;
+        case SceneFile::SHAPE_SPHERE:           return SceneManager::MESH_SPHERE;
+        case SceneFile::SHAPE_IMPORT:           return SceneManager::MESH_IMPORTED;
+        case SceneFile::SHAPE_INSTANCE:         return SceneManager::MESH_PREFAB;
+        default:                                return SceneManager::MESH_BOX;
+        }
+    }
+
+    // One graph node per object, with every world transform computed
+    void BuildSceneGraph(const std::vector<SceneFile::SCENE_OBJECT>& objects, SceneGraph& graph)
+    {
+        std::vector<int> parents(objects.size());
+        std::vector<SceneGraph::NODE_TRANSFORM> locals(objects.size());
+        for (size_t i = 0; i < objects.size(); i++)
+        {
+            parents[i] = objects[i].parent;
+            locals[i].scale = objects[i].scale;
+            locals[i].rotation = objects[i].rotation;
+            locals[i].position = objects[i].position;
+        }
+        graph.Build(parents, locals);
+
+        std::vector<std::pair<int, int>> spans;
+        graph.Update(spans);
+    }
+
+    // Index of tag in a compiled scene's tag table, adding it if new;
+    // -1 for no tag
+    int FindOrAddTag(const std::string& tag, std::vector<std::string>& tags,
+                     std::unordered_map<std::string, int>& indices)
+    {
+        if (tag.empty())
+            return -1;
+
+        auto found = indices.find(tag);
+        if (found != indices.end())
+            return found->second;
+
+        int index = (int)tags.size();
+        tags.push_back(tag);
+        indices[tag] = index;
+        return index;
+    }
+
+    // Tag tables of a compiled scene being built, and where each tag is
+    struct TAG_TABLES
+    {
+        std::unordered_map<std::string, int> textures;
+        std::unordered_map<std::string, int> materials;
+        std::unordered_map<std::string, int> props;
+    };
+
+    // Whether an object's entity depends on a prop importing
+    bool IsPropObject(const SceneFile::SCENE_OBJECT& object)
+    {
+        return object.shape == SceneFile::SHAPE_IMPORT || !object.fallbackProp.empty();
+    }
+
+    // The entity for one drawn object at a world transform, as its
+    // components are laid out in the store
+    void AddSceneEntry(const SceneFile::SCENE_OBJECT& object, const glm::mat4& world,
+                       SceneBinary::SCENE_DATA& scene, TAG_TABLES& tags)
+    {
+        EntityStore::MESH_REF mesh = { (uint8_t)GetShapeMesh(object.shape), 0, -1, -1 };
+        EntityStore::SURFACE surface = { object.color, object.uvScale };
+        EntityStore::BOUNDS bounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+        uint8_t flags = (object.bDrawTop ? EntityStore::FLAG_DRAW_TOP : 0)
+                      | (object.bDrawBottom ? EntityStore::FLAG_DRAW_BOTTOM : 0)
+                      | (object.bDrawSides ? EntityStore::FLAG_DRAW_SIDES : 0)
+                      | (object.bOccluder ? EntityStore::FLAG_OCCLUDER : 0);
+
+        if (object.shape == SceneFile::SHAPE_IMPORT)
+        {
+            SceneBinary::PROP_RECORD prop = { (uint32_t)FindOrAddTag(object.prop, scene.propTags, tags.props),
+                                              SceneBinary::PROP_IMPORT };
+            scene.props.push_back(prop);
+            mesh.cullMode = SceneManager::CULL_NONE;
+        }
+        else
+        {
+            if (!object.fallbackProp.empty())
+            {
+                SceneBinary::PROP_RECORD prop = { (uint32_t)FindOrAddTag(object.fallbackProp, scene.propTags, tags.props),
+                                                  SceneBinary::PROP_FALLBACK };
+                scene.props.push_back(prop);
+            }
+
+            SceneManager::MESH_TYPE type = (SceneManager::MESH_TYPE)mesh.mesh;
+            mesh.cullMode = (uint8_t)SelectCullMode(IsClosedMesh(type, object.bDrawTop, object.bDrawBottom, object.bDrawSides), world);
+            GetMeshLocalBounds(type, bounds.boundsMin, bounds.boundsMax);
+            TransformBounds(world, bounds.boundsMin, bounds.boundsMax);
+        }
+
+        scene.transforms.push_back(world);
+        scene.meshes.push_back(mesh);
+        scene.materials.push_back(FindOrAddTag(object.materialTag, scene.materialTags, tags.materials));
+        scene.textures.push_back(FindOrAddTag(object.textureTag, scene.textureTags, tags.textures));
+        scene.surfaces.push_back(surface);
+        scene.bounds.push_back(bounds);
+        scene.flags.push_back(flags);
+    }
+
+    // What keeps an object out of a compiled scene, or nullptr if
+    // nothing does. The binary holds flat entities only, so a scene
+    // that needs the scene graph, plants or prefabs stays a text scene
+    // rather than losing them.
+    const char* GetCompileBlocker(const SceneFile::SCENE_OBJECT& object)
+    {
+        if (object.parent >= 0 || object.shape == SceneFile::SHAPE_GROUP)
+            return "a hierarchy";
+        if (object.shape == SceneFile::SHAPE_PLANT)
+            return "plants";
+        if (object.definition >= 0 || object.shape == SceneFile::SHAPE_PREFAB ||
+            object.shape == SceneFile::SHAPE_INSTANCE)
+        {
+            return "prefabs";
+        }
+        return nullptr;
+    }
+
+    // The first object's blocker, or nullptr if the scene can be compiled
+    const char* GetCompileBlocker(const std::vector<SceneFile::SCENE_OBJECT>& objects)
+    {
+        for (const SceneFile::SCENE_OBJECT& object : objects)
+        {
+            const char* blocker = GetCompileBlocker(object);
+            if (blocker != nullptr)
+                return blocker;
+        }
+        return nullptr;
+    }
+
+    // Everything LoadSceneFile() works out per object that doesn't need
+    // GL: world transforms, world bounds and cull modes. Imports keep
+    // their mesh's own bounds and closedness for load time. Entities
+    // that depend on a prop go last, so the prop table lines up with
+    // the end of the columns. objects must pass GetCompileBlocker().
+    void CompileScene(const std::vector<SceneFile::SCENE_OBJECT>& objects, SceneBinary::SCENE_DATA& scene)
+    {
+        SceneGraph graph;
+        BuildSceneGraph(objects, graph);
+
+        TAG_TABLES tags;
+        // entities without a prop, then the ones with
+        for (int pass = 0; pass < 2; pass++)
+        {
+            bool bProps = (pass == 1);
+            for (size_t i = 0; i < objects.size(); i++)
+            {
+                if (IsPropObject(objects[i]) == bProps)
+                    AddSceneEntry(objects[i], graph.GetWorld(graph.GetNode((int)i)), scene, tags);
+            }
+        }
+    }
+
+    // count objects, as copies of the objects that a compiled scene can
+    // hold on a grid spacing apart; names are dropped so the copies
+    // don't clash. Returns how many objects one copy has.
+    size_t ReplicateFlat(const std::vector<SceneFile::SCENE_OBJECT>& objects, size_t count, float spacing,
+                         std::vector<SceneFile::SCENE_OBJECT>& flat)
+    {
+        std::vector<SceneFile::SCENE_OBJECT> copy;
+        for (const SceneFile::SCENE_OBJECT& object : objects)
+        {
+            if (GetCompileBlocker(object) == nullptr)
+            {
+                copy.push_back(object);
+                copy.back().name.clear();
+            }
+        }
+
+        flat.clear();
+        if (copy.empty())
+            return 0;
+        size_t copies = (count + copy.size() - 1) / copy.size();
+        size_t columns = (size_t)std::ceil(std::sqrt((double)copies));
+        flat.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t n = i / copy.size();
+            SceneFile::SCENE_OBJECT object = copy[i % copy.size()];
+            object.position += glm::vec3((float)(n % columns) * spacing, 0.0f, (float)(n / columns) * -spacing);
+            flat.push_back(object);
+        }
+        return copy.size();
+    }
 }
 
 /***********************************************************
@@ -37,8 +386,71 @@ namespace {
 SceneManager::SceneManager(ShaderManager *pShaderManager)
 {
     m_pShaderManager = pShaderManager;
+    m_pDepthShaderManager = nullptr;
     m_basicMeshes = new ShapeMeshes();
+    m_pMeshLibrary = new MeshLibrary();
     m_loadedTextures = 0;
+
+    m_pWorkerPool = new WorkerPool();
+    m_pOcclusionCuller = new OcclusionCuller(m_pWorkerPool);
+    for (FRAME_PACKET& packet : m_framePackets)
+    {
+        packet.pMeshletCuller = new MeshletCuller(m_pWorkerPool);
+        packet.sceneVersion = 0;
+        packet.bBuilt = false;
+    }
+    m_buildPacket = 0;
+    m_pDrawPacket = nullptr;
+    m_sectionsRemaining.store(0);
+    m_sceneVersion = 0;
+    m_pSceneBVH = new SceneBVH(m_pWorkerPool);
+    // starts out matching the setting's default, so only real flips log
+    m_bLastMeshletCulling = true;
+    m_meshletFrame = 0;
+    m_pRenderSettings = nullptr;
+    m_pStateCache = nullptr;
+    m_viewMatrix = glm::mat4(1.0f);
+    m_projectionMatrix = glm::mat4(1.0f);
+    m_bLastOcclusionCulling = false;
+    m_bLastLevelOfDetail = false;
+    m_triangleQueries[0] = m_triangleQueries[1] = 0;
+    m_bQueryUsedLOD[0] = m_bQueryUsedLOD[1] = false;
+    m_bQueryPending[0] = m_bQueryPending[1] = false;
+    m_queryIndex = 0;
+    m_trianglesFullDetail = -1;
+    m_trianglesWithLOD = -1;
+    m_fragmentQueries[0] = m_fragmentQueries[1] = 0;
+    m_fragmentQueryTarget = GL_SAMPLES_PASSED;
+    m_bQueryUsedPrepass[0] = m_bQueryUsedPrepass[1] = false;
+    m_bFragmentQueryPending[0] = m_bFragmentQueryPending[1] = false;
+    m_fragmentsWithoutPrepass = -1;
+    m_fragmentsWithPrepass = -1;
+    m_bLastDepthPrepass = false;
+    m_timeQueries[0] = m_timeQueries[1] = 0;
+    m_bQueryUsedPacked[0] = m_bQueryUsedPacked[1] = false;
+    m_bTimeQueryPending[0] = m_bTimeQueryPending[1] = false;
+    m_gpuTimeFloat = -1;
+    m_gpuTimePacked = -1;
+    m_pOverdrawVisualizer = new OverdrawVisualizer();
+    m_bOverdrawShadersLoaded = false;
+    m_overdrawFrame = 0;
+    m_pProceduralMeshes = new ProceduralMeshes();
+    m_bProceduralShadersLoaded = false;
+    m_bProceduralMeshes = false;
+    m_pPlantRenderer = new PlantRenderer();
+    m_bPlantShadersLoaded = false;
+    m_bProceduralPlants = false;
+    m_bSceneFileChecked = false;
+    m_sceneFileTime = -1;
+    m_sceneFileSize = -1;
+    m_sceneFileFrame = 0;
+    m_bStressScene = false;
+    m_frameStats.objects = 0;
+    m_frameStats.drawn = 0;
+    m_frameStats.drawCalls = 0;
+    m_bLastWind = false;
+    m_simulationSeconds = 0.0;
+    m_selectedEntity = EntityStore::NO_ENTITY;
 }
 
 /***********************************************************
@@ -48,9 +460,39 @@ SceneManager::SceneManager(ShaderManager *pShaderManager)
  ***********************************************************/
 SceneManager::~SceneManager()
 {
+    // the workers may still be reading the entities
+    FinishFramePacket();
+
     m_pShaderManager = nullptr;
+    m_pDepthShaderManager = nullptr;
     delete m_basicMeshes;
     m_basicMeshes = nullptr;
+    delete m_pMeshLibrary;
+    m_pMeshLibrary = nullptr;
+    if (m_triangleQueries[0] != 0)
+        glDeleteQueries(2, m_triangleQueries);
+    if (m_fragmentQueries[0] != 0)
+        glDeleteQueries(2, m_fragmentQueries);
+    if (m_timeQueries[0] != 0)
+        glDeleteQueries(2, m_timeQueries);
+    delete m_pOverdrawVisualizer;
+    m_pOverdrawVisualizer = nullptr;
+    delete m_pProceduralMeshes;
+    m_pProceduralMeshes = nullptr;
+    delete m_pPlantRenderer;
+    m_pPlantRenderer = nullptr;
+    delete m_pOcclusionCuller;
+    m_pOcclusionCuller = nullptr;
+    for (FRAME_PACKET& packet : m_framePackets)
+    {
+        delete packet.pMeshletCuller;
+        packet.pMeshletCuller = nullptr;
+    }
+    delete m_pSceneBVH;
+    m_pSceneBVH = nullptr;
+    delete m_pWorkerPool;
+    m_pWorkerPool = nullptr;
+    m_pRenderSettings = nullptr;
 }
 
 /***********************************************************
@@ -80,7 +522,7 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 
         // Generate and bind a new texture slot on the GPU
         glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        m_pStateCache->BindTexture2D(0, textureID);
 
         // GL_REPEAT tiles the texture when UVs go past 1.0
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -105,7 +547,7 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
         // Build mipmaps so the texture looks good at different distances
         glGenerateMipmap(GL_TEXTURE_2D);
         stbi_image_free(image); // done with CPU-side pixel data
-        glBindTexture(GL_TEXTURE_2D, 0); // unbind to keep state clean
+        m_pStateCache->BindTexture2D(0, 0); // unbind to keep state clean
 
         // Save the texture ID and tag for later lookup
         m_textureIDs[m_loadedTextures].ID = textureID;
@@ -128,8 +570,7 @@ void SceneManager::BindGLTextures()
 {
     for (int i = 0; i < m_loadedTextures; i++)
     {
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+        m_pStateCache->BindTexture2D(i, m_textureIDs[i].ID);
     }
 }
 
@@ -174,115 +615,1474 @@ int SceneManager::FindTextureSlot(std::string tag)
         if (m_textureIDs[i].tag == tag)
             return i;
     }
-    return -1;
+    return -1;
+}
+
+/***********************************************************
+ * FindMaterial()
+ * Searches the material list by tag and fills in the output
+ * struct if found. Returns true on success, false if the
+ * tag doesn't exist.
+ ***********************************************************/
+bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+{
+    for (auto& mat : m_objectMaterials)
+    {
+        if (mat.tag == tag)
+        {
+            material = mat;
+            return true;
+        }
+    }
+    return false;
+}
+
+/***********************************************************
+ * FindMaterialIndex()
+ * Same search as FindMaterial(), for draw records that keep
+ * the index instead of a copy.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const std::string& tag) const
+{
+    for (size_t i = 0; i < m_objectMaterials.size(); i++)
+    {
+        if (m_objectMaterials[i].tag == tag)
+            return (int)i;
+    }
+    return -1;
+}
+
+/***********************************************************
+ * ImportPropMesh()
+ * Props are optional — with no file the scene's fallback
+ * objects are drawn instead, so a missing file isn't worth
+ * a log line.
+ ***********************************************************/
+int SceneManager::ImportPropMesh(const std::string& name)
+{
+    for (const char* extension : PROP_MESH_EXTENSIONS)
+    {
+        std::string path = PROP_MESH_DIRECTORY + name + extension;
+        if (std::ifstream(path).good())
+            return m_pMeshLibrary->ImportMesh(path);
+    }
+    return -1;
+}
+
+/***********************************************************
+ * GetPropMesh()
+ * Only successful imports are remembered, so a prop file
+ * added later is picked up by the next scene reload.
+ ***********************************************************/
+int SceneManager::GetPropMesh(const std::string& name)
+{
+    auto prop = m_propMeshes.find(name);
+    if (prop != m_propMeshes.end())
+        return prop->second;
+
+    int handle = ImportPropMesh(name);
+    if (handle >= 0)
+        m_propMeshes[name] = handle;
+    return handle;
+}
+
+/***********************************************************
+ * SubmitDrawList()
+ * Draws the packet the worker pool culled last frame while
+ * the workers cull this frame's camera into the other one,
+ * so the list build overlaps the GL submission at the cost
+ * of one frame of latency. The packet is drawn with the
+ * camera it was culled for, so culling always matches what
+ * is on screen. The first frame, and the first after a
+ * reload, have no packet yet and build one here instead.
+ *
+ * Draws are grouped by cull mode so face culling state only
+ * changes a couple of times per frame. With the depth
+ * pre-pass on, the survivors are drawn depth-only first and
+ * the Phong pass then only shades the frontmost surface.
+ * Prefab placements that survive are drawn after the
+ * groups, part by part across every placement of a prefab,
+ * and plants after those, one instanced draw per part.
+ * The overdraw view replaces both passes with a heatmap.
+ ***********************************************************/
+void SceneManager::SubmitDrawList()
+{
+    bool bPrepass = (m_pRenderSettings != nullptr) && m_pRenderSettings->bDepthPrepass &&
+                    (m_pDepthShaderManager != nullptr);
+    bool bOverdraw = (m_pRenderSettings != nullptr) && m_pRenderSettings->bOverdrawView &&
+                     m_bOverdrawShadersLoaded;
+
+    // LOD needs the viewport height in pixels
+    GLint viewport[4] = { 0, 0, 0, 0 };
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    size_t count = m_entities.GetCount();
+    m_frameStats.objects = count + m_plants.size();
+    m_frameStats.drawCalls = 0;
+
+    // Count the triangles and shaded fragments of the main pass and time
+    // it on the GPU. Fragment shader invocations need
+    // ARB_pipeline_statistics_query; without it, samples passing the
+    // depth test are the closest stand-in.
+    if (m_triangleQueries[0] == 0)
+    {
+        glGenQueries(2, m_triangleQueries);
+        glGenQueries(2, m_fragmentQueries);
+        glGenQueries(2, m_timeQueries);
+        if (GLEW_ARB_pipeline_statistics_query)
+            m_fragmentQueryTarget = GL_FRAGMENT_SHADER_INVOCATIONS_ARB;
+    }
+    UpdateTriangleReport();
+    UpdateFragmentReport();
+    UpdateStateFilter();
+    UpdateVertexFormat();
+    UpdateProceduralMeshes();
+    UpdatePlants();
+    bool bPacked = m_pMeshLibrary->IsPackedVertices();
+
+    // Last frame's build is finished by now; that's the one drawn
+    FRAME_PACKET& packet = m_framePackets[m_buildPacket];
+    if (!packet.bBuilt || packet.sceneVersion != m_sceneVersion)
+    {
+        PrepareFramePacket(packet, (float)viewport[3]);
+        StartFramePacket(packet);
+        FinishFramePacket();
+    }
+    // Its clusters are tested while the pool is still free, so the
+    // chunks spread over every worker
+    if (packet.bMeshlets)
+        packet.pMeshletCuller->Cull();
+
+    // Nothing below changes the entities, so the workers can cull this
+    // frame's camera into the other packet meanwhile
+    m_buildPacket = 1 - m_buildPacket;
+    FRAME_PACKET& nextPacket = m_framePackets[m_buildPacket];
+    PrepareFramePacket(nextPacket, (float)viewport[3]);
+    StartFramePacket(nextPacket);
+
+    m_pDrawPacket = &packet;
+    if (packet.bMeshlets)
+        packet.pMeshletCuller->Upload();
+    UpdateMeshletReport();
+    m_frameStats.drawn = packet.drawn;
+
+    // Every program draws with the packet's camera
+    m_pStateCache->UseProgram(m_pShaderManager);
+    m_pStateCache->SetMat4Value(m_pShaderManager, "view", packet.view);
+    m_pStateCache->SetMat4Value(m_pShaderManager, "projection", packet.projection);
+    m_pStateCache->SetVec3Value(m_pShaderManager, "viewPosition", packet.eye);
+    if (m_bProceduralMeshes)
+    {
+        ShaderManager* pProceduralShader = m_pProceduralMeshes->GetPhongShader();
+        m_pStateCache->UseProgram(pProceduralShader);
+        m_pStateCache->SetMat4Value(pProceduralShader, "view", packet.view);
+        m_pStateCache->SetMat4Value(pProceduralShader, "projection", packet.projection);
+        m_pStateCache->SetVec3Value(pProceduralShader, "viewPosition", packet.eye);
+        m_pStateCache->UseProgram(m_pShaderManager);
+    }
+    if (packet.bPlants)
+    {
+        ShaderManager* pPlantShader = m_pPlantRenderer->GetPhongShader();
+        m_pStateCache->UseProgram(pPlantShader);
+        m_pStateCache->SetMat4Value(pPlantShader, "view", packet.view);
+        m_pStateCache->SetMat4Value(pPlantShader, "projection", packet.projection);
+        m_pStateCache->SetVec3Value(pPlantShader, "viewPosition", packet.eye);
+        m_pStateCache->UseProgram(m_pShaderManager);
+    }
+
+    // Remember the caller's face culling state so we can put it back
+    bool cullEnabled = m_pStateCache->IsCapabilityEnabled(GL_CULL_FACE);
+    GLenum frontFace = m_pStateCache->GetFrontFace();
+    m_pStateCache->CullFace(GL_BACK);
+
+    if (bOverdraw)
+    {
+        DrawOverdrawView(viewport[2], viewport[3]);
+    }
+    else
+    {
+        m_overdrawFrame = 0;
+
+        if (bPrepass)
+        {
+            DrawDepthPrepass();
+
+            // depth is final now — only shade the fragment that won; each
+            // group below picks the test its depths can meet
+            m_pStateCache->DepthMask(GL_FALSE);
+        }
+
+        glBeginQuery(GL_PRIMITIVES_GENERATED, m_triangleQueries[m_queryIndex]);
+        glBeginQuery(m_fragmentQueryTarget, m_fragmentQueries[m_queryIndex]);
+        glBeginQuery(GL_TIME_ELAPSED, m_timeQueries[m_queryIndex]);
+
+        for (int mode = 0; mode < CULL_MODE_COUNT; mode++)
+        {
+            if (packet.cullBuckets[mode].empty())
+                continue;
+            ApplyCullMode((CULL_MODE)mode);
+
+            if (bPrepass)
+                m_pStateCache->DepthFunc(GL_LEQUAL);
+            for (size_t i : packet.cullBuckets[mode])
+            {
+                if (!IsProceduralDraw(i))
+                    DrawEntity(i, m_pShaderManager);
+            }
+
+            // procedural draws go last in each group to switch programs once
+            if (m_bProceduralMeshes)
+            {
+                ShaderManager* pProceduralShader = m_pProceduralMeshes->GetPhongShader();
+                if (bPrepass)
+                    m_pStateCache->DepthFunc(GL_EQUAL);
+                m_pStateCache->UseProgram(pProceduralShader);
+                for (size_t i : packet.cullBuckets[mode])
+                {
+                    if (IsProceduralDraw(i))
+                        DrawEntity(i, pProceduralShader);
+                }
+                m_pStateCache->UseProgram(m_pShaderManager);
+            }
+        }
+
+        if (bPrepass)
+            m_pStateCache->DepthFunc(GL_LEQUAL);
+        DrawPrefabs(m_pShaderManager, true);
+        // plants last, one program switch for all of them
+        if (packet.bPlants)
+        {
+            if (bPrepass)
+                m_pStateCache->DepthFunc(GL_EQUAL);
+            DrawPlants(m_pPlantRenderer->GetPhongShader(), true);
+        }
+
+        glEndQuery(GL_TIME_ELAPSED);
+        glEndQuery(m_fragmentQueryTarget);
+        glEndQuery(GL_PRIMITIVES_GENERATED);
+        m_bQueryUsedLOD[m_queryIndex] = packet.bLOD;
+        m_bQueryPending[m_queryIndex] = true;
+        m_bQueryUsedPrepass[m_queryIndex] = bPrepass;
+        m_bFragmentQueryPending[m_queryIndex] = true;
+        m_bQueryUsedPacked[m_queryIndex] = bPacked;
+        m_bTimeQueryPending[m_queryIndex] = true;
+        m_queryIndex = 1 - m_queryIndex;
+
+        if (bPrepass)
+        {
+            m_pStateCache->DepthFunc(GL_LESS);
+            m_pStateCache->DepthMask(GL_TRUE);
+        }
+    }
+
+    // Restore face culling to whatever state it was in before we started
+    m_pStateCache->SetCapability(GL_CULL_FACE, cullEnabled);
+    m_pStateCache->FrontFace(frontFace);
+    m_pDrawPacket = nullptr;
+
+    // Report whenever culling gets switched on or off, once a packet
+    // culled with the new setting is drawn
+    if (m_pRenderSettings != nullptr && m_bLastOcclusionCulling != packet.bCull)
+    {
+        m_bLastOcclusionCulling = packet.bCull;
+        std::cout << "INFO: Occlusion culling " << (m_bLastOcclusionCulling ? "ON" : "OFF")
+                  << " — drawing " << packet.drawn << " of " << count + m_plants.size() << " objects";
+        if (m_bLastOcclusionCulling)
+        {
+            std::cout << " (" << packet.occluderFaces << " occluder faces, "
+                      << packet.occluded << " occluded, "
+                      << packet.offscreen << " off-screen)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+/***********************************************************
+ * PrepareFramePacket()
+ * GL thread only, with no build in flight. Snapshots the
+ * camera and the culling toggles into the packet, so its
+ * build and its draw both see the same values no matter
+ * what changes in between, and marks it unbuilt until
+ * MergePacketSections() fills it in.
+ ***********************************************************/
+void SceneManager::PrepareFramePacket(FRAME_PACKET& packet, float viewportHeight)
+{
+    packet.view = m_viewMatrix;
+    packet.projection = m_projectionMatrix;
+    packet.eye = glm::vec3(glm::inverse(m_viewMatrix)[3]);
+    packet.viewportHeight = viewportHeight;
+    packet.bCull = (m_pRenderSettings != nullptr) && m_pRenderSettings->bOcclusionCulling;
+    packet.bLOD = (m_pRenderSettings != nullptr) && m_pRenderSettings->bLevelOfDetail;
+    packet.bMeshlets = (m_pRenderSettings != nullptr) && m_pRenderSettings->bMeshletCulling;
+    packet.bPlants = m_bProceduralPlants;
+    packet.sceneVersion = m_sceneVersion;
+    packet.bBuilt = false;
+}
+
+/***********************************************************
+ * StartFramePacket()
+ * Rasterizes the occluders first, as their own ParallelFor
+ * over the whole pool. With culling on, the hierarchy then
+ * hands back the entities in the frustum, sorted back into
+ * position order. Those (or every entity, with culling
+ * off) are split into PACKET_SECTION_COUNT runs, with one
+ * async job per run. Everything the jobs touch is sized
+ * here, and each job writes only its own section and its
+ * own positions in the per-entity arrays, so they never
+ * share a write.
+ ***********************************************************/
+void SceneManager::StartFramePacket(FRAME_PACKET& packet)
+{
+    size_t count = m_entities.GetCount();
+    if (m_lodLevels.size() != count)
+        m_lodLevels.assign(count, -1);
+    packet.drawLevels.assign(count, -1);
+    packet.meshletSlots.assign(count, -1);
+
+    packet.occluderFaces = 0;
+    if (packet.bCull)
+    {
+        const glm::mat4* transforms = m_entities.GetTransforms();
+        const uint8_t* flags = m_entities.GetFlags();
+        const uint8_t occluderMask = EntityStore::FLAG_OCCLUDER | EntityStore::FLAG_HIDDEN;
+
+        m_pOcclusionCuller->BeginFrame(packet.projection * packet.view);
+        for (size_t i = 0; i < count; i++)
+        {
+            if ((flags[i] & occluderMask) == EntityStore::FLAG_OCCLUDER)
+                m_pOcclusionCuller->AddOccluderBox(transforms[i]);
+        }
+        m_pOcclusionCuller->RasterizeOccluders();
+        packet.occluderFaces = m_pOcclusionCuller->GetStats().occluderFaces;
+
+        m_pSceneBVH->QueryFrustum(packet.projection * packet.view, m_frustumEntities);
+        std::sort(m_frustumEntities.begin(), m_frustumEntities.end());
+    }
+
+    // The last section to finish joins them all, so nothing waits on
+    // the merge until FinishFramePacket()
+    m_sectionsRemaining.store(PACKET_SECTION_COUNT);
+    m_pWorkerPool->ParallelForAsync(PACKET_SECTION_COUNT, [this, &packet](int section)
+    {
+        BuildPacketSection(packet, section);
+        if (m_sectionsRemaining.fetch_sub(1) == 1)
+            MergePacketSections(packet);
+    });
+}
+
+/***********************************************************
+ * BuildPacketSection()
+ * Walks one run of the candidates and keeps the ones whose
+ * flags and bounds survive the occlusion test, grouped by cull
+ * mode in scene order. Curved shapes that survive get a
+ * detail level based on their on-screen size, picked up
+ * front so the pre-pass and the main pass draw exactly the
+ * same geometry. Prefab placements go in a list of their
+ * own, since they are drawn part by part.
+ ***********************************************************/
+void SceneManager::BuildPacketSection(FRAME_PACKET& packet, int section)
+{
+    PACKET_SECTION& build = packet.sections[section];
+    for (int mode = 0; mode < CULL_MODE_COUNT; mode++)
+        build.cullBuckets[mode].clear();
+    build.prefabDraws.clear();
+    build.occluded = 0;
+    build.offscreen = 0;
+
+    const EntityStore::MESH_REF* meshes = m_entities.GetMeshes();
+    const EntityStore::BOUNDS* bounds = m_entities.GetBounds();
+    const uint8_t* flags = m_entities.GetFlags();
+
+    size_t candidates = packet.bCull ? m_frustumEntities.size() : m_entities.GetCount();
+    size_t begin = candidates * section / PACKET_SECTION_COUNT;
+    size_t end = candidates * (section + 1) / PACKET_SECTION_COUNT;
+    for (size_t candidate = begin; candidate < end; candidate++)
+    {
+        size_t i = packet.bCull ? (size_t)m_frustumEntities[candidate] : candidate;
+        if (flags[i] & EntityStore::FLAG_HIDDEN)
+            continue;
+
+        // occluders are always drawn — they'd only ever pass their own test
+        if (packet.bCull && !(flags[i] & EntityStore::FLAG_OCCLUDER))
+        {
+            OcclusionCuller::VISIBILITY visibility = m_pOcclusionCuller->TestBounds(bounds[i].boundsMin, bounds[i].boundsMax);
+            if (visibility == OcclusionCuller::OCCLUDED)
+            {
+                build.occluded++;
+                continue;
+            }
+            if (visibility == OcclusionCuller::OFFSCREEN)
+            {
+                build.offscreen++;
+                continue;
+            }
+        }
+
+        if (meshes[i].mesh == MESH_PREFAB)
+        {
+            build.prefabDraws.push_back(i);
+            continue;
+        }
+        packet.drawLevels[i] = packet.bLOD ? SelectLODLevel(i, packet) : -1;
+        build.cullBuckets[meshes[i].cullMode].push_back(i);
+    }
+}
+
+/***********************************************************
+ * MergePacketSections()
+ * Runs on whichever worker finishes the last section.
+ * Sections are joined in entity order, so the buckets
+ * and the meshlet slots come out the same however the jobs
+ * were scheduled. Imported meshes that survived get their
+ * clusters queued here; the GL thread culls them with
+ * MeshletCuller::Cull() before the packet is drawn, so only
+ * draws still in a bucket are tested. Prefab placements
+ * are grouped by prefab, and plants are culled here too.
+ ***********************************************************/
+void SceneManager::MergePacketSections(FRAME_PACKET& packet)
+{
+    packet.drawn = 0;
+    packet.occluded = 0;
+    packet.offscreen = 0;
+    for (int mode = 0; mode < CULL_MODE_COUNT; mode++)
+    {
+        std::vector<size_t>& bucket = packet.cullBuckets[mode];
+        bucket.clear();
+        for (const PACKET_SECTION& section : packet.sections)
+            bucket.insert(bucket.end(), section.cullBuckets[mode].begin(), section.cullBuckets[mode].end());
+        packet.drawn += (int)bucket.size();
+    }
+    packet.prefabDraws.clear();
+    for (const PACKET_SECTION& section : packet.sections)
+    {
+        packet.prefabDraws.insert(packet.prefabDraws.end(), section.prefabDraws.begin(), section.prefabDraws.end());
+        packet.occluded += section.occluded;
+        packet.offscreen += section.offscreen;
+    }
+    // stable, so placements of one prefab stay in scene order
+    const EntityStore::MESH_REF* meshes = m_entities.GetMeshes();
+    std::stable_sort(packet.prefabDraws.begin(), packet.prefabDraws.end(), [meshes](size_t a, size_t b)
+    {
+        return meshes[a].prefab < meshes[b].prefab;
+    });
+    packet.drawn += (int)packet.prefabDraws.size();
+    // entities outside the frustum never reached a section
+    if (packet.bCull)
+        packet.offscreen += (int)(m_entities.GetCount() - m_frustumEntities.size());
+
+    // Cone culling is only used where back faces are culled anyway
+    packet.pMeshletCuller->BeginFrame(packet.projection * packet.view, packet.eye);
+    if (packet.bMeshlets)
+    {
+        const glm::mat4* transforms = m_entities.GetTransforms();
+        for (int mode = 0; mode < CULL_MODE_COUNT; mode++)
+        {
+            for (size_t i : packet.cullBuckets[mode])
+            {
+                if (meshes[i].mesh != MESH_IMPORTED)
+                    continue;
+
+                const std::vector<MeshLibrary::MESHLET>& meshlets = m_pMeshLibrary->GetImportedMeshlets(meshes[i].importedMesh);
+                if (!meshlets.empty())
+                    packet.meshletSlots[i] = packet.pMeshletCuller->AddDraw(meshlets, transforms[i], meshes[i].cullMode != CULL_NONE);
+            }
+        }
+    }
+
+    // a handful of whole-plant tests, not worth a section of their own
+    packet.drawn += CullPlants(packet);
+    packet.bBuilt = true;
+}
+
+/***********************************************************
+ * FinishFramePacket()
+ * GL thread only. Blocks until the packet started by the
+ * last StartFramePacket() is merged, helping with any
+ * sections no worker has picked up yet. Until this returns
+ * the workers are reading m_entities, m_lodLevels and the
+ * occlusion buffer, so anything that changes the entities
+ * or rasterizes new occluders has to call it first. Safe
+ * to call with no build in flight.
+ ***********************************************************/
+void SceneManager::FinishFramePacket()
+{
+    if (m_pWorkerPool != nullptr)
+        m_pWorkerPool->Wait();
+}
+
+/***********************************************************
+ * DrawDepthPrepass()
+ * Draws every surviving entity with the position-only depth
+ * shader and color writes off, so the depth buffer holds the
+ * nearest surface before any Phong lighting runs. Uses the
+ * same cull grouping and prefab order as the main pass, and
+ * the procedural depth program for procedural draws.
+ *
+ * Buffer meshes and prefab parts are shaded by the external
+ * Phong program, whose vertex shader isn't invariant, so
+ * their depths can differ from these in the last bit. Those
+ * draws are pushed back by a polygon offset here and tested
+ * GL_LEQUAL in the main pass. Procedural draws and plants
+ * each use one invariant vertex shader for both passes, so
+ * they keep the exact GL_EQUAL test.
+ ***********************************************************/
+void SceneManager::DrawDepthPrepass()
+{
+    const FRAME_PACKET& packet = *m_pDrawPacket;
+    m_pStateCache->UseProgram(m_pDepthShaderManager);
+    m_pStateCache->SetMat4Value(m_pDepthShaderManager, "view", packet.view);
+    m_pStateCache->SetMat4Value(m_pDepthShaderManager, "projection", packet.projection);
+
+    ShaderManager* pProceduralShader = m_pProceduralMeshes->GetDepthShader();
+    if (m_bProceduralMeshes)
+    {
+        m_pStateCache->UseProgram(pProceduralShader);
+        m_pStateCache->SetMat4Value(pProceduralShader, "view", packet.view);
+        m_pStateCache->SetMat4Value(pProceduralShader, "projection", packet.projection);
+        m_pStateCache->UseProgram(m_pDepthShaderManager);
+    }
+
+    m_pStateCache->ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    m_pStateCache->DepthFunc(GL_LESS);
+    m_pStateCache->PolygonOffset(PREPASS_OFFSET_FACTOR, PREPASS_OFFSET_UNITS);
+
+    for (int mode = 0; mode < CULL_MODE_COUNT; mode++)
+    {
+        if (packet.cullBuckets[mode].empty())
+            continue;
+        ApplyCullMode((CULL_MODE)mode);
+
+        m_pStateCache->Enable(GL_POLYGON_OFFSET_FILL);
+        for (size_t i : packet.cullBuckets[mode])
+        {
+            if (IsProceduralDraw(i))
+                continue;
+            m_pStateCache->SetMat4Value(m_pDepthShaderManager, g_ModelName, GetDrawModel(i));
+            DrawEntityMesh(i);
+        }
+
+        // same invariant vertex shader as the procedural Phong program,
+        // so the GL_EQUAL main pass matches these depths exactly
+        if (m_bProceduralMeshes)
+        {
+            m_pStateCache->Disable(GL_POLYGON_OFFSET_FILL);
+            m_pStateCache->UseProgram(pProceduralShader);
+            const glm::mat4* transforms = m_entities.GetTransforms();
+            for (size_t i : packet.cullBuckets[mode])
+            {
+                if (!IsProceduralDraw(i))
+                    continue;
+                m_pStateCache->SetMat4Value(pProceduralShader, g_ModelName, transforms[i]);
+                DrawEntityGeometry(i, pProceduralShader);
+            }
+            m_pStateCache->UseProgram(m_pDepthShaderManager);
+        }
+    }
+    m_pStateCache->Enable(GL_POLYGON_OFFSET_FILL);
+    DrawPrefabs(m_pDepthShaderManager, false);
+    m_pStateCache->Disable(GL_POLYGON_OFFSET_FILL);
+
+    // same invariant vertex shader as the plant Phong program, so plants
+    // keep the exact test too
+    if (packet.bPlants)
+    {
+        ShaderManager* pPlantShader = m_pPlantRenderer->GetDepthShader();
+        m_pStateCache->UseProgram(pPlantShader);
+        m_pStateCache->SetMat4Value(pPlantShader, "view", packet.view);
+        m_pStateCache->SetMat4Value(pPlantShader, "projection", packet.projection);
+        DrawPlants(pPlantShader, false);
+    }
+
+    m_pStateCache->ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    m_pStateCache->UseProgram(m_pShaderManager);
+}
+
+/***********************************************************
+ * DrawOverdrawView()
+ * Replaces the normal passes with the overdraw counter: the
+ * surviving entities are rasterized with depth testing off and
+ * the per-pixel counts are shown as a heatmap. Stats are
+ * logged when the view is switched on and every
+ * OVERDRAW_REPORT_FRAMES frames after that. Procedural draws
+ * are counted with their buffer meshes, which cover the
+ * same pixels, and plants with the instanced count program.
+ ***********************************************************/
+void SceneManager::DrawOverdrawView(int width, int height)
+{
+    bool bReport = (m_overdrawFrame % OVERDRAW_REPORT_FRAMES) == 0;
+    m_overdrawFrame++;
+
+    const FRAME_PACKET& packet = *m_pDrawPacket;
+    ShaderManager* pCountShader = m_pOverdrawVisualizer->BeginCounting(
+        width, height, packet.view, packet.projection);
+
+    for (int mode = 0; mode < CULL_MODE_COUNT; mode++)
+    {
+        if (packet.cullBuckets[mode].empty())
+            continue;
+        ApplyCullMode((CULL_MODE)mode);
+
+        for (size_t i : packet.cullBuckets[mode])
+        {
+            m_pStateCache->SetMat4Value(pCountShader, g_ModelName, GetDrawModel(i));
+            DrawEntityMesh(i);
+        }
+    }
+    DrawPrefabs(pCountShader, false);
+    if (packet.bPlants)
+        DrawPlants(m_pOverdrawVisualizer->GetInstancedCountShader(), false);
+
+    m_pOverdrawVisualizer->EndCounting(bReport);
+    m_pStateCache->UseProgram(m_pShaderManager);
+
+    if (bReport)
+    {
+        const OverdrawVisualizer::OVERDRAW_STATS& stats = m_pOverdrawVisualizer->GetStats();
+        std::cout << "INFO: Overdraw — average " << stats.averageOverdraw
+                  << " fragments/pixel (" << stats.averageCoveredOverdraw
+                  << " over the " << stats.coveredPixels << " of " << stats.totalPixels
+                  << " pixels covered), max " << stats.maxOverdraw << std::endl;
+    }
+}
+
+/***********************************************************
+ * ApplyCullMode()
+ * Closed shapes drop their back faces. Mirrored transforms
+ * flip the winding, so their front faces are clockwise.
+ * Open shells are drawn with culling off so the inside of
+ * an uncapped cylinder still shows.
+ ***********************************************************/
+void SceneManager::ApplyCullMode(CULL_MODE cullMode)
+{
+    switch (cullMode)
+    {
+    case CULL_BACK:
+        m_pStateCache->Enable(GL_CULL_FACE);
+        m_pStateCache->FrontFace(GL_CCW);
+        break;
+    case CULL_BACK_MIRRORED:
+        m_pStateCache->Enable(GL_CULL_FACE);
+        m_pStateCache->FrontFace(GL_CW);
+        break;
+    case CULL_NONE:
+    default:
+        m_pStateCache->Disable(GL_CULL_FACE);
+        break;
+    }
+}
+
+/***********************************************************
+ * SelectLODLevel()
+ * Estimates the object's on-screen diameter from its world
+ * bounds and picks a MeshLibrary level. The level from last
+ * frame is kept until the size moves LOD_HYSTERESIS past a
+ * threshold, so objects hovering at a boundary don't flicker
+ * between levels. Returns -1 for meshes without LOD levels.
+ ***********************************************************/
+int SceneManager::SelectLODLevel(size_t index, const FRAME_PACKET& packet)
+{
+    MeshLibrary::LOD_SHAPE shape;
+    if (!GetLODShape((MESH_TYPE)m_entities.GetMeshes()[index].mesh, shape))
+        return -1;
+
+    const EntityStore::BOUNDS& bounds = m_entities.GetBounds()[index];
+    glm::vec3 center = (bounds.boundsMin + bounds.boundsMax) * 0.5f;
+    float radius = glm::length(bounds.boundsMax - bounds.boundsMin) * 0.5f;
+
+    // projection[1][1] is 1/tan(fov/2) for perspective, 1/halfHeight for ortho
+    float pixels = radius * packet.projection[1][1] * packet.viewportHeight;
+    bool bPerspective = (packet.projection[2][3] != 0.0f);
+    if (bPerspective)
+    {
+        float distance = glm::length(center - packet.eye);
+        pixels = (distance > radius) ? pixels / distance : 1e9f;
+    }
+
+    int level = m_lodLevels[index];
+    if (level < 0)
+    {
+        // first time we've seen this entity — no hysteresis yet
+        level = 0;
+        while (level < MeshLibrary::LOD_LEVEL_COUNT - 1 && pixels < g_LODThresholdPixels[level])
+            level++;
+    }
+    else
+    {
+        while (level > 0 && pixels >= g_LODThresholdPixels[level - 1] * (1.0f + LOD_HYSTERESIS))
+            level--;
+        while (level < MeshLibrary::LOD_LEVEL_COUNT - 1 && pixels < g_LODThresholdPixels[level] * (1.0f - LOD_HYSTERESIS))
+            level++;
+    }
+
+    m_lodLevels[index] = level;
+    return level;
+}
+
+/***********************************************************
+ * UpdateTriangleReport()
+ * Picks up triangle counts from earlier frames' queries
+ * without stalling, remembers the latest count for LOD off
+ * and on, and prints both whenever LOD gets toggled.
+ ***********************************************************/
+void SceneManager::UpdateTriangleReport()
+{
+    for (int q = 0; q < 2; q++)
+    {
+        if (!m_bQueryPending[q])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_triangleQueries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint triangles = 0;
+        glGetQueryObjectuiv(m_triangleQueries[q], GL_QUERY_RESULT, &triangles);
+        if (m_bQueryUsedLOD[q])
+            m_trianglesWithLOD = triangles;
+        else
+            m_trianglesFullDetail = triangles;
+        m_bQueryPending[q] = false;
+    }
+
+    if (m_pRenderSettings == nullptr || m_bLastLevelOfDetail == m_pRenderSettings->bLevelOfDetail)
+        return;
+    m_bLastLevelOfDetail = m_pRenderSettings->bLevelOfDetail;
+
+    std::cout << "INFO: Level of detail " << (m_bLastLevelOfDetail ? "ON" : "OFF")
+              << " — triangles per frame: full detail ";
+    if (m_trianglesFullDetail >= 0)
+        std::cout << m_trianglesFullDetail;
+    else
+        std::cout << "(not measured yet)";
+    std::cout << ", with LOD ";
+    if (m_trianglesWithLOD >= 0)
+        std::cout << m_trianglesWithLOD;
+    else
+        std::cout << "(not measured yet)";
+    if (m_trianglesFullDetail > 0 && m_trianglesWithLOD >= 0)
+    {
+        std::cout << " (" << (100 - (100 * m_trianglesWithLOD) / m_trianglesFullDetail) << "% fewer)";
+    }
+    std::cout << std::endl;
+}
+
+/***********************************************************
+ * UpdateFragmentReport()
+ * Same idea as UpdateTriangleReport(), for the fragments
+ * the main pass shaded. Prints the latest counts with the
+ * depth pre-pass off and on whenever it gets toggled.
+ ***********************************************************/
+void SceneManager::UpdateFragmentReport()
+{
+    for (int q = 0; q < 2; q++)
+    {
+        if (!m_bFragmentQueryPending[q])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_fragmentQueries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint fragments = 0;
+        glGetQueryObjectuiv(m_fragmentQueries[q], GL_QUERY_RESULT, &fragments);
+        if (m_bQueryUsedPrepass[q])
+            m_fragmentsWithPrepass = fragments;
+        else
+            m_fragmentsWithoutPrepass = fragments;
+        m_bFragmentQueryPending[q] = false;
+    }
+
+    if (m_pRenderSettings == nullptr || m_bLastDepthPrepass == m_pRenderSettings->bDepthPrepass)
+        return;
+    m_bLastDepthPrepass = m_pRenderSettings->bDepthPrepass;
+
+    if (m_pDepthShaderManager == nullptr)
+    {
+        std::cout << "INFO: Depth pre-pass unavailable — no depth shader loaded" << std::endl;
+        return;
+    }
+
+    std::cout << "INFO: Depth pre-pass " << (m_bLastDepthPrepass ? "ON" : "OFF")
+              << " — Phong pass "
+              << (m_fragmentQueryTarget == GL_SAMPLES_PASSED ? "samples passed" : "fragment shader invocations")
+              << " per frame: without pre-pass ";
+    if (m_fragmentsWithoutPrepass >= 0)
+        std::cout << m_fragmentsWithoutPrepass;
+    else
+        std::cout << "(not measured yet)";
+    std::cout << ", with pre-pass ";
+    if (m_fragmentsWithPrepass >= 0)
+        std::cout << m_fragmentsWithPrepass;
+    else
+        std::cout << "(not measured yet)";
+    if (m_fragmentsWithoutPrepass > 0 && m_fragmentsWithPrepass >= 0)
+    {
+        std::cout << " (" << (100 - (100 * m_fragmentsWithPrepass) / m_fragmentsWithoutPrepass) << "% fewer)";
+    }
+    std::cout << std::endl;
+}
+
+/***********************************************************
+ * UpdateStateFilter()
+ * Switches the state cache's filtering to match its toggle
+ * and prints the previous frame's issued and elided call
+ * counts whenever it changes.
+ ***********************************************************/
+void SceneManager::UpdateStateFilter()
+{
+    if (m_pRenderSettings == nullptr || m_pStateCache->IsFilterEnabled() == m_pRenderSettings->bStateFilter)
+        return;
+
+    const GLStateCache::STATE_STATS& stats = m_pStateCache->GetLastFrameStats();
+    std::cout << "INFO: GL state filter " << (m_pRenderSettings->bStateFilter ? "ON" : "OFF")
+              << " — last frame (filter " << (m_pStateCache->IsFilterEnabled() ? "on" : "off") << "): "
+              << stats.issued << " calls issued, " << stats.elided << " elided, "
+              << stats.redundant << " redundant" << std::endl;
+
+    m_pStateCache->SetFilterEnabled(m_pRenderSettings->bStateFilter);
+}
+
+/***********************************************************
+ * UpdateVertexFormat()
+ * Same query pattern as UpdateTriangleReport(), for main
+ * pass GPU time. Switches MeshLibrary's vertex layout to
+ * match its toggle and prints vertex memory for both
+ * layouts with the latest GPU time for each.
+ ***********************************************************/
+void SceneManager::UpdateVertexFormat()
+{
+    for (int q = 0; q < 2; q++)
+    {
+        if (!m_bTimeQueryPending[q])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_timeQueries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(m_timeQueries[q], GL_QUERY_RESULT, &nanoseconds);
+        if (m_bQueryUsedPacked[q])
+            m_gpuTimePacked = (long long)nanoseconds;
+        else
+            m_gpuTimeFloat = (long long)nanoseconds;
+        m_bTimeQueryPending[q] = false;
+    }
+
+    if (m_pRenderSettings == nullptr || m_pMeshLibrary->IsPackedVertices() == m_pRenderSettings->bPackedVertices)
+        return;
+    m_pMeshLibrary->SetPackedVertices(m_pRenderSettings->bPackedVertices);
+
+    size_t floatBytes = m_pMeshLibrary->GetVertexBufferBytes(false);
+    size_t packedBytes = m_pMeshLibrary->GetVertexBufferBytes(true);
+    std::cout << "INFO: Packed vertices " << (m_pRenderSettings->bPackedVertices ? "ON" : "OFF")
+              << " — LOD mesh vertex memory: float " << floatBytes / 1024
+              << " KB, packed " << packedBytes / 1024 << " KB";
+    if (floatBytes > 0)
+        std::cout << " (" << (100 - (100 * packedBytes) / floatBytes) << "% smaller)";
+    std::cout << "; main pass GPU time: float ";
+    if (m_gpuTimeFloat >= 0)
+        std::cout << m_gpuTimeFloat / 1000000.0 << " ms";
+    else
+        std::cout << "(not measured yet)";
+    std::cout << ", packed ";
+    if (m_gpuTimePacked >= 0)
+        std::cout << m_gpuTimePacked / 1000000.0 << " ms";
+    else
+        std::cout << "(not measured yet)";
+    std::cout << std::endl;
+}
+
+/***********************************************************
+ * UpdateProceduralMeshes()
+ * Picks up the toggle once per frame, so every pass in a
+ * frame agrees on which draws are procedural.
+ ***********************************************************/
+void SceneManager::UpdateProceduralMeshes()
+{
+    bool bWanted = (m_pRenderSettings != nullptr) && m_pRenderSettings->bProceduralMeshes;
+    if (bWanted == m_bProceduralMeshes)
+        return;
+
+    if (bWanted && !m_bProceduralShadersLoaded)
+    {
+        std::cout << "INFO: Procedural meshes unavailable — shaders did not load" << std::endl;
+        m_pRenderSettings->bProceduralMeshes = false;
+        return;
+    }
+
+    m_bProceduralMeshes = bWanted;
+    std::cout << "INFO: Procedural meshes " << (m_bProceduralMeshes ? "ON" : "OFF")
+              << " — curved shapes " << (m_bProceduralMeshes ? "built from gl_VertexID, reading none of the "
+                                                              : "read from the ")
+              << m_pMeshLibrary->GetVertexBufferBytes(m_pMeshLibrary->IsPackedVertices()) / 1024
+              << " KB of LOD vertex buffers" << std::endl;
+}
+
+/***********************************************************
+ * UpdatePlants()
+ * Picks up the toggle once per frame like the procedural
+ * mesh toggle, and swaps the replaced scene entities out or
+ * back in as it flips.
+ ***********************************************************/
+void SceneManager::UpdatePlants()
+{
+    bool bWanted = (m_pRenderSettings != nullptr) && m_pRenderSettings->bProceduralPlants;
+    if (bWanted == m_bProceduralPlants)
+        return;
+
+    if (bWanted && !m_bPlantShadersLoaded)
+    {
+        std::cout << "INFO: Procedural plants unavailable — shaders did not load" << std::endl;
+        m_pRenderSettings->bProceduralPlants = false;
+        return;
+    }
+
+    m_bProceduralPlants = bWanted;
+    int replaced = HidePlantReplacements(m_bProceduralPlants);
+
+    int bark = 0;
+    int leaves = 0;
+    for (const PLANT_RECORD& plant : m_plants)
+    {
+        bark += m_pPlantRenderer->GetInstanceCount(plant.plant, PlantRenderer::PART_BARK);
+        for (int band = 0; band < PlantGenerator::LEAF_SHADE_COUNT; band++)
+            leaves += m_pPlantRenderer->GetInstanceCount(plant.plant, (PlantRenderer::PLANT_PART)(PlantRenderer::PART_LEAVES + band));
+    }
+    std::cout << "INFO: Procedural plants " << (m_bProceduralPlants ? "ON" : "OFF") << " — "
+              << m_plants.size() << " plants (" << bark << " bark segments, " << leaves << " leaves in "
+              << m_plants.size() * PlantRenderer::PART_COUNT << " instanced draws) "
+              << (m_bProceduralPlants ? "standing in for " : "handing back ") << replaced
+              << " scene entities" << std::endl;
+}
+
+/***********************************************************
+ * HidePlantReplacements()
+ * A replaced subtree is one contiguous run of graph nodes,
+ * so this only visits the nodes being swapped out.
+ ***********************************************************/
+int SceneManager::HidePlantReplacements(bool bHidden)
+{
+    int count = 0;
+    for (const PLANT_RECORD& plant : m_plants)
+    {
+        if (plant.replacedNode < 0)
+            continue;
+        int end = m_sceneGraph.GetSubtreeEnd(plant.replacedNode);
+        for (int node = plant.replacedNode; node < end; node++)
+        {
+            int index = m_entities.GetIndex(m_nodeEntities[node]);
+            if (index >= 0)
+            {
+                uint8_t& flags = m_entities.GetFlags()[index];
+                flags = bHidden ? (flags | EntityStore::FLAG_HIDDEN) : (flags & ~EntityStore::FLAG_HIDDEN);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/***********************************************************
+ * CullPlants()
+ * Each plant is tested as a whole against the occlusion
+ * buffer — its draws are all-or-nothing anyway.
+ ***********************************************************/
+int SceneManager::CullPlants(FRAME_PACKET& packet)
+{
+    int visible = 0;
+    packet.plantVisible.resize(m_plants.size());
+    for (size_t i = 0; i < m_plants.size(); i++)
+    {
+        const PLANT_RECORD& plant = m_plants[i];
+        bool bVisible = packet.bPlants;
+        if (bVisible && packet.bCull)
+        {
+            glm::vec3 boundsMin = plant.boundsMin;
+            glm::vec3 boundsMax = plant.boundsMax;
+            TransformBounds(m_sceneGraph.GetWorld(plant.node), boundsMin, boundsMax);
+            bVisible = m_pOcclusionCuller->TestBounds(boundsMin, boundsMax) == OcclusionCuller::VISIBLE;
+        }
+        packet.plantVisible[i] = bVisible ? 1 : 0;
+        visible += bVisible ? 1 : 0;
+    }
+    return visible;
+}
+
+/***********************************************************
+ * DrawPlants()
+ * The plant's graph node supplies the shared model matrix,
+ * so plants follow the scene graph like any other object.
+ * Instances never mirror, so the node's transform alone
+ * decides the winding.
+ ***********************************************************/
+void SceneManager::DrawPlants(ShaderManager* pShader, bool bShade)
+{
+    m_pStateCache->UseProgram(pShader);
+    for (size_t i = 0; i < m_plants.size(); i++)
+    {
+        if (!m_pDrawPacket->plantVisible[i])
+            continue;
+
+        const PLANT_RECORD& plant = m_plants[i];
+        const glm::mat4& world = m_sceneGraph.GetWorld(plant.node);
+        ApplyCullMode(SelectCullMode(true, world));
+        m_pStateCache->SetMat4Value(pShader, g_ModelName, world);
+        if (bShade)
+        {
+            m_pStateCache->SetIntValue(pShader, g_UseTextureName, false);
+            m_pStateCache->SetVec2Value(pShader, "UVscale", glm::vec2(1.0f, 1.0f));
+        }
+
+        for (int part = 0; part < PlantRenderer::PART_COUNT; part++)
+        {
+            if (bShade)
+            {
+                m_pStateCache->SetVec4Value(pShader, g_ColorValueName, plant.colors[part]);
+                if (plant.materialIndices[part] >= 0)
+                {
+                    const OBJECT_MATERIAL& material = m_objectMaterials[plant.materialIndices[part]];
+                    m_pStateCache->SetVec3Value(pShader, "material.diffuseColor", material.diffuseColor);
+                    m_pStateCache->SetVec3Value(pShader, "material.specularColor", material.specularColor);
+                    m_pStateCache->SetFloatValue(pShader, "material.shininess", material.shininess);
+                }
+            }
+            m_pPlantRenderer->DrawPart(plant.plant, (PlantRenderer::PLANT_PART)part);
+            m_frameStats.drawCalls++;
+        }
+    }
+    m_pStateCache->UseProgram(m_pShaderManager);
+}
+
+/***********************************************************
+ * UpdateMeshletReport()
+ * Reads the drawn packet's counts, so the log always
+ * describes what is on screen.
+ ***********************************************************/
+void SceneManager::UpdateMeshletReport()
+{
+    bool bMeshlets = m_pDrawPacket->bMeshlets;
+    bool bToggled = (m_pRenderSettings != nullptr) && (bMeshlets != m_bLastMeshletCulling);
+    m_bLastMeshletCulling = bMeshlets;
+    if (!bMeshlets)
+    {
+        m_meshletFrame = 0;
+        if (bToggled)
+            std::cout << "INFO: Meshlet culling OFF — imported meshes drawn whole" << std::endl;
+        return;
+    }
+
+    const MeshletCuller::CULL_STATS& stats = m_pDrawPacket->pMeshletCuller->GetStats();
+    bool bReport = bToggled || (stats.tested > 0 && (m_meshletFrame % MESHLET_REPORT_FRAMES) == 0);
+    m_meshletFrame++;
+    if (!bReport)
+        return;
+
+    int culled = stats.offscreen + stats.backFacing;
+    std::cout << "INFO: Meshlet culling ON — culled " << culled << " of " << stats.tested
+              << " clusters (" << stats.offscreen << " off-screen, " << stats.backFacing << " back-facing), "
+              << stats.commands << " draw commands for " << stats.draws << " imported meshes" << std::endl;
+}
+
+/***********************************************************
+ * DrawEntity()
+ * Pushes one entity's transform, color or texture, UV
+ * scale, and material to pShader, which must already be
+ * bound, then draws its mesh. The state cache drops
+ * whatever matches the draw before it, which is most of it.
+ ***********************************************************/
+void SceneManager::DrawEntity(size_t index, ShaderManager* pShader)
+{
+    if (pShader != nullptr)
+    {
+        // procedural shapes are built at their true size, no packing scale
+        glm::mat4 model = IsProceduralDraw(index) ? m_entities.GetTransforms()[index] : GetDrawModel(index);
+        m_pStateCache->SetMat4Value(pShader, g_ModelName, model);
+        SetSurfaceState(pShader, m_entities.GetTextures()[index], m_entities.GetSurfaces()[index],
+                        m_entities.GetMaterials()[index]);
+    }
+
+    DrawEntityGeometry(index, pShader);
+}
+
+/***********************************************************
+ * SetSurfaceState()
+ * Sets the texture or flat color, UV scale and material on
+ * pShader, which must already be bound. A textureSlot of -1
+ * draws surface.color instead; a materialIndex of -1 keeps
+ * whatever material the last draw set.
+ ***********************************************************/
+void SceneManager::SetSurfaceState(ShaderManager* pShader, int textureSlot, const EntityStore::SURFACE& surface, int materialIndex)
+{
+    if (textureSlot >= 0)
+    {
+        m_pStateCache->SetIntValue(pShader, g_UseTextureName, true);
+        m_pStateCache->SetSampler2DValue(pShader, g_TextureValueName, textureSlot);
+    }
+    else
+    {
+        m_pStateCache->SetIntValue(pShader, g_UseTextureName, false);
+        m_pStateCache->SetVec4Value(pShader, g_ColorValueName, surface.color);
+    }
+
+    m_pStateCache->SetVec2Value(pShader, "UVscale", surface.uvScale);
+
+    if (materialIndex >= 0)
+    {
+        const OBJECT_MATERIAL& material = m_objectMaterials[materialIndex];
+        m_pStateCache->SetVec3Value(pShader, "material.diffuseColor", material.diffuseColor);
+        m_pStateCache->SetVec3Value(pShader, "material.specularColor", material.specularColor);
+        m_pStateCache->SetFloatValue(pShader, "material.shininess", material.shininess);
+    }
+}
+
+/***********************************************************
+ * IsProceduralDraw()
+ * Only the curved shapes have a procedural version.
+ ***********************************************************/
+bool SceneManager::IsProceduralDraw(size_t index) const
+{
+    MeshLibrary::LOD_SHAPE shape;
+    return m_bProceduralMeshes && GetLODShape((MESH_TYPE)m_entities.GetMeshes()[index].mesh, shape);
+}
+
+/***********************************************************
+ * DrawEntityGeometry()
+ * With LOD off a procedural draw uses the finest level.
+ ***********************************************************/
+void SceneManager::DrawEntityGeometry(size_t index, ShaderManager* pShader)
+{
+    m_frameStats.drawCalls++;
+    MeshLibrary::LOD_SHAPE shape;
+    if (m_bProceduralMeshes && GetLODShape((MESH_TYPE)m_entities.GetMeshes()[index].mesh, shape))
+    {
+        uint8_t flags = m_entities.GetFlags()[index];
+        int level = (m_pDrawPacket->drawLevels[index] >= 0) ? m_pDrawPacket->drawLevels[index] : 0;
+        m_pProceduralMeshes->Draw(m_pStateCache, pShader, shape, level,
+                                  (flags & EntityStore::FLAG_DRAW_TOP) != 0,
+                                  (flags & EntityStore::FLAG_DRAW_BOTTOM) != 0,
+                                  (flags & EntityStore::FLAG_DRAW_SIDES) != 0);
+        return;
+    }
+
+    DrawEntityMesh(index);
+}
+
+/***********************************************************
+ * DrawEntityMesh()
+ * Draws the entity's ShapeMeshes primitive, or its
+ * MeshLibrary version when a detail level was picked. Leaves
+ * shader state alone so the depth pre-pass can share it.
+ ***********************************************************/
+void SceneManager::DrawEntityMesh(size_t index)
+{
+    DrawMesh(m_entities.GetMeshes()[index], m_entities.GetFlags()[index],
+             m_pDrawPacket->drawLevels[index], m_pDrawPacket->meshletSlots[index]);
+}
+
+/***********************************************************
+ * DrawMesh()
+ * Issues one mesh with whatever program and uniforms are
+ * bound. A level of -1 draws the basic mesh; otherwise a
+ * curved shape draws that MeshLibrary LOD level. Cylinder
+ * parts come from flags. A meshletSlot of -1 draws an
+ * import whole; otherwise only the clusters the drawn
+ * packet's meshlet culler kept for that slot are drawn.
+ ***********************************************************/
+void SceneManager::DrawMesh(const EntityStore::MESH_REF& mesh, uint8_t flags, int level, int meshletSlot)
+{
+    bool bDrawTop = (flags & EntityStore::FLAG_DRAW_TOP) != 0;
+    bool bDrawBottom = (flags & EntityStore::FLAG_DRAW_BOTTOM) != 0;
+    bool bDrawSides = (flags & EntityStore::FLAG_DRAW_SIDES) != 0;
+
+    MeshLibrary::LOD_SHAPE shape;
+    if (level >= 0 && GetLODShape((MESH_TYPE)mesh.mesh, shape))
+    {
+        m_pMeshLibrary->DrawLODMesh(shape, level, bDrawTop, bDrawBottom, bDrawSides);
+        return;
+    }
+
+    switch (mesh.mesh)
+    {
+    case MESH_PLANE:
+        m_basicMeshes->DrawPlaneMesh();
+        break;
+    case MESH_BOX:
+        m_basicMeshes->DrawBoxMesh();
+        break;
+    case MESH_CYLINDER:
+        m_basicMeshes->DrawCylinderMesh(bDrawTop, bDrawBottom, bDrawSides);
+        break;
+    case MESH_TAPERED_CYLINDER:
+        m_basicMeshes->DrawTaperedCylinderMesh(bDrawTop, bDrawBottom, bDrawSides);
+        break;
+    case MESH_TORUS:
+        m_basicMeshes->DrawTorusMesh();
+        break;
+    case MESH_SPHERE:
+        m_basicMeshes->DrawSphereMesh();
+        break;
+    case MESH_IMPORTED:
+        m_pMeshLibrary->DrawImportedMesh(mesh.importedMesh,
+                                         meshletSlot >= 0 ? m_pDrawPacket->pMeshletCuller : nullptr, meshletSlot);
+        break;
+    }
 }
 
 /***********************************************************
- * FindMaterial()
- * Searches the material list by tag and fills in the output
- * struct if found. Returns true on success, false if the
- * tag doesn't exist.
+ * DrawPrefabs()
+ * Parts are the outer loop and placements the inner one, so
+ * a part's surface is pushed once for all of a prefab's
+ * placements and only the model matrix changes in between.
+ * A mirrored placement flips the winding of every part.
+ * Parts always draw their full-detail buffer meshes: no LOD,
+ * procedural shapes or meshlet culling.
  ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+void SceneManager::DrawPrefabs(ShaderManager* pShader, bool bShade)
 {
-    for (auto& mat : m_objectMaterials)
+    const glm::mat4* transforms = m_entities.GetTransforms();
+    const EntityStore::MESH_REF* meshes = m_entities.GetMeshes();
+    const std::vector<size_t>& prefabDraws = m_pDrawPacket->prefabDraws;
+    size_t first = 0;
+    while (first < prefabDraws.size())
     {
-        if (mat.tag == tag)
+        int prefab = meshes[prefabDraws[first]].prefab;
+        size_t last = first + 1;
+        while (last < prefabDraws.size() && meshes[prefabDraws[last]].prefab == prefab)
+            last++;
+
+        const PREFAB_RECORD& record = m_prefabs[prefab];
+        for (int partIndex = record.firstPart; partIndex < record.firstPart + record.partCount; partIndex++)
         {
-            material = mat;
-            return true;
+            const PREFAB_PART& part = m_prefabParts[partIndex];
+            glm::mat4 partModel = part.local;
+            if (part.mesh.mesh == MESH_IMPORTED)
+                partModel = partModel * glm::scale(glm::vec3(m_pMeshLibrary->GetImportedPositionScale(part.mesh.importedMesh)));
+            if (bShade)
+                SetSurfaceState(pShader, part.texture, part.surface, part.material);
+
+            for (size_t draw = first; draw < last; draw++)
+            {
+                size_t i = prefabDraws[draw];
+                CULL_MODE cullMode = (CULL_MODE)part.mesh.cullMode;
+                if (cullMode != CULL_NONE && meshes[i].cullMode == CULL_BACK_MIRRORED)
+                    cullMode = (cullMode == CULL_BACK) ? CULL_BACK_MIRRORED : CULL_BACK;
+                ApplyCullMode(cullMode);
+                m_pStateCache->SetMat4Value(pShader, g_ModelName, transforms[i] * partModel);
+                DrawMesh(part.mesh, part.flags, -1, -1);
+                m_frameStats.drawCalls++;
+            }
         }
+        first = last;
     }
-    return false;
 }
 
 /***********************************************************
- * SetTransformations()
- * Builds the model matrix from scale, rotation (XYZ order),
- * and translation, then pushes it to the shader.
- * Call this before every draw call to position the mesh.
+ * GetDrawModel()
+ * Packed LOD and imported meshes store positions divided by
+ * a per-mesh scale; putting it back here keeps the occlusion
+ * bounds and LOD selection working on the plain entity
+ * transform.
+ ***********************************************************/
+glm::mat4 SceneManager::GetDrawModel(size_t index) const
+{
+    const EntityStore::MESH_REF& mesh = m_entities.GetMeshes()[index];
+    const glm::mat4& model = m_entities.GetTransforms()[index];
+    int level = m_pDrawPacket->drawLevels[index];
+
+    float scale = 1.0f;
+    MeshLibrary::LOD_SHAPE shape;
+    if (mesh.mesh == MESH_IMPORTED)
+        scale = m_pMeshLibrary->GetImportedPositionScale(mesh.importedMesh);
+    else if (level >= 0 && GetLODShape((MESH_TYPE)mesh.mesh, shape))
+        scale = m_pMeshLibrary->GetPositionScale(shape, level);
+
+    if (scale == 1.0f)
+        return model;
+    return model * glm::scale(glm::vec3(scale));
+}
+
+/***********************************************************
+ * SetRenderSettings()
+ * Hooks up the runtime toggles owned by main.
  ***********************************************************/
-void SceneManager::SetTransformations(
-    glm::vec3 scaleXYZ,
-    float XrotationDegrees,
-    float YrotationDegrees,
-    float ZrotationDegrees,
-    glm::vec3 positionXYZ)
+void SceneManager::SetRenderSettings(RENDER_SETTINGS* pRenderSettings)
 {
-    // TRS order: translate * rotateZ * rotateY * rotateX * scale
-    glm::mat4 modelView = glm::translate(positionXYZ)
-                        * glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0,0,1))
-                        * glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0,1,0))
-                        * glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1,0,0))
-                        * glm::scale(scaleXYZ);
+    m_pRenderSettings = pRenderSettings;
+}
 
-    if (m_pShaderManager != nullptr)
-        m_pShaderManager->setMat4Value(g_ModelName, modelView);
+/***********************************************************
+ * SetViewMatrices()
+ * Stores this frame's camera for the next packet, which is
+ * culled and later drawn with it.
+ ***********************************************************/
+void SceneManager::SetViewMatrices(const glm::mat4& view, const glm::mat4& projection)
+{
+    m_viewMatrix = view;
+    m_projectionMatrix = projection;
 }
 
 /***********************************************************
- * SetShaderColor()
- * Switches the shader to flat-color mode and sets the RGBA
- * color for the next draw call. Disables texture sampling.
+ * SetSimulationTime()
  ***********************************************************/
-void SceneManager::SetShaderColor(
-    float redColorValue,
-    float greenColorValue,
-    float blueColorValue,
-    float alphaValue)
+void SceneManager::SetSimulationTime(double seconds)
 {
-    glm::vec4 color(redColorValue, greenColorValue, blueColorValue, alphaValue);
+    m_simulationSeconds = seconds;
+}
 
-    if (m_pShaderManager != nullptr)
+/***********************************************************
+ * PickEntity()
+ * The ray runs from the near plane to the far plane through
+ * the screen point, so it works the same for perspective and
+ * orthographic views. The BVH only hands over entities whose
+ * bounds the ray enters, nearest first, and stops looking
+ * once the rest start past the closest surface hit.
+ ***********************************************************/
+bool SceneManager::PickEntity(const glm::vec2& screenPoint, PICK_RESULT& result) const
+{
+    glm::mat4 toWorld = glm::inverse(m_projectionMatrix * m_viewMatrix);
+    glm::vec4 nearPoint = toWorld * glm::vec4(screenPoint, -1.0f, 1.0f);
+    glm::vec4 farPoint = toWorld * glm::vec4(screenPoint, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 toFar = glm::vec3(farPoint) / farPoint.w - origin;
+    float length = glm::length(toFar);
+    if (!(length > 0.0f))
+        return false;
+    glm::vec3 direction = toFar / length;
+
+    float distance;
+    int hit = m_pSceneBVH->CastRay(origin, direction, length, [this, &origin, &direction](int index, float& itemDistance)
     {
-        m_pShaderManager->setIntValue(g_UseTextureName, false);
-        m_pShaderManager->setVec4Value(g_ColorValueName, color);
-    }
+        return IntersectEntity((size_t)index, origin, direction, itemDistance);
+    }, distance);
+    if (hit < 0)
+        return false;
+
+    result.entity = m_entities.GetEntity((size_t)hit);
+    result.point = origin + direction * distance;
+    result.distance = distance;
+    return true;
 }
 
 /***********************************************************
- * SetShaderTexture()
- * Switches the shader to texture mode and tells it which
- * texture slot to sample from, looked up by tag name.
+ * IntersectEntity()
+ * The ray goes into object space, where every shape is the
+ * unit version ShapeRaycast knows; imported meshes are
+ * tested against their bounds. A prefab placement carries
+ * the ray on into each part and is hit where its nearest
+ * part is. Hidden entities can't be picked.
  ***********************************************************/
-void SceneManager::SetShaderTexture(std::string textureTag)
+bool SceneManager::IntersectEntity(size_t index, const glm::vec3& origin, const glm::vec3& direction, float& distance) const
 {
-    if (m_pShaderManager != nullptr)
+    uint8_t flags = m_entities.GetFlags()[index];
+    if (flags & EntityStore::FLAG_HIDDEN)
+        return false;
+
+    const EntityStore::MESH_REF& mesh = m_entities.GetMeshes()[index];
+    glm::mat4 toObject = glm::inverse(m_entities.GetTransforms()[index]);
+    glm::vec3 localOrigin = glm::vec3(toObject * glm::vec4(origin, 1.0f));
+    glm::vec3 localDirection = glm::vec3(toObject * glm::vec4(direction, 0.0f));
+    if (mesh.mesh != MESH_PREFAB)
+        return IntersectMesh(mesh, flags, localOrigin, localDirection, distance);
+
+    const PREFAB_RECORD& prefab = m_prefabs[mesh.prefab];
+    bool bHit = false;
+    for (int partIndex = prefab.firstPart; partIndex < prefab.firstPart + prefab.partCount; partIndex++)
     {
-        m_pShaderManager->setIntValue(g_UseTextureName, true);
-        int textureID = FindTextureSlot(textureTag);
-        m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
+        const PREFAB_PART& part = m_prefabParts[partIndex];
+        glm::vec3 partOrigin = glm::vec3(part.toPart * glm::vec4(localOrigin, 1.0f));
+        glm::vec3 partDirection = glm::vec3(part.toPart * glm::vec4(localDirection, 0.0f));
+        if (IntersectMesh(part.mesh, part.flags, partOrigin, partDirection, distance))
+            bHit = true;
     }
+    return bHit;
 }
 
 /***********************************************************
- * SetTextureUVScale()
- * Sets how many times the texture tiles across a surface.
- * Bump up U or V to make the texture repeat more often.
+ * IntersectMesh()
  ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
+bool SceneManager::IntersectMesh(const EntityStore::MESH_REF& mesh, uint8_t flags, const glm::vec3& localOrigin,
+                                 const glm::vec3& localDirection, float& distance) const
 {
-    if (m_pShaderManager != nullptr)
+    bool bTop = (flags & EntityStore::FLAG_DRAW_TOP) != 0;
+    bool bBottom = (flags & EntityStore::FLAG_DRAW_BOTTOM) != 0;
+    bool bSides = (flags & EntityStore::FLAG_DRAW_SIDES) != 0;
+
+    switch (mesh.mesh)
     {
-        m_pShaderManager->setVec2Value("UVscale", glm::vec2(u,v));
+    case MESH_PLANE:
+        return ShapeRaycast::IntersectPlane(localOrigin, localDirection, distance);
+    case MESH_BOX:
+        return ShapeRaycast::IntersectBox(localOrigin, localDirection, glm::vec3(-0.5f), glm::vec3(0.5f), distance);
+    case MESH_CYLINDER:
+        return ShapeRaycast::IntersectCylinder(localOrigin, localDirection, 1.0f, bTop, bBottom, bSides, distance);
+    case MESH_TAPERED_CYLINDER:
+        return ShapeRaycast::IntersectCylinder(localOrigin, localDirection, MeshLibrary::TAPERED_TOP_RADIUS,
+                                               bTop, bBottom, bSides, distance);
+    case MESH_TORUS:
+        return ShapeRaycast::IntersectTorus(localOrigin, localDirection, MeshLibrary::TORUS_TUBE_RADIUS, distance);
+    case MESH_SPHERE:
+        return ShapeRaycast::IntersectSphere(localOrigin, localDirection, distance);
+    case MESH_IMPORTED:
+    default:
+    {
+        float boundsMin[3];
+        float boundsMax[3];
+        m_pMeshLibrary->GetImportedBounds(mesh.importedMesh, boundsMin, boundsMax);
+        return ShapeRaycast::IntersectBox(localOrigin, localDirection,
+                                          glm::vec3(boundsMin[0], boundsMin[1], boundsMin[2]),
+                                          glm::vec3(boundsMax[0], boundsMax[1], boundsMax[2]), distance);
+    }
     }
 }
 
 /***********************************************************
- * SetShaderMaterial()
- * Looks up a material by tag and pushes its diffuse color,
- * specular color, and shininess to the shader for Phong
- * lighting calculations.
+ * SelectEntityAt()
  ***********************************************************/
-void SceneManager::SetShaderMaterial(std::string materialTag)
+void SceneManager::SelectEntityAt(const glm::vec2& screenPoint)
 {
-    OBJECT_MATERIAL material;
-    if (FindMaterial(materialTag, material))
+    auto startTime = std::chrono::steady_clock::now();
+    PICK_RESULT pick;
+    bool bHit = PickEntity(screenPoint, pick);
+    double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (!bHit)
     {
-        m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-        m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-        m_pShaderManager->setFloatValue("material.shininess", material.shininess);
+        m_selectedEntity = EntityStore::NO_ENTITY;
+        std::cout << "INFO: Picked nothing (" << microseconds << " us over " << m_entities.GetCount()
+                  << " entities)" << std::endl;
+        return;
     }
+
+    m_selectedEntity = pick.entity;
+    size_t index = (size_t)m_entities.GetIndex(pick.entity);
+    std::cout << "INFO: Picked entity " << pick.entity.slot << ":" << pick.entity.generation << " ("
+              << MESH_NAMES[m_entities.GetMeshes()[index].mesh] << ") at (" << pick.point.x << ", "
+              << pick.point.y << ", " << pick.point.z << "), " << pick.distance << " units away, in "
+              << microseconds << " us over " << m_entities.GetCount() << " entities" << std::endl;
+}
+
+/***********************************************************
+ * SetDepthShader()
+ * Hooks up the depth-only shader. Without one the pre-pass
+ * toggle has no effect.
+ ***********************************************************/
+void SceneManager::SetDepthShader(ShaderManager* pDepthShaderManager)
+{
+    m_pDepthShaderManager = pDepthShaderManager;
+}
+
+/***********************************************************
+ * SetStateCache()
+ * Hooks up the GL state filter shared with main and the
+ * view manager, and hands it to the overdraw view.
+ ***********************************************************/
+void SceneManager::SetStateCache(GLStateCache* pStateCache)
+{
+    m_pStateCache = pStateCache;
+    m_pOverdrawVisualizer->SetStateCache(pStateCache);
 }
 
 /***********************************************************
@@ -445,57 +2245,61 @@ void SceneManager::DefineObjectMaterials()
  *   Point 1     — cool blue sky fill lifting shadow areas
  *   Point 2     — warm bounce off the counter surface
  *   Point 3     — soft overhead fill so tops aren't pitch dark
+ *
+ * Leaves pShader bound.
  ***********************************************************/
-void SceneManager::SetupSceneLights()
+void SceneManager::SetupSceneLights(ShaderManager* pShader)
 {
+    m_pStateCache->UseProgram(pShader);
+
     // Turn on Phong shading in the fragment shader
-    m_pShaderManager->setBoolValue(g_UseLightingName, true);
+    m_pStateCache->SetBoolValue(pShader, g_UseLightingName, true);
 
     // --- Directional light (sun through front-left window) ---
     // Ray travels: right (+X), slightly down (-Y), slightly into scene (-Z).
     // Left-facing surfaces get bright, right-facing surfaces get shadow — matches photo.
-    m_pShaderManager->setBoolValue("directionalLight.bActive", true);
-    m_pShaderManager->setVec3Value("directionalLight.direction", 1.0f, -0.55f, -0.40f);
-    m_pShaderManager->setVec3Value("directionalLight.ambient",  0.07f, 0.06f, 0.06f); // reduced — less ambient wash on back wall
-    m_pShaderManager->setVec3Value("directionalLight.diffuse",  0.24f, 0.23f, 0.22f); // trimmed further to dim back wall
-    m_pShaderManager->setVec3Value("directionalLight.specular", 0.10f, 0.10f, 0.10f); // soft highlights
+    m_pStateCache->SetBoolValue(pShader, "directionalLight.bActive", true);
+    m_pStateCache->SetVec3Value(pShader, "directionalLight.direction", 1.0f, -0.55f, -0.40f);
+    m_pStateCache->SetVec3Value(pShader, "directionalLight.ambient",  0.07f, 0.06f, 0.06f); // reduced — less ambient wash on back wall
+    m_pStateCache->SetVec3Value(pShader, "directionalLight.diffuse",  0.24f, 0.23f, 0.22f); // trimmed further to dim back wall
+    m_pStateCache->SetVec3Value(pShader, "directionalLight.specular", 0.10f, 0.10f, 0.10f); // soft highlights
 
     // --- Point light 0 — front-left key light (warm window glow) ---
     // Far left and in front — drives specular highlights on the table top and mug
-    m_pShaderManager->setBoolValue("pointLights[0].bActive",  true);
-    m_pShaderManager->setVec3Value("pointLights[0].position", -14.0f, 9.0f, 18.0f);
-    m_pShaderManager->setVec3Value("pointLights[0].ambient",  0.08f, 0.07f, 0.07f); // raised — more front fill
-    m_pShaderManager->setVec3Value("pointLights[0].diffuse",  0.50f, 0.48f, 0.46f); // doubled — brighter front scene
-    m_pShaderManager->setVec3Value("pointLights[0].specular", 0.14f, 0.13f, 0.12f); // stronger highlights
+    m_pStateCache->SetBoolValue(pShader, "pointLights[0].bActive",  true);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[0].position", -14.0f, 9.0f, 18.0f);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[0].ambient",  0.08f, 0.07f, 0.07f); // raised — more front fill
+    m_pStateCache->SetVec3Value(pShader, "pointLights[0].diffuse",  0.50f, 0.48f, 0.46f); // doubled — brighter front scene
+    m_pStateCache->SetVec3Value(pShader, "pointLights[0].specular", 0.14f, 0.13f, 0.12f); // stronger highlights
 
     // --- Point light 1 — cool sky fill (~7000 K) ---
     // Simulates scattered blue-sky light lifting the shadow sides of objects
-    m_pShaderManager->setBoolValue("pointLights[1].bActive",  true);
-    m_pShaderManager->setVec3Value("pointLights[1].position", -8.0f, 16.0f, 6.0f);
-    m_pShaderManager->setVec3Value("pointLights[1].ambient",  0.05f, 0.06f, 0.08f);
-    m_pShaderManager->setVec3Value("pointLights[1].diffuse",  0.18f, 0.21f, 0.26f); // cool blue tint
-    m_pShaderManager->setVec3Value("pointLights[1].specular", 0.05f, 0.06f, 0.08f);
+    m_pStateCache->SetBoolValue(pShader, "pointLights[1].bActive",  true);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[1].position", -8.0f, 16.0f, 6.0f);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[1].ambient",  0.05f, 0.06f, 0.08f);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[1].diffuse",  0.18f, 0.21f, 0.26f); // cool blue tint
+    m_pStateCache->SetVec3Value(pShader, "pointLights[1].specular", 0.05f, 0.06f, 0.08f);
 
     // --- Point light 2 — warm counter bounce (front, low) ---
     // Mimics light bouncing off the pale counter toward the camera side of objects
-    m_pShaderManager->setBoolValue("pointLights[2].bActive",  true);
-    m_pShaderManager->setVec3Value("pointLights[2].position", 0.0f, 3.0f, 14.0f);
-    m_pShaderManager->setVec3Value("pointLights[2].ambient",  0.07f, 0.07f, 0.06f); // raised — lifts front shadows
-    m_pShaderManager->setVec3Value("pointLights[2].diffuse",  0.38f, 0.37f, 0.35f); // more than doubled — fills front faces
-    m_pShaderManager->setVec3Value("pointLights[2].specular", 0.12f, 0.12f, 0.11f); // brighter gloss on counter/mug
+    m_pStateCache->SetBoolValue(pShader, "pointLights[2].bActive",  true);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[2].position", 0.0f, 3.0f, 14.0f);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[2].ambient",  0.07f, 0.07f, 0.06f); // raised — lifts front shadows
+    m_pStateCache->SetVec3Value(pShader, "pointLights[2].diffuse",  0.38f, 0.37f, 0.35f); // more than doubled — fills front faces
+    m_pStateCache->SetVec3Value(pShader, "pointLights[2].specular", 0.12f, 0.12f, 0.11f); // brighter gloss on counter/mug
 
     // --- Point light 3 — soft overhead fill (ceiling bounce) ---
     // Keeps the tops of objects from going completely dark
     // Diffuse pulled way back so the overhead angle doesn't over-brighten the back wall
-    m_pShaderManager->setBoolValue("pointLights[3].bActive",  true);
-    m_pShaderManager->setVec3Value("pointLights[3].position", -2.0f, 18.0f, 2.0f);
-    m_pShaderManager->setVec3Value("pointLights[3].ambient",  0.05f, 0.05f, 0.05f); // reduced from 0.12
-    m_pShaderManager->setVec3Value("pointLights[3].diffuse",  0.18f, 0.18f, 0.18f); // reduced from 0.45
-    m_pShaderManager->setVec3Value("pointLights[3].specular", 0.04f, 0.04f, 0.04f); // reduced from 0.08
+    m_pStateCache->SetBoolValue(pShader, "pointLights[3].bActive",  true);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[3].position", -2.0f, 18.0f, 2.0f);
+    m_pStateCache->SetVec3Value(pShader, "pointLights[3].ambient",  0.05f, 0.05f, 0.05f); // reduced from 0.12
+    m_pStateCache->SetVec3Value(pShader, "pointLights[3].diffuse",  0.18f, 0.18f, 0.18f); // reduced from 0.45
+    m_pStateCache->SetVec3Value(pShader, "pointLights[3].specular", 0.04f, 0.04f, 0.04f); // reduced from 0.08
 
     // Turn off lights we're not using
-    m_pShaderManager->setBoolValue("pointLights[4].bActive", false);
-    m_pShaderManager->setBoolValue("spotLight.bActive",      false);
+    m_pStateCache->SetBoolValue(pShader, "pointLights[4].bActive", false);
+    m_pStateCache->SetBoolValue(pShader, "spotLight.bActive",      false);
 }
 
 /***********************************************************
@@ -515,6 +2319,18 @@ void SceneManager::PrepareScene()
     m_basicMeshes->LoadCylinderMesh();        // mug body, pot rim, wire legs
     m_basicMeshes->LoadTorusMesh();           // mug handle
     m_basicMeshes->LoadSphereMesh();          // foliage clusters, wire arch tops
+
+    // Lower-detail versions of the curved shapes for small/distant draws
+    m_pMeshLibrary->LoadLODMeshes();
+
+    // Debug heatmap shaders — the scene still renders without them
+    m_bOverdrawShadersLoaded = m_pOverdrawVisualizer->LoadShaders();
+    // Same for the vertex-pulling programs
+    m_bProceduralShadersLoaded = m_pProceduralMeshes->LoadShaders();
+    // And for the instanced plant programs
+    m_bPlantShadersLoaded = m_pPlantRenderer->LoadShaders();
+    // linking may have changed the bound program behind the cache's back
+    m_pStateCache->Invalidate();
 }
 
 /***********************************************************
@@ -542,953 +2358,748 @@ void SceneManager::LoadSceneTextures()
 /***********************************************************
  * RenderScene()
  * Draws the full kitchen counter scene every frame.
- * Scene layout:
+ * Scene layout (see scenes/kitchen.scene):
  *   Upper counter — gray flower pot with bonsai tree
  *   Lower shelf   — candle mug, coasters in wire holder,
  *                   wooden napkin holder
+ *
+ * The draw list is built once from the scene file and kept
+ * until the file changes, so a frame only culls and submits,
+ * and the culling runs on the worker pool a frame ahead.
  ***********************************************************/
 void SceneManager::RenderScene()
 {
-    // Set up all lights before drawing anything
-    SetupSceneLights();
-
-    // Disable backface culling for the whole scene so open-ended
-    // cylinders and tapered shapes don't have missing faces
-    GLboolean cullEnabled = glIsEnabled(GL_CULL_FACE);
-    glDisable(GL_CULL_FACE);
-
-    // Reusable transform variables — set these before every draw call
-    glm::vec3 scaleXYZ;
-    float XrotationDegrees = 0.0f;
-    float YrotationDegrees = 0.0f;
-    float ZrotationDegrees = 0.0f;
-    glm::vec3 positionXYZ;
-
-    // Y heights for the two shelf levels — everything derives from these two values
-    const float upperTableY = 1.0f;   // top surface of the upper counter
-    const float lowerShelfY = -0.5f;  // top surface of the lower shelf
-
-    /******************************************************************/
-    //  BACKGROUND — drawn first so everything else renders on top
-    //
-    //  Mirrors the reference photo:
-    //    - Cream back wall spanning the full width
-    //    - Tall pantry cabinet column on the left
-    //    - Two upper cabinet doors centered above the fridge
-    //    - Whirlpool French-door fridge in the center
-    //    - Plain wall section on the right with light-switch plate
-    //    - Dark hardwood floor strip at the base
-    /******************************************************************/
-    {
-        const float bgZ    = -11.0f;
-        const float floorY = -4.0f;
-        const float ceilY  = 16.0f;
-        const float wallH  = ceilY - floorY;
-        const float wallW  = 60.0f;
-        const float cabZ   = bgZ + 0.35f;
-
-        // Back wall
-        scaleXYZ    = glm::vec3(wallW, wallH, 0.3f);
-        positionXYZ = glm::vec3(0.0f, floorY + wallH * 0.5f, bgZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderTexture("wall");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("wall");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Dark hardwood floor strip
-        scaleXYZ    = glm::vec3(wallW, 0.3f, 6.0f);
-        positionXYZ = glm::vec3(0.0f, floorY + 0.15f, bgZ + 3.0f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.16f, 0.11f, 0.07f, 1.0f);
-        SetShaderMaterial("bark");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Ceiling strip
-        scaleXYZ    = glm::vec3(wallW, 1.5f, 4.0f);
-        positionXYZ = glm::vec3(0.0f, ceilY - 0.75f, bgZ + 2.0f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderTexture("wall");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("wall");
-        m_basicMeshes->DrawBoxMesh();
-
-        // ── LEFT PANTRY CABINET COLUMN ────────────────────────────────
-        const float cabW = 5.5f;
-        const float cabX = -9.5f;
+    // Set up all lights before drawing anything; the procedural and
+    // plant programs keep their own copies of the light uniforms
+    if (m_bProceduralShadersLoaded)
+        SetupSceneLights(m_pProceduralMeshes->GetPhongShader());
+    if (m_bPlantShadersLoaded)
+        SetupSceneLights(m_pPlantRenderer->GetPhongShader());
+    SetupSceneLights(m_pShaderManager);
+
+    // Pick up edits to the scene file, then anything that moved, once
+    // the workers are done reading last frame's entities
+    FinishFramePacket();
+    UpdateSceneFile();
+    UpdateSceneGraph();
+
+    // Start culling this frame and issue last frame's list to OpenGL
+    SubmitDrawList();
+}
 
-        // Upper pantry body
-        scaleXYZ    = glm::vec3(cabW, 7.5f, 0.7f);
-        positionXYZ = glm::vec3(cabX, 8.5f, cabZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.78f, 0.78f, 0.77f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
+/***********************************************************
+ * UpdateSceneFile()
+ * Loads the scene on the first frame, then compares the
+ * file's stamp every SCENE_FILE_CHECK_FRAMES frames and
+ * reloads it when it has changed. The compiled scene is
+ * used whenever it matches the text file's stamp. A failed
+ * load is only retried once the file changes again.
+ ***********************************************************/
+void SceneManager::UpdateSceneFile()
+{
+    if (m_bStressScene)
+        return;
+    if (m_bSceneFileChecked && ++m_sceneFileFrame < SCENE_FILE_CHECK_FRAMES)
+        return;
+    m_sceneFileFrame = 0;
+
+    long long modifiedTime = -1;
+    long long size = -1;
+    SceneFile::GetFileStamp(SCENE_FILE_PATH, modifiedTime, size);
+    if (m_bSceneFileChecked && modifiedTime == m_sceneFileTime && size == m_sceneFileSize)
+        return;
+
+    bool bReload = m_bSceneFileChecked;
+    m_bSceneFileChecked = true;
+    m_sceneFileTime = modifiedTime;
+    m_sceneFileSize = size;
+
+    bool bLoaded = LoadSceneBinary() || LoadSceneFile();
+    if (!bLoaded && bReload)
+        std::cout << "INFO: Keeping the previous scene until " << SCENE_FILE_PATH << " is fixed" << std::endl;
+}
 
-        // Lower pantry body
-        scaleXYZ    = glm::vec3(cabW, 7.0f, 0.7f);
-        positionXYZ = glm::vec3(cabX, 0.5f, cabZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.78f, 0.78f, 0.77f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
+/***********************************************************
+ * LoadSceneFile()
+ ***********************************************************/
+bool SceneManager::LoadSceneFile()
+{
+    auto startTime = std::chrono::steady_clock::now();
 
-        // Upper door inset panel
-        scaleXYZ    = glm::vec3(cabW * 0.80f, 6.8f, 0.12f);
-        positionXYZ = glm::vec3(cabX, 8.5f, cabZ + 0.41f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.72f, 0.72f, 0.71f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
+    std::vector<SceneFile::SCENE_OBJECT> objects;
+    if (!SceneFile::Load(SCENE_FILE_PATH, objects) || !BuildScene(objects))
+        return false;
 
-        // Lower door inset panel
-        scaleXYZ    = glm::vec3(cabW * 0.80f, 6.3f, 0.12f);
-        positionXYZ = glm::vec3(cabX, 0.5f, cabZ + 0.41f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.72f, 0.72f, 0.71f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "INFO: Loaded " << SCENE_FILE_PATH << " (" << objects.size() << " objects, "
+              << m_entities.GetCount() << " entities) in " << milliseconds << " ms" << std::endl;
+    for (const PREFAB_RECORD& prefab : m_prefabs)
+    {
+        std::cout << "INFO: Prefab " << prefab.name << " shares " << prefab.partCount << " parts between "
+                  << prefab.placements << " placement" << (prefab.placements == 1 ? "" : "s") << std::endl;
+    }
+    return true;
+}
 
-        // Mid-rail between upper/lower pantry doors
-        scaleXYZ    = glm::vec3(cabW, 0.25f, 0.75f);
-        positionXYZ = glm::vec3(cabX, 4.2f, cabZ + 0.05f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.78f, 0.78f, 0.77f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
+/***********************************************************
+ * LoadStressScene()
+ * Replaces the entities like a file load does, so it waits
+ * for the packet the workers are building first. The copies
+ * go through BuildScene(), with the same checks.
+ ***********************************************************/
+bool SceneManager::LoadStressScene(size_t count)
+{
+    FinishFramePacket();
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<SceneFile::SCENE_OBJECT> kitchen;
+    if (!SceneFile::Load(SCENE_FILE_PATH, kitchen))
+        return false;
+    std::vector<SceneFile::SCENE_OBJECT> objects;
+    SceneFile::Replicate(kitchen, count, STRESS_SPACING, STRESS_POSITION_JITTER, STRESS_YAW_JITTER, objects);
+    if (!BuildScene(objects))
+        return false;
+    m_bStressScene = true;
+    // prefab definitions are shared, not copied
+    size_t perCopy = (size_t)std::count_if(kitchen.begin(), kitchen.end(), [](const SceneFile::SCENE_OBJECT& object)
+    {
+        return object.definition < 0;
+    });
+
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "INFO: Loaded a stress scene of " << count << " objects ("
+              << (count + perCopy - 1) / std::max<size_t>(perCopy, 1) << " copies of " << SCENE_FILE_PATH << ", "
+              << m_entities.GetCount() << " entities, " << m_plants.size() << " plants) in "
+              << milliseconds << " ms" << std::endl;
+    return true;
+}
 
-        // Handles — upper and lower pantry doors
-        for (int d = 0; d < 2; d++)
+/***********************************************************
+ * BuildScene()
+ * Checks texture and material tags and plant presets, then
+ * builds the scene graph, the prefabs, and one entity per
+ * drawn object or prefab placement in order. Prefab parts
+ * get no entities of their own. Nothing can fail once the
+ * checks pass, so the entities are rebuilt in place. Props
+ * are imported the first time an object asks for them.
+ ***********************************************************/
+bool SceneManager::BuildScene(const std::vector<SceneFile::SCENE_OBJECT>& objects)
+{
+    int errors = 0;
+    for (const SceneFile::SCENE_OBJECT& object : objects)
+    {
+        if (!object.textureTag.empty() && FindTextureSlot(object.textureTag) < 0)
         {
-            float handleY = (d == 0) ? 8.5f : 0.5f;
-            scaleXYZ    = glm::vec3(0.12f, 1.2f, 0.12f);
-            positionXYZ = glm::vec3(cabX + 1.8f, handleY, cabZ + 0.54f);
-            SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-            SetShaderColor(0.55f, 0.55f, 0.55f, 1.0f);
-            SetShaderMaterial("metal");
-            m_basicMeshes->DrawCylinderMesh(false, false, true);
+            std::cout << "INFO: " << SCENE_FILE_PATH << ":" << object.line
+                      << ": unknown texture '" << object.textureTag << "'" << std::endl;
+            errors++;
         }
-
-        // ── FRIDGE SURROUND + UPPER CABINET ───────────────────────────
-        const float fridgeW    = 5.2f;
-        const float fridgeX    = -1.0f;
-        const float fridgeBotY = floorY + 0.3f;
-        const float fridgeH    = 13.5f;  // taller fridge (was 10.5)
-        const float fridgeTopY = fridgeBotY + fridgeH;
-
-        // Left surround pilaster
-        scaleXYZ    = glm::vec3(1.2f, fridgeH + 2.3f, 0.9f);  // taller to match fridge + bigger upper cab
-        positionXYZ = glm::vec3(fridgeX - fridgeW * 0.5f - 0.6f,
-                                fridgeBotY + (fridgeH + 2.3f) * 0.5f, cabZ - 0.05f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.78f, 0.78f, 0.77f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Right surround pilaster
-        scaleXYZ    = glm::vec3(1.2f, fridgeH + 2.3f, 0.9f);  // taller to match
-        positionXYZ = glm::vec3(fridgeX + fridgeW * 0.5f + 0.6f,
-                                fridgeBotY + (fridgeH + 2.3f) * 0.5f, cabZ - 0.05f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.78f, 0.78f, 0.77f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Upper cabinet box above fridge
-        const float upCabH = 2.3f;  // matched to reference — ~17% of fridge height (was 5.5)
-        const float upCabY = fridgeTopY + upCabH * 0.5f;
-        scaleXYZ    = glm::vec3(fridgeW + 2.4f, upCabH, 0.85f);
-        positionXYZ = glm::vec3(fridgeX, upCabY, cabZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.78f, 0.78f, 0.77f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Left upper cabinet door inset
-        scaleXYZ    = glm::vec3((fridgeW + 2.4f) * 0.46f, upCabH * 0.82f, 0.12f);
-        positionXYZ = glm::vec3(fridgeX - (fridgeW + 2.4f) * 0.25f, upCabY, cabZ + 0.48f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.72f, 0.72f, 0.71f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Right upper cabinet door inset
-        scaleXYZ    = glm::vec3((fridgeW + 2.4f) * 0.46f, upCabH * 0.82f, 0.12f);
-        positionXYZ = glm::vec3(fridgeX + (fridgeW + 2.4f) * 0.25f, upCabY, cabZ + 0.48f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.72f, 0.72f, 0.71f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Upper cabinet handles
-        for (int d = -1; d <= 1; d += 2)
+        if (!object.materialTag.empty() && FindMaterialIndex(object.materialTag) < 0)
         {
-            scaleXYZ    = glm::vec3(0.1f, 0.9f, 0.1f);
-            positionXYZ = glm::vec3(fridgeX + d * 0.3f, upCabY -.5f , cabZ + 0.61f);
-            SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-            SetShaderColor(0.55f, 0.55f, 0.55f, 1.0f);
-            SetShaderMaterial("metal");
-            m_basicMeshes->DrawCylinderMesh(false, false, true);
+            std::cout << "INFO: " << SCENE_FILE_PATH << ":" << object.line
+                      << ": unknown material '" << object.materialTag << "'" << std::endl;
+            errors++;
         }
-
-        // ── FRIDGE BODY ───────────────────────────────────────────────
-        const float fridgeFaceZ = cabZ + 0.55f;
-        const float fridgeDepth = 1.2f;
-
-        // Main stainless body
-        scaleXYZ    = glm::vec3(fridgeW, fridgeH, fridgeDepth);
-        positionXYZ = glm::vec3(fridgeX, fridgeBotY + fridgeH * 0.5f,
-                                fridgeFaceZ - fridgeDepth * 0.5f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.40f, 0.40f, 0.41f, 1.0f);
-        SetShaderMaterial("stainless");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Vertical door seam
-        scaleXYZ    = glm::vec3(0.06f, fridgeH * 0.72f, fridgeDepth + 0.02f);
-        positionXYZ = glm::vec3(fridgeX,
-                                fridgeBotY + fridgeH * 0.26f + fridgeH * 0.72f * 0.5f,
-                                fridgeFaceZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.22f, 0.22f, 0.23f, 1.0f);
-        SetShaderMaterial("darkMetal");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Horizontal seam (upper doors / freezer drawer)
-        scaleXYZ    = glm::vec3(fridgeW + 0.05f, 0.08f, fridgeDepth + 0.02f);
-        positionXYZ = glm::vec3(fridgeX, fridgeBotY + fridgeH * 0.26f, fridgeFaceZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.20f, 0.20f, 0.21f, 1.0f);
-        SetShaderMaterial("darkMetal");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Left door handle
-        scaleXYZ    = glm::vec3(0.14f, 3.8f, 0.14f);
-        positionXYZ = glm::vec3(fridgeX - 0.55f, fridgeBotY + fridgeH * 0.62f,
-                                fridgeFaceZ + 0.22f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.14f, 0.14f, 0.14f, 1.0f);
-        SetShaderMaterial("fridgeHandle");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Right door handle
-        scaleXYZ    = glm::vec3(0.14f, 3.8f, 0.14f);
-        positionXYZ = glm::vec3(fridgeX + 0.55f, fridgeBotY + fridgeH * 0.62f,
-                                fridgeFaceZ + 0.22f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.14f, 0.14f, 0.14f, 1.0f);
-        SetShaderMaterial("fridgeHandle");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Freezer drawer handle (wide horizontal bar)
-        scaleXYZ    = glm::vec3(fridgeW * 0.65f, 0.18f, 0.18f);
-        positionXYZ = glm::vec3(fridgeX, fridgeBotY + fridgeH * 0.13f,
-                                fridgeFaceZ + 0.22f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.14f, 0.14f, 0.14f, 1.0f);
-        SetShaderMaterial("fridgeHandle");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Fridge feet
-        for (int f = -1; f <= 1; f += 2)
+        PlantGenerator::PLANT_PARAMETERS parameters;
+        if (object.shape == SceneFile::SHAPE_PLANT && !PlantGenerator::GetPreset(object.plant, parameters))
         {
-            scaleXYZ    = glm::vec3(0.25f, 0.28f, 0.25f);
-            positionXYZ = glm::vec3(fridgeX + f * (fridgeW * 0.38f),
-                                    fridgeBotY - 0.14f, fridgeFaceZ - 0.4f);
-            SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-            SetShaderColor(0.10f, 0.10f, 0.10f, 1.0f);
-            SetShaderMaterial("darkMetal");
-            m_basicMeshes->DrawCylinderMesh(true, true, true);
+            std::cout << "INFO: " << SCENE_FILE_PATH << ":" << object.line
+                      << ": unknown plant preset '" << object.plant << "'" << std::endl;
+            errors++;
         }
-
-        // ── RIGHT WALL SECTION ────────────────────────────────────────
-        scaleXYZ    = glm::vec3(8.0f, wallH, 0.3f);
-        positionXYZ = glm::vec3(8.0f, floorY + wallH * 0.5f, bgZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderTexture("wall");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("wall");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Light-switch plate on right wall
-        scaleXYZ    = glm::vec3(0.55f, 0.85f, 0.12f);
-        positionXYZ = glm::vec3(6.8f, 2.8f, bgZ + 0.22f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.80f, 0.80f, 0.79f, 1.0f);
-        SetShaderMaterial("cabinetWhite");
-        m_basicMeshes->DrawBoxMesh();
     }
-    // ── End of background ──────────────────────────────────────────────
-
-    /******************************************************************/
-    //  UPPER COUNTER SLAB
-    //  The raised surface that the flower pot sits on.
-    /******************************************************************/
-    float topThickness = 1.0f; // slab height going upward
-
-    // Top face of the counter slab
-    scaleXYZ    = glm::vec3(20.0f, topThickness, 8.0f);
-    positionXYZ = glm::vec3(0.0f, upperTableY + topThickness * 0.5f, -3.0f);
-    SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-    SetShaderTexture("toptable");
-    SetTextureUVScale(1.0f, 1.0f);
-    SetShaderMaterial("tableTop"); // maximum gloss lacquer look
-    m_basicMeshes->DrawBoxMesh();
-
-    // Vertical front face panel between the upper and lower shelf levels
-    scaleXYZ    = glm::vec3(20.0f, upperTableY - lowerShelfY, 0.8f);
-    positionXYZ = glm::vec3(0.0f, (upperTableY + lowerShelfY) / 2.0f, 0.0f);
-    SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-    SetShaderColor(0.72f, 0.72f, 0.70f, 1.0f);
-    SetShaderMaterial("counter");
-    m_basicMeshes->DrawBoxMesh();
-
-    /******************************************************************/
-    //  LOWER SHELF
-    //  Flat plane where the mug, coasters, and napkin holder sit.
-    /******************************************************************/
-    scaleXYZ    = glm::vec3(20.0f, 1.0f, 6.0f);
-    positionXYZ = glm::vec3(0.0f, lowerShelfY, 3.0f);
-    SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-    SetShaderColor(0.55f, 0.53f, 0.50f, 1.0f);
-    SetShaderTexture("bottomtable");
-    SetTextureUVScale(1.0f, 1.0f);
-    SetShaderMaterial("counter");
-    m_basicMeshes->DrawPlaneMesh();
-
-    /******************************************************************/
-    //  FLOWER POT + BONSAI TREE
-    //  Two-cylinder pot (narrow base + wider upper section) on the
-    //  upper counter. Soil disk on top, then a trunk with branches
-    //  and overlapping sphere clusters for the foliage canopy.
-    /******************************************************************/
-    {
-        float potRadius  = 1.6f;
-        float potCenterX = 0.0f;
-        float potCenterZ = -3.0f;
-        float potBaseY   = upperTableY + topThickness; // pot sits on top of the counter slab
-
-        // --- Bottom cylinder (slightly narrower and shorter) ---
-        float baseH = 1.0f;
-        float baseR = potRadius * 0.92f; // a little narrower than the upper section
-        scaleXYZ    = glm::vec3(baseR, baseH, baseR);
-        positionXYZ = glm::vec3(potCenterX, potBaseY, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderTexture("pot");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("grayMatte");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        // --- Upper cylinder (full width, taller) ---
-        float upperH = 1.8f;
-        scaleXYZ    = glm::vec3(potRadius, upperH, potRadius);
-        positionXYZ = glm::vec3(potCenterX, potBaseY + baseH, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderTexture("pot");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("grayMatte");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        float potTopY = potBaseY + baseH + upperH; // top rim of the pot
-
-        // --- Soil disk visible inside the pot rim ---
-        scaleXYZ    = glm::vec3(potRadius * 0.90f, 0.05f, potRadius * 0.90f);
-        positionXYZ = glm::vec3(potCenterX, potTopY , potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.25f, 0.18f, 0.10f, 1.0f); // dark earthy brown
-        SetShaderMaterial("soil");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        // ═══════════════════════════════════════════════════════════
-        //  S-CURVE TRUNK  — seg1 halved (0.45), segs 2-4 unchanged (0.75)
-        //
-        //  Tip formula: tip = base + h·(-sin Z°, cos Z°)
-        //
-        //  Computed joint positions (all at potCenterZ):
-        //    s0 = ( 0.00, potTopY+0.05)  ← pot rim
-        //    s1 = (+0.15, potTopY+0.47)  h=0.45, Z=-20°  [halved]
-        //    s2 = (+0.34, potTopY+1.19)  h=0.75, Z=-15°  ← LEFT  branch
-        //    s3 = (+0.24, potTopY+1.93)  h=0.75, Z=+8°   ← RIGHT branch
-        //    s4 = (-0.04, potTopY+2.63)  h=0.75, Z=+22°  ← apex / crown
-        //
-        //  Branch tips:
-        //    LEFT : s2, Z=+55°, h=1.4 → (-0.81, potTopY+1.99)  [LOWER]
-        //    RIGHT: s3, Z=-50°, h=1.2 → (+1.16, potTopY+2.70)  [HIGHER]
-        //    CROWN: above s4          → (-0.04, potTopY+3.12)   [TOP]
-        // ═══════════════════════════════════════════════════════════
-
-        SetShaderColor(0.20f, 0.17f, 0.14f, 1.0f);
-        SetShaderMaterial("bark");
-
-        // ── Segment 1  Z=-20°  h=0.45  (halved) ──────────────────────
-        scaleXYZ    = glm::vec3(0.22f, 0.45f, 0.22f);
-        positionXYZ = glm::vec3(potCenterX + 0.00f, potTopY + 0.05f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, -20, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // Joint at s1  (+0.15, potTopY+0.47)
-        scaleXYZ    = glm::vec3(0.21f, 0.21f, 0.21f);
-        positionXYZ = glm::vec3(potCenterX + 0.15f, potTopY + 0.47f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
-
-        // ── Segment 2  Z=-15°  h=0.75 ────────────────────────────────
-        scaleXYZ    = glm::vec3(0.19f, 0.75f, 0.19f);
-        positionXYZ = glm::vec3(potCenterX + 0.15f, potTopY + 0.47f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, -15, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // Joint at s2  (+0.34, potTopY+1.19)  ← LEFT branch exits here
-        scaleXYZ    = glm::vec3(0.19f, 0.19f, 0.19f);
-        positionXYZ = glm::vec3(potCenterX + 0.34f, potTopY + 1.19f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
-
-        // ── Segment 3  Z=+8°  h=0.75 ─────────────────────────────────
-        scaleXYZ    = glm::vec3(0.16f, 0.75f, 0.16f);
-        positionXYZ = glm::vec3(potCenterX + 0.34f, potTopY + 1.19f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, +8, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // Joint at s3  (+0.24, potTopY+1.93)  ← RIGHT branch exits here
-        scaleXYZ    = glm::vec3(0.16f, 0.16f, 0.16f);
-        positionXYZ = glm::vec3(potCenterX + 0.24f, potTopY + 1.93f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
-
-        // ── Segment 4  Z=+22°  h=0.75  (tapers thin) ─────────────────
-        scaleXYZ    = glm::vec3(0.12f, 0.75f, 0.12f);
-        positionXYZ = glm::vec3(potCenterX + 0.24f, potTopY + 1.93f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, +22, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // ── LEFT BRANCH  s1=(+0.15, potTopY+0.47)  Z=+55°  h=1.4 ────
-        // tip = (0.15-1.4·sin55°, potTopY+0.47+1.4·cos55°) = (-1.00, potTopY+1.27)
-        scaleXYZ    = glm::vec3(0.11f, 1.40f, 0.11f);
-        positionXYZ = glm::vec3(potCenterX + 0.15f, potTopY + 0.47f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, +55, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // Left sub-twig — forks at t≈0.6  base=(0.15-0.84·sin55°, potTopY+0.47+0.84·cos55°)=(-0.54, potTopY+0.95)
-        scaleXYZ    = glm::vec3(0.07f, 0.65f, 0.07f);
-        positionXYZ = glm::vec3(potCenterX - 0.54f, potTopY + 0.95f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, +42, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // ── RIGHT BRANCH  s2=(+0.34, potTopY+1.19)  Z=-50°  h=1.2 ───
-        // tip = (0.34+1.2·sin50°, potTopY+1.19+1.2·cos50°) = (+1.26, potTopY+1.96)
-        scaleXYZ    = glm::vec3(0.10f, 1.20f, 0.10f);
-        positionXYZ = glm::vec3(potCenterX + 0.34f, potTopY + 1.19f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, -50, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // Right sub-twig — forks at t≈0.6  base=(0.34+0.72·sin50°, potTopY+1.19+0.72·cos50°)=(+0.89, potTopY+1.65)
-        scaleXYZ    = glm::vec3(0.06f, 0.60f, 0.06f);
-        positionXYZ = glm::vec3(potCenterX + 0.89f, potTopY + 1.65f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, -35, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-        // ═══════════════════════════════════════════════════════════
-        //  LEAF CLUSTERS — branches moved lower
-        //
-        //    CROWN : (-0.04, potTopY+3.12)  [unchanged]
-        //    LEFT  : (-1.00, potTopY+1.27)  [left tip at s1 exit]
-        //    RIGHT : (+1.26, potTopY+1.96)  [right tip at s2 exit]
-        // ═══════════════════════════════════════════════════════════
-        SetShaderMaterial("foliage");
-        float cHr=0.19f, cHg=0.50f, cHb=0.15f;  // highlight
-        float cMr=0.14f, cMg=0.40f, cMb=0.11f;  // mid-tone
-        float cSr=0.09f, cSg=0.28f, cSb=0.08f;  // shadow/inner
-
-        // ──────────────────────────────────────────────────────────
-        //  TOP CROWN  —  8 spheres, noticeably the largest cluster
-        // ──────────────────────────────────────────────────────────
-        float tcX = potCenterX - 0.04f;
-        float tcY = potTopY + 3.12f;
-        float tcZ = potCenterZ;
-
-        // Core (large)
-        scaleXYZ    = glm::vec3(0.65f, 0.55f, 0.62f);
-        positionXYZ = glm::vec3(tcX, tcY, tcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cMr, cMg, cMb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
-
-        // Top lobe
-        scaleXYZ    = glm::vec3(0.48f, 0.42f, 0.46f);
-        positionXYZ = glm::vec3(tcX - 0.08f, tcY + 0.52f, tcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr, cHg, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
-
-        // Right lobe
-        scaleXYZ    = glm::vec3(0.52f, 0.44f, 0.48f);
-        positionXYZ = glm::vec3(tcX + 0.58f, tcY + 0.12f, tcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr, cHg + 0.02f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
-
-        // Left lobe
-        scaleXYZ    = glm::vec3(0.50f, 0.42f, 0.46f);
-        positionXYZ = glm::vec3(tcX - 0.55f, tcY + 0.08f, tcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cMr, cMg + 0.02f, cMb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
-
-        // Front lobe (toward viewer)
-        scaleXYZ    = glm::vec3(0.46f, 0.40f, 0.44f);
-        positionXYZ = glm::vec3(tcX + 0.10f, tcY - 0.06f, tcZ + 0.50f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr + 0.01f, cHg + 0.03f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
-
-        // Back lobe
-        scaleXYZ    = glm::vec3(0.44f, 0.38f, 0.42f);
-        positionXYZ = glm::vec3(tcX + 0.05f, tcY + 0.04f, tcZ - 0.48f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cSr, cSg, cSb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    if (errors > 0)
+        return false;
+
+    SceneGraph graph;
+    BuildSceneGraph(objects, graph);
+    std::vector<int> prefabIndices;
+    BuildPrefabs(objects, graph, prefabIndices);
+
+    // stale handles to the old entities stay stale after Clear()
+    m_entities.Clear();
+    m_entities.Reserve(objects.size());
+    m_nodeEntities.assign(objects.size(), EntityStore::NO_ENTITY);
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        const SceneFile::SCENE_OBJECT& object = objects[i];
+        if (object.shape == SceneFile::SHAPE_GROUP || object.shape == SceneFile::SHAPE_PLANT || object.definition >= 0)
+            continue;
+        if (!object.fallbackProp.empty() && GetPropMesh(object.fallbackProp) >= 0)
+            continue;
+        if (object.shape == SceneFile::SHAPE_IMPORT && GetPropMesh(object.prop) < 0)
+            continue;
+
+        int node = graph.GetNode((int)i);
+        int prefab = (object.shape == SceneFile::SHAPE_INSTANCE) ? prefabIndices[object.prefab] : -1;
+        m_nodeEntities[node] = AddSceneEntity(object, graph.GetWorld(node), prefab);
+    }
 
-        // Lower-inner shadow mass
-        scaleXYZ    = glm::vec3(0.55f, 0.38f, 0.52f);
-        positionXYZ = glm::vec3(tcX + 0.06f, tcY - 0.42f, tcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cSr, cSg + 0.02f, cSb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    m_windNodes.clear();
+    m_windRest.clear();
+    for (const char* name : WIND_NODE_NAMES)
+    {
+        for (size_t i = 0; i < objects.size(); i++)
+        {
+            if (objects[i].name == name)
+            {
+                m_windNodes.push_back(graph.GetNode((int)i));
+                m_windRest.push_back(graph.GetLocal(m_windNodes.back()));
+            }
+        }
+    }
 
-        // Upper-right accent
-        scaleXYZ    = glm::vec3(0.38f, 0.33f, 0.36f);
-        positionXYZ = glm::vec3(tcX + 0.44f, tcY + 0.48f, tcZ + 0.16f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr + 0.02f, cHg + 0.04f, cHb + 0.01f, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    m_sceneGraph = graph;
+    // positions in the store mean different objects now, so packets
+    // culled before this are stale
+    m_lodLevels.clear();
+    m_sceneVersion++;
+    m_pSceneBVH->Build(m_entities.GetBounds(), m_entities.GetCount());
+
+    // Plants are regenerated on every load; it's a millisecond or two
+    // each, and presets may have been retuned since
+    m_pPlantRenderer->Clear();
+    m_plants.clear();
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        const SceneFile::SCENE_OBJECT& object = objects[i];
+        if (object.shape != SceneFile::SHAPE_PLANT)
+            continue;
+
+        PlantGenerator::PLANT_PARAMETERS parameters;
+        PlantGenerator::PLANT_INSTANCES instances;
+        PlantGenerator::GetPreset(object.plant, parameters);
+        PlantGenerator::Generate(parameters, instances);
+
+        PLANT_RECORD plant;
+        plant.plant = m_pPlantRenderer->AddPlant(m_pMeshLibrary, instances);
+        plant.node = m_sceneGraph.GetNode((int)i);
+        plant.replacedNode = (object.replaces >= 0) ? m_sceneGraph.GetNode(object.replaces) : -1;
+        plant.boundsMin = instances.boundsMin;
+        plant.boundsMax = instances.boundsMax;
+        plant.colors[PlantRenderer::PART_BARK] = parameters.barkColor;
+        plant.materialIndices[PlantRenderer::PART_BARK] = FindMaterialIndex(parameters.barkMaterial);
+        for (int band = 0; band < PlantGenerator::LEAF_SHADE_COUNT; band++)
+        {
+            plant.colors[PlantRenderer::PART_LEAVES + band] = parameters.leafColors[band];
+            plant.materialIndices[PlantRenderer::PART_LEAVES + band] = FindMaterialIndex(parameters.leafMaterial);
+        }
+        m_plants.push_back(plant);
+    }
+    if (m_bProceduralPlants)
+        HidePlantReplacements(true);
+    return true;
+}
 
-        // ──────────────────────────────────────────────────────────
-        //  LEFT CLUSTER  —  7 spheres  (LOWER, smaller than crown)
-        //  Branch tip: (-1.00, potTopY+1.27)
-        // ──────────────────────────────────────────────────────────
-        float lcX = potCenterX - 1.00f;
-        float lcY = potTopY + 1.27f;
-        float lcZ = potCenterZ;
-
-        // Core
-        scaleXYZ    = glm::vec3(0.40f, 0.34f, 0.38f);
-        positionXYZ = glm::vec3(lcX, lcY, lcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cMr, cMg, cMb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * LoadSceneBinary()
+ * Maps the compiled scene and hands it to BuildBinaryScene()
+ * if it was compiled from the text file as it is now. A
+ * missing or stale file is quiet; the text file is used.
+ ***********************************************************/
+bool SceneManager::LoadSceneBinary()
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    MappedFile file;
+    SceneBinary::SCENE_VIEW view;
+    if (!SceneBinary::Read(SCENE_BINARY_PATH, file, view))
+        return false;
+    if (view.sourceTime != m_sceneFileTime || view.sourceSize != m_sceneFileSize)
+        return false;
+    if (!BuildBinaryScene(view))
+        return false;
+
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "INFO: Loaded " << SCENE_BINARY_PATH << " (" << view.entityCount << " records, "
+              << m_entities.GetCount() << " entities) in " << milliseconds << " ms" << std::endl;
+    return true;
+}
 
-        // Top
-        scaleXYZ    = glm::vec3(0.30f, 0.26f, 0.28f);
-        positionXYZ = glm::vec3(lcX - 0.05f, lcY + 0.36f, lcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr + 0.01f, cHg + 0.03f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * BuildBinaryScene()
+ * Tags are looked up by name once per tag, and nothing is
+ * touched until they all resolve. Each column is then one
+ * block copy into the store. What's left per entity is
+ * what the compiler can't know: one pass turning tag table
+ * indices into texture slots and material indices (skipped
+ * when they already match), and the prop entities at the
+ * end, where imports take their bounds and cull mode from
+ * the loaded mesh and the alternate that isn't needed is
+ * dropped.
+ ***********************************************************/
+bool SceneManager::BuildBinaryScene(const SceneBinary::SCENE_VIEW& view)
+{
+    std::vector<int> textureSlots(view.textureCount);
+    std::vector<int> materialIndices(view.materialCount);
+    std::vector<int> propMeshes(view.propCount);
+    bool bIdentity = true;
+    int errors = 0;
+    for (uint32_t i = 0; i < view.textureCount; i++)
+    {
+        textureSlots[i] = FindTextureSlot(view.GetTexture(i));
+        bIdentity = bIdentity && textureSlots[i] == (int)i;
+        if (textureSlots[i] < 0)
+        {
+            std::cout << "INFO: " << SCENE_BINARY_PATH << ": unknown texture '" << view.GetTexture(i) << "'" << std::endl;
+            errors++;
+        }
+    }
+    for (uint32_t i = 0; i < view.materialCount; i++)
+    {
+        materialIndices[i] = FindMaterialIndex(view.GetMaterial(i));
+        bIdentity = bIdentity && materialIndices[i] == (int)i;
+        if (materialIndices[i] < 0)
+        {
+            std::cout << "INFO: " << SCENE_BINARY_PATH << ": unknown material '" << view.GetMaterial(i) << "'" << std::endl;
+            errors++;
+        }
+    }
+    if (errors > 0)
+        return false;
+    for (uint32_t i = 0; i < view.propCount; i++)
+        propMeshes[i] = GetPropMesh(view.GetProp(i));
+
+    // stale handles to the old entities stay stale after Clear()
+    m_entities.Clear();
+    m_entities.Append(view.entityCount, view.transforms, view.meshes, view.materials, view.textures,
+                      view.surfaces, view.bounds, view.flags);
+
+    // an index outside its table is read as no tag
+    if (!bIdentity)
+    {
+        int* textures = m_entities.GetTextures();
+        int* materials = m_entities.GetMaterials();
+        for (uint32_t i = 0; i < view.entityCount; i++)
+        {
+            textures[i] = ((uint32_t)textures[i] < view.textureCount) ? textureSlots[textures[i]] : -1;
+            materials[i] = ((uint32_t)materials[i] < view.materialCount) ? materialIndices[materials[i]] : -1;
+        }
+    }
 
-        // Left tip
-        scaleXYZ    = glm::vec3(0.28f, 0.24f, 0.26f);
-        positionXYZ = glm::vec3(lcX - 0.40f, lcY + 0.05f, lcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr, cHg + 0.02f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    // back to front, so an entity Destroy() moves into a hole has
+    // already been dealt with
+    uint32_t firstProp = view.entityCount - view.propRecordCount;
+    for (uint32_t i = view.propRecordCount; i-- > 0;)
+    {
+        const SceneBinary::PROP_RECORD& prop = view.props[i];
+        size_t index = firstProp + i;
+        int mesh = (prop.prop < view.propCount) ? propMeshes[prop.prop] : -1;
+        bool bImport = (prop.kind == SceneBinary::PROP_IMPORT);
+        if (bImport == (mesh < 0))
+        {
+            m_entities.Destroy(m_entities.GetEntity(index));
+            continue;
+        }
+        if (bImport)
+        {
+            m_entities.GetMeshes()[index].importedMesh = mesh;
+            SetEntityTransform(index, m_entities.GetTransforms()[index]);
+        }
+    }
 
-        // Right (toward trunk)
-        scaleXYZ    = glm::vec3(0.26f, 0.22f, 0.24f);
-        positionXYZ = glm::vec3(lcX + 0.36f, lcY + 0.08f, lcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cSr, cSg + 0.02f, cSb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    // positions in the store mean different objects now, so packets
+    // culled before this are stale
+    m_lodLevels.clear();
+    m_sceneVersion++;
+    m_pSceneBVH->Build(m_entities.GetBounds(), m_entities.GetCount());
+    // only flat scenes are compiled, so there's no hierarchy, no
+    // plants and no prefabs
+    m_sceneGraph = SceneGraph();
+    m_pPlantRenderer->Clear();
+    m_plants.clear();
+    m_prefabs.clear();
+    m_prefabParts.clear();
+    m_nodeEntities.clear();
+    m_windNodes.clear();
+    m_windRest.clear();
+    return true;
+}
 
-        // Front
-        scaleXYZ    = glm::vec3(0.30f, 0.25f, 0.28f);
-        positionXYZ = glm::vec3(lcX - 0.08f, lcY + 0.02f, lcZ + 0.36f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr, cHg + 0.01f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * BuildPrefabs()
+ * A prefab line takes no transform, so the graph's world
+ * transform of each part is already its place in prefab
+ * space. Parts follow the same fallback and import rules as
+ * scene objects, and are grouped by cull mode so drawing a
+ * prefab switches face culling as little as possible.
+ ***********************************************************/
+void SceneManager::BuildPrefabs(const std::vector<SceneFile::SCENE_OBJECT>& objects, const SceneGraph& graph,
+                                std::vector<int>& prefabIndices)
+{
+    m_prefabs.clear();
+    m_prefabParts.clear();
+    prefabIndices.assign(objects.size(), -1);
+    // parts in file order, and the prefab each belongs to
+    std::vector<PREFAB_PART> parts;
+    std::vector<int> partPrefabs;
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        if (objects[i].shape != SceneFile::SHAPE_PREFAB)
+            continue;
+        prefabIndices[i] = (int)m_prefabs.size();
+
+        PREFAB_RECORD prefab;
+        prefab.name = objects[i].name;
+        prefab.firstPart = (int)m_prefabParts.size();
+        prefab.partCount = 0;
+        prefab.boundsMin = glm::vec3(0.0f);
+        prefab.boundsMax = glm::vec3(0.0f);
+        prefab.placements = 0;
+        m_prefabs.push_back(prefab);
+    }
 
-        // Lower shadow
-        scaleXYZ    = glm::vec3(0.34f, 0.24f, 0.32f);
-        positionXYZ = glm::vec3(lcX - 0.04f, lcY - 0.28f, lcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cSr, cSg, cSb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        const SceneFile::SCENE_OBJECT& object = objects[i];
+        if (object.definition < 0 || object.shape == SceneFile::SHAPE_PREFAB || object.shape == SceneFile::SHAPE_GROUP)
+            continue;
+        if (!object.fallbackProp.empty() && GetPropMesh(object.fallbackProp) >= 0)
+            continue;
+        if (object.shape == SceneFile::SHAPE_IMPORT && GetPropMesh(object.prop) < 0)
+            continue;
+
+        PREFAB_PART part;
+        part.local = graph.GetWorld(graph.GetNode((int)i));
+        part.toPart = glm::inverse(part.local);
+        part.mesh.mesh = (uint8_t)GetShapeMesh(object.shape);
+        part.mesh.importedMesh = (part.mesh.mesh == MESH_IMPORTED) ? GetPropMesh(object.prop) : -1;
+        part.mesh.prefab = -1;
+        part.material = object.materialTag.empty() ? -1 : FindMaterialIndex(object.materialTag);
+        part.texture = object.textureTag.empty() ? -1 : FindTextureSlot(object.textureTag);
+        part.surface.color = object.color;
+        part.surface.uvScale = object.uvScale;
+        part.flags = (object.bDrawTop ? EntityStore::FLAG_DRAW_TOP : 0)
+                   | (object.bDrawBottom ? EntityStore::FLAG_DRAW_BOTTOM : 0)
+                   | (object.bDrawSides ? EntityStore::FLAG_DRAW_SIDES : 0);
+
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        bool bClosed;
+        if (part.mesh.mesh == MESH_IMPORTED)
+        {
+            float importedMin[3];
+            float importedMax[3];
+            m_pMeshLibrary->GetImportedBounds(part.mesh.importedMesh, importedMin, importedMax);
+            boundsMin = glm::vec3(importedMin[0], importedMin[1], importedMin[2]);
+            boundsMax = glm::vec3(importedMax[0], importedMax[1], importedMax[2]);
+            bClosed = m_pMeshLibrary->IsImportedMeshClosed(part.mesh.importedMesh);
+        }
+        else
+        {
+            GetMeshLocalBounds((MESH_TYPE)part.mesh.mesh, boundsMin, boundsMax);
+            bClosed = IsClosedMesh((MESH_TYPE)part.mesh.mesh, object.bDrawTop, object.bDrawBottom, object.bDrawSides);
+        }
+        part.mesh.cullMode = (uint8_t)SelectCullMode(bClosed, part.local);
+        TransformBounds(part.local, boundsMin, boundsMax);
+
+        PREFAB_RECORD& prefab = m_prefabs[prefabIndices[object.definition]];
+        prefab.boundsMin = (prefab.partCount == 0) ? boundsMin : glm::min(prefab.boundsMin, boundsMin);
+        prefab.boundsMax = (prefab.partCount == 0) ? boundsMax : glm::max(prefab.boundsMax, boundsMax);
+        prefab.partCount++;
+        parts.push_back(part);
+        partPrefabs.push_back(prefabIndices[object.definition]);
+    }
 
-        // Sub-twig cluster (left fork tip ≈ (-0.96, potTopY+1.45))
-        scaleXYZ    = glm::vec3(0.24f, 0.20f, 0.22f);
-        positionXYZ = glm::vec3(potCenterX - 0.96f, potTopY + 1.45f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr + 0.01f, cHg + 0.04f, cHb + 0.01f, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    // a prefab's parts can be spread through the file, so they're
+    // gathered into one run per prefab here
+    std::vector<size_t> order(parts.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&parts, &partPrefabs](size_t a, size_t b)
+    {
+        if (partPrefabs[a] != partPrefabs[b])
+            return partPrefabs[a] < partPrefabs[b];
+        return parts[a].mesh.cullMode < parts[b].mesh.cullMode;
+    });
+    m_prefabParts.reserve(parts.size());
+    for (size_t i : order)
+        m_prefabParts.push_back(parts[i]);
+
+    int firstPart = 0;
+    for (PREFAB_RECORD& prefab : m_prefabs)
+    {
+        prefab.firstPart = firstPart;
+        firstPart += prefab.partCount;
+    }
+}
 
-        // ──────────────────────────────────────────────────────────
-        //  RIGHT CLUSTER  —  7 spheres  (HIGHER, smaller than crown)
-        //  Branch tip: (+1.26, potTopY+1.96)
-        // ──────────────────────────────────────────────────────────
-        float rcX = potCenterX + 1.26f;
-        float rcY = potTopY + 1.96f;
-        float rcZ = potCenterZ;
-
-        // Core
-        scaleXYZ    = glm::vec3(0.40f, 0.34f, 0.38f);
-        positionXYZ = glm::vec3(rcX, rcY, rcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cMr, cMg, cMb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * AddSceneEntity()
+ * Creates the entity for one object that passed
+ * BuildScene()'s checks and places it at world. An import
+ * must have a mesh — BuildScene() skips the ones whose prop
+ * failed. A prefab placement also counts itself on its
+ * prefab. Returns the new entity's handle.
+ ***********************************************************/
+EntityStore::ENTITY SceneManager::AddSceneEntity(const SceneFile::SCENE_OBJECT& object, const glm::mat4& world, int prefab)
+{
+    EntityStore::ENTITY entity = m_entities.Create();
+    size_t index = (size_t)m_entities.GetIndex(entity);
+
+    EntityStore::MESH_REF& mesh = m_entities.GetMeshes()[index];
+    mesh.mesh = (uint8_t)GetShapeMesh(object.shape);
+    mesh.importedMesh = (mesh.mesh == MESH_IMPORTED) ? GetPropMesh(object.prop) : -1;
+    mesh.prefab = prefab;
+    if (prefab >= 0)
+        m_prefabs[prefab].placements++;
+
+    EntityStore::SURFACE& surface = m_entities.GetSurfaces()[index];
+    surface.color = object.color;
+    surface.uvScale = object.uvScale;
+    m_entities.GetTextures()[index] = object.textureTag.empty() ? -1 : FindTextureSlot(object.textureTag);
+    m_entities.GetMaterials()[index] = object.materialTag.empty() ? -1 : FindMaterialIndex(object.materialTag);
+    m_entities.GetFlags()[index] = (object.bDrawTop ? EntityStore::FLAG_DRAW_TOP : 0)
+                                 | (object.bDrawBottom ? EntityStore::FLAG_DRAW_BOTTOM : 0)
+                                 | (object.bDrawSides ? EntityStore::FLAG_DRAW_SIDES : 0)
+                                 | (object.bOccluder ? EntityStore::FLAG_OCCLUDER : 0);
+
+    SetEntityTransform(index, world);
+    return entity;
+}
 
-        // Top
-        scaleXYZ    = glm::vec3(0.30f, 0.26f, 0.28f);
-        positionXYZ = glm::vec3(rcX + 0.04f, rcY + 0.36f, rcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr + 0.01f, cHg + 0.03f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * SetEntityTransform()
+ * Closed shapes get back-face culling; imported meshes say
+ * for themselves whether they're closed. Bounds are the
+ * mesh's object-space box carried through the transform. A
+ * prefab placement's cull mode only records whether it's
+ * mirrored; each part brings its own.
+ ***********************************************************/
+void SceneManager::SetEntityTransform(size_t index, const glm::mat4& world)
+{
+    EntityStore::MESH_REF& mesh = m_entities.GetMeshes()[index];
+    EntityStore::BOUNDS& bounds = m_entities.GetBounds()[index];
+    uint8_t flags = m_entities.GetFlags()[index];
 
-        // Right tip (furthest right)
-        scaleXYZ    = glm::vec3(0.28f, 0.24f, 0.26f);
-        positionXYZ = glm::vec3(rcX + 0.40f, rcY + 0.05f, rcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr, cHg + 0.02f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    m_entities.GetTransforms()[index] = world;
+    if (mesh.mesh == MESH_IMPORTED)
+    {
+        mesh.cullMode = (uint8_t)SelectCullMode(m_pMeshLibrary->IsImportedMeshClosed(mesh.importedMesh), world);
 
-        // Left (toward trunk)
-        scaleXYZ    = glm::vec3(0.26f, 0.22f, 0.24f);
-        positionXYZ = glm::vec3(rcX - 0.36f, rcY + 0.08f, rcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cSr, cSg + 0.02f, cSb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+        float boundsMin[3];
+        float boundsMax[3];
+        m_pMeshLibrary->GetImportedBounds(mesh.importedMesh, boundsMin, boundsMax);
+        bounds.boundsMin = glm::vec3(boundsMin[0], boundsMin[1], boundsMin[2]);
+        bounds.boundsMax = glm::vec3(boundsMax[0], boundsMax[1], boundsMax[2]);
+    }
+    else if (mesh.mesh == MESH_PREFAB)
+    {
+        mesh.cullMode = (uint8_t)SelectCullMode(true, world);
+        bounds.boundsMin = m_prefabs[mesh.prefab].boundsMin;
+        bounds.boundsMax = m_prefabs[mesh.prefab].boundsMax;
+    }
+    else
+    {
+        bool bClosed = IsClosedMesh((MESH_TYPE)mesh.mesh,
+                                    (flags & EntityStore::FLAG_DRAW_TOP) != 0,
+                                    (flags & EntityStore::FLAG_DRAW_BOTTOM) != 0,
+                                    (flags & EntityStore::FLAG_DRAW_SIDES) != 0);
+        mesh.cullMode = (uint8_t)SelectCullMode(bClosed, world);
+        GetMeshLocalBounds((MESH_TYPE)mesh.mesh, bounds.boundsMin, bounds.boundsMax);
+    }
+    TransformBounds(world, bounds.boundsMin, bounds.boundsMax);
+}
 
-        // Front
-        scaleXYZ    = glm::vec3(0.30f, 0.25f, 0.28f);
-        positionXYZ = glm::vec3(rcX + 0.06f, rcY + 0.02f, rcZ + 0.36f);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr, cHg + 0.01f, cHb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * UpdateSceneGraph()
+ * Only the subtrees under swayed nodes are recomputed, and
+ * only their entities are touched — a swaying branch costs its
+ * own twigs and leaves, not the rest of the scene, and the
+ * BVH refits just their boxes. Turning the wind off puts the
+ * nodes back at rest. The sway is a function of time, so it
+ * is evaluated at the frame's interpolated simulation time
+ * rather than stepped.
+ ***********************************************************/
+void SceneManager::UpdateSceneGraph()
+{
+    bool bWind = (m_pRenderSettings != nullptr) && m_pRenderSettings->bBonsaiWind;
+    if (bWind != m_bLastWind)
+    {
+        m_bLastWind = bWind;
+        int moving = 0;
+        for (size_t i = 0; i < m_windNodes.size(); i++)
+        {
+            moving += m_sceneGraph.GetSubtreeEnd(m_windNodes[i]) - m_windNodes[i];
+            if (!bWind)
+                m_sceneGraph.SetLocal(m_windNodes[i], m_windRest[i]);
+        }
+        std::cout << "INFO: Bonsai wind " << (bWind ? "ON" : "OFF") << " — " << m_windNodes.size()
+                  << " swaying nodes move " << moving << " of " << m_sceneGraph.GetNodeCount()
+                  << " scene graph nodes" << std::endl;
+    }
 
-        // Lower shadow
-        scaleXYZ    = glm::vec3(0.34f, 0.24f, 0.32f);
-        positionXYZ = glm::vec3(rcX + 0.04f, rcY - 0.28f, rcZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cSr, cSg, cSb, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    if (bWind)
+    {
+        for (size_t i = 0; i < m_windNodes.size(); i++)
+        {
+            SceneGraph::NODE_TRANSFORM local = m_windRest[i];
+            double phase = 2.0 * PI * WIND_SWAY_HZ * m_simulationSeconds + WIND_PHASE_STEP * i;
+            local.rotation.z += WIND_SWAY_DEGREES * (float)std::sin(phase);
+            m_sceneGraph.SetLocal(m_windNodes[i], local);
+        }
+    }
 
-        // Sub-twig cluster (right fork tip ≈ (+1.22, potTopY+2.14))
-        scaleXYZ    = glm::vec3(0.24f, 0.20f, 0.22f);
-        positionXYZ = glm::vec3(potCenterX + 1.22f, potTopY + 2.14f, potCenterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(cHr + 0.01f, cHg + 0.04f, cHb + 0.01f, 1.0f);
-        m_basicMeshes->DrawSphereMesh();
+    if (m_sceneGraph.Update(m_graphSpans) == 0)
+        return;
+    m_movedEntities.clear();
+    for (const std::pair<int, int>& span : m_graphSpans)
+    {
+        for (int node = span.first; node < span.second; node++)
+        {
+            int index = m_entities.GetIndex(m_nodeEntities[node]);
+            if (index >= 0)
+            {
+                SetEntityTransform(index, m_sceneGraph.GetWorld(node));
+                m_movedEntities.push_back(index);
+            }
+        }
+    }
+    if (m_pSceneBVH->Refit(m_entities.GetBounds(), m_movedEntities))
+    {
+        std::cout << "INFO: Scene BVH rebuilt once refits had worn it down (SAH cost now "
+                  << m_pSceneBVH->GetCost() << ")" << std::endl;
     }
+}
 
-    /******************************************************************/
-    //  CANDLE MUG  (lower left shelf)
-    //  Off-white ceramic mug holding a "snowy day" scented candle.
-    //  Built from: cylinder body, torus handle, wax top disk,
-    //  and a thin label band around the lower section.
-    /******************************************************************/
-    {
-        float mugRadius = 0.65f;
-        float mugHeight = 1.275f;
-        float mugX      = -4.0f;
-        float mugZ      = 4.0f;
-        float mugBaseY  = lowerShelfY;
-
-        // Mug body — main cylinder
-        scaleXYZ    = glm::vec3(mugRadius, mugHeight, mugRadius);
-        positionXYZ = glm::vec3(mugX, mugBaseY, mugZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.95f, 0.93f, 0.90f, 1.0f); // off-white ceramic
-        SetShaderMaterial("ceramic");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        // Candle wax surface — thin flat disk just inside the rim
-        scaleXYZ    = glm::vec3(mugRadius * 0.88f, 0.055f, mugRadius * 0.88f);
-        positionXYZ = glm::vec3(mugX, mugBaseY + mugHeight - 0.05f, mugZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.88f, 0.84f, 0.72f, 1.0f); // deeper cream/wax color
-        SetShaderMaterial("ceramic");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        // Handle — torus centered on the mug wall so only the outer half
-        // is visible, giving a clean D-shaped handle silhouette
-        scaleXYZ    = glm::vec3(0.42f, 0.3f, 0.42f);
-        positionXYZ = glm::vec3(
-            mugX - mugRadius,             // flush against the mug wall
-            mugBaseY + mugHeight * 0.50f, // vertically centered
-            mugZ
-        );
-        SetTransformations(scaleXYZ, 90.0f, 0.0f, 0.0f, positionXYZ);
-        SetShaderColor(0.95f, 0.93f, 0.90f, 1.0f);
-        SetShaderMaterial("ceramic");
-        m_basicMeshes->DrawTorusMesh();
+/***********************************************************
+ * CompileSceneFile()
+ * Runs headless from --compile-scene: tags can't be checked
+ * against loaded textures and materials here, so that
+ * happens when the compiled scene is loaded. Scenes the
+ * binary can't hold are refused, and keep loading from
+ * the text file.
+ ***********************************************************/
+bool SceneManager::CompileSceneFile(const std::string& scenePath, const std::string& binaryPath)
+{
+    std::vector<SceneFile::SCENE_OBJECT> objects;
+    if (!SceneFile::Load(scenePath, objects))
+        return false;
+    const char* blocker = GetCompileBlocker(objects);
+    if (blocker != nullptr)
+    {
+        std::cout << "INFO: " << scenePath << " uses " << blocker
+                  << ", which a compiled scene can't hold; it will be loaded from the text file" << std::endl;
+        return false;
+    }
 
-        // Label band — thin cylinder wrapping the lower portion of the mug
-        scaleXYZ    = glm::vec3(mugRadius + 0.01f, mugHeight * 0.25f, mugRadius + 0.01f);
-        positionXYZ = glm::vec3(mugX, mugBaseY + mugHeight * 0.15f, mugZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.88f, 0.86f, 0.82f, 1.0f); // slight tan to hint at a paper label
-        SetShaderMaterial("ceramic");
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-    }
-
-    /******************************************************************/
-    //  COASTERS + WIRE HOLDER  (center of lower shelf)
-    //  A stack of round wood coasters inside a minimal wire frame.
-    //  The holder has 4 U-shaped arches (front, back, left, right),
-    //  each built from two thin cylinder legs, horizontal foot bars,
-    //  and a stretched sphere capping the top of the U-curve.
-    /******************************************************************/
-    {
-        float coasterRadius    = 1.1f;
-        float coasterThickness = 0.15f;
-        float coasterGap       = 0.06f; // small visible gap between each coaster
-        int   numCoasters      = 8;
-        float coasterX         = -1.5f;
-        float coasterZ         = 4.5f;
-        float baseY            = lowerShelfY;
-
-        // Pre-calculate stack dimensions so the wire height matches the coaster stack
-        float stackBaseY  = baseY + 0.10f;
-        float stackHeight = numCoasters * (coasterThickness + coasterGap);
-        float stackTopY   = stackBaseY + stackHeight;
-
-        // Wire frame dimensions
-        float wireR      = 0.045f;               // wire thickness (very thin)
-        float wireH      = stackHeight;           // wire legs match the stack height
-        float legSpacing = 0.30f;                 // half-distance between the two legs of a U
-        float edgeDist   = coasterRadius + 0.03f; // just outside the coaster edge
-        float footY      = baseY + wireR;         // ground level for the horizontal foot bars
-
-        // --- Front arch (+Z side) — legs spread left/right along X ---
-        // Left leg
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX - legSpacing, baseY, coasterZ + edgeDist);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-        SetShaderMaterial("darkMetal");
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Left foot bar — runs inward toward coaster center (-Z direction)
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX - legSpacing, footY, coasterZ + edgeDist);
-        SetTransformations(scaleXYZ, -90, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Right leg
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX + legSpacing, baseY, coasterZ + edgeDist);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Right foot bar
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX + legSpacing, footY, coasterZ + edgeDist);
-        SetTransformations(scaleXYZ, -90, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Top U-curve — stretched sphere bridging the two legs
-        scaleXYZ    = glm::vec3(legSpacing + wireR, wireR * 1.5f, wireR);
-        positionXYZ = glm::vec3(coasterX, baseY + wireH, coasterZ + edgeDist);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
+    SceneBinary::SCENE_DATA scene;
+    scene.sourceTime = -1;
+    scene.sourceSize = -1;
+    SceneFile::GetFileStamp(scenePath, scene.sourceTime, scene.sourceSize);
+    CompileScene(objects, scene);
 
-        // --- Back arch (-Z side) ---
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX - legSpacing, baseY, coasterZ - edgeDist);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-        SetShaderMaterial("darkMetal");
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Left foot (+Z toward center)
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX - legSpacing, footY, coasterZ - edgeDist);
-        SetTransformations(scaleXYZ, 90, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Right leg
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX + legSpacing, baseY, coasterZ - edgeDist);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Right foot
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX + legSpacing, footY, coasterZ - edgeDist);
-        SetTransformations(scaleXYZ, 90, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        scaleXYZ    = glm::vec3(legSpacing + wireR, wireR * 1.5f, wireR);
-        positionXYZ = glm::vec3(coasterX, baseY + wireH, coasterZ - edgeDist);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
+    if (!SceneBinary::Write(binaryPath, scene))
+    {
+        std::cout << "INFO: Could not write compiled scene " << binaryPath << std::endl;
+        return false;
+    }
+    std::cout << "INFO: Compiled " << scenePath << " into " << binaryPath << " ("
+              << scene.transforms.size() << " records)" << std::endl;
+    return true;
+}
 
-        // --- Left arch (-X side) — legs spread along Z axis ---
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX - edgeDist, baseY, coasterZ - legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-        SetShaderMaterial("darkMetal");
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Foot toward center (+X)
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX - edgeDist, footY, coasterZ - legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, -90, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Other leg
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX - edgeDist, baseY, coasterZ + legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Other foot
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX - edgeDist, footY, coasterZ + legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, -90, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        scaleXYZ    = glm::vec3(wireR, wireR * 1.5f, legSpacing + wireR);
-        positionXYZ = glm::vec3(coasterX - edgeDist, baseY + wireH, coasterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
+/***********************************************************
+ * RunSceneBenchmark()
+ * Both sides go through the loads the app itself uses, from
+ * file to populated entity store and BVH: SceneFile::Load()
+ * and BuildScene() against SceneBinary::Read() and
+ * BuildBinaryScene(). Only flat scenes compile, so the
+ * copies are of the kitchen's flat objects. Runs on the GL
+ * thread once textures are loaded, and leaves the scene
+ * file to be loaded again on the next frame.
+ ***********************************************************/
+void SceneManager::RunSceneBenchmark(const std::vector<std::string>& args)
+{
+    std::vector<size_t> counts;
+    for (const std::string& arg : args)
+    {
+        size_t count = (size_t)std::strtoull(arg.c_str(), nullptr, 10);
+        if (count > 0)
+            counts.push_back(count);
+    }
+    if (counts.empty())
+        counts = { 1000, 100000, 1000000 };
 
-        // --- Right arch (+X side) ---
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX + edgeDist, baseY, coasterZ - legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-        SetShaderMaterial("darkMetal");
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Foot toward center (-X)
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX + edgeDist, footY, coasterZ - legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, 90, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Other leg
-        scaleXYZ    = glm::vec3(wireR, wireH, wireR);
-        positionXYZ = glm::vec3(coasterX + edgeDist, baseY, coasterZ + legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        // Other foot
-        scaleXYZ    = glm::vec3(wireR, edgeDist, wireR);
-        positionXYZ = glm::vec3(coasterX + edgeDist, footY, coasterZ + legSpacing);
-        SetTransformations(scaleXYZ, 0, 0, 90, positionXYZ);
-        m_basicMeshes->DrawCylinderMesh(false, false, true);
-        scaleXYZ    = glm::vec3(wireR, wireR * 1.5f, legSpacing + wireR);
-        positionXYZ = glm::vec3(coasterX + edgeDist, baseY + wireH, coasterZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        m_basicMeshes->DrawSphereMesh();
+    std::vector<SceneFile::SCENE_OBJECT> kitchen;
+    if (!SceneFile::Load(SCENE_FILE_PATH, kitchen))
+        return;
+    if (!MeshCache::EnsureDirectory(SCENE_BENCHMARK_DIRECTORY))
+    {
+        std::cout << "INFO: Could not create " << SCENE_BENCHMARK_DIRECTORY << std::endl;
+        return;
+    }
 
-        // --- Coaster stack — 8 round disks with small visible gaps ---
-        for (int i = 0; i < numCoasters; i++)
+    // the workers mustn't be reading the entities being replaced
+    FinishFramePacket();
+    for (size_t count : counts)
+    {
+        std::string textPath = std::string(SCENE_BENCHMARK_DIRECTORY) + "/bench_" + std::to_string(count) + ".scene";
+        std::string binaryPath = textPath + "b";
+        size_t perCopy = 0;
         {
-            scaleXYZ    = glm::vec3(coasterRadius, coasterThickness, coasterRadius);
-            positionXYZ = glm::vec3(coasterX,
-                                    stackBaseY + i * (coasterThickness + coasterGap),
-                                    coasterZ);
-            SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-            // Alternate shade slightly so each coaster reads as a separate piece
-            float shade = (i % 2 == 0) ? 0.90f : 0.87f;
-            SetShaderColor(shade, shade - 0.01f, shade - 0.04f, 1.0f);
-            SetShaderTexture("coaster");
-            SetTextureUVScale(1.0f, 1.0f);
-            SetShaderMaterial("lightWood");
-            m_basicMeshes->DrawCylinderMesh(true, true, true);
+            std::vector<SceneFile::SCENE_OBJECT> objects;
+            perCopy = ReplicateFlat(kitchen, count, SCENE_BENCHMARK_SPACING, objects);
+            if (perCopy == 0)
+            {
+                std::cout << "INFO: " << SCENE_FILE_PATH << " has no flat objects to compile" << std::endl;
+                return;
+            }
+            SceneBinary::SCENE_DATA scene;
+            scene.sourceTime = -1;
+            scene.sourceSize = -1;
+            CompileScene(objects, scene);
+            if (!SceneFile::Write(textPath, objects) || !SceneBinary::Write(binaryPath, scene))
+            {
+                std::cout << "INFO: Could not write the benchmark scenes to " << SCENE_BENCHMARK_DIRECTORY << std::endl;
+                return;
+            }
         }
-    }
-
-    /******************************************************************/
-    //  NAPKIN HOLDER  (lower right shelf)
-    //  Two thin wooden boards with arch-shaped tops, facing each
-    //  other and connected at the base. Napkins stand vertically in
-    //  the slot between the two panels.
-    //
-    //  Arch trick: DrawCylinderMesh draws a full circle, so we
-    //  position it at the top edge of the rectangular box panel —
-    //  the lower half hides inside the box, leaving only the arch.
-    /***************************************
-     * ***************************/
-    {
-        float nhX        = 2.0f;   // center X on the lower shelf
-        float nhZ        = 4.5f;   // center Z (moved back from front edge)
-        float nhBaseY    = lowerShelfY;
-        float panelWidth = 3.4f;   // width of each wooden panel (X direction)
-        float panelRectH = 2.0f;   // height of the rectangular lower portion of each panel
-        float archRadius = panelWidth / 2.0f; // arch radius = half panel width
-        float panelThk   = 0.2f; // board thickness — reduce to make panels thinner
-        float slotGap    = 0.75f;  // gap between front and back panels where napkins sit
-
-        // --- Front panel (+Z side) ---
-        float frontZ = nhZ + slotGap / 2.0f + panelThk / 2.0f;
-
-        // Rectangular lower portion of the front panel
-        scaleXYZ    = glm::vec3(panelWidth, panelRectH, panelThk);
-        positionXYZ = glm::vec3(nhX, nhBaseY + panelRectH / 2.0f, frontZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.55f, 0.35f, 0.15f, 1.0f);
-        SetShaderTexture("wood");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("wood");
-        m_basicMeshes->DrawBoxMesh();
 
-        // Arch top — cylinder rotated -90X so its local Y axis points inward (-Z)
-        // Placed at the outer face so the arch aligns with the box edge exactly
-        scaleXYZ    = glm::vec3(archRadius, panelThk, archRadius);
-        positionXYZ = glm::vec3(nhX, nhBaseY + panelRectH, frontZ + panelThk / 2.0f);
-        SetTransformations(scaleXYZ, -90, 0, 0, positionXYZ);
-        SetShaderColor(0.55f, 0.35f, 0.15f, 1.0f);
-        SetShaderTexture("woodie");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("woodie");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        // --- Back panel (-Z side) ---
-        float backZ = nhZ - slotGap / 2.0f - panelThk / 2.0f;
-
-        // Rectangular lower portion of the back panel
-        scaleXYZ    = glm::vec3(panelWidth, panelRectH, panelThk);
-        positionXYZ = glm::vec3(nhX, nhBaseY + panelRectH / 2.0f, backZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.55f, 0.35f, 0.15f, 1.0f);
-        SetShaderTexture("wood");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("wood");
-        m_basicMeshes->DrawBoxMesh();
-
-        // Arch top — rotated +90X so local Y points inward (+Z)
-        scaleXYZ    = glm::vec3(archRadius, panelThk, archRadius);
-        positionXYZ = glm::vec3(nhX, nhBaseY + panelRectH, backZ - panelThk / 2.0f);
-        SetTransformations(scaleXYZ, 90, 0, 0, positionXYZ);
-        SetShaderColor(0.55f, 0.35f, 0.15f, 1.0f);
-        SetShaderTexture("wood");
-        SetTextureUVScale(1.0f, 1.0f);
-        SetShaderMaterial("wood");
-        m_basicMeshes->DrawCylinderMesh(true, true, true);
-
-        // --- Base slab connecting front and back panels at the bottom ---
-        float totalDepth = slotGap + panelThk * 2.0f; // full depth of the whole holder
-        scaleXYZ    = glm::vec3(panelWidth, panelThk, totalDepth);
-        positionXYZ = glm::vec3(nhX, nhBaseY + panelThk / 2.0f, nhZ);
-        SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-        SetShaderColor(0.52f, 0.32f, 0.13f, 1.0f); // slightly darker than the panels
-        SetShaderMaterial("wood");
-        m_basicMeshes->DrawBoxMesh();
-
-        // --- Napkins — 12 thin boxes packed into the slot ---
-        float totalWoodH  = panelRectH + archRadius; // full visible height of each panel
-        float napkinH     = totalWoodH * 1.0f;       // napkins match panel height
-        int   napkinCount = 12;
-        float totalSlotZ  = slotGap * 0.88f;         // napkins fill 88% of the slot depth
-        float napkinThk   = totalSlotZ / (float)napkinCount;
-        float startZ      = nhZ - totalSlotZ / 2.0f + napkinThk / 2.0f;
-
-        for (int i = 0; i < napkinCount; i++)
+        double bestText = 0.0;
+        double bestBinary = 0.0;
+        size_t textEntities = 0;
+        size_t binaryEntities = 0;
+        size_t binaryBytes = 0;
+        for (int run = 0; run < SCENE_BENCHMARK_RUNS; run++)
         {
-            // Vary height and shade a little so they look like individual napkins
-            float heightVar = (i % 2 == 0) ? 1.0f : 0.97f;
-            float shade     = 0.94f + (i % 3) * 0.01f;
-
-            scaleXYZ    = glm::vec3(panelWidth * 1.17f, napkinH * heightVar, napkinThk * 0.92f);
-            positionXYZ = glm::vec3(nhX, nhBaseY + (napkinH * heightVar) / 2.0f + panelThk,
-                                    startZ + i * napkinThk);
-            SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-            SetShaderColor(shade, shade, shade * 0.98f, 1.0f);
-            SetShaderTexture("napkin");
-            SetTextureUVScale(1.0f, 1.0f);
-            SetShaderMaterial("napkin");
-            m_basicMeshes->DrawBoxMesh();
+            auto startTime = std::chrono::steady_clock::now();
+            std::vector<SceneFile::SCENE_OBJECT> objects;
+            if (!SceneFile::Load(textPath, objects) || !BuildScene(objects))
+                return;
+            double textSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            textEntities = m_entities.GetCount();
+
+            startTime = std::chrono::steady_clock::now();
+            MappedFile file;
+            SceneBinary::SCENE_VIEW view;
+            if (!SceneBinary::Read(binaryPath, file, view) || !BuildBinaryScene(view))
+                return;
+            double binarySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            binaryEntities = m_entities.GetCount();
+            binaryBytes = file.GetSize();
+
+            if (run == 0 || textSeconds < bestText)
+                bestText = textSeconds;
+            if (run == 0 || binarySeconds < bestBinary)
+                bestBinary = binarySeconds;
         }
+
+        size_t textBytes = 0;
+        MappedFile text;
+        if (text.Open(textPath))
+            textBytes = text.GetSize();
+
+        std::cout << "INFO: " << count << " objects (" << perCopy << " per copy): text "
+                  << bestText * 1000.0 << " ms (" << textBytes / 1.0e6 << " MB, " << textEntities
+                  << " entities), binary " << bestBinary * 1000.0 << " ms (" << binaryBytes / 1.0e6 << " MB, "
+                  << binaryEntities << " entities) — " << bestText / std::max(bestBinary, 1.0e-9) << "x"
+                  << std::endl;
     }
 
-    // Restore backface culling to whatever state it was in before we started
-    if (cullEnabled)
-        glEnable(GL_CULL_FACE);
-}
\ No newline at end of file
+    // put the real scene back on the next frame
+    m_bSceneFileChecked = false;
+}
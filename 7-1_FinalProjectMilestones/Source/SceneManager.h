@@ -9,10 +9,28 @@
 #pragma once
 #include "ShaderManager.h"
 #include "ShapeMeshes.h"
+#include "MeshLibrary.h"
+#include "RenderSettings.h"
+#include "GLStateCache.h"
+#include "EntityStore.h"
+#include "PlantRenderer.h"
+#include "SceneBinary.h"
+#include "SceneFile.h"
+#include "SceneGraph.h"
+#include <atomic>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <glm/glm.hpp>
 
+class MeshletCuller;
+class OcclusionCuller;
+class OverdrawVisualizer;
+class ProceduralMeshes;
+class SceneBVH;
+class WorkerPool;
+
 /***********************************************************
  *  SceneManager
  *
@@ -41,17 +59,283 @@ public:
         std::string tag;
     };
 
+    // basic shape meshes that can be queued for drawing
+    enum MESH_TYPE
+    {
+        MESH_PLANE,
+        MESH_BOX,
+        MESH_CYLINDER,
+        MESH_TAPERED_CYLINDER,
+        MESH_TORUS,
+        MESH_SPHERE,
+        // a MeshLibrary::ImportMesh() mesh, picked by importedMesh
+        MESH_IMPORTED,
+        // a placed prefab, picked by prefab; draws the prefab's parts
+        MESH_PREFAB
+    };
+
+    // face culling state a draw needs
+    enum CULL_MODE
+    {
+        CULL_BACK,            // closed shape, counter-clockwise front faces
+        CULL_BACK_MIRRORED,   // closed shape under a mirroring transform
+        CULL_NONE,            // open shell, both sides visible
+        CULL_MODE_COUNT
+    };
+
+    // a generated plant from a scene file plant line, drawn with one
+    // instanced call per part
+    struct PLANT_RECORD
+    {
+        // PlantRenderer handle
+        int plant;
+        // graph node the plant stands on, and the root of the subtree
+        // it replaces (-1 for none)
+        int node;
+        int replacedNode;
+        // plant-space bounds, carried to world space for culling
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        glm::vec4 colors[PlantRenderer::PART_COUNT];
+        // index into m_objectMaterials per part, -1 if none
+        int materialIndices[PlantRenderer::PART_COUNT];
+    };
+
+    // worker jobs a packet build is split into, each culling one
+    // contiguous run of the entities
+    static const int PACKET_SECTION_COUNT = 16;
+
+    // one job's share of a packet build — each job writes only its own
+    struct PACKET_SECTION
+    {
+        // surviving entity positions grouped by cull mode
+        std::vector<size_t> cullBuckets[CULL_MODE_COUNT];
+        // surviving prefab placements, in entity order
+        std::vector<size_t> prefabDraws;
+        int occluded;
+        int offscreen;
+    };
+
+    // one frame's culled entity list; the worker pool builds one while
+    // the GL thread submits the other
+    struct FRAME_PACKET
+    {
+        // camera and toggles the packet is culled for, and drawn with
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec3 eye;
+        float viewportHeight;
+        bool bCull;
+        bool bLOD;
+        bool bMeshlets;
+        bool bPlants;
+        // m_sceneVersion it was started at, and whether the build finished
+        unsigned int sceneVersion;
+        bool bBuilt;
+        PACKET_SECTION sections[PACKET_SECTION_COUNT];
+        // entity positions grouped by cull mode, sections in order
+        std::vector<size_t> cullBuckets[CULL_MODE_COUNT];
+        // positions of the surviving prefab placements, grouped by prefab
+        std::vector<size_t> prefabDraws;
+        // MeshLibrary detail level per entity position, -1 to draw
+        // the ShapeMeshes primitive
+        std::vector<int> drawLevels;
+        // pMeshletCuller slot per entity position, -1 to draw the
+        // whole imported mesh
+        std::vector<int> meshletSlots;
+        // per-cluster culling of the imported meshes in the buckets, with
+        // its own indirect buffer
+        MeshletCuller* pMeshletCuller;
+        // survived the occlusion test, by m_plants index
+        std::vector<uint8_t> plantVisible;
+        // survivors and the occlusion counts, for the log
+        int drawn;
+        int occluderFaces;
+        int occluded;
+        int offscreen;
+    };
+
+    // one drawn object of a prefab, in prefab space; shared by every
+    // placement and never changed once the scene is built
+    struct PREFAB_PART
+    {
+        glm::mat4 local;
+        // inverse of local, to carry pick rays into the part
+        glm::mat4 toPart;
+        // cullMode is for an unmirrored placement
+        EntityStore::MESH_REF mesh;
+        // same meanings as the entity components
+        int material;
+        int texture;
+        EntityStore::SURFACE surface;
+        uint8_t flags;
+    };
+
+    // a scene file prefab line and the parts under it
+    struct PREFAB_RECORD
+    {
+        std::string name;
+        // run of m_prefabParts, grouped by cull mode
+        int firstPart;
+        int partCount;
+        // prefab-space bounds of every part, carried to world space
+        // for each placement
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        // entities placing it
+        int placements;
+    };
+
+    // counts for the last frame SubmitDrawList() issued
+    struct FRAME_STATS
+    {
+        // entities and plants in the scene
+        size_t objects;
+        // of those, how many survived culling
+        int drawn;
+        // mesh draws issued over every pass: one per entity draw, prefab
+        // part drawn at a placement, or instanced plant part
+        int drawCalls;
+    };
+
+    // what PickEntity() hit
+    struct PICK_RESULT
+    {
+        EntityStore::ENTITY entity;
+        // world-space point on the surface, and its distance from the
+        // near plane along the pick ray
+        glm::vec3 point;
+        float distance;
+    };
+
 private:
     // pointer to shader manager object
     ShaderManager* m_pShaderManager;
+    // position-only shader for the depth pre-pass, owned by main
+    ShaderManager* m_pDepthShaderManager;
     // pointer to basic shapes object
     ShapeMeshes* m_basicMeshes;
+    // multi-resolution versions of the curved shapes
+    MeshLibrary* m_pMeshLibrary;
     // total number of loaded textures
     int m_loadedTextures;
     // loaded textures info
     TEXTURE_INFO m_textureIDs[16];
     // defined object materials
     std::vector<OBJECT_MATERIAL> m_objectMaterials;
+    // one entity per scene object that draws, kept from frame to
+    // frame until the file changes
+    EntityStore m_entities;
+    // last entity SelectEntityAt() hit
+    EntityStore::ENTITY m_selectedEntity;
+    // scene file stamp of the last load attempt, to spot edits
+    bool m_bSceneFileChecked;
+    long long m_sceneFileTime;
+    long long m_sceneFileSize;
+    // frames since the scene file was last checked
+    int m_sceneFileFrame;
+    // a LoadStressScene() scene is up, so edits don't replace it
+    bool m_bStressScene;
+    // transforms of the loaded scene file, one node per object; empty
+    // when the scene came from the compiled binary
+    SceneGraph m_sceneGraph;
+    // entity of each graph node, NO_ENTITY for nodes that don't draw
+    std::vector<EntityStore::ENTITY> m_nodeEntities;
+    // node runs the last graph update recomputed
+    std::vector<std::pair<int, int>> m_graphSpans;
+    // nodes the wind sways and their transforms at rest
+    std::vector<int> m_windNodes;
+    std::vector<SceneGraph::NODE_TRANSFORM> m_windRest;
+    // wind setting in effect last frame
+    bool m_bLastWind;
+    // seconds of simulation the frame is drawn at
+    double m_simulationSeconds;
+    // threads shared by the CPU-side render work
+    WorkerPool* m_pWorkerPool;
+    // software occlusion buffer tested before any GL call
+    OcclusionCuller* m_pOcclusionCuller;
+    // the packet the workers build into while the other one is drawn,
+    // and the one being drawn (null outside SubmitDrawList())
+    FRAME_PACKET m_framePackets[2];
+    int m_buildPacket;
+    const FRAME_PACKET* m_pDrawPacket;
+    // sections of the packet being built that haven't finished yet
+    std::atomic<int> m_sectionsRemaining;
+    // bumped whenever entity positions change meaning, which makes
+    // older packets stale
+    unsigned int m_sceneVersion;
+    // hierarchy over the entity bounds, rebuilt on load and refit as
+    // the scene graph moves entities
+    SceneBVH* m_pSceneBVH;
+    // entity positions inside the frustum of the packet being built
+    std::vector<int> m_frustumEntities;
+    // entity positions the last graph update moved
+    std::vector<int> m_movedEntities;
+    // meshlet setting seen last frame, to log when it changes
+    bool m_bLastMeshletCulling;
+    // frames since meshlet culling was last reported
+    int m_meshletFrame;
+    // runtime toggles, owned by main
+    RENDER_SETTINGS* m_pRenderSettings;
+    // redundant state filter in front of GL, owned by main
+    GLStateCache* m_pStateCache;
+    // counts for the last frame, and the one being issued
+    FRAME_STATS m_frameStats;
+    // camera matrices from the last SetViewMatrices()
+    glm::mat4 m_viewMatrix;
+    glm::mat4 m_projectionMatrix;
+    // occlusion setting seen last frame, to log when it changes
+    bool m_bLastOcclusionCulling;
+    // LOD level each entity got in the last packet built, by entity position
+    std::vector<int> m_lodLevels;
+    // LOD setting seen last frame, to log when it changes
+    bool m_bLastLevelOfDetail;
+    // GL_PRIMITIVES_GENERATED queries, alternated between frames
+    GLuint m_triangleQueries[2];
+    bool m_bQueryUsedLOD[2];
+    bool m_bQueryPending[2];
+    int m_queryIndex;
+    // last measured triangles per frame with LOD off / on (-1 unknown)
+    long long m_trianglesFullDetail;
+    long long m_trianglesWithLOD;
+    // main pass fragment queries, alternated alongside the triangle ones
+    GLuint m_fragmentQueries[2];
+    GLenum m_fragmentQueryTarget;
+    bool m_bQueryUsedPrepass[2];
+    bool m_bFragmentQueryPending[2];
+    // last measured main pass fragments with the pre-pass off / on (-1 unknown)
+    long long m_fragmentsWithoutPrepass;
+    long long m_fragmentsWithPrepass;
+    // pre-pass setting seen last frame, to log when it changes
+    bool m_bLastDepthPrepass;
+    // main pass GL_TIME_ELAPSED queries, alternated alongside the others
+    GLuint m_timeQueries[2];
+    bool m_bQueryUsedPacked[2];
+    bool m_bTimeQueryPending[2];
+    // last measured main pass GPU time in ns with float / packed vertices (-1 unknown)
+    long long m_gpuTimeFloat;
+    long long m_gpuTimePacked;
+    // debug heatmap of fragments per pixel
+    OverdrawVisualizer* m_pOverdrawVisualizer;
+    bool m_bOverdrawShadersLoaded;
+    // frames since the overdraw view was switched on
+    int m_overdrawFrame;
+    // curved shapes built in the vertex shader, no vertex buffers
+    ProceduralMeshes* m_pProceduralMeshes;
+    bool m_bProceduralShadersLoaded;
+    // procedural mode in effect this frame
+    bool m_bProceduralMeshes;
+    // instanced procedural plants, one entry per scene plant line
+    PlantRenderer* m_pPlantRenderer;
+    bool m_bPlantShadersLoaded;
+    std::vector<PLANT_RECORD> m_plants;
+    // plant mode in effect this frame
+    bool m_bProceduralPlants;
+    // prefabs of the loaded scene and all of their parts
+    std::vector<PREFAB_RECORD> m_prefabs;
+    std::vector<PREFAB_PART> m_prefabParts;
+    // MeshLibrary handles of the props imported so far, by name
+    std::unordered_map<std::string, int> m_propMeshes;
 
     // load texture images and convert to OpenGL texture data
     bool CreateGLTexture(const char* filename, std::string tag);
@@ -64,37 +348,160 @@ private:
     int FindTextureSlot(std::string tag);
     // find a defined material by tag
     bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+    // index of a defined material in m_objectMaterials, -1 if unknown
+    int FindMaterialIndex(const std::string& tag) const;
 
-    // set the transformation values into the transform buffer
-    void SetTransformations(
-        glm::vec3 scaleXYZ,
-        float XrotationDegrees,
-        float YrotationDegrees,
-        float ZrotationDegrees,
-        glm::vec3 positionXYZ);
-
-    // set the color values into the shader
-    void SetShaderColor(
-        float redColorValue,
-        float greenColorValue,
-        float blueColorValue,
-        float alphaValue);
-
-    // set the texture data into the shader
-    void SetShaderTexture(std::string textureTag);
-    // set the UV scale for the texture mapping
-    void SetTextureUVScale(float u, float v);
-    // set the object material into the shader
-    void SetShaderMaterial(std::string materialTag);
+    // reload the scene file on the first frame and whenever it changes
+    void UpdateSceneFile();
+    // parse and validate the scene file and rebuild m_entities from it;
+    // leaves the current entities alone if anything is wrong
+    bool LoadSceneFile();
+    // validate objects parsed from the scene file and rebuild the scene
+    // graph, entities and plants from them; leaves the current scene
+    // alone if anything is wrong
+    bool BuildScene(const std::vector<SceneFile::SCENE_OBJECT>& objects);
+    // rebuild m_entities from the compiled scene, if there is one and
+    // it was compiled from the text file as it is now
+    bool LoadSceneBinary();
+    // resolve a mapped compiled scene's tags and copy its columns into
+    // m_entities; leaves the current scene alone if a tag is unknown
+    bool BuildBinaryScene(const SceneBinary::SCENE_VIEW& view);
+    // turn the prefab lines of objects and their parts into
+    // m_prefabs and m_prefabParts; prefabIndices gets each prefab
+    // line's index in m_prefabs
+    void BuildPrefabs(const std::vector<SceneFile::SCENE_OBJECT>& objects, const SceneGraph& graph,
+                      std::vector<int>& prefabIndices);
+    // add an entity for one scene object with its world transform;
+    // prefab is the m_prefabs index an instance places, -1 otherwise
+    EntityStore::ENTITY AddSceneEntity(const SceneFile::SCENE_OBJECT& object, const glm::mat4& world, int prefab);
+    // set an entity's transform and the cull mode and bounds that follow from it
+    void SetEntityTransform(size_t index, const glm::mat4& world);
+    // sway the wind nodes if wind is on, then bring the entities of
+    // every graph node that moved up to date
+    void UpdateSceneGraph();
+    // import meshes/<name>.glb, .gltf or .obj, whichever exists first;
+    // returns the MeshLibrary handle or -1
+    int ImportPropMesh(const std::string& name);
+    // ImportPropMesh() once per name, remembering what loaded
+    int GetPropMesh(const std::string& name);
+    // start culling this frame's camera on the worker pool and issue
+    // the packet culled last frame to OpenGL
+    void SubmitDrawList();
+    // copy the camera, viewport height and toggles a packet is culled for
+    void PrepareFramePacket(FRAME_PACKET& packet, float viewportHeight);
+    // rasterize the occluders, then hand the packet's sections to the
+    // workers and return without waiting for them
+    void StartFramePacket(FRAME_PACKET& packet);
+    // cull one section of the entities into the packet; no GL calls
+    void BuildPacketSection(FRAME_PACKET& packet, int section);
+    // join the finished sections in order and queue the meshlet draws
+    void MergePacketSections(FRAME_PACKET& packet);
+    // wait for the packet the workers are building, if any; the
+    // entities must not change while one is in flight
+    void FinishFramePacket();
+    // draw the surviving entities as an overdraw heatmap
+    void DrawOverdrawView(int width, int height);
+    // set GL face culling for a group of draws
+    void ApplyCullMode(CULL_MODE cullMode);
+    // fill the depth buffer for the surviving draws with color writes off
+    void DrawDepthPrepass();
+    // push the shader state of the entity at index to pShader and draw its mesh
+    void DrawEntity(size_t index, ShaderManager* pShader);
+    // true if this frame builds the entity's mesh in the vertex shader
+    bool IsProceduralDraw(size_t index) const;
+    // draw an entity procedurally, or as DrawEntityMesh() does; pShader
+    // must be a procedural program for procedural entities
+    void DrawEntityGeometry(size_t index, ShaderManager* pShader);
+    // draw an entity's mesh (or its LOD stand-in) with whatever shader is bound
+    void DrawEntityMesh(size_t index);
+    // push a color or texture, UV scale and material to a bound pShader
+    void SetSurfaceState(ShaderManager* pShader, int textureSlot, const EntityStore::SURFACE& surface, int materialIndex);
+    // draw a mesh at a MeshLibrary detail level (-1 for the ShapeMeshes
+    // primitive) with its MeshletCuller slot (-1 to draw it whole)
+    void DrawMesh(const EntityStore::MESH_REF& mesh, uint8_t flags, int level, int meshletSlot);
+    // draw every part of the drawn packet's prefab placements with a
+    // bound pShader, setting surfaces only when bShade
+    void DrawPrefabs(ShaderManager* pShader, bool bShade);
+    // model matrix to send for an entity, including the packed mesh scale
+    glm::mat4 GetDrawModel(size_t index) const;
+    // pick a detail level from projected size, sticking to last frame's
+    // level until the size clearly crosses a threshold
+    int SelectLODLevel(size_t index, const FRAME_PACKET& packet);
+    // read back finished triangle count queries and log LOD changes
+    void UpdateTriangleReport();
+    // read back finished fragment count queries and log pre-pass changes
+    void UpdateFragmentReport();
+    // follow the state filter toggle and log call counts when it flips
+    void UpdateStateFilter();
+    // follow the packed vertex toggle and log memory and GPU time when it flips
+    void UpdateVertexFormat();
+    // follow the procedural mesh toggle and log when it flips
+    void UpdateProceduralMeshes();
+    // follow the procedural plant toggle and log when it flips
+    void UpdatePlants();
+    // hide or show the entities each plant's replaced subtree holds;
+    // returns how many entities that is
+    int HidePlantReplacements(bool bHidden);
+    // occlusion test every plant's world bounds into the packet; returns
+    // how many survive
+    int CullPlants(FRAME_PACKET& packet);
+    // draw the drawn packet's surviving plants with a PlantRenderer
+    // program, setting colors and materials only when bShade
+    void DrawPlants(ShaderManager* pShader, bool bShade);
+    // log the drawn packet's cluster counts when the toggle flips and
+    // every so often
+    void UpdateMeshletReport();
+    // exact test of a pick ray against an entity's shape, in the form of
+    // a SceneBVH::RAY_TEST
+    bool IntersectEntity(size_t index, const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
+    // the same test against one mesh, with the ray in its object space
+    bool IntersectMesh(const EntityStore::MESH_REF& mesh, uint8_t flags, const glm::vec3& localOrigin,
+                       const glm::vec3& localDirection, float& distance) const;
 
     // define the materials used in the scene
     void DefineObjectMaterials();
-    // configure Phong lighting (primary + fill light sources)
-    void SetupSceneLights();
+    // configure Phong lighting (primary + fill light sources) on a program
+    void SetupSceneLights(ShaderManager* pShader);
 
 public:
     // Methods to customize for the 3D scene
     void PrepareScene();
     void RenderScene();
     void LoadSceneTextures();
+
+    // hook up the shared runtime render toggles
+    void SetRenderSettings(RENDER_SETTINGS* pRenderSettings);
+    // camera matrices the next packet is culled and drawn with
+    void SetViewMatrices(const glm::mat4& view, const glm::mat4& projection);
+    // simulation time this frame is drawn at, which animation follows
+    void SetSimulationTime(double seconds);
+    // shader used by the optional depth pre-pass
+    void SetDepthShader(ShaderManager* pDepthShaderManager);
+    // hook up the shared GL state filter; must be set before PrepareScene()
+    void SetStateCache(GLStateCache* pStateCache);
+
+    // Find the entity under a point on screen, given in normalized
+    // device coordinates (-1 to 1, +y up), with the camera from the last
+    // SetViewMatrices(). False if the ray hits nothing.
+    bool PickEntity(const glm::vec2& screenPoint, PICK_RESULT& result) const;
+    // Pick what's under a point on screen, remember it and log it
+    void SelectEntityAt(const glm::vec2& screenPoint);
+    // last entity picked, NO_ENTITY after a miss; goes stale on reload
+    EntityStore::ENTITY GetSelectedEntity() const { return m_selectedEntity; }
+
+    // Replace the scene with copies of the scene file's objects, count
+    // of them in all, jittered on a grid; the file is no longer watched
+    bool LoadStressScene(size_t count);
+    // counts for the last frame drawn
+    const FRAME_STATS& GetFrameStats() const { return m_frameStats; }
+
+    // Compile a text scene into the binary format; needs no window.
+    // Returns false if the scene has errors, uses a hierarchy, plants or
+    // prefabs, or the output can't be written.
+    static bool CompileSceneFile(const std::string& scenePath, const std::string& binaryPath);
+    // Time text against binary scene loads, each through to populated
+    // entities, of the kitchen's flat objects copied out to each object
+    // count in args (1k, 100k and 1M by default) and log them. Needs the
+    // scene prepared and its textures loaded.
+    void RunSceneBenchmark(const std::vector<std::string>& args);
 };
\ No newline at end of file
@@ -0,0 +1,479 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShapeRaycast.cpp
+// ============
+// Closed-form ray tests for the flat and quadric shapes, and a root
+// finder for the torus quartic.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeRaycast.h"
+#include "EntityStore.h"
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+
+#include <glm/gtx/transform.hpp>
+
+namespace
+{
+    // Bisection steps per torus root; each halves the bracket, so 48
+    // narrows a few units down to well under a float's precision
+    const int ROOT_ITERATIONS = 48;
+    // How much bigger than the torus the box its quartic is solved over
+    // is, so a ray never starts that stretch already on the surface
+    const float TORUS_BOX_PADDING = 0.05f;
+
+    // Shape counts RunBenchmark() uses when none are given, how far
+    // apart it spaces the shapes, and how many picks it times
+    const size_t BENCHMARK_COUNTS[] = { 10000, 100000, 1000000 };
+    const float BENCHMARK_SPACING = 4.0f;
+    const int BENCHMARK_PICKS = 1000;
+    const int BENCHMARK_RUNS = 3;
+
+    // the shapes RunBenchmark() scatters, in MeshLibrary's proportions
+    enum BENCHMARK_SHAPE
+    {
+        BENCHMARK_BOX,
+        BENCHMARK_SPHERE,
+        BENCHMARK_CYLINDER,
+        BENCHMARK_TAPERED_CYLINDER,
+        BENCHMARK_TORUS,
+        BENCHMARK_SHAPE_COUNT
+    };
+    const float BENCHMARK_TAPER = 0.5f;
+    const float BENCHMARK_TUBE_RADIUS = 0.1f;
+
+    // Record t as the hit if it's on the ray and beats the best so far
+    bool AcceptHit(double t, float& distance)
+    {
+        if (t < 0.0 || t >= distance)
+            return false;
+        distance = (float)t;
+        return true;
+    }
+
+    // Real roots of a t^2 + b t + c, ascending, without the cancellation
+    // the textbook formula suffers when b^2 dwarfs 4ac
+    int SolveQuadratic(double a, double b, double c, double roots[2])
+    {
+        if (a == 0.0)
+        {
+            if (b == 0.0)
+                return 0;
+            roots[0] = -c / b;
+            return 1;
+        }
+        double discriminant = b * b - 4.0 * a * c;
+        if (discriminant < 0.0)
+            return 0;
+        double q = -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+        double first = q / a;
+        double second = (q != 0.0) ? c / q : first;
+        roots[0] = std::min(first, second);
+        roots[1] = std::max(first, second);
+        return 2;
+    }
+
+    // coefficients[0] + coefficients[1] t + ... + coefficients[degree] t^degree
+    double EvaluatePolynomial(const double* coefficients, int degree, double t)
+    {
+        double value = coefficients[degree];
+        for (int i = degree - 1; i >= 0; i--)
+            value = value * t + coefficients[i];
+        return value;
+    }
+
+    // Real roots in [low, high], ascending. Between two neighbouring
+    // roots of the derivative the polynomial is monotonic, so each of
+    // those stretches holds at most one root and a sign change brackets
+    // it exactly; the derivative's roots come from the same search one
+    // degree down. Roots where the curve only touches zero are missed,
+    // which for a ray means grazing a surface at a single point.
+    int FindRoots(const double* coefficients, int degree, double low, double high, double* roots)
+    {
+        while (degree > 0 && coefficients[degree] == 0.0)
+            degree--;
+        if (degree == 0)
+            return 0;
+        if (degree == 1)
+        {
+            double root = -coefficients[0] / coefficients[1];
+            if (root < low || root > high)
+                return 0;
+            roots[0] = root;
+            return 1;
+        }
+
+        double derivative[4];
+        for (int i = 1; i <= degree; i++)
+            derivative[i - 1] = coefficients[i] * i;
+        double ends[5];
+        int endCount = 0;
+        ends[endCount++] = low;
+        endCount += FindRoots(derivative, degree - 1, low, high, ends + 1);
+        ends[endCount++] = high;
+
+        int count = 0;
+        for (int i = 0; i + 1 < endCount; i++)
+        {
+            double a = ends[i];
+            double b = ends[i + 1];
+            double valueA = EvaluatePolynomial(coefficients, degree, a);
+            double valueB = EvaluatePolynomial(coefficients, degree, b);
+            if (valueA == 0.0)
+            {
+                if (count == 0 || roots[count - 1] != a)
+                    roots[count++] = a;
+                continue;
+            }
+            if (valueB == 0.0 || (valueA < 0.0) == (valueB < 0.0))
+                continue;
+
+            for (int step = 0; step < ROOT_ITERATIONS; step++)
+            {
+                double middle = 0.5 * (a + b);
+                double value = EvaluatePolynomial(coefficients, degree, middle);
+                if ((value < 0.0) == (valueA < 0.0))
+                {
+                    a = middle;
+                    valueA = value;
+                }
+                else
+                {
+                    b = middle;
+                }
+            }
+            roots[count++] = 0.5 * (a + b);
+        }
+        if (EvaluatePolynomial(coefficients, degree, high) == 0.0 && (count == 0 || roots[count - 1] != high))
+            roots[count++] = high;
+        return count;
+    }
+
+    // Stretch of the ray inside a box, as distances along it; false if
+    // it misses or the box is behind the origin
+    bool ClipToBox(const glm::vec3& origin, const glm::vec3& direction,
+                   const glm::vec3& boxMin, const glm::vec3& boxMax, double& enter, double& leave)
+    {
+        enter = -std::numeric_limits<double>::max();
+        leave = std::numeric_limits<double>::max();
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (direction[axis] == 0.0f)
+            {
+                if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+                    return false;
+                continue;
+            }
+            double inverse = 1.0 / direction[axis];
+            double near = (boxMin[axis] - origin[axis]) * inverse;
+            double far = (boxMax[axis] - origin[axis]) * inverse;
+            if (near > far)
+                std::swap(near, far);
+            enter = std::max(enter, near);
+            leave = std::min(leave, far);
+        }
+        return enter <= leave && leave >= 0.0;
+    }
+
+    // World bounds of a shape's local box under a transform
+    EntityStore::BOUNDS TransformLocalBounds(const glm::mat4& world, const glm::vec3& localMin, const glm::vec3& localMax)
+    {
+        glm::vec3 center = glm::vec3(world * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+        glm::vec3 half = (localMax - localMin) * 0.5f;
+        glm::vec3 extent = glm::abs(glm::vec3(world[0])) * half.x +
+                           glm::abs(glm::vec3(world[1])) * half.y +
+                           glm::abs(glm::vec3(world[2])) * half.z;
+        EntityStore::BOUNDS bounds = { center - extent, center + extent };
+        return bounds;
+    }
+
+    // Microseconds per pick for a run that took seconds
+    double PerPick(double seconds)
+    {
+        return seconds * 1.0e6 / BENCHMARK_PICKS;
+    }
+}
+
+/***********************************************************
+ * IntersectPlane()
+ ***********************************************************/
+bool ShapeRaycast::IntersectPlane(const glm::vec3& origin, const glm::vec3& direction, float& distance)
+{
+    if (direction.y == 0.0f)
+        return false;
+    double t = -(double)origin.y / direction.y;
+    double x = origin.x + t * direction.x;
+    double z = origin.z + t * direction.z;
+    if (std::abs(x) > 1.0 || std::abs(z) > 1.0)
+        return false;
+    return AcceptHit(t, distance);
+}
+
+/***********************************************************
+ * IntersectBox()
+ ***********************************************************/
+bool ShapeRaycast::IntersectBox(const glm::vec3& origin, const glm::vec3& direction,
+                                const glm::vec3& boxMin, const glm::vec3& boxMax, float& distance)
+{
+    double enter;
+    double leave;
+    if (!ClipToBox(origin, direction, boxMin, boxMax, enter, leave))
+        return false;
+    return AcceptHit((enter >= 0.0) ? enter : leave, distance);
+}
+
+/***********************************************************
+ * IntersectSphere()
+ ***********************************************************/
+bool ShapeRaycast::IntersectSphere(const glm::vec3& origin, const glm::vec3& direction, float& distance)
+{
+    double ox = origin.x, oy = origin.y, oz = origin.z;
+    double dx = direction.x, dy = direction.y, dz = direction.z;
+    double roots[2];
+    int count = SolveQuadratic(dx * dx + dy * dy + dz * dz, 2.0 * (ox * dx + oy * dy + oz * dz),
+                               ox * ox + oy * oy + oz * oz - 1.0, roots);
+    for (int i = 0; i < count; i++)
+    {
+        if (roots[i] >= 0.0)
+            return AcceptHit(roots[i], distance);
+    }
+    return false;
+}
+
+/***********************************************************
+ * IntersectCylinder()
+ * The side is the cone x^2 + z^2 = (1 - k y)^2 cut to
+ * 0 <= y <= 1, with k = 0 for a straight cylinder; each
+ * cap is a disc of its end's radius.
+ ***********************************************************/
+bool ShapeRaycast::IntersectCylinder(const glm::vec3& origin, const glm::vec3& direction, float topRadius,
+                                     bool bTop, bool bBottom, bool bSides, float& distance)
+{
+    double ox = origin.x, oy = origin.y, oz = origin.z;
+    double dx = direction.x, dy = direction.y, dz = direction.z;
+    double k = 1.0 - topRadius;
+    bool bHit = false;
+
+    if (bSides)
+    {
+        double w = 1.0 - k * oy;
+        double roots[2];
+        int count = SolveQuadratic(dx * dx + dz * dz - k * k * dy * dy,
+                                   2.0 * (ox * dx + oz * dz + w * k * dy),
+                                   ox * ox + oz * oz - w * w, roots);
+        for (int i = 0; i < count; i++)
+        {
+            double y = oy + roots[i] * dy;
+            if (y >= 0.0 && y <= 1.0 && AcceptHit(roots[i], distance))
+            {
+                bHit = true;
+                break;
+            }
+        }
+    }
+
+    if (dy != 0.0)
+    {
+        const double capHeights[2] = { 0.0, 1.0 };
+        const double capRadii[2] = { 1.0, topRadius };
+        const bool bCaps[2] = { bBottom, bTop };
+        for (int cap = 0; cap < 2; cap++)
+        {
+            if (!bCaps[cap])
+                continue;
+            double t = (capHeights[cap] - oy) / dy;
+            double x = ox + t * dx;
+            double z = oz + t * dz;
+            if (x * x + z * z <= capRadii[cap] * capRadii[cap] && AcceptHit(t, distance))
+                bHit = true;
+        }
+    }
+    return bHit;
+}
+
+/***********************************************************
+ * IntersectTorus()
+ * Points on the torus satisfy
+ *   (|p|^2 + R^2 - r^2)^2 = 4 R^2 (x^2 + y^2)
+ * with ring radius R = 1 and tube radius r. Along the ray
+ * that's a quartic in t, solved over just the stretch inside
+ * a box around the torus, measured from where the ray
+ * enters it so the coefficients stay small.
+ ***********************************************************/
+bool ShapeRaycast::IntersectTorus(const glm::vec3& origin, const glm::vec3& direction, float tubeRadius, float& distance)
+{
+    glm::vec3 extent = glm::vec3(1.0f + tubeRadius, 1.0f + tubeRadius, tubeRadius) * (1.0f + TORUS_BOX_PADDING);
+    double enter;
+    double leave;
+    if (!ClipToBox(origin, direction, -extent, extent, enter, leave))
+        return false;
+    enter = std::max(enter, 0.0);
+    leave = std::min(leave, (double)distance);
+    if (enter > leave)
+        return false;
+
+    double dx = direction.x, dy = direction.y, dz = direction.z;
+    double ox = origin.x + dx * enter, oy = origin.y + dy * enter, oz = origin.z + dz * enter;
+    double a = dx * dx + dy * dy + dz * dz;
+    double b = ox * dx + oy * dy + oz * dz;
+    double m = ox * ox + oy * oy + oz * oz + 1.0 - (double)tubeRadius * tubeRadius;
+    double coefficients[5] = {
+        m * m - 4.0 * (ox * ox + oy * oy),
+        4.0 * b * m - 8.0 * (ox * dx + oy * dy),
+        4.0 * b * b + 2.0 * a * m - 4.0 * (dx * dx + dy * dy),
+        4.0 * a * b,
+        a * a
+    };
+
+    double roots[4];
+    if (FindRoots(coefficients, 4, 0.0, leave - enter, roots) == 0)
+        return false;
+    return AcceptHit(enter + roots[0], distance);
+}
+
+/***********************************************************
+ * RunBenchmark()
+ * Boxes, spheres, cylinders and tori, randomly turned and
+ * sized, are scattered through a cube that grows with the
+ * count. Each pick is a ray from outside one corner to a
+ * random point inside, through SceneBVH::CastRay() with the
+ * exact tests, the way SceneManager picks. The same rays
+ * against the bounds alone show what the exact tests cost
+ * and how often they change the answer.
+ ***********************************************************/
+void ShapeRaycast::RunBenchmark(const std::vector<std::string>& args)
+{
+    std::vector<size_t> counts;
+    for (const std::string& arg : args)
+    {
+        size_t count = (size_t)std::strtoull(arg.c_str(), nullptr, 10);
+        if (count > 0)
+            counts.push_back(count);
+    }
+    if (counts.empty())
+        counts.assign(std::begin(BENCHMARK_COUNTS), std::end(BENCHMARK_COUNTS));
+
+    for (size_t count : counts)
+    {
+        float side = std::cbrt((float)count) * BENCHMARK_SPACING;
+        std::mt19937 random((unsigned)count);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<int> shapes(count);
+        std::vector<glm::mat4> toObject(count);
+        std::vector<EntityStore::BOUNDS> bounds(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            shapes[i] = (int)(i % BENCHMARK_SHAPE_COUNT);
+            glm::vec3 position(unit(random) * side, unit(random) * side, unit(random) * side);
+            glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.01f));
+            glm::vec3 scale(0.3f + unit(random), 0.3f + unit(random), 0.3f + unit(random));
+            glm::mat4 world = glm::translate(position) * glm::rotate(unit(random) * 6.2832f, axis) * glm::scale(scale);
+            toObject[i] = glm::inverse(world);
+
+            glm::vec3 localMin(-1.0f);
+            glm::vec3 localMax(1.0f);
+            if (shapes[i] == BENCHMARK_BOX)
+            {
+                localMin = glm::vec3(-0.5f);
+                localMax = glm::vec3(0.5f);
+            }
+            else if (shapes[i] == BENCHMARK_CYLINDER || shapes[i] == BENCHMARK_TAPERED_CYLINDER)
+            {
+                localMin.y = 0.0f;
+            }
+            else if (shapes[i] == BENCHMARK_TORUS)
+            {
+                localMin = -glm::vec3(1.0f + BENCHMARK_TUBE_RADIUS, 1.0f + BENCHMARK_TUBE_RADIUS, BENCHMARK_TUBE_RADIUS);
+                localMax = -localMin;
+            }
+            bounds[i] = TransformLocalBounds(world, localMin, localMax);
+        }
+
+        auto buildStart = std::chrono::steady_clock::now();
+        SceneBVH bvh(nullptr);
+        bvh.Build(bounds.data(), count);
+        double buildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+        glm::vec3 eye(-0.25f * side, 0.75f * side, -0.25f * side);
+        std::vector<glm::vec3> directions(BENCHMARK_PICKS);
+        for (glm::vec3& direction : directions)
+            direction = glm::normalize(glm::vec3(unit(random) * side, unit(random) * side, unit(random) * side) - eye);
+        float maxDistance = side * 3.0f;
+
+        double bestExact = 0.0;
+        double bestBounds = 0.0;
+        int exactHits = 0;
+        int boundsHits = 0;
+        int changed = 0;
+        for (int run = 0; run < BENCHMARK_RUNS; run++)
+        {
+            std::vector<int> exactPicks(BENCHMARK_PICKS);
+            auto startTime = std::chrono::steady_clock::now();
+            for (int pick = 0; pick < BENCHMARK_PICKS; pick++)
+            {
+                const glm::vec3& direction = directions[pick];
+                float hitDistance;
+                exactPicks[pick] = bvh.CastRay(eye, direction, maxDistance, [&](int item, float& distance)
+                {
+                    glm::vec3 localOrigin = glm::vec3(toObject[item] * glm::vec4(eye, 1.0f));
+                    glm::vec3 localDirection = glm::vec3(toObject[item] * glm::vec4(direction, 0.0f));
+                    switch (shapes[item])
+                    {
+                    case BENCHMARK_BOX:
+                        return IntersectBox(localOrigin, localDirection, glm::vec3(-0.5f), glm::vec3(0.5f), distance);
+                    case BENCHMARK_SPHERE:
+                        return IntersectSphere(localOrigin, localDirection, distance);
+                    case BENCHMARK_CYLINDER:
+                        return IntersectCylinder(localOrigin, localDirection, 1.0f, true, true, true, distance);
+                    case BENCHMARK_TAPERED_CYLINDER:
+                        return IntersectCylinder(localOrigin, localDirection, BENCHMARK_TAPER, true, true, true, distance);
+                    default:
+                        return IntersectTorus(localOrigin, localDirection, BENCHMARK_TUBE_RADIUS, distance);
+                    }
+                }, hitDistance);
+            }
+            auto exactTime = std::chrono::steady_clock::now();
+
+            std::vector<int> boundsPicks(BENCHMARK_PICKS);
+            for (int pick = 0; pick < BENCHMARK_PICKS; pick++)
+            {
+                float hitDistance;
+                boundsPicks[pick] = bvh.CastRay(eye, directions[pick], maxDistance, SceneBVH::RAY_TEST(), hitDistance);
+            }
+            auto boundsTime = std::chrono::steady_clock::now();
+
+            double exactSeconds = std::chrono::duration<double>(exactTime - startTime).count();
+            double boundsSeconds = std::chrono::duration<double>(boundsTime - exactTime).count();
+            if (run == 0 || exactSeconds < bestExact)
+                bestExact = exactSeconds;
+            if (run == 0 || boundsSeconds < bestBounds)
+                bestBounds = boundsSeconds;
+
+            exactHits = 0;
+            boundsHits = 0;
+            changed = 0;
+            for (int pick = 0; pick < BENCHMARK_PICKS; pick++)
+            {
+                exactHits += (exactPicks[pick] >= 0) ? 1 : 0;
+                boundsHits += (boundsPicks[pick] >= 0) ? 1 : 0;
+                changed += (exactPicks[pick] != boundsPicks[pick]) ? 1 : 0;
+            }
+        }
+
+        std::cout << "INFO: Picking among " << count << " shapes (BVH built in " << buildMilliseconds
+                  << " ms): exact " << PerPick(bestExact) << " us a pick (" << exactHits << "/" << BENCHMARK_PICKS
+                  << " hit), bounds only " << PerPick(bestBounds) << " us (" << boundsHits << " hit, "
+                  << changed << " picks differ)" << std::endl;
+    }
+}
@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShapeRaycast.h
+// ============
+// Exact ray intersections with the unit shapes the scene is built from,
+// for picking objects under the cursor.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  ShapeRaycast
+ *
+ *  Each test takes a ray already carried into the shape's
+ *  object space by the inverse of its world transform. The
+ *  direction is left unnormalized there, so a distance along
+ *  it is the same distance along the world ray.
+ *
+ *  Every test has the shape of a SceneBVH::RAY_TEST: it
+ *  returns true and lowers distance only for a surface hit
+ *  at or past the origin and closer than distance already
+ *  was. A ray starting inside a solid shape hits it where
+ *  it leaves.
+ *
+ *  Shapes match ShapeMeshes and MeshLibrary: the plane is
+ *  the 2x2 square at y = 0, the box the unit cube around the
+ *  origin, the sphere radius 1, the cylinders radius 1 from
+ *  y = 0 to 1, and the torus a ring of radius 1 about Z.
+ ***********************************************************/
+class ShapeRaycast
+{
+public:
+    static bool IntersectPlane(const glm::vec3& origin, const glm::vec3& direction, float& distance);
+    // any axis-aligned box, e.g. an imported mesh's bounds
+    static bool IntersectBox(const glm::vec3& origin, const glm::vec3& direction,
+                             const glm::vec3& boxMin, const glm::vec3& boxMax, float& distance);
+    static bool IntersectSphere(const glm::vec3& origin, const glm::vec3& direction, float& distance);
+    // topRadius below 1 gives the tapered cylinder; parts left out
+    // of the draw can't be hit
+    static bool IntersectCylinder(const glm::vec3& origin, const glm::vec3& direction, float topRadius,
+                                  bool bTop, bool bBottom, bool bSides, float& distance);
+    static bool IntersectTorus(const glm::vec3& origin, const glm::vec3& direction, float tubeRadius, float& distance);
+
+    // Time picks through a BVH of each count of scattered shapes in
+    // args (10k, 100k and 1M by default) and log them
+    static void RunBenchmark(const std::vector<std::string>& args);
+};
@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+// StressTest.cpp
+// ============
+// Runs the render loop over tiled copies of the scene at increasing object
+// counts and logs frame time, draw calls and memory at each.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StressTest.h"
+#include "SceneManager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Object counts used when none are given, and how many frames
+    // each stage skips and then measures
+    const size_t STRESS_COUNTS[] = { 1000, 10000, 100000, 1000000 };
+    const int WARMUP_FRAMES = 30;
+    const int MEASURED_FRAMES = 120;
+
+    double Milliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+/***********************************************************
+ * StressTest()
+ ***********************************************************/
+StressTest::StressTest(SceneManager* pSceneManager, const std::vector<std::string>& args)
+{
+    m_pSceneManager = pSceneManager;
+    for (const std::string& arg : args)
+    {
+        size_t count = (size_t)std::strtoull(arg.c_str(), nullptr, 10);
+        if (count > 0)
+            m_counts.push_back(count);
+    }
+    if (m_counts.empty())
+        m_counts.assign(std::begin(STRESS_COUNTS), std::end(STRESS_COUNTS));
+
+    m_stage = 0;
+    m_frame = 0;
+    m_bLoaded = false;
+    m_loadMilliseconds = 0.0;
+    m_cpuSum = 0.0;
+    m_cpuWorst = 0.0;
+    m_frameSum = 0.0;
+    m_frameWorst = 0.0;
+    m_drawCallSum = 0;
+    m_drawnSum = 0;
+}
+
+/***********************************************************
+ * BeginFrame()
+ * The gap since the last BeginFrame() is the previous
+ * frame's full time; it only counts once that frame was
+ * itself a measured one.
+ ***********************************************************/
+void StressTest::BeginFrame()
+{
+    CLOCK::time_point now = CLOCK::now();
+    if (m_bLoaded && m_frame > WARMUP_FRAMES)
+    {
+        double frameMilliseconds = Milliseconds(now - m_frameStart);
+        m_frameSum += frameMilliseconds;
+        m_frameWorst = std::max(m_frameWorst, frameMilliseconds);
+    }
+
+    if (!m_bLoaded && m_stage < m_counts.size())
+    {
+        if (!m_pSceneManager->LoadStressScene(m_counts[m_stage]))
+            std::cout << "ERROR: Couldn't build a stress scene of " << m_counts[m_stage] << " objects" << std::endl;
+        m_loadMilliseconds = Milliseconds(CLOCK::now() - now);
+        m_bLoaded = true;
+        m_frame = 0;
+        m_cpuSum = 0.0;
+        m_cpuWorst = 0.0;
+        m_frameSum = 0.0;
+        m_frameWorst = 0.0;
+        m_drawCallSum = 0;
+        m_drawnSum = 0;
+        now = CLOCK::now();
+    }
+
+    m_frameStart = now;
+}
+
+/***********************************************************
+ * EndFrame()
+ * The last measured frame's full time is picked up by the
+ * BeginFrame() after it, so a stage is reported one frame
+ * after its last measurement.
+ ***********************************************************/
+bool StressTest::EndFrame()
+{
+    if (m_stage >= m_counts.size())
+        return false;
+
+    m_frame++;
+    if (m_frame <= WARMUP_FRAMES)
+        return true;
+
+    if (m_frame <= WARMUP_FRAMES + MEASURED_FRAMES)
+    {
+        double cpuMilliseconds = Milliseconds(CLOCK::now() - m_frameStart);
+        m_cpuSum += cpuMilliseconds;
+        m_cpuWorst = std::max(m_cpuWorst, cpuMilliseconds);
+        const SceneManager::FRAME_STATS& stats = m_pSceneManager->GetFrameStats();
+        m_drawCallSum += stats.drawCalls;
+        m_drawnSum += stats.drawn;
+        return true;
+    }
+
+    ReportStage();
+    m_stage++;
+    m_bLoaded = false;
+    return m_stage < m_counts.size();
+}
+
+/***********************************************************
+ * ReportStage()
+ ***********************************************************/
+void StressTest::ReportStage() const
+{
+    const SceneManager::FRAME_STATS& stats = m_pSceneManager->GetFrameStats();
+    std::cout << "INFO: Stress " << m_counts[m_stage] << " objects (" << stats.objects
+              << " entities and plants): load " << m_loadMilliseconds << " ms, CPU "
+              << m_cpuSum / MEASURED_FRAMES << " ms avg / " << m_cpuWorst << " ms worst, frame "
+              << m_frameSum / MEASURED_FRAMES << " ms avg / " << m_frameWorst << " ms worst, "
+              << m_drawCallSum / MEASURED_FRAMES << " draw calls, "
+              << m_drawnSum / MEASURED_FRAMES << " drawn, "
+              << GetResidentBytes() / (1024.0 * 1024.0) << " MB resident" << std::endl;
+}
+
+/***********************************************************
+ * GetResidentBytes()
+ ***********************************************************/
+size_t StressTest::GetResidentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (size_t)counters.WorkingSetSize;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount) != KERN_SUCCESS)
+        return 0;
+    return (size_t)info.resident_size;
+#else
+    // second field of statm is resident pages
+    FILE* pFile = std::fopen("/proc/self/statm", "r");
+    if (!pFile)
+        return 0;
+    unsigned long pages = 0;
+    unsigned long residentPages = 0;
+    int fields = std::fscanf(pFile, "%lu %lu", &pages, &residentPages);
+    std::fclose(pFile);
+    return fields == 2 ? (size_t)residentPages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
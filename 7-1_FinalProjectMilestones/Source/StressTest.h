@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// StressTest.h
+// ============
+// Runs the render loop over tiled copies of the scene at increasing object
+// counts and logs frame time, draw calls and memory at each.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class SceneManager;
+
+/***********************************************************
+ *  StressTest
+ *
+ *  Drives SceneManager::LoadStressScene() from the main
+ *  loop, one stage per object count. Each stage lets
+ *  WARMUP_FRAMES frames go by for caches and drivers to
+ *  settle, then measures MEASURED_FRAMES frames: the CPU
+ *  time from BeginFrame() to EndFrame(), which covers the
+ *  scene update and every GL call issued, and the full
+ *  frame from one BeginFrame() to the next, which adds the
+ *  buffer swap and event polling.
+ ***********************************************************/
+class StressTest
+{
+public:
+    // args are object counts; 1k, 10k, 100k and 1M by default
+    StressTest(SceneManager* pSceneManager, const std::vector<std::string>& args);
+
+    // call at the top of each frame; loads the next stage's scene
+    // when the last one is done
+    void BeginFrame();
+    // call once the frame's GL calls are issued, before the swap;
+    // false once every stage has been logged
+    bool EndFrame();
+
+    // resident memory of this process in bytes, 0 if unknown
+    static size_t GetResidentBytes();
+
+private:
+    typedef std::chrono::steady_clock CLOCK;
+
+    // log the stage just measured
+    void ReportStage() const;
+
+    SceneManager* m_pSceneManager;
+    std::vector<size_t> m_counts;
+    // stage being run, and frames into it
+    size_t m_stage;
+    int m_frame;
+    // whether this stage's scene is loaded
+    bool m_bLoaded;
+    double m_loadMilliseconds;
+
+    CLOCK::time_point m_frameStart;
+    // sums and worst cases over the measured frames
+    double m_cpuSum;
+    double m_cpuWorst;
+    double m_frameSum;
+    double m_frameWorst;
+    long long m_drawCallSum;
+    long long m_drawnSum;
+};
@@ -15,12 +15,23 @@
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/type_ptr.hpp>    
 
+#include <map>
+
 // Namespace for internal globals
 namespace
 {
     const int WINDOW_WIDTH = 1000;
     const int WINDOW_HEIGHT = 800;
 
+    // Current window size in screen coordinates, which the cursor uses,
+    // and its framebuffer size in pixels, which rendering uses
+    int gWindowWidth = WINDOW_WIDTH;
+    int gWindowHeight = WINDOW_HEIGHT;
+    int gFramebufferWidth = WINDOW_WIDTH;
+    int gFramebufferHeight = WINDOW_HEIGHT;
+    // projection aspect, left alone while the window is minimized
+    float gAspect = (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT;
+
     // Camera pointer for 3D scene interaction
     Camera* g_pCamera = nullptr;
 
@@ -29,12 +40,16 @@ namespace
     float gLastY = WINDOW_HEIGHT / 2.0f;
     bool gFirstMouse = true;
 
-    // Frame timing
-    float gDeltaTime = 0.0f;
-    float gLastFrame = 0.0f;
+    // Camera position before the latest simulation step, for blending
+    glm::vec3 gPreviousPosition(0.0f);
 
     // Tracks current projection mode so the mouse callback can check it
     bool g_bOrthographic = false;
+
+    // Last known state of each toggle key, for press-once detection
+    std::map<int, bool> gKeyWasDown;
+    // and of the left mouse button, for click detection
+    bool gLeftButtonWasDown = false;
 }
 
 /***********************************************************
@@ -42,6 +57,12 @@ namespace
  ***********************************************************/
 ViewManager::ViewManager(ShaderManager* pShaderManager)
     : bOrthographicProjection(false) // Initialize member
+    , m_pRenderSettings(nullptr)
+    , m_pStateCache(nullptr)
+    , m_viewMatrix(1.0f)
+    , m_projectionMatrix(1.0f)
+    , m_bPickRequested(false)
+    , m_pickPoint(0.0f)
 {
     m_pShaderManager = pShaderManager;
     m_pWindow = nullptr;
@@ -52,6 +73,7 @@ ViewManager::ViewManager(ShaderManager* pShaderManager)
     g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
     g_pCamera->Zoom = 80;
     g_pCamera->MovementSpeed = 10;
+    gPreviousPosition = g_pCamera->Position;
 }
 
 /***********************************************************
@@ -86,6 +108,12 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
     glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
+    // Track resizes; a HiDPI framebuffer is already bigger than asked for
+    glfwSetWindowSizeCallback(window, &ViewManager::Window_Size_Callback);
+    glfwSetFramebufferSizeCallback(window, &ViewManager::Framebuffer_Size_Callback);
+    glfwGetWindowSize(window, &gWindowWidth, &gWindowHeight);
+    glfwGetFramebufferSize(window, &gFramebufferWidth, &gFramebufferHeight);
+
     // Enable blending for transparency
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -119,6 +147,41 @@ void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos,
     g_pCamera->ProcessMouseMovement(xOffset, yOffset);
 }
 
+/***********************************************************
+ *  Window_Size_Callback
+ ***********************************************************/
+void ViewManager::Window_Size_Callback(GLFWwindow* window, int width, int height)
+{
+    gWindowWidth = width;
+    gWindowHeight = height;
+}
+
+/***********************************************************
+ *  Framebuffer_Size_Callback
+ *
+ *  The viewport is set from this size at the start of each
+ *  frame, so it only needs recording here. A minimized
+ *  window reports 0 x 0.
+ ***********************************************************/
+void ViewManager::Framebuffer_Size_Callback(GLFWwindow* window, int width, int height)
+{
+    gFramebufferWidth = width;
+    gFramebufferHeight = height;
+}
+
+/***********************************************************
+ *  GetFramebufferWidth / GetFramebufferHeight
+ ***********************************************************/
+int ViewManager::GetFramebufferWidth() const
+{
+    return gFramebufferWidth;
+}
+
+int ViewManager::GetFramebufferHeight() const
+{
+    return gFramebufferHeight;
+}
+
 /***********************************************************
  *  ProcessKeyboardEvents
  ***********************************************************/
@@ -130,55 +193,158 @@ void ViewManager::ProcessKeyboardEvents()
     if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(m_pWindow, true);
 
-    // Camera movement
-    if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-        g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-    if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-        g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-    if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-        g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-    if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-        g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-    if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-        g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-    if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-        g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-
     // Projection switching — reset gFirstMouse when toggling so the camera
-    // doesn't jump from stale mouse coordinates when returning to perspective
+    // doesn't jump from stale mouse coordinates when returning to perspective.
+    // The cursor is shown while mouse look is off, so clicks can point.
     if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS && !bOrthographicProjection)
     {
         bOrthographicProjection = true;
         g_bOrthographic = true;
         gFirstMouse = true;
+        glfwSetInputMode(m_pWindow, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
     }
     if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS && bOrthographicProjection)
     {
         bOrthographicProjection = false;
         g_bOrthographic = false;
         gFirstMouse = true; // Prevent jump when re-enabling mouse look
+        glfwSetInputMode(m_pWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+
+    // Render toggles
+    if (m_pRenderSettings)
+    {
+        if (WasKeyPressed(GLFW_KEY_C))
+            m_pRenderSettings->bOcclusionCulling = !m_pRenderSettings->bOcclusionCulling;
+        if (WasKeyPressed(GLFW_KEY_L))
+            m_pRenderSettings->bLevelOfDetail = !m_pRenderSettings->bLevelOfDetail;
+        if (WasKeyPressed(GLFW_KEY_Z))
+            m_pRenderSettings->bDepthPrepass = !m_pRenderSettings->bDepthPrepass;
+        if (WasKeyPressed(GLFW_KEY_V))
+            m_pRenderSettings->bOverdrawView = !m_pRenderSettings->bOverdrawView;
+        if (WasKeyPressed(GLFW_KEY_G))
+            m_pRenderSettings->bStateFilter = !m_pRenderSettings->bStateFilter;
+        if (WasKeyPressed(GLFW_KEY_K))
+            m_pRenderSettings->bPackedVertices = !m_pRenderSettings->bPackedVertices;
+        if (WasKeyPressed(GLFW_KEY_M))
+            m_pRenderSettings->bProceduralMeshes = !m_pRenderSettings->bProceduralMeshes;
+        if (WasKeyPressed(GLFW_KEY_J))
+            m_pRenderSettings->bMeshletCulling = !m_pRenderSettings->bMeshletCulling;
+        if (WasKeyPressed(GLFW_KEY_B))
+            m_pRenderSettings->bBonsaiWind = !m_pRenderSettings->bBonsaiWind;
+        if (WasKeyPressed(GLFW_KEY_T))
+            m_pRenderSettings->bProceduralPlants = !m_pRenderSettings->bProceduralPlants;
+        if (WasKeyPressed(GLFW_KEY_R))
+            m_pRenderSettings->bDynamicResolution = !m_pRenderSettings->bDynamicResolution;
+    }
+}
+
+/***********************************************************
+ *  StepSimulation
+ *
+ *  Called zero or more times a frame by the fixed-step
+ *  loop, so the camera covers the same ground per second
+ *  whatever the frame rate.
+ ***********************************************************/
+void ViewManager::StepSimulation(double stepSeconds)
+{
+    if (!m_pWindow || !g_pCamera) return;
+
+    gPreviousPosition = g_pCamera->Position;
+
+    float seconds = (float)stepSeconds;
+    if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+        g_pCamera->ProcessKeyboard(FORWARD, seconds);
+    if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+        g_pCamera->ProcessKeyboard(BACKWARD, seconds);
+    if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+        g_pCamera->ProcessKeyboard(LEFT, seconds);
+    if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+        g_pCamera->ProcessKeyboard(RIGHT, seconds);
+    if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+        g_pCamera->ProcessKeyboard(UP, seconds);
+    if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+        g_pCamera->ProcessKeyboard(DOWN, seconds);
+}
+
+/***********************************************************
+ *  WasKeyPressed
+ *
+ *  Edge-triggered key check so holding a toggle key down
+ *  doesn't flip the setting every frame.
+ ***********************************************************/
+bool ViewManager::WasKeyPressed(int key)
+{
+    bool bDown = glfwGetKey(m_pWindow, key) == GLFW_PRESS;
+    bool bWasDown = gKeyWasDown[key];
+    gKeyWasDown[key] = bDown;
+    return bDown && !bWasDown;
+}
+
+/***********************************************************
+ *  ProcessMouseButtons
+ *
+ *  A click counts on the frame the button goes down. GLFW
+ *  gives the cursor in window coordinates, y down.
+ ***********************************************************/
+void ViewManager::ProcessMouseButtons()
+{
+    bool bDown = glfwGetMouseButton(m_pWindow, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    bool bClicked = bDown && !gLeftButtonWasDown;
+    gLeftButtonWasDown = bDown;
+    if (!bClicked)
+        return;
+
+    m_pickPoint = glm::vec2(0.0f);
+    if (bOrthographicProjection)
+    {
+        double xPos = 0.0;
+        double yPos = 0.0;
+        glfwGetCursorPos(m_pWindow, &xPos, &yPos);
+        if (gWindowWidth > 0 && gWindowHeight > 0)
+            m_pickPoint = glm::vec2(2.0f * (float)xPos / gWindowWidth - 1.0f,
+                                    1.0f - 2.0f * (float)yPos / gWindowHeight);
     }
+    m_bPickRequested = true;
+}
+
+/***********************************************************
+ *  TakePickRequest
+ ***********************************************************/
+bool ViewManager::TakePickRequest(glm::vec2& screenPoint)
+{
+    if (!m_bPickRequested)
+        return false;
+    m_bPickRequested = false;
+    screenPoint = m_pickPoint;
+    return true;
 }
 
 /***********************************************************
  *  PrepareSceneView
+ *
+ *  Only the position is blended; mouse look turns the
+ *  camera as events arrive, so it is already current.
  ***********************************************************/
-void ViewManager::PrepareSceneView()
+void ViewManager::PrepareSceneView(double alpha)
 {
     if (!m_pWindow) return;
 
-    // Timing
-    float currentFrame = glfwGetTime();
-    gDeltaTime = currentFrame - gLastFrame;
-    gLastFrame = currentFrame;
-
-    // Handle keyboard input
+    // Handle keyboard and mouse button input
     ProcessKeyboardEvents();
+    ProcessMouseButtons();
 
-    // View matrix from camera
+    // View matrix from the camera, lent the blended position for the call
+    glm::vec3 position = g_pCamera->Position;
+    glm::vec3 drawnPosition = glm::mix(gPreviousPosition, position, (float)alpha);
+    g_pCamera->Position = drawnPosition;
     glm::mat4 view = g_pCamera->GetViewMatrix();
+    g_pCamera->Position = position;
+
+    // Projection, shaped to the framebuffer
+    if (gFramebufferWidth > 0 && gFramebufferHeight > 0)
+        gAspect = (float)gFramebufferWidth / (float)gFramebufferHeight;
 
-    // Projection
     glm::mat4 projection;
     if (bOrthographicProjection)
     {
@@ -187,22 +353,27 @@ void ViewManager::PrepareSceneView()
         // conflicts with the mouse callback and freezes mouse control.
         float scale = 10.0f;
         projection = glm::ortho(
-            -scale, scale,
+            -scale * gAspect, scale * gAspect,
             -scale, scale,
             0.1f, 100.0f);
     }
     else
     {
         projection = glm::perspective(glm::radians(g_pCamera->Zoom),
-                                      (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT,
+                                      gAspect,
                                       0.1f, 100.0f);
     }
 
+    // Keep a copy for CPU-side culling
+    m_viewMatrix = view;
+    m_projectionMatrix = projection;
+
     // Send matrices and camera position to shader
     if (m_pShaderManager)
     {
-        m_pShaderManager->setMat4Value("view", view);
-        m_pShaderManager->setMat4Value("projection", projection);
-        m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+        m_pStateCache->UseProgram(m_pShaderManager);
+        m_pStateCache->SetMat4Value(m_pShaderManager, "view", view);
+        m_pStateCache->SetMat4Value(m_pShaderManager, "projection", projection);
+        m_pStateCache->SetVec3Value(m_pShaderManager, "viewPosition", drawnPosition);
     }
 }
\ No newline at end of file
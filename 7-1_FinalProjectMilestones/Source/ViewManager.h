@@ -15,6 +15,8 @@
 #include <glm/glm.hpp>
 
 #include "ShaderManager.h"
+#include "GLStateCache.h"
+#include "RenderSettings.h"
 #include "camera.h"
 
 /***********************************************************
@@ -34,15 +36,44 @@ public:
     // Create the GLFW window and initialize OpenGL context
     GLFWwindow* CreateDisplayWindow(const char* windowTitle);
 
-    // Update the view and projection matrices, handle input
-    void PrepareSceneView();
+    // Move the camera one fixed simulation step from the held keys
+    void StepSimulation(double stepSeconds);
+    // Update the view and projection matrices, handle input; the camera
+    // is drawn alpha of the way from its previous step to its latest
+    void PrepareSceneView(double alpha);
 
     // Static callback for mouse movement
     static void Mouse_Position_Callback(GLFWwindow* window, double xPos, double yPos);
+    // Static callbacks for the window and its framebuffer changing size;
+    // the two differ on HiDPI displays
+    static void Window_Size_Callback(GLFWwindow* window, int width, int height);
+    static void Framebuffer_Size_Callback(GLFWwindow* window, int width, int height);
+
+    // Size of the window's framebuffer in pixels, kept current by the callback
+    int GetFramebufferWidth() const;
+    int GetFramebufferHeight() const;
+
+    // Hook up the shared runtime render toggles
+    void SetRenderSettings(RENDER_SETTINGS* pRenderSettings) { m_pRenderSettings = pRenderSettings; }
+    // Hook up the shared GL state filter; must be set before PrepareSceneView()
+    void SetStateCache(GLStateCache* pStateCache) { m_pStateCache = pStateCache; }
+
+    // Matrices computed by the last PrepareSceneView() call
+    const glm::mat4& GetViewMatrix() const { return m_viewMatrix; }
+    const glm::mat4& GetProjectionMatrix() const { return m_projectionMatrix; }
+
+    // True once per left click, with where it landed in normalized
+    // device coordinates: the cursor in the orthographic view, where it
+    // moves freely, or the middle of the view while it steers the camera
+    bool TakePickRequest(glm::vec2& screenPoint);
 
 private:
-    // Process keyboard events each frame
+    // Process keyboard events each frame; movement is in StepSimulation()
     void ProcessKeyboardEvents();
+    // True only on the frame a key goes from released to pressed
+    bool WasKeyPressed(int key);
+    // Turn a left click into a pick request
+    void ProcessMouseButtons();
 
     // Pointer to shader manager
     ShaderManager* m_pShaderManager;
@@ -52,4 +83,18 @@ private:
 
     // Track if orthographic projection is active
     bool bOrthographicProjection;
+
+    // Runtime render toggles, owned by main
+    RENDER_SETTINGS* m_pRenderSettings;
+
+    // Redundant state filter in front of GL, owned by main
+    GLStateCache* m_pStateCache;
+
+    // Matrices sent to the shader this frame
+    glm::mat4 m_viewMatrix;
+    glm::mat4 m_projectionMatrix;
+
+    // Click waiting for TakePickRequest()
+    bool m_bPickRequested;
+    glm::vec2 m_pickPoint;
 };
@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////////////////////
+// WorkerPool.cpp
+// ============
+// Small persistent thread pool for splitting per-frame CPU work
+// (occlusion rasterization, culling, draw list building) across cores.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+/***********************************************************
+ * WorkerPool()
+ * Starts the worker threads. They sleep until ParallelFor()
+ * hands them a batch of jobs.
+ ***********************************************************/
+WorkerPool::WorkerPool(unsigned int threadCount)
+    : m_nextJob(0)
+    , m_jobCount(0)
+    , m_activeWorkers(0)
+    , m_generation(0)
+    , m_bBatchActive(false)
+    , m_bShutdown(false)
+{
+    if (threadCount == 0)
+    {
+        // leave one core for the thread that owns the GL context
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = (cores > 1) ? cores - 1 : 0;
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+/***********************************************************
+ * ~WorkerPool()
+ * Wakes every worker with the shutdown flag set and joins
+ * them so no thread outlives the pool.
+ ***********************************************************/
+WorkerPool::~WorkerPool()
+{
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bShutdown = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+/***********************************************************
+ * ParallelFor()
+ * Runs job(i) for every i in [0, jobCount). The calling
+ * thread takes jobs too, so this also works with zero
+ * worker threads. Blocks until every job has finished.
+ * If an async batch is still running, the jobs run on the
+ * calling thread rather than waiting for the workers.
+ ***********************************************************/
+void WorkerPool::ParallelFor(int jobCount, const std::function<void(int)>& job)
+{
+    if (jobCount <= 0)
+        return;
+
+    bool bPoolFree = false;
+    if (!m_threads.empty() && jobCount > 1)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // An async batch whose workers have all finished can be collected now
+        if (m_bBatchActive && IsBatchFinished())
+            m_bBatchActive = false;
+
+        if (!m_bBatchActive)
+        {
+            StartBatch(jobCount, job);
+            bPoolFree = true;
+        }
+    }
+
+    // Not worth waking anyone for a single job, and don't queue
+    // behind someone else's batch
+    if (!bPoolFree)
+    {
+        for (int i = 0; i < jobCount; i++)
+            job(i);
+        return;
+    }
+
+    m_wakeCondition.notify_all();
+
+    // Help out instead of sitting idle
+    RunJobs();
+
+    Wait();
+}
+
+/***********************************************************
+ * ParallelForAsync()
+ * Same as ParallelFor(), but returns as soon as the workers
+ * have the batch. Call Wait() before starting another async
+ * batch or touching anything the jobs write. With no worker
+ * threads the jobs simply run inside Wait().
+ ***********************************************************/
+void WorkerPool::ParallelForAsync(int jobCount, const std::function<void(int)>& job)
+{
+    Wait();
+
+    if (jobCount <= 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        StartBatch(jobCount, job);
+    }
+    m_wakeCondition.notify_all();
+}
+
+/***********************************************************
+ * Wait()
+ * Runs whatever jobs nobody has picked up yet, then blocks
+ * until every worker is done with the batch. Does nothing
+ * if no batch is active.
+ ***********************************************************/
+void WorkerPool::Wait()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_bBatchActive)
+            return;
+    }
+
+    RunJobs();
+
+    // Wait for the stragglers before the job object gets replaced
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return IsBatchFinished(); });
+    m_bBatchActive = false;
+}
+
+/***********************************************************
+ * StartBatch()
+ * Publishes a new batch and bumps the generation so sleeping
+ * workers pick it up. The caller holds m_mutex and notifies
+ * m_wakeCondition after releasing it.
+ ***********************************************************/
+void WorkerPool::StartBatch(int jobCount, const std::function<void(int)>& job)
+{
+    m_job = job;
+    m_jobCount = jobCount;
+    m_nextJob.store(0);
+    m_activeWorkers = (int)m_threads.size();
+    m_bBatchActive = true;
+    m_generation++;
+}
+
+/***********************************************************
+ * RunJobs()
+ * Grabs job indices off the shared counter until there are
+ * none left in the current batch.
+ ***********************************************************/
+void WorkerPool::RunJobs()
+{
+    for (;;)
+    {
+        int index = m_nextJob.fetch_add(1);
+        if (index >= m_jobCount)
+            break;
+        m_job(index);
+    }
+}
+
+/***********************************************************
+ * WorkerLoop()
+ * Sleeps until a new batch (or shutdown) arrives, works the
+ * batch, then reports back to ParallelFor().
+ ***********************************************************/
+void WorkerPool::WorkerLoop()
+{
+    unsigned long long seenGeneration = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCondition.wait(lock, [&] { return m_bShutdown || m_generation != seenGeneration; });
+            if (m_bShutdown)
+                return;
+            seenGeneration = m_generation;
+        }
+
+        RunJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeWorkers--;
+        }
+        m_doneCondition.notify_one();
+    }
+}
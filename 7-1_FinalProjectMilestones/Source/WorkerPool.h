@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// WorkerPool.h
+// ============
+// Small persistent thread pool for splitting per-frame CPU work
+// (occlusion rasterization, culling, draw list building) across cores.
+//
+// AUTHOR: Emily V
+// Created for CS-330-Computational Graphics and Visualization, Feb 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  WorkerPool
+ *
+ *  Keeps a fixed set of threads parked between frames so we
+ *  don't pay thread creation costs every frame. Work is
+ *  handed out as numbered jobs; the calling thread helps out
+ *  and returns once every job has finished.
+ *
+ *  ParallelForAsync() starts a batch and returns right away
+ *  so the caller can keep going; Wait() collects it. While
+ *  an async batch is still running, ParallelFor() runs its
+ *  jobs on the calling thread instead of blocking on it.
+ ***********************************************************/
+class WorkerPool
+{
+public:
+    // constructor — 0 threads means "one less than the core count"
+    WorkerPool(unsigned int threadCount = 0);
+    // destructor
+    ~WorkerPool();
+
+    // Run job(0) .. job(jobCount - 1) across the pool and wait for all of them
+    void ParallelFor(int jobCount, const std::function<void(int)>& job);
+    // Start job(0) .. job(jobCount - 1) on the workers and return immediately
+    void ParallelForAsync(int jobCount, const std::function<void(int)>& job);
+    // Finish the batch started by ParallelForAsync(), helping with any jobs left
+    void Wait();
+
+    // Number of worker threads (not counting the calling thread)
+    unsigned int GetThreadCount() const { return (unsigned int)m_threads.size(); }
+
+private:
+    // Body of each worker thread
+    void WorkerLoop();
+    // Pull and run jobs until the current batch is exhausted
+    void RunJobs();
+    // Hand a batch to the workers; caller must hold m_mutex
+    void StartBatch(int jobCount, const std::function<void(int)>& job);
+    // True once every job is taken and every worker has left the
+    // current batch; caller must hold m_mutex
+    bool IsBatchFinished() const { return m_activeWorkers == 0 && m_nextJob.load() >= m_jobCount; }
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+
+    // current batch of jobs — copied so async batches outlive the caller's lambda
+    std::function<void(int)> m_job;
+    std::atomic<int> m_nextJob;
+    int m_jobCount;
+    // workers still busy with the current batch
+    int m_activeWorkers;
+    // bumped every batch so sleeping workers know there is new work
+    unsigned long long m_generation;
+    // a batch has been started and not yet collected
+    bool m_bBatchActive;
+    bool m_bShutdown;
+};
@@ -0,0 +1,14 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthFragmentShader.glsl
+// ============
+// Depth pre-pass fragment shader. Color writes are masked off during the
+// pre-pass, so this only exists to complete the program.
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+out vec4 outFragmentColor;
+
+void main()
+{
+    outFragmentColor = vec4(1.0f);
+}
@@ -0,0 +1,20 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthVertexShader.glsl
+// ============
+// Depth pre-pass vertex shader for buffer meshes. It computes positions the
+// same way as the main vertex shader, but the two programs aren't
+// guaranteed to give bit-identical depths, so the scene manager draws
+// these with a polygon offset and tests the Phong pass GL_LEQUAL.
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(inVertexPosition, 1.0f);
+}
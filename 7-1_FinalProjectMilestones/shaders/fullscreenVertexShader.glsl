@@ -0,0 +1,16 @@
+///////////////////////////////////////////////////////////////////////////////
+// fullscreenVertexShader.glsl
+// ============
+// Covers the viewport with one triangle built from gl_VertexID, so no
+// vertex buffer is needed. Draw with glDrawArrays(GL_TRIANGLES, 0, 3).
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+out vec2 fragmentTextureCoordinate;
+
+void main()
+{
+    vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    fragmentTextureCoordinate = corner;
+    gl_Position = vec4(corner * 2.0f - 1.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedVertexShader.glsl
+// ============
+// Draws one MeshLibrary mesh many times in a single call: each instance
+// brings its own transform (attributes 3-6) and taper (attribute 7),
+// applied inside the shared model matrix. A taper below 1 narrows a
+// unit cylinder towards its top and tilts its side normals to match;
+// at 1 the mesh is left as it is.
+//
+// Outputs match the shared Phong vertex shader, so this links against
+// its fragment shader as well as the depth pre-pass one.
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in float instanceTaper;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+
+// the Phong and depth programs must place every vertex identically
+invariant gl_Position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    vec3 position = inVertexPosition;
+    position.xz *= mix(1.0f, instanceTaper, position.y);
+
+    // a cone's side normal leans up by how much the radius shrinks;
+    // cap normals have no sideways part and are left alone
+    vec3 normal = inVertexNormal;
+    normal.y += (1.0f - instanceTaper) * length(normal.xz);
+
+    mat4 world = model * instanceModel;
+    fragmentPosition = vec3(world * vec4(position, 1.0f));
+    fragmentVertexNormal = mat3(transpose(inverse(world))) * normal;
+    fragmentTextureCoordinate = inTextureCoordinate;
+    gl_Position = projection * view * world * vec4(position, 1.0f);
+}
@@ -0,0 +1,14 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawCountFragmentShader.glsl
+// ============
+// Overdraw view counting pass. Every fragment adds 1 to its pixel through
+// additive blending into a float target.
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+out vec4 outFragmentColor;
+
+void main()
+{
+    outFragmentColor = vec4(1.0f, 0.0f, 0.0f, 0.0f);
+}
@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawHeatmapFragmentShader.glsl
+// ============
+// Overdraw view display pass. Maps per-pixel fragment counts to colors:
+// black = nothing drawn, blue = 1, green = 2, yellow = 4, red = 8,
+// white = 16 or more.
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outFragmentColor;
+
+uniform sampler2D overdrawCounts;
+
+void main()
+{
+    float count = texture(overdrawCounts, fragmentTextureCoordinate).r;
+
+    const vec3 ramp[6] = vec3[6](
+        vec3(0.0f, 0.0f, 0.0f),
+        vec3(0.0f, 0.2f, 0.9f),
+        vec3(0.0f, 0.8f, 0.2f),
+        vec3(1.0f, 0.9f, 0.0f),
+        vec3(1.0f, 0.1f, 0.0f),
+        vec3(1.0f, 1.0f, 1.0f));
+
+    // 0 stays black; each step above 1 is a doubling of the count
+    float position = (count < 1.0f) ? count : 1.0f + log2(count);
+    position = clamp(position, 0.0f, 5.0f);
+    int index = int(floor(position));
+    vec3 color = mix(ramp[index], ramp[min(index + 1, 5)], position - float(index));
+
+    outFragmentColor = vec4(color, 1.0f);
+}
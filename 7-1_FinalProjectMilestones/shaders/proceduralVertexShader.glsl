@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// proceduralVertexShader.glsl
+// ============
+// Builds the curved primitives (sphere, cylinder, tapered cylinder,
+// torus) from gl_VertexID with no vertex buffers. Triangles come out in
+// the same order, winding and parameterization as MeshLibrary's
+// generators, unindexed: vertex 3t + c is corner c of triangle t.
+// Cylinders lay out [bottom][sides][top][bottom] like MeshLibrary, so
+// every combination of parts is a single glDrawArrays() range.
+//
+// Outputs match the shared Phong vertex shader, so this links against
+// its fragment shader as well as the depth pre-pass one.
+///////////////////////////////////////////////////////////////////////////////
+#version 330 core
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+
+// the Phong and depth programs must place every vertex identically
+invariant gl_Position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// MeshLibrary::LOD_SHAPE
+uniform int proceduralShape;
+// sphere sectors, cylinder sectors, torus main segments
+uniform int proceduralSegments;
+// sphere stacks, torus tube segments
+uniform int proceduralRings;
+// cylinder top radius, torus tube radius
+uniform float proceduralRadius;
+
+const int SHAPE_SPHERE = 0;
+const int SHAPE_CYLINDER = 1;
+const int SHAPE_TAPERED_CYLINDER = 2;
+const int SHAPE_TORUS = 3;
+
+const float PI = 3.14159265358979f;
+
+vec3 position;
+vec3 normal;
+vec2 uv;
+
+// Sphere grid point: ring i from the top pole, sector j
+void SphereVertex(int i, int j)
+{
+    float phi = PI / 2.0f - PI * float(i) / float(proceduralRings);
+    float theta = 2.0f * PI * float(j) / float(proceduralSegments);
+    position = vec3(cos(phi) * cos(theta), sin(phi), cos(phi) * sin(theta));
+    normal = position;
+    uv = vec2(float(j) / float(proceduralSegments), 1.0f - float(i) / float(proceduralRings));
+}
+
+// Rows 0 and stacks-1 only have one triangle per sector (the other
+// would have zero area at the pole); every other row has two.
+void Sphere(int triangle, int corner)
+{
+    int sectors = proceduralSegments;
+    int i;
+    int j;
+    bool bFirst;
+
+    int middle = 2 * sectors * (proceduralRings - 2);
+    if (triangle < sectors)
+    {
+        i = 0;
+        j = triangle;
+        bFirst = false;
+    }
+    else if (triangle - sectors < middle)
+    {
+        int t = triangle - sectors;
+        i = 1 + t / (2 * sectors);
+        j = (t % (2 * sectors)) / 2;
+        bFirst = (t % 2) == 0;
+    }
+    else
+    {
+        i = proceduralRings - 1;
+        j = triangle - sectors - middle;
+        bFirst = true;
+    }
+
+    // (k1, k1 + 1, k2) and (k1 + 1, k2 + 1, k2)
+    ivec2 corners[3];
+    if (bFirst)
+    {
+        corners[0] = ivec2(i, j);
+        corners[1] = ivec2(i, j + 1);
+        corners[2] = ivec2(i + 1, j);
+    }
+    else
+    {
+        corners[0] = ivec2(i, j + 1);
+        corners[1] = ivec2(i + 1, j + 1);
+        corners[2] = ivec2(i + 1, j);
+    }
+    SphereVertex(corners[corner].x, corners[corner].y);
+}
+
+void Cylinder(int triangle, int corner)
+{
+    int sectors = proceduralSegments;
+    float topRadius = proceduralRadius;
+
+    int side = triangle - sectors;
+    if (side >= 0 && side < 2 * sectors)
+    {
+        // sides: (bottom0, top0, bottom1) and (bottom1, top0, top1)
+        int j = side / 2;
+        bool bFirst = (side % 2) == 0;
+        ivec2 corners[3];
+        if (bFirst)
+        {
+            corners[0] = ivec2(j, 0);
+            corners[1] = ivec2(j, 1);
+            corners[2] = ivec2(j + 1, 0);
+        }
+        else
+        {
+            corners[0] = ivec2(j + 1, 0);
+            corners[1] = ivec2(j, 1);
+            corners[2] = ivec2(j + 1, 1);
+        }
+
+        int sector = corners[corner].x;
+        float top = float(corners[corner].y);
+        float angle = 2.0f * PI * float(sector) / float(sectors);
+        float c = cos(angle);
+        float s = sin(angle);
+        float slope = 1.0f - topRadius;
+        float normalScale = 1.0f / sqrt(1.0f + slope * slope);
+        float radius = mix(1.0f, topRadius, top);
+
+        position = vec3(radius * c, top, radius * s);
+        normal = vec3(c, slope, s) * normalScale;
+        uv = vec2(float(sector) / float(sectors), top);
+        return;
+    }
+
+    // caps: center, then the two rim points, ordered so the cap is
+    // counter-clockwise from the side it faces
+    bool bTop = (triangle >= 3 * sectors) && (triangle < 4 * sectors);
+    int j = triangle % sectors;
+    float y = bTop ? 1.0f : 0.0f;
+    float radius = bTop ? topRadius : 1.0f;
+    normal = vec3(0.0f, bTop ? 1.0f : -1.0f, 0.0f);
+
+    if (corner == 0)
+    {
+        position = vec3(0.0f, y, 0.0f);
+        uv = vec2(0.5f);
+        return;
+    }
+
+    int rim = (bTop == (corner == 1)) ? j + 1 : j;
+    float angle = 2.0f * PI * float(rim) / float(sectors);
+    float c = cos(angle);
+    float s = sin(angle);
+    position = vec3(radius * c, y, radius * s);
+    uv = vec2(0.5f + 0.5f * c, 0.5f + 0.5f * s);
+}
+
+void Torus(int triangle, int corner)
+{
+    int tubeSegments = proceduralRings;
+    int cell = triangle / 2;
+    int i = cell / tubeSegments;
+    int j = cell % tubeSegments;
+
+    // (a, b, a + 1) and (a + 1, b, b + 1), with b one main segment on
+    ivec2 corners[3];
+    if ((triangle % 2) == 0)
+    {
+        corners[0] = ivec2(i, j);
+        corners[1] = ivec2(i + 1, j);
+        corners[2] = ivec2(i, j + 1);
+    }
+    else
+    {
+        corners[0] = ivec2(i, j + 1);
+        corners[1] = ivec2(i + 1, j);
+        corners[2] = ivec2(i + 1, j + 1);
+    }
+
+    ivec2 grid = corners[corner];
+    float u = 2.0f * PI * float(grid.x) / float(proceduralSegments);
+    float v = 2.0f * PI * float(grid.y) / float(tubeSegments);
+    float ring = 1.0f + proceduralRadius * cos(v);
+
+    position = vec3(ring * cos(u), ring * sin(u), proceduralRadius * sin(v));
+    normal = vec3(cos(v) * cos(u), cos(v) * sin(u), sin(v));
+    uv = vec2(float(grid.x) / float(proceduralSegments), float(grid.y) / float(tubeSegments));
+}
+
+void main()
+{
+    int triangle = gl_VertexID / 3;
+    int corner = gl_VertexID % 3;
+
+    if (proceduralShape == SHAPE_SPHERE)
+        Sphere(triangle, corner);
+    else if (proceduralShape == SHAPE_TORUS)
+        Torus(triangle, corner);
+    else
+        Cylinder(triangle, corner);
+
+    fragmentPosition = vec3(model * vec4(position, 1.0f));
+    fragmentVertexNormal = mat3(transpose(inverse(model))) * normal;
+    fragmentTextureCoordinate = uv;
+    gl_Position = projection * view * model * vec4(position, 1.0f);
+}